@@ -18,11 +18,14 @@
 
 #pragma once
 
+#include <limits>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 #include <rapidjson/document.h>
+#include <rapidjson/reader.h>
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
@@ -33,36 +36,221 @@ namespace px {
 namespace carnot {
 namespace builtins {
 
-// TODO(zasgar): PL-419 To have proper support for JSON we need structs and nullable types.
-// Revisit when we have them.
-class PluckUDF : public udf::ScalarUDF {
+namespace internal {
+
+/**
+ * JSONPluckHandler is a SAX handler that finds the value of a key in a top level JSON object.
+ *
+ * Unlike parsing into a rapidjson::Document, no DOM is allocated, and the parse stops as soon as
+ * the value of the key has been read, so members after the key are never parsed. Input that is
+ * malformed up to the end of the value yields no value, as does input that doesn't end the top
+ * level object, such as a truncated body. Errors between the value and the final '}' are not
+ * detected.
+ */
+class JSONPluckHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, JSONPluckHandler> {
  public:
-  StringValue Exec(FunctionContext*, StringValue in, StringValue key) {
-    rapidjson::Document d;
-    rapidjson::ParseResult ok = d.Parse(in.data());
-    // TODO(zasgar/michellenguyen, PP-419): Replace with null when available.
-    if (ok == nullptr) {
-      return "";
+  using SizeType = rapidjson::SizeType;
+
+  explicit JSONPluckHandler(std::string_view key) : key_(key), writer_(buffer_) {}
+
+  /**
+   * Scans the JSON string for the key.
+   * @return true if the input is an object with the key, false otherwise.
+   */
+  bool Pluck(const std::string& json) {
+    rapidjson::Reader reader;
+    rapidjson::StringStream ss(json.c_str());
+    rapidjson::ParseResult result = reader.Parse(ss, *this);
+    if (!found_) {
+      return false;
     }
-    if (!d.IsObject()) {
-      return "";
+    // The handler terminates the parse once the value is complete, which is not an error.
+    if (result.IsError() && result.Code() != rapidjson::kParseErrorTermination) {
+      return false;
     }
-    if (!d.HasMember(key.data())) {
+    return EndsObject(json);
+  }
+
+  // Returns the value as a string. Strings are returned without quotes, and null as empty.
+  std::string AsString() const {
+    if (!found_ || type_ == rapidjson::kNullType) {
       return "";
     }
-    const auto& plucked_value = d[key.data()];
-    if (plucked_value.IsNull()) {
-      return "";
+    if (type_ == rapidjson::kStringType) {
+      return str_;
     }
-    if (plucked_value.IsString()) {
-      return plucked_value.GetString();
+    // This is robust to nested JSON.
+    return buffer_.GetString();
+  }
+
+  // Returns the value if it is an integer, and 0 otherwise.
+  int64_t AsInt64() const { return found_ && is_int_ ? int_ : 0; }
+
+  // Returns the value if it is a number, and 0.0 otherwise.
+  double AsFloat64() const { return found_ && type_ == rapidjson::kNumberType ? double_ : 0.0; }
+
+  bool Null() { return OnValue(rapidjson::kNullType, [this] { return writer_.Null(); }); }
+  bool Bool(bool b) {
+    return OnValue(b ? rapidjson::kTrueType : rapidjson::kFalseType,
+                   [this, b] { return writer_.Bool(b); });
+  }
+  bool Int(int i) { return OnInt(i, [this, i] { return writer_.Int(i); }); }
+  bool Uint(unsigned u) { return OnInt(u, [this, u] { return writer_.Uint(u); }); }
+  bool Int64(int64_t i) { return OnInt(i, [this, i] { return writer_.Int64(i); }); }
+  bool Uint64(uint64_t u) {
+    auto write = [this, u] { return writer_.Uint64(u); };
+    // Values past the range of int64 can only be read as a float.
+    if (u > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+      return OnDouble(static_cast<double>(u), write);
+    }
+    return OnInt(static_cast<int64_t>(u), write);
+  }
+  bool Double(double d) { return OnDouble(d, [this, d] { return writer_.Double(d); }); }
+  bool RawNumber(const char* str, SizeType len, bool copy) {
+    return OnValue(rapidjson::kNumberType,
+                   [this, str, len, copy] { return writer_.RawNumber(str, len, copy); });
+  }
+  bool String(const char* str, SizeType len, bool copy) {
+    if (!in_value_ && depth_ == 1 && matched_) {
+      str_.assign(str, len);
+    }
+    return OnValue(rapidjson::kStringType,
+                   [this, str, len, copy] { return writer_.String(str, len, copy); });
+  }
+  bool Key(const char* str, SizeType len, bool copy) {
+    if (in_value_) {
+      return writer_.Key(str, len, copy);
+    }
+    // The parse stops at the first match, so like rapidjson::Document::FindMember(), the first of
+    // duplicate keys wins.
+    if (depth_ == 1) {
+      matched_ = std::string_view(str, len) == key_;
     }
+    return true;
+  }
+  bool StartObject() {
+    return OnStartContainer(rapidjson::kObjectType, [this] { return writer_.StartObject(); });
+  }
+  bool EndObject(SizeType count) {
+    return OnEndContainer([this, count] { return writer_.EndObject(count); });
+  }
+  bool StartArray() {
+    // A top level array is not an object, so there is nothing to pluck.
+    if (depth_ == 0) {
+      return false;
+    }
+    return OnStartContainer(rapidjson::kArrayType, [this] { return writer_.StartArray(); });
+  }
+  bool EndArray(SizeType count) {
+    return OnEndContainer([this, count] { return writer_.EndArray(count); });
+  }
 
-    // This is robust to nested JSON.
-    rapidjson::StringBuffer sb;
-    rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
-    plucked_value.Accept(writer);
-    return sb.GetString();
+ private:
+  // Whether the last non-whitespace character closes an object. This catches truncated input
+  // without parsing past the value.
+  static bool EndsObject(std::string_view json) {
+    size_t pos = json.find_last_not_of(" \t\n\r");
+    return pos != std::string_view::npos && json[pos] == '}';
+  }
+
+  template <typename TWriteFn>
+  bool OnValue(rapidjson::Type type, TWriteFn write) {
+    if (in_value_) {
+      return write();
+    }
+    if (depth_ == 1 && matched_) {
+      type_ = type;
+      found_ = true;
+      if (type != rapidjson::kStringType) {
+        write();
+      }
+      // Stop parsing, the rest of the document is not needed.
+      return false;
+    }
+    // Scalars at the top level are not objects.
+    return depth_ > 0;
+  }
+
+  template <typename TWriteFn>
+  bool OnInt(int64_t i, TWriteFn write) {
+    if (!in_value_ && depth_ == 1 && matched_) {
+      is_int_ = true;
+      int_ = i;
+      double_ = static_cast<double>(i);
+    }
+    return OnValue(rapidjson::kNumberType, write);
+  }
+
+  template <typename TWriteFn>
+  bool OnDouble(double d, TWriteFn write) {
+    if (!in_value_ && depth_ == 1 && matched_) {
+      double_ = d;
+    }
+    return OnValue(rapidjson::kNumberType, write);
+  }
+
+  template <typename TWriteFn>
+  bool OnStartContainer(rapidjson::Type type, TWriteFn write) {
+    ++depth_;
+    if (in_value_) {
+      return write();
+    }
+    if (depth_ == 2 && matched_) {
+      in_value_ = true;
+      type_ = type;
+      return write();
+    }
+    return true;
+  }
+
+  template <typename TWriteFn>
+  bool OnEndContainer(TWriteFn write) {
+    --depth_;
+    if (!in_value_) {
+      return true;
+    }
+    write();
+    if (depth_ == 1) {
+      // The plucked object or array is complete, stop parsing.
+      in_value_ = false;
+      found_ = true;
+      return false;
+    }
+    return true;
+  }
+
+  std::string_view key_;
+  rapidjson::StringBuffer buffer_;
+  rapidjson::Writer<rapidjson::StringBuffer> writer_;
+
+  // The nesting depth of the current event, where the members of the top level object are at 1.
+  int depth_ = 0;
+  // Whether the last key at the top level is the key being plucked.
+  bool matched_ = false;
+  // Whether the events are inside the plucked object or array.
+  bool in_value_ = false;
+
+  bool found_ = false;
+  rapidjson::Type type_ = rapidjson::kNullType;
+  std::string str_;
+  bool is_int_ = false;
+  int64_t int_ = 0;
+  double double_ = 0.0;
+};
+
+}  // namespace internal
+
+// TODO(zasgar): PL-419 To have proper support for JSON we need structs and nullable types.
+// Revisit when we have them.
+class PluckUDF : public udf::ScalarUDF {
+ public:
+  StringValue Exec(FunctionContext*, StringValue in, StringValue key) {
+    internal::JSONPluckHandler handler(key);
+    // TODO(zasgar/michellenguyen, PP-419): Replace with null when available.
+    if (!handler.Pluck(in)) {
+      return "";
+    }
+    return handler.AsString();
   }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder(
@@ -87,17 +275,12 @@ class PluckUDF : public udf::ScalarUDF {
 class PluckAsInt64UDF : public udf::ScalarUDF {
  public:
   Int64Value Exec(FunctionContext*, StringValue in, StringValue key) {
-    rapidjson::Document d;
-    rapidjson::ParseResult ok = d.Parse(in.data());
+    internal::JSONPluckHandler handler(key);
     // TODO(zasgar/michellenguyen, PP-419): Replace with null when available.
-    if (ok == nullptr) {
-      return 0;
-    }
-    if (!d.IsObject()) {
+    if (!handler.Pluck(in)) {
       return 0;
     }
-    const auto& plucked_value = d[key.data()];
-    return plucked_value.GetInt64();
+    return handler.AsInt64();
   }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder(
@@ -122,17 +305,12 @@ class PluckAsInt64UDF : public udf::ScalarUDF {
 class PluckAsFloat64UDF : public udf::ScalarUDF {
  public:
   Float64Value Exec(FunctionContext*, StringValue in, StringValue key) {
-    rapidjson::Document d;
-    rapidjson::ParseResult ok = d.Parse(in.data());
+    internal::JSONPluckHandler handler(key);
     // TODO(zasgar/michellenguyen, PP-419): Replace with null when available.
-    if (ok == nullptr) {
-      return 0.0;
-    }
-    if (!d.IsObject()) {
+    if (!handler.Pluck(in)) {
       return 0.0;
     }
-    const auto& plucked_value = d[key.data()];
-    return plucked_value.GetDouble();
+    return handler.AsFloat64();
   }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder(
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+#include "src/carnot/funcs/builtins/json_ops.h"
+
+namespace px {
+namespace carnot {
+namespace builtins {
+
+static constexpr char kQuantiles[] = R"({"p50": 1.23, "p90": 4.56, "p99": 7.89, "p99.9": 10.11})";
+
+// Plucks the percentiles the way the latency scripts do, with one pluck per key.
+// NOLINTNEXTLINE : runtime/references.
+static void BM_PluckQuantiles(benchmark::State& state) {
+  PluckAsFloat64UDF udf;
+  std::string quantiles(kQuantiles);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(udf.Exec(nullptr, quantiles, "p50"));
+    benchmark::DoNotOptimize(udf.Exec(nullptr, quantiles, "p90"));
+    benchmark::DoNotOptimize(udf.Exec(nullptr, quantiles, "p99"));
+  }
+}
+
+// Plucks a small key out of a large JSON body, where the key is early in the document. The parse
+// stops after the key, so the time should not grow with the size of the body.
+// NOLINTNEXTLINE : runtime/references.
+static void BM_PluckLargeBody(benchmark::State& state) {
+  PluckUDF udf;
+  std::string body = R"({"status": "ok", "items": [)";
+  for (int i = 0; i < state.range(0); ++i) {
+    if (i > 0) {
+      body += ",";
+    }
+    body += R"({"id": 1234, "name": "some item name", "tags": ["a", "b", "c"]})";
+  }
+  body += "]}";
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(udf.Exec(nullptr, body, "status"));
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(body.length()) *
+                          static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK(BM_PluckQuantiles);
+BENCHMARK(BM_PluckLargeBody)->RangeMultiplier(4)->Range(1, 1024);
+
+}  // namespace builtins
+}  // namespace carnot
+}  // namespace px
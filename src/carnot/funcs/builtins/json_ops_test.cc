@@ -62,6 +62,54 @@ TEST(JSONOps, PluckUDF_non_object_input_return_empty) {
   udf_tester.ForInput("[\"asdad\"]", "str_key").Expect("");
 }
 
+TEST(JSONOps, PluckUDF_numbers_and_arrays) {
+  constexpr char kJSON[] = R"({"p50": 5.1, "count": 12, "ok": true, "tags": ["a", {"b": 1}]})";
+  auto udf_tester = udf::UDFTester<PluckUDF>();
+  udf_tester.ForInput(kJSON, "p50").Expect("5.1");
+  udf_tester.ForInput(kJSON, "count").Expect("12");
+  udf_tester.ForInput(kJSON, "ok").Expect("true");
+  udf_tester.ForInput(kJSON, "tags").Expect(R"(["a",{"b":1}])");
+}
+
+TEST(JSONOps, PluckUDF_only_matches_top_level_keys) {
+  constexpr char kJSON[] = R"({"a": {"key": "nested"}, "b": [{"key": 1}], "key": "top"})";
+  auto udf_tester = udf::UDFTester<PluckUDF>();
+  udf_tester.ForInput(kJSON, "key").Expect("top");
+}
+
+TEST(JSONOps, PluckUDF_null_return_empty) {
+  auto udf_tester = udf::UDFTester<PluckUDF>();
+  udf_tester.ForInput(R"({"key": null})", "key").Expect("");
+}
+
+TEST(JSONOps, PluckUDF_malformed_before_key_return_empty) {
+  auto udf_tester = udf::UDFTester<PluckUDF>();
+  udf_tester.ForInput(R"({"a": 1, "key" "abc"})", "key").Expect("");
+  udf_tester.ForInput(R"({"a": [1, 2}, "key": "abc"})", "key").Expect("");
+}
+
+// Truncated input yields no value, even though the parse stops at the key.
+TEST(JSONOps, PluckUDF_truncated_after_key_return_empty) {
+  udf::UDFTester<PluckUDF>().ForInput(R"({"key": "abc", "a": [1, 2)", "key").Expect("");
+  udf::UDFTester<PluckUDF>().ForInput(R"({"key": {"b": 1}, "a")", "key").Expect("");
+  udf::UDFTester<PluckAsInt64UDF>().ForInput(R"({"key": 1, "a")", "key").Expect(0);
+  udf::UDFTester<PluckAsFloat64UDF>().ForInput(R"({"key": 1.5, )", "key").Expect(0.0);
+  udf::UDFTester<PluckUDF>().ForInput(R"({"key": "abc")", "key").Expect("");
+}
+
+// Members after the key are not parsed, so errors there go unnoticed.
+TEST(JSONOps, PluckUDF_stops_after_key) {
+  constexpr char kJSON[] = R"({"key": "abc", "a": [1, 2} })";
+  udf::UDFTester<PluckUDF>().ForInput(kJSON, "key").Expect("abc");
+  udf::UDFTester<PluckUDF>().ForInput(R"({"key": {"b": 1}, "a" 1})", "key").Expect(R"({"b":1})");
+  udf::UDFTester<PluckUDF>().ForInput(R"({"a": 1, "key": [1, 2]} )", "key").Expect("[1,2]");
+}
+
+TEST(JSONOps, PluckUDF_duplicate_key_return_first) {
+  auto udf_tester = udf::UDFTester<PluckUDF>();
+  udf_tester.ForInput(R"({"key": "first", "key": "second"})", "key").Expect("first");
+}
+
 TEST(JSONOps, PluckAsInt64UDF) {
   auto udf_tester = udf::UDFTester<PluckAsInt64UDF>();
   udf_tester.ForInput(kTestJSONStr, "int64_key").Expect(34243242341);
@@ -77,6 +125,13 @@ TEST(JSONOps, PluckAsIntUDF_non_object_input_return_empty) {
   udf_tester.ForInput("[\"asdad\"]", "int64_key").Expect(0);
 }
 
+TEST(JSONOps, PluckAsInt64UDF_missing_or_non_int_return_empty) {
+  auto udf_tester = udf::UDFTester<PluckAsInt64UDF>();
+  udf_tester.ForInput(kTestJSONStr, "blah").Expect(0);
+  udf_tester.ForInput(kTestJSONStr, "str_plain").Expect(0);
+  udf_tester.ForInput(kTestJSONStr, "float64_key").Expect(0);
+}
+
 TEST(JSONOps, PluckAsFloat64UDF) {
   auto udf_tester = udf::UDFTester<PluckAsFloat64UDF>();
   udf_tester.ForInput(kTestJSONStr, "float64_key").Expect(123423.5234);
@@ -92,6 +147,12 @@ TEST(JSONOps, PluckAsFloatUDF_non_object_input_return_empty) {
   udf_tester.ForInput("[\"asdad\"]", "float64_key").Expect(0.0);
 }
 
+TEST(JSONOps, PluckAsFloat64UDF_int_value) {
+  auto udf_tester = udf::UDFTester<PluckAsFloat64UDF>();
+  udf_tester.ForInput(kTestJSONStr, "int64_key").Expect(34243242341.0);
+  udf_tester.ForInput(kTestJSONStr, "blah").Expect(0.0);
+}
+
 TEST(JSONOps, PluckArrayUDF) {
   auto udf_tester = udf::UDFTester<PluckArrayUDF>();
   udf_tester.ForInput(kTestJSONArray, 2).Expect(R"({"pixie":"labs"})");
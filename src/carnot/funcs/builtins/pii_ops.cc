@@ -17,8 +17,11 @@
  */
 #include <algorithm>
 #include <map>
+#include <numeric>
 #include <vector>
 
+#include <absl/strings/ascii.h>
+
 #include "src/carnot/funcs/builtins/pii_ops.h"
 
 namespace px {
@@ -246,9 +249,28 @@ Status RedactPIIUDF::Init(FunctionContext*) {
   taggers_.push_back(std::make_unique<RegexTagger<Tag::Type::IMEI>>());
   taggers_.push_back(std::make_unique<RegexTagger<Tag::Type::IMEISV>>());
   taggers_.push_back(std::make_unique<RegexTagger<Tag::Type::CC_NUMBER>>());
+
+  tagger_set_ = std::make_unique<re2::RE2::Set>(RE2::DefaultOptions, RE2::UNANCHORED);
+  for (const auto& tagger : taggers_) {
+    std::string err;
+    if (tagger_set_->Add(tagger->Pattern(), &err) < 0) {
+      return error::Internal("Failed to add PII pattern to regex set: $0", err);
+    }
+  }
+  if (!tagger_set_->Compile()) {
+    return error::Internal("Failed to compile PII regex set.");
+  }
   return Status::OK();
 }
 
+// Every PII pattern requires at least one digit, '@', '%', ':' or '-', so strings without any of
+// these can skip the regexes entirely.
+static inline bool MayContainPII(std::string_view input) {
+  return std::any_of(input.begin(), input.end(), [](char c) {
+    return absl::ascii_isdigit(c) || c == '@' || c == '%' || c == ':' || c == '-';
+  });
+}
+
 // Replace all tagged sequences in the string with the corresponding substitution string. For
 // overlapping tags, we take the longest tag.
 static inline std::string ReplaceTagsWithSubs(std::string input, std::vector<Tag>* tags) {
@@ -305,9 +327,27 @@ static inline std::string ReplaceTagsWithSubs(std::string input, std::vector<Tag
 }
 
 StringValue RedactPIIUDF::Exec(FunctionContext*, StringValue input) {
+  if (!MayContainPII(input)) {
+    return input;
+  }
+
+  std::vector<int> matched_taggers;
+  re2::RE2::Set::ErrorInfo err;
+  if (!tagger_set_->Match(input, &matched_taggers, &err)) {
+    if (err.kind == re2::RE2::Set::kNoError) {
+      return input;
+    }
+    // If the set failed to run (eg. the DFA ran out of memory), fall back to running all the
+    // taggers, since redaction must not be skipped.
+    matched_taggers.resize(taggers_.size());
+    std::iota(matched_taggers.begin(), matched_taggers.end(), 0);
+  }
+  // Run the taggers in their original order, which the tag de-duplication relies on.
+  std::sort(matched_taggers.begin(), matched_taggers.end());
+
   std::vector<Tag> tags;
-  for (const auto& tagger : taggers_) {
-    auto s = tagger->AddTags(&input, &tags);
+  for (int idx : matched_taggers) {
+    auto s = taggers_[idx]->AddTags(&input, &tags);
     if (!s.ok()) {
       return "Invalid regex: " + s.msg();
     }
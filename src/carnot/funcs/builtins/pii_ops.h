@@ -22,6 +22,7 @@
 #include <vector>
 
 #include "re2/re2.h"
+#include "re2/set.h"
 #include "src/carnot/udf/registry.h"
 #include "src/common/base/utils.h"
 #include "src/shared/types/types.h"
@@ -55,6 +56,8 @@ class Tagger {
  public:
   virtual ~Tagger() = default;
   virtual Status AddTags(std::string* input, std::vector<Tag>* tags) = 0;
+  // The regex pattern that any tag found by this tagger must match.
+  virtual std::string_view Pattern() const = 0;
 };
 
 class RedactPIIUDF : public udf::ScalarUDF {
@@ -78,6 +81,9 @@ class RedactPIIUDF : public udf::ScalarUDF {
 
  private:
   std::vector<std::unique_ptr<Tagger>> taggers_;
+  // All of the tagger patterns compiled into a single automaton, with the same indices as
+  // taggers_. A single pass over the input determines which taggers need to run.
+  std::unique_ptr<re2::RE2::Set> tagger_set_;
 };
 
 void RegisterPIIOpsOrDie(udf::Registry* registry);
@@ -90,7 +96,7 @@ class RegexTagger : public Tagger {
     DCHECK_EQ(regex_.error_code(), RE2::NoError) << regex_.error();
   }
 
-  Status AddTags(std::string* input, std::vector<Tag>* tags) {
+  Status AddTags(std::string* input, std::vector<Tag>* tags) override {
     re2::StringPiece input_piece(input->data(), input->length());
     auto prev_length = input_piece.length();
     int curr_idx = 0;
@@ -116,6 +122,8 @@ class RegexTagger : public Tagger {
     return Status::OK();
   }
 
+  std::string_view Pattern() const override { return TagTypeTraits<TTag>::BuildRegexPattern(); }
+
  private:
   re2::RE2 regex_;
 };
@@ -49,7 +49,31 @@ static void BM_RedactPII(benchmark::State& state) {
                           static_cast<int64_t>(state.iterations()));
 }
 
+static constexpr std::string_view clean_input_chunk = R"input(
+        {"name": "some user name", "items": [{"id": 1234, "status": "ok"}, {"id": 5678}],
+        "description": "a typical request body that does not contain any personal information"}
+)input";
+
+// Most bodies do not contain PII, in which case only the combined regex set has to run.
+// NOLINTNEXTLINE : runtime/references.
+static void BM_RedactPIINoMatch(benchmark::State& state) {
+  RedactPIIUDF udf;
+  PL_UNUSED(udf.Init(nullptr));
+
+  std::string text_chunk(clean_input_chunk);
+  std::string text;
+  for (int i = 0; i < state.range(0); i++) {
+    text += text_chunk;
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(udf.Exec(nullptr, text));
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(text.length()) *
+                          static_cast<int64_t>(state.iterations()));
+}
+
 BENCHMARK(BM_RedactPII)->RangeMultiplier(2)->Range(1, 12);
+BENCHMARK(BM_RedactPIINoMatch)->RangeMultiplier(2)->Range(1, 12);
 
 }  // namespace builtins
 }  // namespace carnot
@@ -217,6 +217,20 @@ TEST_P(RedactionTest, basic) {
   udf::UDFTester<RedactPIIUDF>().Init().ForInput(test_case.first).Expect(test_case.second);
 }
 
+TEST(RedactPIIUDF, no_pii_characters) {
+  udf::UDFTester<RedactPIIUDF>()
+      .Init()
+      .ForInput("hello world, there is nothing to redact here.")
+      .Expect("hello world, there is nothing to redact here.");
+}
+
+TEST(RedactPIIUDF, letters_only_mac_addr) {
+  udf::UDFTester<RedactPIIUDF>()
+      .Init()
+      .ForInput("mac=ff-ff-ab-cd-ef-ff;")
+      .Expect("mac=<REDACTED_MAC_ADDR>;");
+}
+
 INSTANTIATE_TEST_SUITE_P(TemplatedRedactionTest, RedactionTest,
                          testing::ValuesIn(TestCaseGen({IPv4Gen(), IPv6Gen(), EmailGen(), CCGen(),
                                                         IMEIGen(), NegativeExampleGen()})));
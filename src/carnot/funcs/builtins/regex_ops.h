@@ -29,6 +29,7 @@
 #include <utility>
 #include <vector>
 #include "re2/re2.h"
+#include "re2/set.h"
 #include "src/carnot/udf/registry.h"
 #include "src/common/base/utils.h"
 #include "src/shared/types/types.h"
@@ -125,6 +126,12 @@ class MatchRegexRule : public udf::ScalarUDF {
     if (!parse_result) {
       return Status(statuspb::Code::INVALID_ARGUMENT, "unable to parse string as json");
     }
+    regex_rules.clear();
+    regex_rules_length = 0;
+    set_idx_to_rule_idx_.clear();
+    re2::RE2::Options opts;
+    opts.set_log_errors(false);
+    regex_set_ = std::make_unique<re2::RE2::Set>(opts, RE2::ANCHOR_BOTH);
     // Populate the parse regular expressions into self::regex_rules.
     for (rapidjson::Value::ConstMemberIterator itr = regex_rules_json.MemberBegin();
          itr != regex_rules_json.MemberEnd(); ++itr) {
@@ -132,13 +139,35 @@ class MatchRegexRule : public udf::ScalarUDF {
       std::string name = itr->name.GetString();
       std::string regex_pattern = itr->value.GetString();
       PL_RETURN_IF_ERROR(regex_match_udf.Init(ctx, regex_pattern));
+      // Invalid patterns never match, so they are left out of the set.
+      if (regex_set_->Add(regex_pattern, nullptr) >= 0) {
+        set_idx_to_rule_idx_.push_back(regex_rules_length);
+      }
       regex_rules.emplace_back(make_pair(name, std::move(regex_match_udf)));
       regex_rules_length++;
     }
+    if (!set_idx_to_rule_idx_.empty() && !regex_set_->Compile()) {
+      return error::Internal("Failed to compile regex rules.");
+    }
     return Status::OK();
   }
 
   types::StringValue Exec(FunctionContext* ctx, StringValue value) {
+    if (set_idx_to_rule_idx_.empty()) {
+      return "";
+    }
+    // All the rules are matched in a single pass, and the first matching rule wins.
+    std::vector<int> matches;
+    re2::RE2::Set::ErrorInfo err;
+    if (regex_set_->Match(value, &matches, &err)) {
+      int set_idx = *std::min_element(matches.begin(), matches.end());
+      return regex_rules[set_idx_to_rule_idx_[set_idx]].first;
+    }
+    if (err.kind == re2::RE2::Set::kNoError) {
+      return "";
+    }
+    // The set can fail to run (eg. if the DFA runs out of memory), so fall back to matching the
+    // rules one at a time.
     for (int i = 0; i < regex_rules_length; i++) {
       if (regex_rules[i].second.Exec(ctx, value).val) {
         return regex_rules[i].first;
@@ -171,6 +200,9 @@ class MatchRegexRule : public udf::ScalarUDF {
  private:
   int regex_rules_length = 0;
   std::vector<std::pair<std::string, RegexMatchUDF> > regex_rules;
+  std::unique_ptr<re2::RE2::Set> regex_set_;
+  // Maps the index of a pattern in regex_set_ to its index in regex_rules.
+  std::vector<int> set_idx_to_rule_idx_;
 };
 
 void RegisterRegexOpsOrDie(udf::Registry* registry);
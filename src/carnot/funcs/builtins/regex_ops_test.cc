@@ -91,6 +91,14 @@ TEST(RegexOps, regex_match_rules) {
   EXPECT_NOT_OK(MatchRegexRule().Init(nullptr, "(?i).*onpointerenter.*"));
 }
 
+TEST(RegexOps, regex_match_rules_first_match_wins) {
+  auto udf_tester = udf::UDFTester<MatchRegexRule>();
+  udf_tester.Init(R"({"invalid": "(abc", "select": "SELECT.*", "any": ".*", "id": ".*id.*"})");
+  udf_tester.ForInput("SELECT id FROM courses").Expect("select");
+  udf_tester.ForInput("UPDATE courses SET id = 2").Expect("any");
+  udf_tester.ForInput("(abc").Expect("any");
+}
+
 }  // namespace builtins
 }  // namespace carnot
 }  // namespace px
@@ -18,6 +18,7 @@
 
 
 #include "src/carnot/funcs/builtins/request_path_ops.h"
+#include <algorithm>
 #include <string_view>
 #include <vector>
 #include "src/carnot/udf/registry.h"
@@ -210,36 +211,135 @@ void RequestPathCluster::ToJSON(rapidjson::Writer<rapidjson::StringBuffer>* writ
   writer->EndObject();
 }
 
+void RequestPathCentroidIndex::Insert(int64_t cluster_index, const RequestPath& centroid) {
+  auto [root_it, inserted] = depth_to_root_.try_emplace(centroid.depth(), nodes_.size());
+  if (inserted) {
+    nodes_.emplace_back();
+  }
+  int32_t node_id = root_it->second;
+  nodes_[node_id].num_clusters++;
+  for (const auto& path_component : centroid.path_components()) {
+    auto [child_it, new_child] = nodes_[node_id].children.try_emplace(path_component, 0);
+    if (new_child) {
+      child_it->second = nodes_.size();
+      // Note that this may reallocate nodes_, so no references to nodes are held across it.
+      nodes_.emplace_back();
+    }
+    node_id = child_it->second;
+    nodes_[node_id].num_clusters++;
+  }
+  nodes_[node_id].cluster_indices.push_back(cluster_index);
+}
+
+void RequestPathCentroidIndex::Remove(int64_t cluster_index, const RequestPath& centroid) {
+  auto root_it = depth_to_root_.find(centroid.depth());
+  if (root_it == depth_to_root_.end()) {
+    return;
+  }
+  std::vector<int32_t> node_path = {root_it->second};
+  for (const auto& path_component : centroid.path_components()) {
+    const auto& children = nodes_[node_path.back()].children;
+    auto child_it = children.find(path_component);
+    if (child_it == children.end()) {
+      return;
+    }
+    node_path.push_back(child_it->second);
+  }
+  auto& cluster_indices = nodes_[node_path.back()].cluster_indices;
+  auto it = std::find(cluster_indices.begin(), cluster_indices.end(), cluster_index);
+  if (it == cluster_indices.end()) {
+    return;
+  }
+  cluster_indices.erase(it);
+  for (int32_t node_id : node_path) {
+    nodes_[node_id].num_clusters--;
+  }
+}
+
+void RequestPathCentroidIndex::Clear() {
+  nodes_.clear();
+  depth_to_root_.clear();
+}
+
+int64_t RequestPathCentroidIndex::MostSimilar(const RequestPath& request_path,
+                                              int64_t* num_agree) const {
+  *num_agree = 0;
+  auto root_it = depth_to_root_.find(request_path.depth());
+  if (root_it == depth_to_root_.end()) {
+    return -1;
+  }
+  int64_t best_index = -1;
+  Search(root_it->second, request_path.path_components(), 0, 0, num_agree, &best_index);
+  return best_index;
+}
+
+void RequestPathCentroidIndex::Search(int32_t node_id,
+                                      const std::vector<std::string>& path_components,
+                                      size_t level, int64_t num_agree, int64_t* best_num_agree,
+                                      int64_t* best_index) const {
+  const Node& node = nodes_[node_id];
+  if (node.num_clusters == 0) {
+    return;
+  }
+  int64_t remaining = path_components.size() - level;
+  if (num_agree + remaining < *best_num_agree) {
+    return;
+  }
+  if (remaining == 0) {
+    // A centroid has to agree on at least one path component to be considered similar.
+    for (int64_t cluster_index : node.cluster_indices) {
+      if (num_agree > *best_num_agree ||
+          (num_agree == *best_num_agree && *best_index != -1 && cluster_index < *best_index)) {
+        *best_num_agree = num_agree;
+        *best_index = cluster_index;
+      }
+    }
+    return;
+  }
+
+  // Visit the agreeing child first, so that the best centroid is found early and prunes the
+  // remaining subtrees. kAnyToken never agrees with anything.
+  const auto& path_component = path_components[level];
+  int32_t agreeing_child = -1;
+  if (path_component != RequestPath::kAnyToken) {
+    auto child_it = node.children.find(path_component);
+    if (child_it != node.children.end()) {
+      agreeing_child = child_it->second;
+      Search(agreeing_child, path_components, level + 1, num_agree + 1, best_num_agree,
+             best_index);
+    }
+  }
+  for (const auto& [child_path_component, child] : node.children) {
+    if (child == agreeing_child) {
+      continue;
+    }
+    Search(child, path_components, level + 1, num_agree, best_num_agree, best_index);
+  }
+}
+
 double RequestPathClustering::MaxSimilarity(const RequestPath& request_path,
                                             int64_t* max_index) const {
-  auto it = depth_to_centroid_indices_.find(request_path.depth());
-  *max_index = -1;
-  if (it == depth_to_centroid_indices_.end()) {
+  int64_t num_agree;
+  *max_index = centroid_index_.MostSimilar(request_path, &num_agree);
+  if (*max_index == -1) {
     return 0.0;
   }
-  auto max_similarity = 0.0;
-  for (auto index : it->second) {
-    auto similarity = clusters_[index].Similarity(request_path);
-    if (similarity > max_similarity) {
-      *max_index = index;
-      max_similarity = similarity;
-    }
-  }
-  return max_similarity;
+  return static_cast<double>(num_agree) / request_path.depth();
 }
 
 void RequestPathClustering::AddNewCluster(const RequestPathCluster& cluster) {
-  auto centroid = cluster.centroid();
-  if (depth_to_centroid_indices_.find(centroid.depth()) == depth_to_centroid_indices_.end()) {
-    depth_to_centroid_indices_.emplace(centroid.depth(), std::vector<int64_t>());
-  }
-  depth_to_centroid_indices_[centroid.depth()].push_back(clusters_.size());
+  centroid_index_.Insert(clusters_.size(), cluster.centroid());
   clusters_.push_back(cluster);
 }
 
 void RequestPathClustering::MergeCluster(int64_t cluster_index,
                                          const RequestPathCluster& other_cluster) {
+  RequestPath prev_centroid = clusters_[cluster_index].centroid();
   clusters_[cluster_index].Merge(other_cluster);
+  if (!(clusters_[cluster_index].centroid() == prev_centroid)) {
+    centroid_index_.Remove(cluster_index, prev_centroid);
+    centroid_index_.Insert(cluster_index, clusters_[cluster_index].centroid());
+  }
 }
 
 StatusOr<RequestPathClustering> RequestPathClustering::FromJSON(const std::string& json) {
@@ -307,14 +407,10 @@ void RequestPathClustering::Merge(const RequestPathClustering& other_clustering)
   }
 
   clusters_ = new_clusters;
-  // Rebuild depth_to_cluster_indices mapping.
-  depth_to_centroid_indices_.clear();
+  // Rebuild the centroid index.
+  centroid_index_.Clear();
   for (const auto& [cluster_idx, cluster] : Enumerate(clusters_)) {
-    auto depth = cluster.centroid().depth();
-    if (depth_to_centroid_indices_.find(depth) == depth_to_centroid_indices_.end()) {
-      depth_to_centroid_indices_.emplace(depth, std::vector<int64_t>());
-    }
-    depth_to_centroid_indices_[depth].push_back(cluster_idx);
+    centroid_index_.Insert(cluster_idx, cluster.centroid());
   }
 
   for (const auto& cluster : other_clustering.clusters_) {
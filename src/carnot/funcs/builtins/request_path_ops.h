@@ -85,7 +85,7 @@ class RequestPath {
 
   template <typename H>
   friend H AbslHashValue(H h, const RequestPath& request_path) {
-    return H::combine(std::move(h), request_path.ToString());
+    return H::combine(std::move(h), request_path.path_components_);
   }
 
   // Serialization/Deserialization
@@ -174,6 +174,45 @@ class RequestPathCluster {
   absl::flat_hash_set<RequestPath> members_;
 };
 
+class RequestPathCentroidIndex {
+  /**
+   * This class indexes the cluster centroids in a trie of path components, with one trie per
+   * depth. The most similar centroid to a request path is found by walking the trie, following
+   * the agreeing path component first, and pruning subtrees that can no longer beat the best
+   * centroid found so far. For request paths close to an existing centroid, this visits
+   * O(depth) nodes instead of comparing against every centroid of the same depth.
+   */
+ public:
+  void Insert(int64_t cluster_index, const RequestPath& centroid);
+  void Remove(int64_t cluster_index, const RequestPath& centroid);
+  void Clear();
+
+  /**
+   * Returns the index of the most similar centroid to the request path, as defined by
+   * RequestPath::Similarity. Ties go to the lowest cluster index.
+   * @param request_path the request path to find the closest centroid for.
+   * @param num_agree set to the number of path components that agree with the closest centroid.
+   * @return the cluster index, or -1 if no centroid agrees on any path component.
+   */
+  int64_t MostSimilar(const RequestPath& request_path, int64_t* num_agree) const;
+
+ private:
+  struct Node {
+    absl::flat_hash_map<std::string, int32_t> children;
+    // Clusters whose centroid ends at this node.
+    std::vector<int64_t> cluster_indices;
+    // Number of clusters in the subtree, so that emptied subtrees are skipped.
+    int64_t num_clusters = 0;
+  };
+
+  void Search(int32_t node_id, const std::vector<std::string>& path_components, size_t level,
+              int64_t num_agree, int64_t* best_num_agree, int64_t* best_index) const;
+
+  // Nodes refer to their children by index, which keeps the index copyable.
+  std::vector<Node> nodes_;
+  absl::flat_hash_map<int64_t, int32_t> depth_to_root_;
+};
+
 class RequestPathClustering {
  public:
   static StatusOr<RequestPathClustering> FromJSON(const std::string& json);
@@ -202,7 +241,7 @@ class RequestPathClustering {
   void AddNewCluster(const RequestPathCluster& cluster);
   void MergeCluster(int64_t cluster_index, const RequestPathCluster& other_cluster);
   // We currently only allow request path's with the same depth to be clustered together.
-  absl::flat_hash_map<int64_t, std::vector<int64_t>> depth_to_centroid_indices_;
+  RequestPathCentroidIndex centroid_index_;
   std::vector<RequestPathCluster> clusters_;
   double thresh_ = 0.5;
 };
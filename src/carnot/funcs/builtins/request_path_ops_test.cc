@@ -22,6 +22,8 @@
 #include <algorithm>
 #include <vector>
 
+#include <absl/strings/substitute.h>
+
 #include "src/carnot/funcs/builtins/request_path_ops.h"
 #include "src/carnot/funcs/builtins/request_path_ops_test_utils.h"
 #include "src/carnot/udf/test_utils.h"
@@ -72,6 +74,65 @@ TEST(RequestPathClusteringFit, basic_low_cardinality) {
   EXPECT_EQ("/a/b/d", clustering.clusters()[0].Predict(RequestPath("/a/b/d")).ToString());
 }
 
+TEST(RequestPathCentroidIndex, most_similar_matches_brute_force) {
+  std::vector<RequestPath> centroids;
+  for (const auto& a : {"a", "b", "*"}) {
+    for (const auto& b : {"x", "y", "*"}) {
+      for (const auto& c : {"1", "2", "*"}) {
+        centroids.push_back(RequestPath(absl::Substitute("/$0/$1/$2", a, b, c)));
+      }
+    }
+  }
+  // A centroid of another depth should never be returned.
+  centroids.push_back(RequestPath("/a/x"));
+
+  RequestPathCentroidIndex index;
+  for (const auto& [i, centroid] : Enumerate(centroids)) {
+    index.Insert(i, centroid);
+  }
+
+  for (const auto& a : {"a", "c", "*"}) {
+    for (const auto& b : {"x", "z", "*"}) {
+      for (const auto& c : {"1", "3", "*"}) {
+        RequestPath request_path(absl::Substitute("/$0/$1/$2", a, b, c));
+        int64_t expected_index = -1;
+        double max_similarity = 0.0;
+        for (const auto& [i, centroid] : Enumerate(centroids)) {
+          if (centroid.depth() != request_path.depth()) {
+            continue;
+          }
+          auto similarity = centroid.Similarity(request_path);
+          if (similarity > max_similarity) {
+            expected_index = i;
+            max_similarity = similarity;
+          }
+        }
+        int64_t num_agree;
+        EXPECT_EQ(expected_index, index.MostSimilar(request_path, &num_agree))
+            << request_path.ToString();
+        EXPECT_DOUBLE_EQ(max_similarity, static_cast<double>(num_agree) / request_path.depth());
+      }
+    }
+  }
+}
+
+TEST(RequestPathCentroidIndex, remove) {
+  RequestPathCentroidIndex index;
+  index.Insert(0, RequestPath("/a/b/c"));
+  index.Insert(1, RequestPath("/a/b/*"));
+
+  int64_t num_agree;
+  EXPECT_EQ(0, index.MostSimilar(RequestPath("/a/b/c"), &num_agree));
+  EXPECT_EQ(3, num_agree);
+
+  index.Remove(0, RequestPath("/a/b/c"));
+  EXPECT_EQ(1, index.MostSimilar(RequestPath("/a/b/c"), &num_agree));
+  EXPECT_EQ(2, num_agree);
+
+  index.Remove(1, RequestPath("/a/b/*"));
+  EXPECT_EQ(-1, index.MostSimilar(RequestPath("/a/b/c"), &num_agree));
+}
+
 TEST(RequestPathClusteringPredict, basic) {
   auto uda_tester = udf::UDATester<RequestPathClusteringFitUDA>();
   auto serialized_clustering = uda_tester.ForInput("/a/b/c")
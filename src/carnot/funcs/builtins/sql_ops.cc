@@ -15,11 +15,23 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
+#include <algorithm>
+#include <optional>
+#include <utility>
 #include <vector>
 
 #include "src/carnot/funcs/builtins/sql_ops.h"
 #include "src/carnot/udf/registry.h"
 #include "src/common/base/base.h"
+#include "src/common/metrics/metrics.h"
+
+DEFINE_int32(carnot_sql_normalization_cache_size,
+             gflags::Int32FromEnv("PL_CARNOT_SQL_NORMALIZATION_CACHE_SIZE", 8192),
+             "Maximum number of parsed queries cached per SQL dialect by px.normalize_pgsql and "
+             "px.normalize_mysql.");
+DEFINE_int32(carnot_sql_normalization_cache_max_query_bytes,
+             gflags::Int32FromEnv("PL_CARNOT_SQL_NORMALIZATION_CACHE_MAX_QUERY_BYTES", 16384),
+             "Queries longer than this are normalized without being cached.");
 
 namespace {
 static inline px::Status ParseExecuteCommand(std::string execute, std::string* query,
@@ -41,6 +53,78 @@ static inline px::Status ParseExecuteCommand(std::string execute, std::string* q
 namespace px {
 namespace carnot {
 namespace builtins {
+namespace internal {
+
+namespace {
+
+prometheus::Family<prometheus::Counter>& LookupsFamily() {
+  static auto& family = prometheus::BuildCounter()
+                            .Name("carnot_sql_normalization_cache_lookups")
+                            .Help("Parsed query cache lookups made by SQL normalization, by "
+                                  "dialect and result.")
+                            .Register(GetMetricsRegistry());
+  return family;
+}
+
+size_t CacheSizeFromFlags() {
+  return static_cast<size_t>(std::max(FLAGS_carnot_sql_normalization_cache_size, 1));
+}
+
+size_t MaxQuerySizeFromFlags() {
+  return static_cast<size_t>(std::max(FLAGS_carnot_sql_normalization_cache_max_query_bytes, 0));
+}
+
+}  // namespace
+
+SQLFragmentCache& SQLFragmentCache::PgSQL() {
+  static SQLFragmentCache* cache = new SQLFragmentCache(
+      "pgsql", sql_parsing::parse_pgsql_fragments, CacheSizeFromFlags(), MaxQuerySizeFromFlags());
+  return *cache;
+}
+
+SQLFragmentCache& SQLFragmentCache::MySQL() {
+  static SQLFragmentCache* cache = new SQLFragmentCache(
+      "mysql", sql_parsing::parse_mysql_fragments, CacheSizeFromFlags(), MaxQuerySizeFromFlags());
+  return *cache;
+}
+
+SQLFragmentCache::SQLFragmentCache(std::string_view dialect, ParseFn parse_fn, size_t capacity,
+                                   size_t max_query_size)
+    : parse_fn_(std::move(parse_fn)),
+      max_query_size_(max_query_size),
+      cache_(capacity, &LookupsFamily(), {{"dialect", std::string(dialect)}}) {}
+
+std::shared_ptr<const SQLFragmentCache::ParsedQuery> SQLFragmentCache::Parse(
+    const std::string& query) {
+  auto parsed = std::make_shared<ParsedQuery>();
+  auto fragments_or_s = parse_fn_(query);
+  if (fragments_or_s.ok()) {
+    parsed->sorted_fragments = fragments_or_s.ConsumeValueOrDie();
+  } else {
+    parsed->status = fragments_or_s.status();
+  }
+  return parsed;
+}
+
+std::shared_ptr<const SQLFragmentCache::ParsedQuery> SQLFragmentCache::Get(
+    const std::string& query) {
+  if (query.size() > max_query_size_) {
+    return Parse(query);
+  }
+
+  std::optional<std::shared_ptr<const ParsedQuery>> cached = cache_.Get(query);
+  if (cached.has_value()) {
+    return *std::move(cached);
+  }
+
+  // Parse outside of the cache lock. Concurrent misses on the same query may both parse it, which
+  // is harmless since the results are identical.
+  auto parsed = Parse(query);
+  cache_.Put(query, parsed);
+  return parsed;
+}
+
+}  // namespace internal
 
 void RegisterSQLOpsOrDie(udf::Registry* registry) {
   CHECK(registry != nullptr);
@@ -75,7 +159,14 @@ types::StringValue NormalizePostgresSQLUDF::Exec(FunctionContext*, StringValue s
     return result.ToJSON();
   }
 
-  auto result_or_s = sql_parsing::normalize_pgsql(query, param_values);
+  auto parsed = internal::SQLFragmentCache::PgSQL().Get(query);
+  if (!parsed->status.ok()) {
+    sql_parsing::NormalizeResult result;
+    result.errmsg = parsed->status.msg();
+    return result.ToJSON();
+  }
+  auto result_or_s =
+      sql_parsing::normalize_pgsql_fragments(query, parsed->sorted_fragments, param_values);
   if (!result_or_s.ok()) {
     sql_parsing::NormalizeResult result;
     result.errmsg = result_or_s.status().msg();
@@ -105,7 +196,14 @@ types::StringValue NormalizeMySQLUDF::Exec(FunctionContext*, StringValue sql_str
     return result.ToJSON();
   }
 
-  auto result_or_s = sql_parsing::normalize_mysql(query, param_values);
+  auto parsed = internal::SQLFragmentCache::MySQL().Get(query);
+  if (!parsed->status.ok()) {
+    sql_parsing::NormalizeResult result;
+    result.errmsg = parsed->status.msg();
+    return result.ToJSON();
+  }
+  auto result_or_s =
+      sql_parsing::normalize_mysql_fragments(query, parsed->sorted_fragments, param_values);
   if (!result_or_s.ok()) {
     sql_parsing::NormalizeResult result;
     result.errmsg = result_or_s.status().msg();
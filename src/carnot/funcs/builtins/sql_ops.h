@@ -19,17 +19,74 @@
 #pragma once
 
 #include <absl/strings/strip.h>
+#include <functional>
+#include <memory>
 #include <regex>
 #include <string>
+#include <string_view>
+#include <vector>
 #include "src/carnot/funcs/builtins/sql_parsing/normalization.h"
+#include "src/carnot/funcs/shared/sharded_lru_cache.h"
 #include "src/carnot/udf/registry.h"
+#include "src/common/base/base.h"
 #include "src/common/base/status.h"
 #include "src/common/base/utils.h"
 #include "src/shared/types/types.h"
 
+DECLARE_int32(carnot_sql_normalization_cache_size);
+DECLARE_int32(carnot_sql_normalization_cache_max_query_bytes);
+
 namespace px {
 namespace carnot {
 namespace builtins {
+namespace internal {
+
+/**
+ * SQLFragmentCache caches the parsed fragments of SQL queries, keyed by the query text.
+ *
+ * Parsing dominates the cost of normalization, and applications send the same statements over and
+ * over: the query text of a prepared statement is identical across EXECUTEs, and only the
+ * parameters change. The fragments only depend on the query text, so a cached parse is reused
+ * with the parameters of each request. Parse errors are cached as well.
+ *
+ * One ShardedLRUCache per SQL dialect is shared by all queries on the agent. Queries longer than
+ * the maximum query size are parsed without being cached.
+ */
+class SQLFragmentCache : public NotCopyMoveable {
+ public:
+  struct ParsedQuery {
+    Status status;
+    std::vector<sql_parsing::SQLFragment> sorted_fragments;
+  };
+
+  using ParseFn =
+      std::function<StatusOr<std::vector<sql_parsing::SQLFragment>>(const std::string& query)>;
+
+  /**
+   * The caches shared by all queries, configured by the carnot_sql_normalization_cache_* flags.
+   */
+  static SQLFragmentCache& PgSQL();
+  static SQLFragmentCache& MySQL();
+
+  SQLFragmentCache(std::string_view dialect, ParseFn parse_fn, size_t capacity,
+                   size_t max_query_size);
+
+  /**
+   * Returns the parsed fragments of the query, parsing it if it is not cached.
+   */
+  std::shared_ptr<const ParsedQuery> Get(const std::string& query);
+
+  const funcs::CacheStats& stats() const { return cache_.stats(); }
+
+ private:
+  std::shared_ptr<const ParsedQuery> Parse(const std::string& query);
+
+  const ParseFn parse_fn_;
+  const size_t max_query_size_;
+  funcs::ShardedLRUCache<std::shared_ptr<const ParsedQuery>> cache_;
+};
+
+}  // namespace internal
 
 static constexpr char kPgExecCmdCode[] = "Execute";
 static constexpr char kPgQueryCmdCode[] = "Query";
@@ -19,10 +19,15 @@
 #include <gmock/gmock-matchers.h>
 #include <gtest/gtest.h>
 #include <ostream>
+#include <string>
+#include <vector>
+
+#include <absl/strings/substitute.h>
 
 #include "sql_parsing/normalization.h"
 #include "src/carnot/funcs/builtins/sql_ops.h"
 #include "src/carnot/udf/test_utils.h"
+#include "src/common/base/test_utils.h"
 
 namespace px {
 namespace carnot {
@@ -201,6 +206,81 @@ TEST(NormMySQL, invalid_utf8) {
   udf_tester.ForInput(invalid, kMySQLQueryCmdCode).Expect(expected_result.ToJSON());
 }
 
+TEST(NormPGSQL, prepared_statement_reuses_parse) {
+  auto udf_tester = udf::UDFTester<NormalizePostgresSQLUDF>();
+  udf_tester
+      .ForInput("query=[SELECT * FROM cache_test WHERE prop=$1 AND prop2='abcd'] params=['1']",
+                kPgExecCmdCode)
+      .Expect(NormalizeResult{"SELECT * FROM cache_test WHERE prop=$1 AND prop2=$2",
+                              {"'1'", "'abcd'"}}
+                  .ToJSON());
+
+  auto& stats = internal::SQLFragmentCache::PgSQL().stats();
+  auto hits = stats.hits.load();
+  udf_tester
+      .ForInput("query=[SELECT * FROM cache_test WHERE prop=$1 AND prop2='abcd'] params=['2']",
+                kPgExecCmdCode)
+      .Expect(NormalizeResult{"SELECT * FROM cache_test WHERE prop=$1 AND prop2=$2",
+                              {"'2'", "'abcd'"}}
+                  .ToJSON());
+  EXPECT_EQ(hits + 1, stats.hits.load());
+}
+
+class SQLFragmentCacheTest : public ::testing::Test {
+ protected:
+  internal::SQLFragmentCache::ParseFn CountingParseFn() {
+    return [this](const std::string& query) -> StatusOr<std::vector<sql_parsing::SQLFragment>> {
+      ++num_parses_;
+      if (query == "invalid") {
+        return error::InvalidArgument("SQL Parsing Failed");
+      }
+      return sql_parsing::parse_pgsql_fragments(query);
+    };
+  }
+
+  int num_parses_ = 0;
+};
+
+TEST_F(SQLFragmentCacheTest, caches_fragments_and_errors) {
+  internal::SQLFragmentCache cache("test", CountingParseFn(), 16, 1024);
+
+  auto parsed = cache.Get("SELECT 1");
+  ASSERT_OK(parsed->status);
+  ASSERT_EQ(1, parsed->sorted_fragments.size());
+  EXPECT_EQ("1", parsed->sorted_fragments[0].text);
+  EXPECT_EQ(parsed, cache.Get("SELECT 1"));
+
+  EXPECT_NOT_OK(cache.Get("invalid")->status);
+  EXPECT_NOT_OK(cache.Get("invalid")->status);
+
+  EXPECT_EQ(2, num_parses_);
+  EXPECT_EQ(2U, cache.stats().hits.load());
+  EXPECT_EQ(2U, cache.stats().misses.load());
+}
+
+TEST_F(SQLFragmentCacheTest, long_queries_not_cached) {
+  internal::SQLFragmentCache cache("test", CountingParseFn(), 16, 8);
+
+  cache.Get("SELECT 1234");
+  cache.Get("SELECT 1234");
+  EXPECT_EQ(2, num_parses_);
+}
+
+TEST_F(SQLFragmentCacheTest, bounded_size) {
+  // A capacity of 1 leaves a single entry per shard.
+  internal::SQLFragmentCache cache("test", CountingParseFn(), 1, 1024);
+
+  for (int i = 0; i < 100; ++i) {
+    cache.Get(absl::Substitute("SELECT $0", i));
+  }
+  EXPECT_EQ(100, num_parses_);
+  for (int i = 0; i < 100; ++i) {
+    cache.Get(absl::Substitute("SELECT $0", i));
+  }
+  // At most one query per shard can still be cached.
+  EXPECT_GE(num_parses_, 200 - 16);
+}
+
 }  // namespace builtins
 }  // namespace carnot
 }  // namespace px
@@ -136,6 +136,28 @@ StatusOr<NormalizeResult> normalize_mysql(std::string sql,
       sql, param_values);
 }
 
+StatusOr<std::vector<SQLFragment>> parse_pgsql_fragments(const std::string& sql) {
+  return parse_sql_fragments<pgsql_parser::PostgresSQLParser, pgsql_parser::PostgresSQLLexer>(sql);
+}
+
+StatusOr<std::vector<SQLFragment>> parse_mysql_fragments(const std::string& sql) {
+  return parse_sql_fragments<mysql_parser::MySQLParser, mysql_parser::MySQLLexer,
+                             UpperCaseCharStream>(sql);
+}
+
+StatusOr<NormalizeResult> normalize_pgsql_fragments(
+    const std::string& sql, const std::vector<SQLFragment>& sorted_fragments,
+    const std::vector<std::string>& param_values) {
+  return normalize_sql_fragments<pgsql_parser::PostgresSQLParser>(sql, sorted_fragments,
+                                                                   param_values);
+}
+
+StatusOr<NormalizeResult> normalize_mysql_fragments(
+    const std::string& sql, const std::vector<SQLFragment>& sorted_fragments,
+    const std::vector<std::string>& param_values) {
+  return normalize_sql_fragments<mysql_parser::MySQLParser>(sql, sorted_fragments, param_values);
+}
+
 std::ostream& operator<<(std::ostream& os, const NormalizeResult& result) {
   if (result.errmsg != "") {
     return os << "error: " << result.errmsg;
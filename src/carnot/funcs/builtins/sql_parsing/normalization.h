@@ -219,22 +219,46 @@ class ConstantFragmentHandler : public SQLFragmentHandler {
 };
 
 /**
- * normalize_sql replaces table names and constants in a sql query with placeholders, inplace.
+ * parse_sql_fragments parses a sql query and returns its constant and parameter placeholder
+ * fragments, in the order they appear in the query. The fragments only depend on the query text,
+ * so they can be reused across EXECUTEs of the same prepared statement.
  * @param sql: Unnormalized SQL query.
- * @param param_values: Parameters already account for in the unnormalized version of the query. For
- * non-EXECUTE type queries this should be empty.
- * @return status or result, whether the query was successful or not and if it was the normalization
- * result.
+ * @return status or fragments, whether the query was parsed successfully and if it was the
+ * fragments to replace.
  */
 template <typename TParser, typename TLexer, typename TCharStream = antlr4::ANTLRInputStream>
-StatusOr<NormalizeResult> normalize_sql(std::string sql,
-                                        const std::vector<std::string>& param_values) {
+StatusOr<std::vector<SQLFragment>> parse_sql_fragments(const std::string& sql) {
   AntlrParser<TParser, TLexer, TCharStream> parser(sql);
   ParserRuleFragmentListener listener({ParserTypeTraits<TParser>::constant_rule_index,
                                        ParserTypeTraits<TParser>::param_placeholder_rule_index},
                                       {SQLFragment::CONSTANT, SQLFragment::PARAM_PLACEHOLDER});
   PL_RETURN_IF_ERROR(parser.ParseWalk(&listener));
 
+  // Sort fragments into the order they appear in the query.
+  std::vector<SQLFragment> sorted_fragments(listener.fragments());
+  std::sort(sorted_fragments.begin(), sorted_fragments.end(),
+            [](const SQLFragment& a, const SQLFragment& b) {
+              if (a.line != b.line) {
+                return a.line < b.line;
+              }
+              return a.start_char_index < b.start_char_index;
+            });
+  return sorted_fragments;
+}
+
+/**
+ * normalize_sql_fragments replaces the fragments of a sql query with placeholders.
+ * @param sql: Unnormalized SQL query.
+ * @param sorted_fragments: The fragments of the query, as returned by parse_sql_fragments.
+ * @param param_values: Parameters already account for in the unnormalized version of the query. For
+ * non-EXECUTE type queries this should be empty.
+ * @return status or result, whether the query was successful or not and if it was the normalization
+ * result.
+ */
+template <typename TParser>
+StatusOr<NormalizeResult> normalize_sql_fragments(const std::string& sql,
+                                                  const std::vector<SQLFragment>& sorted_fragments,
+                                                  const std::vector<std::string>& param_values) {
   NormalizationState state;
   NormalizeResult result;
   result.normalized_query = sql;
@@ -244,15 +268,6 @@ StatusOr<NormalizeResult> normalize_sql(std::string sql,
   ConstantFragmentHandler<TParser> constant_handler(&state, &result);
   ParamFragmentHandler<TParser> param_handler(param_values, &state, &result);
 
-  // Sort fragments into the order they appear in the query.
-  std::vector<SQLFragment> sorted_fragments(listener.fragments());
-  std::sort(sorted_fragments.begin(), sorted_fragments.end(), [](SQLFragment a, SQLFragment b) {
-    if (a.line != b.line) {
-      return a.line < b.line;
-    }
-    return a.start_char_index < b.start_char_index;
-  });
-
   for (const auto& fragment : sorted_fragments) {
     switch (fragment.type) {
       case SQLFragment::CONSTANT:
@@ -266,12 +281,40 @@ StatusOr<NormalizeResult> normalize_sql(std::string sql,
   return result;
 }
 
+/**
+ * normalize_sql replaces table names and constants in a sql query with placeholders, inplace.
+ * @param sql: Unnormalized SQL query.
+ * @param param_values: Parameters already account for in the unnormalized version of the query. For
+ * non-EXECUTE type queries this should be empty.
+ * @return status or result, whether the query was successful or not and if it was the normalization
+ * result.
+ */
+template <typename TParser, typename TLexer, typename TCharStream = antlr4::ANTLRInputStream>
+StatusOr<NormalizeResult> normalize_sql(std::string sql,
+                                        const std::vector<std::string>& param_values) {
+  PL_ASSIGN_OR_RETURN(auto sorted_fragments,
+                      (parse_sql_fragments<TParser, TLexer, TCharStream>(sql)));
+  return normalize_sql_fragments<TParser>(sql, sorted_fragments, param_values);
+}
+
 StatusOr<NormalizeResult> normalize_pgsql(std::string sql,
                                           const std::vector<std::string>& param_values);
 
 StatusOr<NormalizeResult> normalize_mysql(std::string sql,
                                           const std::vector<std::string>& param_values);
 
+StatusOr<std::vector<SQLFragment>> parse_pgsql_fragments(const std::string& sql);
+
+StatusOr<std::vector<SQLFragment>> parse_mysql_fragments(const std::string& sql);
+
+StatusOr<NormalizeResult> normalize_pgsql_fragments(
+    const std::string& sql, const std::vector<SQLFragment>& sorted_fragments,
+    const std::vector<std::string>& param_values);
+
+StatusOr<NormalizeResult> normalize_mysql_fragments(
+    const std::string& sql, const std::vector<SQLFragment>& sorted_fragments,
+    const std::vector<std::string>& param_values);
+
 }  // namespace sql_parsing
 }  // namespace builtins
 }  // namespace carnot
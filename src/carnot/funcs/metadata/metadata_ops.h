@@ -119,6 +119,8 @@ class PodIDToPodNameUDF : public ScalarUDF {
         .Arg("pod_id", "The pod ID of the pod to get the name for.")
         .Returns("The k8s pod name for the pod ID passed in.");
   }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 class PodNameToPodIDUDF : public ScalarUDF {
@@ -142,6 +144,8 @@ class PodNameToPodIDUDF : public ScalarUDF {
         .Arg("pod_name", "The name of the pod to get the ID for.")
         .Returns("The k8s pod ID for the pod name passed in.");
   }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 class PodNameToPodIPUDF : public ScalarUDF {
@@ -163,6 +167,8 @@ class PodNameToPodIPUDF : public ScalarUDF {
         .Arg("pod_name", "The name of the pod to get the IP for.")
         .Returns("The pod IP for the pod name passed in.");
   }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 class PodIDToNamespaceUDF : public ScalarUDF {
@@ -188,6 +194,8 @@ class PodIDToNamespaceUDF : public ScalarUDF {
         .Arg("pod_id", "The Pod ID of the Pod to get the namespace for.")
         .Returns("The k8s namespace for the Pod ID passed in.");
   }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 class PodNameToNamespaceUDF : public ScalarUDF {
@@ -239,6 +247,8 @@ class UPIDToContainerIDUDF : public ScalarUDF {
 
   // This UDF can currently only run on PEMs, because only PEMs have the UPID information.
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_PEM; }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 inline const md::ContainerInfo* UPIDToContainer(const px::md::AgentMetadataState* md,
@@ -282,6 +292,8 @@ class UPIDToContainerNameUDF : public ScalarUDF {
 
   // This UDF can currently only run on PEMs, because only PEMs have the UPID information.
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_PEM; }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 inline const px::md::PodInfo* UPIDtoPod(const px::md::AgentMetadataState* md,
@@ -347,6 +359,8 @@ class UPIDToNamespaceUDF : public ScalarUDF {
 
   // This UDF can currently only run on PEMs, because only PEMs have the UPID information.
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_PEM; }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 class UPIDToPodIDUDF : public ScalarUDF {
@@ -374,6 +388,8 @@ class UPIDToPodIDUDF : public ScalarUDF {
 
   // This UDF can currently only run on PEMs, because only PEMs have the UPID information.
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_PEM; }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 class UPIDToPodNameUDF : public ScalarUDF {
@@ -405,6 +421,8 @@ class UPIDToPodNameUDF : public ScalarUDF {
 
   // This UDF can currently only run on PEMs, because only PEMs have the UPID information.
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_PEM; }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 class ServiceIDToServiceNameUDF : public ScalarUDF {
@@ -433,6 +451,8 @@ class ServiceIDToServiceNameUDF : public ScalarUDF {
         .Arg("service_id", "The service ID to get the service name for.")
         .Returns("The service name or an empty string if service_id not found.");
   }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 class ServiceIDToClusterIPUDF : public ScalarUDF {
@@ -458,6 +478,8 @@ class ServiceIDToClusterIPUDF : public ScalarUDF {
         .Arg("service_id", "The service ID to get the service name for.")
         .Returns("The cluster IP or an empty string.");
   }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 class ServiceIDToExternalIPsUDF : public ScalarUDF {
@@ -481,6 +503,8 @@ class ServiceIDToExternalIPsUDF : public ScalarUDF {
         .Arg("service_id", "The service ID to get the service name for.")
         .Returns("The external IPs or an empty string.");
   }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 class ServiceNameToServiceIDUDF : public ScalarUDF {
@@ -501,6 +525,8 @@ class ServiceNameToServiceIDUDF : public ScalarUDF {
         .Arg("service_name", "The service to get the service ID.")
         .Returns("The kubernetes service ID for the service passed in.");
   }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 /**
@@ -572,6 +598,8 @@ class UPIDToServiceIDUDF : public ScalarUDF {
 
   // This UDF can currently only run on PEMs, because only PEMs have the UPID information.
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_PEM; }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 /**
@@ -618,6 +646,8 @@ class UPIDToServiceNameUDF : public ScalarUDF {
 
   // This UDF can currently only run on PEMs, because only PEMs have the UPID information.
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_PEM; }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 /**
@@ -650,6 +680,8 @@ class UPIDToNodeNameUDF : public ScalarUDF {
 
   // This UDF can currently only run on PEMs, because only PEMs have the UPID information.
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_PEM; }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 /**
@@ -678,6 +710,8 @@ class UPIDToHostnameUDF : public ScalarUDF {
 
   // This UDF can currently only run on PEMs, because only PEMs have the UPID information.
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_PEM; }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 /**
@@ -720,6 +754,8 @@ class PodIDToServiceNameUDF : public ScalarUDF {
         .Arg("pod_id", "The Pod ID of the Pod to get service name for.")
         .Returns("The k8s service name for the Pod ID passed in.");
   }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 /**
@@ -756,6 +792,8 @@ class PodIDToServiceIDUDF : public ScalarUDF {
         .Arg("pod_id", "The Pod ID of the Pod to get service ID for.")
         .Returns("The k8s service ID for the Pod ID passed in.");
   }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 /**
@@ -785,6 +823,8 @@ class PodIDToNodeNameUDF : public ScalarUDF {
         .Arg("pod_id", "The Pod ID of the Pod to get the node name for.")
         .Returns("The k8s node name for the Pod ID passed in.");
   }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 /**
@@ -831,6 +871,8 @@ class PodNameToServiceNameUDF : public ScalarUDF {
         .Arg("pod_name", "The name of the Pod to get service name for.")
         .Returns("The k8s service name for the Pod name passed in.");
   }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 /**
@@ -871,6 +913,8 @@ class PodNameToServiceIDUDF : public ScalarUDF {
         .Arg("pod_id", "The name of the Pod to get service ID for.")
         .Returns("The k8s service ID for the Pod name passed in.");
   }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 class UPIDToStringUDF : public ScalarUDF {
@@ -932,6 +976,8 @@ class PodIDToPodStartTimeUDF : public ScalarUDF {
         .Arg("pod_id", "The Pod ID of the Pod to get the start time for.")
         .Returns("The start time (as an integer) for the Pod ID passed in.");
   }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 class PodIDToPodStopTimeUDF : public ScalarUDF {
@@ -951,6 +997,8 @@ class PodIDToPodStopTimeUDF : public ScalarUDF {
         .Arg("pod_id", "The Pod ID of the Pod to get the stop time for.")
         .Returns("The stop time (as an integer) for the Pod ID passed in.");
   }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 class PodNameToPodStartTimeUDF : public ScalarUDF {
@@ -971,6 +1019,8 @@ class PodNameToPodStartTimeUDF : public ScalarUDF {
         .Arg("pod_name", "The name of the Pod to get the start time for.")
         .Returns("The start time (as an integer) for the Pod name passed in.");
   }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 class PodNameToPodStopTimeUDF : public ScalarUDF {
@@ -991,6 +1041,8 @@ class PodNameToPodStopTimeUDF : public ScalarUDF {
         .Arg("pod_name", "The name of the Pod to get the stop time for.")
         .Returns("The stop time (as an integer) for the Pod name passed in.");
   }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 class ContainerNameToContainerIDUDF : public ScalarUDF {
@@ -1007,6 +1059,8 @@ class ContainerNameToContainerIDUDF : public ScalarUDF {
         .Arg("container_name", "The name of the container to get the ID for.")
         .Returns("The k8s container ID for the container name passed in.");
   }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 class ContainerIDToContainerStartTimeUDF : public ScalarUDF {
@@ -1029,6 +1083,8 @@ class ContainerIDToContainerStartTimeUDF : public ScalarUDF {
         .Arg("container_id", "The Container ID of the Container to get the start time for.")
         .Returns("The start time (as an integer) for the Container ID passed in.");
   }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 class ContainerIDToContainerStopTimeUDF : public ScalarUDF {
@@ -1051,6 +1107,8 @@ class ContainerIDToContainerStopTimeUDF : public ScalarUDF {
         .Arg("container_id", "The Container ID of the Container to get the stop time for.")
         .Returns("The stop time (as an integer) for the Container ID passed in.");
   }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 class ContainerNameToContainerStartTimeUDF : public ScalarUDF {
@@ -1073,6 +1131,8 @@ class ContainerNameToContainerStartTimeUDF : public ScalarUDF {
         .Arg("container_name", "The name of the Container to get the start time for.")
         .Returns("The start time (as an integer) for the Container name passed in.");
   }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 class ContainerNameToContainerStopTimeUDF : public ScalarUDF {
@@ -1095,6 +1155,8 @@ class ContainerNameToContainerStopTimeUDF : public ScalarUDF {
         .Arg("container_name", "The name of the Container to get the stop time for.")
         .Returns("The stop time (as an integer) for the Container name passed in.");
   }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 inline std::string PodPhaseToString(const px::md::PodPhase& pod_phase) {
@@ -1178,6 +1240,8 @@ class PodNameToPodStatusUDF : public ScalarUDF {
         .Arg("pod_name", "The name of the pod to get the PodStatus for.")
         .Returns("The Kubernetes PodStatus for the Pod passed in.");
   }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 class PodNameToPodReadyUDF : public ScalarUDF {
@@ -1211,6 +1275,8 @@ class PodNameToPodReadyUDF : public ScalarUDF {
         .Returns(
             "A value denoting whether the service state of the pod passed in is ready or not.");
   }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 class PodNameToPodStatusMessageUDF : public ScalarUDF {
@@ -1231,6 +1297,8 @@ class PodNameToPodStatusMessageUDF : public ScalarUDF {
     }
     return pod_info->phase_message();
   }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 class PodNameToPodStatusReasonUDF : public ScalarUDF {
@@ -1251,6 +1319,8 @@ class PodNameToPodStatusReasonUDF : public ScalarUDF {
     }
     return pod_info->phase_reason();
   }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 inline std::string ContainerStateToString(const px::md::ContainerState& container_state) {
@@ -1315,6 +1385,8 @@ class ContainerIDToContainerStatusUDF : public ScalarUDF {
         .Example("df.status = px.container_id_to_status(df.id)")
         .Returns("The status of the container.");
   }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 class UPIDToPodStatusUDF : public ScalarUDF {
@@ -1354,6 +1426,8 @@ class UPIDToPodStatusUDF : public ScalarUDF {
 
   // This UDF can currently only run on PEMs, because only PEMs have the UPID information.
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_PEM; }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 class UPIDToCmdLineUDF : public ScalarUDF {
@@ -1388,6 +1462,8 @@ class UPIDToCmdLineUDF : public ScalarUDF {
 
   // This UDF can currently only run on PEMs, because only PEMs have the UPID information.
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_PEM; }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 inline std::string PodInfoToPodQoS(const px::md::PodInfo* pod_info) {
@@ -1425,6 +1501,8 @@ class UPIDToPodQoSUDF : public ScalarUDF {
 
   // This UDF can currently only run on PEMs, because only PEMs have the UPID information.
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_PEM; }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 class HostnameUDF : public ScalarUDF {
@@ -1495,6 +1573,8 @@ class IPToPodIDUDF : public ScalarUDF {
   // This UDF can currently only run on Kelvins, because only Kelvins have the IP to pod
   // information.
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_KELVIN; }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 class IPToServiceIDUDF : public ScalarUDF {
@@ -1529,6 +1609,8 @@ class IPToServiceIDUDF : public ScalarUDF {
   // This UDF can currently only run on Kelvins, because only Kelvins have the IP to pod
   // information.
   static udfspb::UDFSourceExecutor Executor() { return udfspb::UDFSourceExecutor::UDF_KELVIN; }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
 };
 
 inline bool EqualsOrArrayContains(const std::string& input, const std::string& value) {
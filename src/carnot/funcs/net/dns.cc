@@ -0,0 +1,207 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/funcs/net/dns.h"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+
+#include <algorithm>
+#include <optional>
+#include <utility>
+
+#include "src/common/metrics/metrics.h"
+
+DEFINE_int32(carnot_dns_cache_size, gflags::Int32FromEnv("PL_CARNOT_DNS_CACHE_SIZE", 65536),
+             "Maximum number of addresses kept in the reverse DNS cache used by px.nslookup.");
+DEFINE_int32(carnot_dns_cache_ttl_secs, gflags::Int32FromEnv("PL_CARNOT_DNS_CACHE_TTL_SECS", 300),
+             "How long a resolved hostname is cached for.");
+DEFINE_int32(carnot_dns_negative_cache_ttl_secs,
+             gflags::Int32FromEnv("PL_CARNOT_DNS_NEGATIVE_CACHE_TTL_SECS", 30),
+             "How long an address without a hostname (or a failed lookup) is cached for.");
+DEFINE_int32(carnot_dns_lookup_threads, gflags::Int32FromEnv("PL_CARNOT_DNS_LOOKUP_THREADS", 16),
+             "Maximum number of reverse DNS lookups that run concurrently.");
+DEFINE_int32(carnot_dns_lookup_timeout_ms,
+             gflags::Int32FromEnv("PL_CARNOT_DNS_LOOKUP_TIMEOUT_MS", 2000),
+             "How long a batch waits for its reverse DNS lookups before using the addresses.");
+
+namespace px {
+namespace carnot {
+namespace funcs {
+namespace net {
+namespace internal {
+
+ReverseDNSResult DNSLookup(const std::string& addr) {
+  struct sockaddr_in sa;
+
+  char node[kMaxHostnameSize];
+
+  memset(&sa, 0, sizeof sa);
+  sa.sin_family = AF_INET;
+
+  inet_pton(AF_INET, addr.c_str(), &sa.sin_addr);
+
+  int res =
+      getnameinfo((struct sockaddr*)&sa, sizeof(sa), node, sizeof(node), NULL, 0, NI_NAMEREQD);
+
+  if (res) {
+    return {res == EAI_NONAME ? addr : gai_strerror(res), false};
+  }
+  return {node, true};
+}
+
+namespace {
+
+prometheus::Family<prometheus::Counter>& LookupsFamily() {
+  static auto& family = prometheus::BuildCounter()
+                            .Name("carnot_dns_cache_lookups")
+                            .Help("Reverse DNS cache lookups made by px.nslookup, by result.")
+                            .Register(GetMetricsRegistry());
+  return family;
+}
+
+}  // namespace
+
+DNSCache& DNSCache::GetInstance() {
+  // Intentionally leaked, so that exiting never waits on a lookup that is still running.
+  static DNSCache* cache = [] {
+    Options opts;
+    opts.capacity = static_cast<size_t>(std::max(FLAGS_carnot_dns_cache_size, 1));
+    opts.ttl = std::chrono::seconds{FLAGS_carnot_dns_cache_ttl_secs};
+    opts.negative_ttl = std::chrono::seconds{FLAGS_carnot_dns_negative_cache_ttl_secs};
+    opts.num_threads = static_cast<size_t>(std::max(FLAGS_carnot_dns_lookup_threads, 1));
+    opts.lookup_timeout = std::chrono::milliseconds{FLAGS_carnot_dns_lookup_timeout_ms};
+    return new DNSCache(DNSLookup, opts);
+  }();
+  return *cache;
+}
+
+DNSCache::DNSCache(DNSLookupFn lookup_fn, const Options& opts)
+    : lookup_fn_(std::move(lookup_fn)),
+      opts_(opts),
+      cache_(opts.capacity, &LookupsFamily()),
+      negative_hits_counter_(LookupsFamily().Add({{"result", "negative_hit"}})),
+      timeouts_counter_(LookupsFamily().Add({{"result", "timeout"}})) {
+  const size_t num_threads = std::max<size_t>(opts_.num_threads, 1);
+  for (size_t i = 0; i < num_threads; ++i) {
+    workers_.emplace_back(&DNSCache::RunWorker, this);
+  }
+}
+
+DNSCache::~DNSCache() {
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    stopped_ = true;
+  }
+  queue_cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+  // Lookups that never started are failed, rather than dropped, so that their waiters get the
+  // address back instead of a broken promise.
+  for (auto& [addr, promise] : queue_) {
+    promise.set_value({addr, false});
+  }
+  queue_.clear();
+}
+
+bool DNSCache::GetOrStartLookup(const std::string& addr, std::string* hostname,
+                                std::shared_future<ReverseDNSResult>* pending) {
+  const auto now = Clock::now();
+  std::optional<Entry> entry =
+      cache_.GetIf(addr, [now](const Entry& entry) { return now < entry.expiry; });
+  if (entry.has_value()) {
+    if (!entry->resolved) {
+      ++stats_.negative_hits;
+      negative_hits_counter_.Increment();
+    }
+    *hostname = std::move(entry->hostname);
+    return true;
+  }
+
+  // A lookup that completes between the cache miss and here is started again, which is harmless.
+  std::lock_guard<std::mutex> lock(in_flight_mutex_);
+  auto [it, inserted] = in_flight_.try_emplace(addr);
+  if (inserted) {
+    std::promise<ReverseDNSResult> promise;
+    it->second = promise.get_future().share();
+    {
+      std::lock_guard<std::mutex> queue_lock(queue_mutex_);
+      queue_.emplace_back(addr, std::move(promise));
+    }
+    queue_cv_.notify_one();
+  }
+  *pending = it->second;
+  return false;
+}
+
+std::vector<std::string> DNSCache::Lookup(const std::vector<std::string>& addrs) {
+  std::vector<std::string> hostnames(addrs.size());
+  std::vector<std::pair<size_t, std::shared_future<ReverseDNSResult>>> pending;
+  for (size_t i = 0; i < addrs.size(); ++i) {
+    std::shared_future<ReverseDNSResult> lookup;
+    if (!GetOrStartLookup(addrs[i], &hostnames[i], &lookup)) {
+      pending.emplace_back(i, std::move(lookup));
+    }
+  }
+
+  // All the lookups run concurrently, so they share a single deadline.
+  const auto deadline = Clock::now() + opts_.lookup_timeout;
+  for (auto& [i, lookup] : pending) {
+    if (lookup.wait_until(deadline) == std::future_status::ready) {
+      hostnames[i] = lookup.get().hostname;
+    } else {
+      ++stats_.timeouts;
+      timeouts_counter_.Increment();
+      hostnames[i] = addrs[i];
+    }
+  }
+  return hostnames;
+}
+
+void DNSCache::Insert(const std::string& addr, const ReverseDNSResult& result) {
+  const auto ttl = result.resolved ? opts_.ttl : opts_.negative_ttl;
+  cache_.Put(addr, Entry{result.hostname, result.resolved, Clock::now() + ttl});
+
+  std::lock_guard<std::mutex> lock(in_flight_mutex_);
+  in_flight_.erase(addr);
+}
+
+void DNSCache::RunWorker() {
+  while (true) {
+    std::pair<std::string, std::promise<ReverseDNSResult>> task;
+    {
+      std::unique_lock<std::mutex> lock(queue_mutex_);
+      queue_cv_.wait(lock, [this] { return stopped_ || !queue_.empty(); });
+      if (stopped_) {
+        return;
+      }
+      task = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    ReverseDNSResult result = lookup_fn_(task.first);
+    Insert(task.first, result);
+    task.second.set_value(std::move(result));
+  }
+}
+
+}  // namespace internal
+}  // namespace net
+}  // namespace funcs
+}  // namespace carnot
+}  // namespace px
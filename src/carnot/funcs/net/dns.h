@@ -18,10 +18,30 @@
 
 #pragma once
 
+#include <prometheus/counter.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
-#define TBB_PREVIEW_CONCURRENT_LRU_CACHE 1
-#include "tbb/concurrent_lru_cache.h"
+#include <absl/container/flat_hash_map.h>
+
+#include "src/carnot/funcs/shared/sharded_lru_cache.h"
+#include "src/common/base/base.h"
+
+DECLARE_int32(carnot_dns_cache_size);
+DECLARE_int32(carnot_dns_cache_ttl_secs);
+DECLARE_int32(carnot_dns_negative_cache_ttl_secs);
+DECLARE_int32(carnot_dns_lookup_threads);
+DECLARE_int32(carnot_dns_lookup_timeout_ms);
 
 namespace px {
 namespace carnot {
@@ -30,41 +50,103 @@ namespace net {
 namespace internal {
 
 constexpr size_t kMaxHostnameSize = 512;
-constexpr size_t kLRUCacheSize = 1024;
-
-inline std::string DNSLookup(const std::string& addr) {
-  struct sockaddr_in sa;
 
-  char node[kMaxHostnameSize];
-
-  memset(&sa, 0, sizeof sa);
-  sa.sin_family = AF_INET;
-
-  inet_pton(AF_INET, addr.c_str(), &sa.sin_addr);
+struct ReverseDNSResult {
+  // The hostname, or the address itself if it could not be resolved.
+  std::string hostname;
+  // False if the address has no name, or if the lookup failed.
+  bool resolved = false;
+};
 
-  int res =
-      getnameinfo((struct sockaddr*)&sa, sizeof(sa), node, sizeof(node), NULL, 0, NI_NAMEREQD);
+/**
+ * Performs a blocking reverse DNS lookup of an IPv4 address with getnameinfo.
+ */
+ReverseDNSResult DNSLookup(const std::string& addr);
 
-  if (res) {
-    return res == EAI_NONAME ? addr : gai_strerror(res);
-  }
-  return node;
-}
+using DNSLookupFn = std::function<ReverseDNSResult(const std::string& addr)>;
 
-class DNSCache {
+/**
+ * DNSCache resolves addresses to hostnames, and caches the results.
+ *
+ * Lookups are run on a fixed pool of threads, so that the distinct addresses of a batch are
+ * resolved concurrently, and an address that is already being looked up is never looked up
+ * twice. Callers only wait up to the lookup timeout; a lookup that takes longer keeps running in
+ * the background and is cached for later batches.
+ *
+ * Results are kept in a ShardedLRUCache. Resolved names are kept for the TTL, and addresses without
+ * a name (or failed lookups) for the shorter negative TTL.
+ */
+class DNSCache : public NotCopyMoveable {
  public:
-  static DNSCache& GetInstance() {
-    static DNSCache cache;
-    return cache;
-  }
-
-  std::string Lookup(std::string addr) { return cache_[addr].value(); }
+  struct Options {
+    size_t capacity = 65536;
+    std::chrono::seconds ttl = std::chrono::seconds{300};
+    std::chrono::seconds negative_ttl = std::chrono::seconds{30};
+    size_t num_threads = 16;
+    std::chrono::milliseconds lookup_timeout = std::chrono::milliseconds{2000};
+  };
+
+  // Lookups that are not covered by the cache stats.
+  struct Stats {
+    // Hits on addresses without a name, which are also counted as cache hits.
+    std::atomic<uint64_t> negative_hits{0};
+    std::atomic<uint64_t> timeouts{0};
+  };
+
+  /**
+   * The cache shared by all queries, configured by the carnot_dns_* flags.
+   */
+  static DNSCache& GetInstance();
+
+  DNSCache(DNSLookupFn lookup_fn, const Options& opts);
+  ~DNSCache();
+
+  /**
+   * Returns the hostnames of the addresses. The addresses that are not cached are resolved
+   * concurrently, and waited on until the lookup timeout. The address itself is returned for
+   * lookups that time out.
+   */
+  std::vector<std::string> Lookup(const std::vector<std::string>& addrs);
+
+  std::string Lookup(const std::string& addr) { return Lookup(std::vector<std::string>{addr})[0]; }
+
+  const Stats& stats() const { return stats_; }
+  const CacheStats& cache_stats() const { return cache_.stats(); }
 
  private:
-  DNSCache()
-      : cache_([](std::string addr) -> std::string { return DNSLookup(addr); }, kLRUCacheSize) {}
-
-  tbb::concurrent_lru_cache<std::string, std::string> cache_;
+  using Clock = std::chrono::steady_clock;
+
+  struct Entry {
+    std::string hostname;
+    bool resolved;
+    Clock::time_point expiry;
+  };
+
+  // Returns the cached hostname if there is a fresh entry for the address. Otherwise returns
+  // false and sets *pending to the lookup of the address, starting one if needed.
+  bool GetOrStartLookup(const std::string& addr, std::string* hostname,
+                        std::shared_future<ReverseDNSResult>* pending);
+
+  void Insert(const std::string& addr, const ReverseDNSResult& result);
+  void RunWorker();
+
+  const DNSLookupFn lookup_fn_;
+  const Options opts_;
+  ShardedLRUCache<Entry> cache_;
+
+  // Lookups that are queued or running, so concurrent misses share a single lookup.
+  std::mutex in_flight_mutex_;
+  absl::flat_hash_map<std::string, std::shared_future<ReverseDNSResult>> in_flight_;
+
+  std::mutex queue_mutex_;
+  std::condition_variable queue_cv_;
+  std::deque<std::pair<std::string, std::promise<ReverseDNSResult>>> queue_;
+  bool stopped_ = false;
+  std::vector<std::thread> workers_;
+
+  Stats stats_;
+  prometheus::Counter& negative_hits_counter_;
+  prometheus::Counter& timeouts_counter_;
 };
 
 }  // namespace internal
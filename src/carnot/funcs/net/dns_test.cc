@@ -0,0 +1,221 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/funcs/net/dns.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace carnot {
+namespace funcs {
+namespace net {
+namespace internal {
+
+using ::testing::ElementsAre;
+
+// A stand-in for the system resolver, which names every address "host-<addr>" except 0.0.0.0.
+// Lookups can be held back with Block(), to control which of them are running at once.
+class FakeResolver {
+ public:
+  ReverseDNSResult Resolve(const std::string& addr) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      ++num_lookups_;
+      ++active_;
+      max_active_ = std::max(max_active_, active_);
+      cv_.notify_all();
+      cv_.wait(lock, [this] { return !blocked_; });
+      --active_;
+    }
+    if (addr == "0.0.0.0") {
+      return {addr, false};
+    }
+    return {"host-" + addr, true};
+  }
+
+  DNSLookupFn Fn() {
+    return [this](const std::string& addr) { return Resolve(addr); };
+  }
+
+  void Block() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    blocked_ = true;
+  }
+
+  void Release() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    blocked_ = false;
+    cv_.notify_all();
+  }
+
+  // Waits until the given number of lookups are running at once. Returns false on timeout.
+  bool WaitForActive(int n) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cv_.wait_for(lock, kWaitTimeout, [this, n] { return active_ >= n; });
+  }
+
+  int num_lookups() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return num_lookups_;
+  }
+
+  int max_active() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return max_active_;
+  }
+
+  static constexpr std::chrono::seconds kWaitTimeout{10};
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool blocked_ = false;
+  int active_ = 0;
+  int max_active_ = 0;
+  int num_lookups_ = 0;
+};
+
+DNSCache::Options TestOptions() {
+  DNSCache::Options opts;
+  opts.capacity = 1024;
+  opts.num_threads = 4;
+  opts.lookup_timeout = std::chrono::seconds{10};
+  return opts;
+}
+
+TEST(DNSCacheTest, CachesResults) {
+  FakeResolver resolver;
+  DNSCache cache(resolver.Fn(), TestOptions());
+
+  EXPECT_EQ(cache.Lookup("1.2.3.4"), "host-1.2.3.4");
+  EXPECT_EQ(cache.Lookup("1.2.3.4"), "host-1.2.3.4");
+  EXPECT_EQ(resolver.num_lookups(), 1);
+  EXPECT_EQ(cache.cache_stats().misses.load(), 1U);
+  EXPECT_EQ(cache.cache_stats().hits.load(), 1U);
+}
+
+TEST(DNSCacheTest, ResolvesBatchConcurrently) {
+  FakeResolver resolver;
+  DNSCache cache(resolver.Fn(), TestOptions());
+
+  std::vector<std::string> addrs = {"10.0.0.1", "10.0.0.2", "10.0.0.3", "10.0.0.4",
+                                    "10.0.0.5", "10.0.0.6", "10.0.0.7", "10.0.0.8"};
+  resolver.Block();
+  auto hostnames_future = std::async(std::launch::async, [&] { return cache.Lookup(addrs); });
+  // All the threads of the pool are used by a single batch.
+  ASSERT_TRUE(resolver.WaitForActive(4));
+  resolver.Release();
+
+  std::vector<std::string> hostnames = hostnames_future.get();
+  ASSERT_EQ(hostnames.size(), addrs.size());
+  for (size_t i = 0; i < addrs.size(); ++i) {
+    EXPECT_EQ(hostnames[i], "host-" + addrs[i]);
+  }
+  EXPECT_EQ(resolver.num_lookups(), 8);
+  EXPECT_EQ(resolver.max_active(), 4);
+}
+
+TEST(DNSCacheTest, DuplicateAddressesShareLookup) {
+  FakeResolver resolver;
+  DNSCache cache(resolver.Fn(), TestOptions());
+
+  resolver.Block();
+  auto hostnames_future = std::async(std::launch::async, [&] {
+    return cache.Lookup(std::vector<std::string>{"1.1.1.1", "1.1.1.1", "1.1.1.1"});
+  });
+  ASSERT_TRUE(resolver.WaitForActive(1));
+  resolver.Release();
+
+  EXPECT_THAT(hostnames_future.get(), ElementsAre("host-1.1.1.1", "host-1.1.1.1", "host-1.1.1.1"));
+  EXPECT_EQ(resolver.num_lookups(), 1);
+}
+
+TEST(DNSCacheTest, NegativeCaching) {
+  FakeResolver resolver;
+  DNSCache::Options opts = TestOptions();
+  opts.negative_ttl = std::chrono::seconds{0};
+  DNSCache cache(resolver.Fn(), opts);
+
+  // Addresses without a name are returned as is.
+  EXPECT_EQ(cache.Lookup("0.0.0.0"), "0.0.0.0");
+  EXPECT_EQ(cache.Lookup("0.0.0.0"), "0.0.0.0");
+  // The negative TTL is 0, so every lookup goes to the resolver.
+  EXPECT_EQ(resolver.num_lookups(), 2);
+
+  DNSCache::Options long_opts = TestOptions();
+  long_opts.negative_ttl = std::chrono::seconds{60};
+  DNSCache long_cache(resolver.Fn(), long_opts);
+  EXPECT_EQ(long_cache.Lookup("0.0.0.0"), "0.0.0.0");
+  EXPECT_EQ(long_cache.Lookup("0.0.0.0"), "0.0.0.0");
+  EXPECT_EQ(resolver.num_lookups(), 3);
+  EXPECT_EQ(long_cache.stats().negative_hits.load(), 1U);
+}
+
+TEST(DNSCacheTest, TimeoutReturnsAddressAndCachesLater) {
+  FakeResolver resolver;
+  DNSCache::Options opts = TestOptions();
+  opts.lookup_timeout = std::chrono::milliseconds{10};
+  DNSCache cache(resolver.Fn(), opts);
+
+  resolver.Block();
+  EXPECT_EQ(cache.Lookup("1.2.3.4"), "1.2.3.4");
+  EXPECT_EQ(cache.stats().timeouts.load(), 1U);
+  resolver.Release();
+
+  // The lookup keeps running in the background, and is cached once it completes. Until then,
+  // each Lookup() waits for the running lookup for up to the timeout.
+  const auto deadline = std::chrono::steady_clock::now() + FakeResolver::kWaitTimeout;
+  std::string hostname;
+  do {
+    hostname = cache.Lookup("1.2.3.4");
+  } while (hostname != "host-1.2.3.4" && std::chrono::steady_clock::now() < deadline);
+  EXPECT_EQ(hostname, "host-1.2.3.4");
+  EXPECT_EQ(resolver.num_lookups(), 1);
+}
+
+TEST(DNSCacheTest, EvictsWhenFull) {
+  FakeResolver resolver;
+  DNSCache::Options opts = TestOptions();
+  opts.capacity = 16;
+  DNSCache cache(resolver.Fn(), opts);
+
+  for (int i = 0; i < 100; ++i) {
+    std::string addr = absl::StrCat("10.0.1.", i);
+    EXPECT_EQ(cache.Lookup(addr), "host-" + addr);
+  }
+  // The cache is bounded, so the early addresses are no longer cached.
+  int num_lookups = resolver.num_lookups();
+  for (int i = 0; i < 100; ++i) {
+    cache.Lookup(absl::StrCat("10.0.1.", i));
+  }
+  EXPECT_GT(resolver.num_lookups(), num_lookups);
+}
+
+}  // namespace internal
+}  // namespace net
+}  // namespace funcs
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,165 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <prometheus/counter.h>
+#include <prometheus/family.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/hash/hash.h>
+
+#include "src/common/base/base.h"
+
+namespace px {
+namespace carnot {
+namespace funcs {
+
+struct CacheStats {
+  std::atomic<uint64_t> hits{0};
+  std::atomic<uint64_t> misses{0};
+  std::atomic<uint64_t> evictions{0};
+};
+
+/**
+ * ShardedLRUCache is a bounded map from strings to values, for the UDFs that share work across
+ * queries on an agent.
+ *
+ * Keys are spread over shards that are locked independently, so that concurrent queries rarely
+ * contend. A full shard evicts its least recently used entry. Lookups are counted in stats(), and
+ * if a metric family is given, also exported as counters labeled with result="hit" or "miss".
+ */
+template <typename TValue>
+class ShardedLRUCache : public NotCopyMoveable {
+ public:
+  static constexpr size_t kNumShards = 16;
+
+  /**
+   * @param capacity The maximum number of entries, split evenly among the shards.
+   * @param lookups_family Optional family of counters for the lookups.
+   * @param labels Labels of the lookup counters, on top of the result.
+   */
+  explicit ShardedLRUCache(size_t capacity,
+                           prometheus::Family<prometheus::Counter>* lookups_family = nullptr,
+                           std::map<std::string, std::string> labels = {})
+      : shard_capacity_(std::max<size_t>(capacity / kNumShards, 1)) {
+    if (lookups_family != nullptr) {
+      labels["result"] = "hit";
+      hits_counter_ = &lookups_family->Add(labels);
+      labels["result"] = "miss";
+      misses_counter_ = &lookups_family->Add(labels);
+    }
+  }
+
+  /**
+   * Returns a copy of the value of the key, and marks it as the most recently used.
+   */
+  std::optional<TValue> Get(const std::string& key) {
+    return GetIf(key, [](const TValue&) { return true; });
+  }
+
+  /**
+   * Like Get(), but an entry for which is_fresh() returns false is dropped, and is a miss.
+   */
+  template <typename TPredicate>
+  std::optional<TValue> GetIf(const std::string& key, TPredicate is_fresh) {
+    Shard& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+      auto entry_it = it->second;
+      if (is_fresh(entry_it->second)) {
+        shard.entries.splice(shard.entries.begin(), shard.entries, entry_it);
+        Record(&stats_.hits, hits_counter_);
+        return entry_it->second;
+      }
+      shard.index.erase(it);
+      shard.entries.erase(entry_it);
+    }
+    Record(&stats_.misses, misses_counter_);
+    return std::nullopt;
+  }
+
+  /**
+   * Inserts or replaces the value of the key, evicting the least recently used entry of the shard
+   * if it is full.
+   */
+  void Put(const std::string& key, TValue value) {
+    Shard& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+      it->second->second = std::move(value);
+      shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+      return;
+    }
+    if (shard.entries.size() >= shard_capacity_) {
+      shard.index.erase(shard.entries.back().first);
+      shard.entries.pop_back();
+      ++stats_.evictions;
+    }
+    shard.entries.emplace_front(key, std::move(value));
+    shard.index.emplace(shard.entries.front().first, shard.entries.begin());
+  }
+
+  const CacheStats& stats() const { return stats_; }
+
+ private:
+  using EntryList = std::list<std::pair<std::string, TValue>>;
+
+  struct Shard {
+    std::mutex mutex;
+    // Ordered from the most to the least recently used.
+    EntryList entries;
+    // Keys are views of the keys in entries.
+    absl::flat_hash_map<std::string_view, typename EntryList::iterator> index;
+  };
+
+  Shard& ShardFor(std::string_view key) {
+    return shards_[absl::Hash<std::string_view>{}(key) % kNumShards];
+  }
+
+  static void Record(std::atomic<uint64_t>* stat, prometheus::Counter* counter) {
+    ++*stat;
+    if (counter != nullptr) {
+      counter->Increment();
+    }
+  }
+
+  const size_t shard_capacity_;
+  std::array<Shard, kNumShards> shards_;
+
+  CacheStats stats_;
+  prometheus::Counter* hits_counter_ = nullptr;
+  prometheus::Counter* misses_counter_ = nullptr;
+};
+
+}  // namespace funcs
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/funcs/shared/sharded_lru_cache.h"
+
+#include <string>
+
+#include <absl/strings/str_cat.h>
+
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace carnot {
+namespace funcs {
+
+using ::testing::Optional;
+
+TEST(ShardedLRUCacheTest, GetAndPut) {
+  ShardedLRUCache<int> cache(1024);
+
+  EXPECT_EQ(cache.Get("a"), std::nullopt);
+  cache.Put("a", 1);
+  EXPECT_THAT(cache.Get("a"), Optional(1));
+  cache.Put("a", 2);
+  EXPECT_THAT(cache.Get("a"), Optional(2));
+
+  EXPECT_EQ(cache.stats().hits.load(), 2U);
+  EXPECT_EQ(cache.stats().misses.load(), 1U);
+}
+
+TEST(ShardedLRUCacheTest, StaleEntriesAreDropped) {
+  ShardedLRUCache<int> cache(1024);
+
+  cache.Put("a", 1);
+  EXPECT_EQ(cache.GetIf("a", [](int v) { return v > 1; }), std::nullopt);
+  // The stale entry is gone, even for lookups that would accept it.
+  EXPECT_EQ(cache.Get("a"), std::nullopt);
+}
+
+TEST(ShardedLRUCacheTest, EvictsLeastRecentlyUsed) {
+  // A capacity of 2 per shard.
+  ShardedLRUCache<int> cache(2 * ShardedLRUCache<int>::kNumShards);
+
+  // Touching "hot" after every insert keeps it the most recently used entry of its shard, so it
+  // must survive however the other keys hash.
+  cache.Put("hot", 0);
+  for (int i = 0; i < 1000; ++i) {
+    cache.Put(absl::StrCat("key", i), i);
+    ASSERT_THAT(cache.Get("hot"), Optional(0));
+  }
+  EXPECT_GT(cache.stats().evictions.load(), 0U);
+
+  int num_cached = 0;
+  for (int i = 0; i < 1000; ++i) {
+    num_cached += cache.Get(absl::StrCat("key", i)).has_value();
+  }
+  EXPECT_LE(num_cached, 2 * static_cast<int>(ShardedLRUCache<int>::kNumShards));
+  EXPECT_THAT(cache.Get("key999"), Optional(999));
+}
+
+}  // namespace funcs
+}  // namespace carnot
+}  // namespace px
@@ -106,8 +106,11 @@ StatusOr<ExpressionIR*> ConvertStringTimesRule::ConvertStringTimes(ExpressionIR*
     auto str_node = static_cast<StringIR*>(node);
     PL_ASSIGN_OR_RETURN(
         int64_t time,
-        ParseStringToTime(str_node, relative_time ? compiler_state_->time_now().val : 0));
-    return node->graph()->CreateNode<IntIR>(node->ast(), time);
+        ParseStringToTime(str_node, relative_time ? compiler_state_->relative_time_now().val : 0));
+    PL_ASSIGN_OR_RETURN(IntIR * time_node, node->graph()->CreateNode<IntIR>(node->ast(), time));
+    // Durations such as '-5m' are relative to now, absolute times aren't.
+    time_node->set_relative_to_now(relative_time && ParseDurationFmt(str_node, 0).ok());
+    return time_node;
   } else if (Match(node, Func())) {
     auto func_node = static_cast<FuncIR*>(node);
     for (const auto& [idx, arg] : Enumerate(func_node->all_args())) {
@@ -35,8 +35,10 @@ StatusOr<bool> SetMemorySourceTimesRule::Apply(IRNode* node) {
   // TODO(philkuz) switch to use TimeIR.
   DCHECK(Match(mem_src->start_time_expr(), Int())) << mem_src->start_time_expr()->DebugString();
   DCHECK(Match(mem_src->end_time_expr(), Int())) << mem_src->end_time_expr()->DebugString();
-  mem_src->SetTimeValuesNS(static_cast<IntIR*>(mem_src->start_time_expr())->val(),
-                           static_cast<IntIR*>(mem_src->end_time_expr())->val());
+  auto start_time = static_cast<IntIR*>(mem_src->start_time_expr());
+  auto stop_time = static_cast<IntIR*>(mem_src->end_time_expr());
+  mem_src->SetTimeValuesNS(start_time->val(), stop_time->val());
+  mem_src->SetTimesRelativeToNow(start_time->relative_to_now(), stop_time->relative_to_now());
   return true;
 }
 
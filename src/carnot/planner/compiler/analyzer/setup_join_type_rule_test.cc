@@ -21,6 +21,7 @@
 
 #include <gtest/gtest.h>
 
+#include "src/carnot/planner/compiler/analyzer/resolve_types_rule.h"
 #include "src/carnot/planner/compiler/analyzer/setup_join_type_rule.h"
 #include "src/carnot/planner/compiler/test_utils.h"
 
@@ -55,6 +56,42 @@ TEST_F(RulesTest, setup_join_type_rule) {
   EXPECT_EQ(join_op->parents()[1], mem_src1);
 }
 
+TEST_F(RulesTest, setup_join_type_rule_keeps_key_indices) {
+  Relation relation0({types::DataType::INT64, types::DataType::INT64, types::DataType::INT64},
+                     {"left_only", "col1", "col2"});
+  compiler_state_->relation_map()->emplace("left_table", relation0);
+  auto mem_src1 = MakeMemSource("left_table", relation0);
+
+  Relation relation1({types::DataType::INT64, types::DataType::INT64, types::DataType::INT64,
+                      types::DataType::INT64},
+                     {"right_only", "col1", "col2", "col3"});
+  compiler_state_->relation_map()->emplace("right_table", relation1);
+  auto mem_src2 = MakeMemSource("right_table", relation1);
+
+  auto join_op = MakeJoin({mem_src1, mem_src2}, "right", relation0, relation1,
+                          std::vector<std::string>{"col1"}, std::vector<std::string>{"col3"},
+                          std::vector<std::string>{"_x", "_y"});
+  MakeMemSink(join_op, "out");
+
+  SetupJoinTypeRule rule;
+  ASSERT_OK(rule.Execute(graph.get()));
+  ResolveTypesRule type_rule(compiler_state_.get());
+  ASSERT_OK(type_rule.Execute(graph.get()));
+
+  // Parent 0 is now the user's right table, so the key indices of each equality condition swap
+  // along with the parents.
+  planpb::Operator op;
+  ASSERT_OK(join_op->ToProto(&op));
+  ASSERT_EQ(op.join_op().equality_conditions_size(), 1);
+  EXPECT_EQ(op.join_op().equality_conditions(0).left_column_index(), 3);
+  EXPECT_EQ(op.join_op().equality_conditions(0).right_column_index(), 1);
+
+  // The output still lists the user's left table first.
+  EXPECT_EQ(op.join_op().column_names(0), "left_only");
+  EXPECT_EQ(op.join_op().output_columns(0).parent_index(), 1);
+  EXPECT_EQ(op.join_op().output_columns(0).column_index(), 0);
+}
+
 }  // namespace compiler
 }  // namespace planner
 }  // namespace carnot
@@ -18,6 +18,7 @@
 
 #include "src/carnot/planner/compiler/ast_visitor.h"
 
+#include "src/carnot/planner/compiler/builtin_modules.h"
 #include "src/carnot/planner/compiler_error_context/compiler_error_context.h"
 #include "src/carnot/planner/ir/pattern_match.h"
 #include "src/carnot/planner/objects/collection_object.h"
@@ -95,6 +96,12 @@ Status ASTVisitorImpl::SetupModules(
                       TraceModule::Create(mutations_, this));
   PL_ASSIGN_OR_RETURN((*module_handler_)[ConfigModule::kConfigModuleObjName],
                       ConfigModule::Create(mutations_, this));
+  PL_ASSIGN_OR_RETURN(const BuiltinModuleMap* builtin_modules, BuiltinPxLModules());
+  for (const auto& [module_name, module_ast] : *builtin_modules) {
+    if (!module_name_to_pxl_map.contains(module_name)) {
+      PL_ASSIGN_OR_RETURN((*module_handler_)[module_name], Module::Create(module_ast, this));
+    }
+  }
   for (const auto& [module_name, module_text] : module_name_to_pxl_map) {
     PL_ASSIGN_OR_RETURN((*module_handler_)[module_name], Module::Create(module_text, this));
   }
@@ -949,8 +956,40 @@ StatusOr<udf::ScalarUDFDefinition*> GetUDFDefinition(const std::shared_ptr<udf::
   return udf_or_s;
 }
 
-StatusOr<ExpressionIR*> ExecUDF(IR* graph, const pypa::AstPtr& ast, udf::ScalarUDFDefinition* def,
+bool IsRelativeToNow(const ExpressionIR* expr) {
+  return expr->type() == IRNodeType::kInt && static_cast<const IntIR*>(expr)->relative_to_now();
+}
+
+// Returns whether the result of evaluating the UDF on the args is relative to now, like
+// `px.now() - px.minutes(5)`. Any other use of a time relative to now ties the plan to the time.
+bool ResultRelativeToNow(CompilerState* compiler_state, const udf::ScalarUDFDefinition* def,
+                         const std::vector<ExpressionIR*>& args) {
+  int64_t num_relative = std::count_if(args.begin(), args.end(), IsRelativeToNow);
+  if (num_relative == 0) {
+    return false;
+  }
+  if (def->exec_return_type() == types::INT64 && args.size() == 2) {
+    if (def->name() == "add" && num_relative == 1) {
+      return true;
+    }
+    if (def->name() == "subtract") {
+      // The difference of two times relative to now doesn't depend on now.
+      if (num_relative == 2) {
+        return false;
+      }
+      if (IsRelativeToNow(args[0])) {
+        return true;
+      }
+    }
+  }
+  compiler_state->time_now();
+  return false;
+}
+
+StatusOr<ExpressionIR*> ExecUDF(IR* graph, CompilerState* compiler_state,
+                                const pypa::AstPtr& ast, udf::ScalarUDFDefinition* def,
                                 const std::vector<ExpressionIR*>& args) {
+  bool result_relative_to_now = ResultRelativeToNow(compiler_state, def, args);
   std::vector<std::shared_ptr<types::ColumnWrapper>> column_pool;
   std::vector<const types::ColumnWrapper*> columns;
   // Extract the argument values out into column wrappers.
@@ -993,8 +1032,12 @@ StatusOr<ExpressionIR*> ExecUDF(IR* graph, const pypa::AstPtr& ast, udf::ScalarU
 
   // Convert the output type into a DataIR.
   switch (def->exec_return_type()) {
-    case types::INT64:
-      return graph->CreateNode<IntIR>(ast, output->Get<types::Int64Value>(0).val);
+    case types::INT64: {
+      PL_ASSIGN_OR_RETURN(IntIR * result,
+                          graph->CreateNode<IntIR>(ast, output->Get<types::Int64Value>(0).val));
+      result->set_relative_to_now(result_relative_to_now);
+      return result;
+    }
     case types::FLOAT64:
       return graph->CreateNode<FloatIR>(ast, output->Get<types::Float64Value>(0).val);
     case types::STRING:
@@ -1025,7 +1068,8 @@ StatusOr<QLObjectPtr> ASTVisitorImpl::ProcessDataBinOp(const pypa::AstBinOpPtr&
   std::vector<ExpressionIR*> args = {left, right};
   PL_ASSIGN_OR_RETURN(auto udf, GetUDFDefinition(udf_registry_, op.carnot_op_name, args));
   if (udf != nullptr) {
-    PL_ASSIGN_OR_RETURN(ExpressionIR * expr, ExecUDF(ir_graph_, node, udf, args));
+    PL_ASSIGN_OR_RETURN(ExpressionIR * expr,
+                        ExecUDF(ir_graph_, compiler_state_, node, udf, args));
     return ExprObject::Create(expr, this);
   }
   PL_ASSIGN_OR_RETURN(FuncIR * ir_node, ir_graph_->CreateNode<FuncIR>(node, op, args));
@@ -1050,7 +1094,8 @@ StatusOr<QLObjectPtr> ASTVisitorImpl::ProcessDataBoolOp(const pypa::AstBoolOpPtr
   std::vector<ExpressionIR*> args{left, right};
   PL_ASSIGN_OR_RETURN(auto udf, GetUDFDefinition(udf_registry_, op.carnot_op_name, args));
   if (udf != nullptr) {
-    PL_ASSIGN_OR_RETURN(ExpressionIR * expr, ExecUDF(ir_graph_, node, udf, args));
+    PL_ASSIGN_OR_RETURN(ExpressionIR * expr,
+                        ExecUDF(ir_graph_, compiler_state_, node, udf, args));
     return ExprObject::Create(expr, this);
   }
   PL_ASSIGN_OR_RETURN(FuncIR * ir_node, ir_graph_->CreateNode<FuncIR>(node, op, args));
@@ -1079,7 +1124,8 @@ StatusOr<QLObjectPtr> ASTVisitorImpl::ProcessDataCompare(const pypa::AstCompareP
   PL_ASSIGN_OR_RETURN(FuncIR::Op op, GetOp(op_str, node));
   PL_ASSIGN_OR_RETURN(auto udf, GetUDFDefinition(udf_registry_, op.carnot_op_name, args));
   if (udf != nullptr) {
-    PL_ASSIGN_OR_RETURN(ExpressionIR * expr, ExecUDF(ir_graph_, node, udf, args));
+    PL_ASSIGN_OR_RETURN(ExpressionIR * expr,
+                        ExecUDF(ir_graph_, compiler_state_, node, udf, args));
     return ExprObject::Create(expr, this);
   }
 
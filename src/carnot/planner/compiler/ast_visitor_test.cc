@@ -1915,6 +1915,28 @@ TEST_F(ASTVisitorTest, alt_imports_test_from) {
   EXPECT_MATCH(sink->parents()[0], MemorySource());
 }
 
+constexpr char kPxProfilerImportTest[] = R"pxl(
+import px
+import pxprofiler
+df = px.DataFrame(table='stack_traces_v2.beta', start_time='-30s')
+df = df.groupby(['upid', 'stack_trace_id']).agg(count=('count', px.sum))
+px.display(pxprofiler.with_stack_trace_strings(df, px.now() + px.parse_duration('-30s')))
+)pxl";
+
+TEST_F(ASTVisitorTest, builtin_pxprofiler_module) {
+  // The module is parsed once, and its AST is shared by the compilations.
+  for (int i = 0; i < 2; ++i) {
+    auto graph_or_s = CompileGraph(kPxProfilerImportTest);
+    ASSERT_OK(graph_or_s);
+    auto graph = graph_or_s.ConsumeValueOrDie();
+
+    // Stack traces without a recorded string are kept by a left join.
+    auto joins = graph->FindNodesThatMatch(Join());
+    ASSERT_EQ(joins.size(), 1);
+    EXPECT_EQ(static_cast<JoinIR*>(joins[0])->join_type(), JoinIR::JoinType::kLeft);
+  }
+}
+
 constexpr char kReuseLimitArg[] = R"pxl(
 import px
 
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/planner/compiler/builtin_modules.h"
+
+#include <memory>
+#include <string_view>
+
+#include "src/carnot/planner/parser/parser.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace compiler {
+
+namespace {
+
+// Helpers for the tables of the perf profiler.
+constexpr char kPxProfilerModule[] = R"pxl(
+import px
+
+
+def with_stack_trace_strings(df, start_time):
+    ''' Adds the folded stack_trace column to aggregated stack_traces_v2.beta records.
+
+    The stack trace strings are recorded in stack_trace_strings.beta. The profiler records a string
+    when the stack trace is first sampled in each 5 minute period, so the strings are read from two
+    periods before the start time. Records whose string is not found are kept, with a placeholder
+    stack trace.
+
+    Args:
+    @df: The stack_traces_v2.beta records, with the upid and stack_trace_id columns.
+    @start_time: The start time of the stack_traces_v2.beta records, as a time rather than a
+      duration string, e.g. px.now() + px.parse_duration('-5m').
+    '''
+    strs = px.DataFrame(table='stack_trace_strings.beta', start_time=start_time - px.minutes(10))
+    strs = strs.groupby(['upid', 'stack_trace_id']).agg(stack_trace=('stack_trace', px.any))
+    df = df.merge(
+        strs,
+        how='left',
+        left_on=['upid', 'stack_trace_id'],
+        right_on=['upid', 'stack_trace_id'],
+        suffixes=['', '_x']
+    )
+    df.stack_trace = px.select(df.stack_trace == '', '[unknown stack trace]', df.stack_trace)
+    return df.drop(['upid', 'upid_x', 'stack_trace_id_x'])
+)pxl";
+
+StatusOr<const BuiltinModuleMap*> ParseBuiltinPxLModules() {
+  const absl::flat_hash_map<std::string, std::string_view> module_texts = {
+      {"pxprofiler", kPxProfilerModule},
+  };
+
+  auto modules = std::make_unique<BuiltinModuleMap>();
+  Parser parser;
+  for (const auto& [module_name, module_text] : module_texts) {
+    PL_ASSIGN_OR_RETURN((*modules)[module_name],
+                        parser.Parse(module_text, /* parse_doc_strings */ true));
+  }
+  return modules.release();
+}
+
+}  // namespace
+
+StatusOr<const BuiltinModuleMap*> BuiltinPxLModules() {
+  static const auto* modules = new StatusOr<const BuiltinModuleMap*>(ParseBuiltinPxLModules());
+  return *modules;
+}
+
+}  // namespace compiler
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,47 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <string>
+
+#include <absl/container/flat_hash_map.h>
+#include <pypa/ast/ast.hh>
+
+#include "src/common/base/statusor.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace compiler {
+
+using BuiltinModuleMap = absl::flat_hash_map<std::string, pypa::AstModulePtr>;
+
+/**
+ * @brief Returns the parsed PxL modules that are built into the compiler, keyed by the name that
+ * scripts import them as. They hold helpers shared by the bundled scripts. A module passed to the
+ * compiler under the same name replaces the built-in one.
+ *
+ * The modules are parsed by the first call only, and the ASTs are shared by all compilations.
+ */
+StatusOr<const BuiltinModuleMap*> BuiltinPxLModules();
+
+}  // namespace compiler
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
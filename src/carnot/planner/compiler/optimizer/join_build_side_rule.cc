@@ -0,0 +1,106 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "src/carnot/planner/compiler/optimizer/join_build_side_rule.h"
+
+#include <algorithm>
+
+#include "src/carnot/planner/ir/blocking_agg_ir.h"
+#include "src/carnot/planner/ir/join_ir.h"
+#include "src/carnot/planner/ir/limit_ir.h"
+#include "src/carnot/planner/ir/memory_source_ir.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace compiler {
+
+StatusOr<bool> SelectJoinBuildSideRule::Execute(IR* graph) {
+  estimated_rows_.clear();
+  return Rule::Execute(graph);
+}
+
+int64_t SelectJoinBuildSideRule::EstimateRows(OperatorIR* op) {
+  auto iter = estimated_rows_.find(op);
+  if (iter != estimated_rows_.end()) {
+    return iter->second;
+  }
+
+  int64_t rows = -1;
+  if (Match(op, MemorySource())) {
+    const auto& table_stats = compiler_state_->table_stats();
+    auto stats_iter = table_stats.find(static_cast<MemorySourceIR*>(op)->table_name());
+    if (stats_iter != table_stats.end()) {
+      rows = stats_iter->second.num_rows;
+    }
+  } else if (Match(op, UDTFSource())) {
+    rows = kUDTFSourceRows;
+  } else if (Match(op, Join())) {
+    // The output of a join depends on how many keys match, which the statistics don't cover.
+    rows = -1;
+  } else if (Match(op, Union())) {
+    rows = 0;
+    for (OperatorIR* parent : op->parents()) {
+      int64_t parent_rows = EstimateRows(parent);
+      if (parent_rows < 0) {
+        rows = -1;
+        break;
+      }
+      rows += parent_rows;
+    }
+  } else if (op->parents().size() == 1) {
+    // Filters and maps are assumed to keep the rows of their parent, which overestimates filters
+    // but keeps the order between the two sides of a join for the common case.
+    rows = EstimateRows(op->parents()[0]);
+    if (Match(op, Limit()) && static_cast<LimitIR*>(op)->limit_value_set()) {
+      int64_t limit = static_cast<LimitIR*>(op)->limit_value();
+      rows = rows < 0 ? limit : std::min(rows, limit);
+    } else if (Match(op, BlockingAgg()) && static_cast<BlockingAggIR*>(op)->groups().empty()) {
+      rows = 1;
+    }
+  }
+  estimated_rows_[op] = rows;
+  return rows;
+}
+
+StatusOr<bool> SelectJoinBuildSideRule::Apply(IRNode* ir_node) {
+  if (!Match(ir_node, Join())) {
+    return false;
+  }
+  auto join = static_cast<JoinIR*>(ir_node);
+  // Left joins keep every row of parent 0, and the executor has no join type that keeps every row
+  // of parent 1 instead, so they can't be swapped.
+  if (join->join_type() != JoinIR::JoinType::kInner &&
+      join->join_type() != JoinIR::JoinType::kOuter) {
+    return false;
+  }
+  if (join->parents().size() != 2 || join->parents()[0] == join->parents()[1]) {
+    return false;
+  }
+  int64_t build_rows = EstimateRows(join->parents()[0]);
+  int64_t probe_rows = EstimateRows(join->parents()[1]);
+  if (build_rows < 0 || probe_rows < 0 || build_rows <= probe_rows) {
+    return false;
+  }
+  PL_RETURN_IF_ERROR(join->SwapParents());
+  return true;
+}
+
+}  // namespace compiler
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
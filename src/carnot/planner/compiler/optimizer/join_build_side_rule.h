@@ -0,0 +1,67 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <absl/container/flat_hash_map.h>
+
+#include "src/carnot/planner/compiler_state/compiler_state.h"
+#include "src/carnot/planner/rules/rules.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace compiler {
+
+/**
+ * @brief SelectJoinBuildSideRule makes the smaller input of each join the side that the hash table
+ * is built from.
+ *
+ * The executor builds its hash table from parent 0 of a join and streams parent 1 through it, so
+ * the memory used by a join and the time until it produces output both grow with parent 0. The
+ * rule estimates the number of rows each parent produces from the table statistics in the
+ * CompilerState and swaps the parents of inner and outer joins when parent 0 is the larger one.
+ * Joins where either estimate is unknown are left as written. The metadata service fills in
+ * SchemaInfo.stats from the row counts that the agents report in their heartbeats.
+ */
+class SelectJoinBuildSideRule : public Rule {
+ public:
+  explicit SelectJoinBuildSideRule(CompilerState* compiler_state)
+      : Rule(compiler_state, /*use_topo*/ true, /*reverse_topological_execution*/ false) {}
+
+  StatusOr<bool> Execute(IR* graph) override;
+
+  // The number of rows assumed for a UDTF source, which usually produces a small table about the
+  // cluster rather than the output of a data table.
+  static constexpr int64_t kUDTFSourceRows = 1000;
+
+ protected:
+  StatusOr<bool> Apply(IRNode* ir_node) override;
+
+ private:
+  /**
+   * @brief Returns the estimated number of rows that op produces, or -1 if there is no estimate.
+   */
+  int64_t EstimateRows(OperatorIR* op);
+
+  absl::flat_hash_map<OperatorIR*, int64_t> estimated_rows_;
+};
+
+}  // namespace compiler
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
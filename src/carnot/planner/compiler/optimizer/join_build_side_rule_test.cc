@@ -0,0 +1,137 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "src/carnot/planner/compiler/analyzer/resolve_types_rule.h"
+#include "src/carnot/planner/compiler/optimizer/join_build_side_rule.h"
+#include "src/carnot/planner/compiler/test_utils.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace compiler {
+
+using table_store::schema::Relation;
+
+class SelectJoinBuildSideRuleTest : public RulesTest {
+ protected:
+  void SetUpImpl() override {
+    RulesTest::SetUpImpl();
+    rel1_ = Relation({types::FLOAT64, types::INT64, types::STRING}, {"latency", "key", "data"});
+    rel2_ = Relation({types::INT64, types::FLOAT64}, {"key", "cpu_usage"});
+    compiler_state_->relation_map()->emplace("table1", rel1_);
+    compiler_state_->relation_map()->emplace("table2", rel2_);
+    mem_src1_ = MakeMemSource("table1", rel1_);
+    mem_src2_ = MakeMemSource("table2", rel2_);
+  }
+
+  JoinIR* MakeKeyJoin(const std::string& join_type) {
+    return MakeJoin({mem_src1_, mem_src2_}, join_type, std::vector<ColumnIR*>{MakeColumn("key", 0)},
+                    std::vector<ColumnIR*>{MakeColumn("key", 1)}, {"_x", "_y"});
+  }
+
+  Relation rel1_;
+  Relation rel2_;
+  MemorySourceIR* mem_src1_;
+  MemorySourceIR* mem_src2_;
+};
+
+TEST_F(SelectJoinBuildSideRuleTest, swaps_larger_build_side) {
+  compiler_state_->set_table_stats({{"table1", {1000000}}, {"table2", {10}}});
+  auto join = MakeKeyJoin("inner");
+  MakeMemSink(join, "out");
+
+  ResolveTypesRule type_rule(compiler_state_.get());
+  ASSERT_OK(type_rule.Execute(graph.get()));
+  auto join_type = join->resolved_table_type();
+
+  SelectJoinBuildSideRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ConsumeValueOrDie());
+
+  EXPECT_EQ(join->parents()[0], mem_src2_);
+  EXPECT_EQ(join->parents()[1], mem_src1_);
+  EXPECT_TRUE(join->specified_as_right());
+  EXPECT_EQ(join->suffix_strs(), std::vector<std::string>({"_y", "_x"}));
+  EXPECT_EQ(join->left_right_suffixs(), std::make_tuple("_x", "_y"));
+  EXPECT_MATCH(join->output_columns()[0], ColumnNode("latency", /* parent_idx */ 1));
+  EXPECT_MATCH(join->output_columns()[3], ColumnNode("key", /* parent_idx */ 0));
+  EXPECT_TRUE(join_type->Equals(join->resolved_table_type()));
+
+  // The equality conditions index into the swapped parents.
+  planpb::Operator op;
+  ASSERT_OK(join->ToProto(&op));
+  ASSERT_EQ(op.join_op().equality_conditions_size(), 1);
+  EXPECT_EQ(op.join_op().equality_conditions(0).left_column_index(), 0);
+  EXPECT_EQ(op.join_op().equality_conditions(0).right_column_index(), 1);
+  EXPECT_EQ(op.join_op().output_columns(0).parent_index(), 1);
+  EXPECT_EQ(op.join_op().output_columns(0).column_index(), 0);
+
+  // The smaller side is already the build side, so running again is a no-op.
+  result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ConsumeValueOrDie());
+}
+
+TEST_F(SelectJoinBuildSideRuleTest, estimates_through_operators) {
+  compiler_state_->set_table_stats({{"table1", {1000}}, {"table2", {100000}}});
+  auto limit = MakeLimit(mem_src2_, 10);
+  auto join = MakeJoin({mem_src1_, limit}, "outer", std::vector<ColumnIR*>{MakeColumn("key", 0)},
+                       std::vector<ColumnIR*>{MakeColumn("key", 1)}, {"_x", "_y"});
+  MakeMemSink(join, "out");
+
+  SelectJoinBuildSideRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ConsumeValueOrDie());
+  EXPECT_EQ(join->parents()[0], limit);
+}
+
+TEST_F(SelectJoinBuildSideRuleTest, keeps_left_join) {
+  compiler_state_->set_table_stats({{"table1", {1000000}}, {"table2", {10}}});
+  auto join = MakeKeyJoin("left");
+  MakeMemSink(join, "out");
+
+  SelectJoinBuildSideRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ConsumeValueOrDie());
+  EXPECT_EQ(join->parents()[0], mem_src1_);
+}
+
+TEST_F(SelectJoinBuildSideRuleTest, keeps_join_without_stats) {
+  compiler_state_->set_table_stats({{"table1", {1000000}}});
+  auto join = MakeKeyJoin("inner");
+  MakeMemSink(join, "out");
+
+  SelectJoinBuildSideRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ConsumeValueOrDie());
+  EXPECT_EQ(join->parents()[0], mem_src1_);
+}
+
+}  // namespace compiler
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
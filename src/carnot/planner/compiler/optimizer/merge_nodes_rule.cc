@@ -338,6 +338,19 @@ StatusOr<OperatorIR*> MergeNodesRule::MergeOps(IR* graph,
       new_src->ClearTimeNS();
     } else {
       new_src->SetTimeValuesNS(start_time, stop_time);
+      // The merged times only stay relative to now if all of the sources' times are.
+      bool start_relative = base_src->time_start_relative_to_now();
+      bool stop_relative = base_src->time_stop_relative_to_now();
+      bool mixed = false;
+      for (OperatorIR* other_op : operators_to_merge) {
+        MemorySourceIR* other_src = static_cast<MemorySourceIR*>(other_op);
+        mixed |= other_src->time_start_relative_to_now() != start_relative;
+        mixed |= other_src->time_stop_relative_to_now() != stop_relative;
+      }
+      if (mixed) {
+        compiler_state_->time_now();
+      }
+      new_src->SetTimesRelativeToNow(start_relative && !mixed, stop_relative && !mixed);
     }
 
     new_src->ClearResolvedType();
@@ -23,6 +23,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include "src/carnot/planner/compiler/optimizer/join_build_side_rule.h"
 #include "src/carnot/planner/compiler/optimizer/merge_nodes_rule.h"
 #include "src/carnot/planner/compiler/optimizer/prune_unconnected_operators_rule.h"
 #include "src/carnot/planner/compiler/optimizer/prune_unused_columns_rule.h"
@@ -57,6 +58,11 @@ class Optimizer : public RuleExecutor<IR> {
     merge_nodes_batch->AddRule<MergeNodesRule>(compiler_state_);
   }
 
+  void CreateSelectJoinBuildSideBatch() {
+    RuleBatch* join_build_side_batch = CreateRuleBatch<FailOnMax>("SelectJoinBuildSide", 2);
+    join_build_side_batch->AddRule<SelectJoinBuildSideRule>(compiler_state_);
+  }
+
   void CreatePruneUnusedColumnsBatch() {
     RuleBatch* prune_unused_columns = CreateRuleBatch<FailOnMax>("PruneUnusedColumns", 2);
     prune_unused_columns->AddRule<PruneUnusedColumnsRule>();
@@ -65,6 +71,7 @@ class Optimizer : public RuleExecutor<IR> {
   Status Init() {
     CreatePruneUnconnectedOpsBatch();
     CreateMergeNodesBatch();
+    CreateSelectJoinBuildSideBatch();
     CreatePruneUnusedColumnsBatch();
     return Status::OK();
   }
@@ -89,8 +89,14 @@ struct RedactionOptions {
   bool use_px_redact_pii_best_effort = false;
 };
 
+// TableStats holds approximate statistics of a table across all the agents that have it.
+struct TableStats {
+  int64_t num_rows = 0;
+};
+
 using RelationMap = std::unordered_map<std::string, table_store::schema::Relation>;
 using SensitiveColumnMap = absl::flat_hash_map<std::string, absl::flat_hash_set<std::string>>;
+using TableStatsMap = absl::flat_hash_map<std::string, TableStats>;
 class CompilerState : public NotCopyable {
  public:
   /**
@@ -125,7 +131,17 @@ class CompilerState : public NotCopyable {
     return &table_names_to_sensitive_columns_;
   }
   RegistryInfo* registry_info() const { return registry_info_; }
-  types::Time64NSValue time_now() const { return time_now_; }
+  types::Time64NSValue time_now() const {
+    time_now_used_ = true;
+    return time_now_;
+  }
+  // Whether compilation read time_now(), which ties the compiled plan to that time.
+  bool time_now_used() const { return time_now_used_; }
+  // The current time for values that the IR marks as relative to now, eg. IntIR::relative_to_now().
+  // PlanCache moves those forward when it reuses the plan, so reading this doesn't tie the plan to
+  // the time.
+  types::Time64NSValue relative_time_now() const { return time_now_; }
+  void set_time_now(types::Time64NSValue time_now) { time_now_ = time_now; }
   const std::string& result_address() const { return result_address_; }
   const std::string& result_ssl_targetname() const { return result_ssl_targetname_; }
 
@@ -158,11 +174,16 @@ class CompilerState : public NotCopyable {
   const RedactionOptions& redaction_options() { return redaction_options_; }
   void set_redaction_options(const RedactionOptions& options) { redaction_options_ = options; }
 
+  // Statistics of the tables that have them, by table name.
+  const TableStatsMap& table_stats() const { return table_stats_; }
+  void set_table_stats(TableStatsMap table_stats) { table_stats_ = std::move(table_stats); }
+
  private:
   std::unique_ptr<RelationMap> relation_map_;
   SensitiveColumnMap table_names_to_sensitive_columns_;
   RegistryInfo* registry_info_;
   types::Time64NSValue time_now_;
+  mutable bool time_now_used_ = false;
   std::map<IDRegistryKey, int64_t> udf_to_id_map_;
   std::map<IDRegistryKey, int64_t> uda_to_id_map_;
 
@@ -170,6 +191,7 @@ class CompilerState : public NotCopyable {
   const std::string result_address_;
   const std::string result_ssl_targetname_;
   RedactionOptions redaction_options_;
+  TableStatsMap table_stats_;
 };
 
 }  // namespace planner
@@ -17,7 +17,9 @@
  */
 
 #include <algorithm>
+#include <functional>
 #include <memory>
+#include <numeric>
 #include <queue>
 #include <string>
 #include <unordered_set>
@@ -34,6 +36,12 @@
 #include "src/common/uuid/uuid.h"
 #include "src/shared/upid/upid.h"
 
+DEFINE_bool(planner_spread_kelvin_subplans,
+            gflags::BoolFromEnv("PL_PLANNER_SPREAD_KELVIN_SUBPLANS", false),
+            "Whether to run independent subplans of the Kelvin plan on the other Kelvins. Only "
+            "subplans that produce separate results are spread. A single aggregate or join still "
+            "runs entirely on one Kelvin.");
+
 namespace px {
 namespace carnot {
 namespace planner {
@@ -164,6 +172,169 @@ const distributedpb::CarnotInfo& CoordinatorImpl::GetRemoteProcessor() const {
   return remote_processor_nodes_[0];
 }
 
+namespace {
+
+/**
+ * @brief Groups the operators of a Kelvin plan into subplans that can run on separate Kelvins.
+ * Operators connected by an edge, or by a GRPC bridge within the plan, are in the same subplan.
+ */
+std::vector<absl::flat_hash_set<int64_t>> IndependentKelvinSubplans(const IR* plan) {
+  if (plan->GetSources().empty()) {
+    return {};
+  }
+  std::vector<absl::flat_hash_set<int64_t>> graphs = plan->IndependentGraphs();
+  absl::flat_hash_map<int64_t, size_t> op_to_graph;
+  for (const auto& [i, graph] : Enumerate(graphs)) {
+    for (int64_t op_id : graph) {
+      op_to_graph[op_id] = i;
+    }
+  }
+
+  std::vector<size_t> leader(graphs.size());
+  std::iota(leader.begin(), leader.end(), 0);
+  std::function<size_t(size_t)> find_leader = [&](size_t i) {
+    if (leader[i] != i) {
+      leader[i] = find_leader(leader[i]);
+    }
+    return leader[i];
+  };
+
+  absl::flat_hash_map<int64_t, int64_t> bridge_id_to_source_group;
+  for (IRNode* node : plan->FindNodesThatMatch(GRPCSourceGroup())) {
+    bridge_id_to_source_group[static_cast<GRPCSourceGroupIR*>(node)->source_id()] = node->id();
+  }
+  for (IRNode* node : plan->FindNodesThatMatch(InternalGRPCSink())) {
+    auto it = bridge_id_to_source_group.find(static_cast<GRPCSinkIR*>(node)->destination_id());
+    if (it == bridge_id_to_source_group.end()) {
+      continue;
+    }
+    leader[find_leader(op_to_graph[node->id()])] = find_leader(op_to_graph[it->second]);
+  }
+
+  absl::flat_hash_map<size_t, size_t> leader_to_subplan;
+  std::vector<absl::flat_hash_set<int64_t>> subplans;
+  for (const auto& [i, graph] : Enumerate(graphs)) {
+    auto [it, inserted] = leader_to_subplan.try_emplace(find_leader(i), subplans.size());
+    if (inserted) {
+      subplans.emplace_back();
+    }
+    subplans[it->second].insert(graph.begin(), graph.end());
+  }
+  return subplans;
+}
+
+// Subplans that read anything other than GRPC sources (ie UDTFs) were placed for the Kelvin they
+// were planned on, so they can't move.
+bool SubplanCanMove(const IR* plan, const absl::flat_hash_set<int64_t>& subplan) {
+  for (int64_t op_id : subplan) {
+    IRNode* op = plan->Get(op_id);
+    if (Match(op, SourceOperator()) && !Match(op, GRPCSourceGroup())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool IsResultSink(const IRNode* op) {
+  return Match(op, ExternalGRPCSink()) || Match(op, MemorySink());
+}
+
+}  // namespace
+
+Status CoordinatorImpl::SpreadKelvinSubplans(DistributedPlan* distributed_plan,
+                                             CarnotInstance* kelvin,
+                                             const std::vector<int64_t>& source_node_ids,
+                                             int64_t next_bridge_id) {
+  if (!spread_kelvin_subplans_ || remote_processor_nodes_.size() < 2) {
+    return Status::OK();
+  }
+  IR* kelvin_plan = kelvin->plan();
+  std::vector<absl::flat_hash_set<int64_t>> subplans = IndependentKelvinSubplans(kelvin_plan);
+  if (subplans.size() < 2) {
+    return Status::OK();
+  }
+
+  // Place the largest subplans first, each on the remote processor with the fewest operators so
+  // far. Index 0 is the Kelvin that the whole plan is currently on.
+  std::vector<size_t> num_ops(remote_processor_nodes_.size(), 0);
+  std::vector<size_t> movable;
+  for (const auto& [i, subplan] : Enumerate(subplans)) {
+    if (SubplanCanMove(kelvin_plan, subplan)) {
+      movable.push_back(i);
+    } else {
+      num_ops[0] += subplan.size();
+    }
+  }
+  std::stable_sort(movable.begin(), movable.end(), [&subplans](size_t a, size_t b) {
+    return subplans[a].size() > subplans[b].size();
+  });
+  std::vector<absl::flat_hash_set<int64_t>> ops_per_processor(remote_processor_nodes_.size());
+  for (size_t i : movable) {
+    auto min_it = std::min_element(num_ops.begin(), num_ops.end());
+    *min_it += subplans[i].size();
+    ops_per_processor[min_it - num_ops.begin()].merge(subplans[i]);
+  }
+
+  for (size_t processor_idx = 1; processor_idx < ops_per_processor.size(); ++processor_idx) {
+    const auto& moved_ops = ops_per_processor[processor_idx];
+    if (moved_ops.empty()) {
+      continue;
+    }
+    PL_ASSIGN_OR_RETURN(std::unique_ptr<IR> moved_plan_uptr, kelvin_plan->Clone());
+    IR* moved_plan = moved_plan_uptr.get();
+
+    absl::flat_hash_set<int64_t> ops_to_keep_on_kelvin;
+    for (IRNode* node : kelvin_plan->FindNodesThatMatch(Operator())) {
+      if (moved_ops.contains(node->id())) {
+        continue;
+      }
+      ops_to_keep_on_kelvin.insert(node->id());
+    }
+    PL_RETURN_IF_ERROR(moved_plan->Prune(ops_to_keep_on_kelvin));
+
+    // Result sinks stay on the Kelvin, fed by a GRPC bridge from the moved subplan.
+    absl::flat_hash_set<int64_t> ops_to_remove_from_kelvin;
+    for (int64_t op_id : moved_ops) {
+      auto kelvin_op = static_cast<OperatorIR*>(kelvin_plan->Get(op_id));
+      if (!IsResultSink(kelvin_op)) {
+        ops_to_remove_from_kelvin.insert(op_id);
+        continue;
+      }
+      DCHECK_EQ(kelvin_op->parents().size(), 1UL);
+      OperatorIR* kelvin_parent = kelvin_op->parents()[0];
+      PL_ASSIGN_OR_RETURN(
+          GRPCSourceGroupIR * source_group,
+          kelvin_plan->CreateNode<GRPCSourceGroupIR>(kelvin_parent->ast(), next_bridge_id,
+                                                     kelvin_parent->resolved_type()));
+      PL_RETURN_IF_ERROR(kelvin_op->ReplaceParent(kelvin_parent, source_group));
+
+      auto moved_op = static_cast<OperatorIR*>(moved_plan->Get(op_id));
+      OperatorIR* moved_parent = moved_op->parents()[0];
+      PL_ASSIGN_OR_RETURN(GRPCSinkIR * grpc_sink,
+                          moved_plan->CreateNode<GRPCSinkIR>(moved_parent->ast(), moved_parent,
+                                                             next_bridge_id));
+      PL_RETURN_IF_ERROR(grpc_sink->SetResolvedType(moved_parent->resolved_type()));
+      PL_RETURN_IF_ERROR(moved_plan->Prune({op_id}));
+      ++next_bridge_id;
+    }
+    PL_RETURN_IF_ERROR(kelvin_plan->Prune(ops_to_remove_from_kelvin));
+
+    PL_ASSIGN_OR_RETURN(int64_t moved_node_id,
+                        distributed_plan->AddCarnot(remote_processor_nodes_[processor_idx]));
+    CarnotInstance* moved_carnot = distributed_plan->Get(moved_node_id);
+    moved_carnot->AddPlan(moved_plan);
+    distributed_plan->AddPlan(std::move(moved_plan_uptr));
+    for (int64_t source_node_id : source_node_ids) {
+      if (distributed_plan->HasNode(source_node_id)) {
+        distributed_plan->AddEdge(source_node_id, moved_node_id);
+      }
+    }
+    distributed_plan->AddEdge(moved_node_id, kelvin->id());
+    distributed_plan->AddSecondaryKelvin(moved_carnot);
+  }
+  return Status::OK();
+}
+
 /**
  * A mapping of agent IDs to the corresponding plan.
  */
@@ -245,7 +416,13 @@ StatusOr<std::unique_ptr<DistributedPlan>> CoordinatorImpl::CoordinateImpl(const
   auto distributed_plan = std::make_unique<DistributedPlan>();
   PL_ASSIGN_OR_RETURN(int64_t remote_node_id, distributed_plan->AddCarnot(GetRemoteProcessor()));
   // TODO(philkuz) Need to update the Blocking Split Plan to better represent what we expect.
-  // TODO(philkuz) (PL-1469) Future support for grabbing data from multiple Kelvin nodes.
+
+  // New GRPC bridges created after the split need ids that don't collide with the splitter's.
+  int64_t next_bridge_id = 0;
+  for (IRNode* node : split_plan->original_plan->FindNodesThatMatch(GRPCSourceGroup())) {
+    next_bridge_id =
+        std::max(next_bridge_id, static_cast<GRPCSourceGroupIR*>(node)->source_id() + 1);
+  }
 
   PL_ASSIGN_OR_RETURN(std::unique_ptr<IR> remote_plan_uptr, split_plan->original_plan->Clone());
   CarnotInstance* remote_carnot = distributed_plan->Get(remote_node_id);
@@ -285,6 +462,9 @@ StatusOr<std::unique_ptr<DistributedPlan>> CoordinatorImpl::CoordinateImpl(const
   DistributedPruneUnavailableSourcesRule prune_sources_rule(agent_schema_map);
   PL_RETURN_IF_ERROR(prune_sources_rule.Apply(remote_carnot));
 
+  PL_RETURN_IF_ERROR(SpreadKelvinSubplans(distributed_plan.get(), remote_carnot, source_node_ids,
+                                          next_bridge_id));
+
   distributed_plan->SetKelvin(remote_carnot);
   distributed_plan->AddPlanToAgentMap(std::move(agent_to_plan_map.plan_to_agents));
 
@@ -27,6 +27,8 @@
 #include "src/carnot/planner/ir/ir.h"
 #include "src/carnot/planner/ir/pattern_match.h"
 
+DECLARE_bool(planner_spread_kelvin_subplans);
+
 namespace px {
 namespace carnot {
 namespace planner {
@@ -61,6 +63,14 @@ class Coordinator : public NotCopyable {
   Status Init(CompilerState* compiler_state,
               const distributedpb::DistributedState& distributed_state);
 
+  /**
+   * @brief Sets whether independent subplans of the Kelvin plan may run on the other remote
+   * processors. Defaults to --planner_spread_kelvin_subplans.
+   */
+  void SetSpreadKelvinSubplans(bool spread_kelvin_subplans) {
+    spread_kelvin_subplans_ = spread_kelvin_subplans;
+  }
+
  protected:
   Status ProcessConfig(const CarnotInfo& carnot_info);
 
@@ -76,12 +86,19 @@ class Coordinator : public NotCopyable {
   virtual StatusOr<std::unique_ptr<DistributedPlan>> CoordinateImpl(const IR* logical_plan) = 0;
 
   virtual Status ProcessConfigImpl(const CarnotInfo& carnot_info) = 0;
+
+  bool spread_kelvin_subplans_ = FLAGS_planner_spread_kelvin_subplans;
 };
 
 /**
  * @brief This coordinator creates a plan layout with 1 remote processor getting data
  * from N sources. If the passed in plan has special conditions, it will split differntly.
  *
+ * When spreading is enabled, there are several remote processors and the remote plan consists of
+ * independent subplans, the subplans are spread across the remote processors. Only whole subplans
+ * that produce separate results move; a single aggregate or join is not partitioned. The first
+ * remote processor still produces every result, receiving the results of the subplans run
+ * elsewhere over GRPC.
  */
 class CoordinatorImpl : public Coordinator {
  protected:
@@ -94,6 +111,20 @@ class CoordinatorImpl : public Coordinator {
   const distributedpb::CarnotInfo& GetRemoteProcessor() const;
   bool HasExecutableNodes(const IR* plan);
 
+  /**
+   * @brief Moves independent subplans of the Kelvin plan onto the other remote processors. The
+   * result sinks of a moved subplan stay on the original Kelvin, and are fed by a GRPC bridge from
+   * the Kelvin the subplan moved to.
+   *
+   * @param distributed_plan the plan to add the other remote processors to.
+   * @param kelvin the Kelvin that currently runs the whole Kelvin plan.
+   * @param source_node_ids the data store nodes that may send data to the moved subplans.
+   * @param next_bridge_id the first id that isn't used by a GRPC bridge in the plan.
+   * @return Status
+   */
+  Status SpreadKelvinSubplans(DistributedPlan* distributed_plan, CarnotInstance* kelvin,
+                              const std::vector<int64_t>& source_node_ids, int64_t next_bridge_id);
+
   /**
    * @brief Removes the sources and any operators depending on that source. Operators that depend on
    * the source not only means the Transitive dependents, but also any parents of those Transitive
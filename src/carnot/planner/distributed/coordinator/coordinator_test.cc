@@ -169,6 +169,63 @@ TEST_F(CoordinatorTest, one_pem_three_kelvin) {
   }
 }
 
+TEST_F(CoordinatorTest, independent_kelvin_subplans_stay_on_one_kelvin_by_default) {
+  auto ps = LoadDistributedStatePb(kOnePEMThreeKelvinsDistributedState);
+  auto coordinator = Coordinator::Create(compiler_state_.get(), ps).ConsumeValueOrDie();
+
+  compiler_state_->relation_map()->emplace("table", MakeRelation());
+  MakeMemSink(MakeMemSource(MakeRelation()), "out1");
+  MakeMemSink(MakeMemSource(MakeRelation()), "out2");
+  ResolveTypesRule rule(compiler_state_.get());
+  ASSERT_OK(rule.Execute(graph.get()));
+
+  auto physical_plan = coordinator->Coordinate(graph.get()).ConsumeValueOrDie();
+  EXPECT_EQ(physical_plan->dag().nodes().size(), 2UL);
+  EXPECT_EQ(physical_plan->secondary_kelvins().size(), 0UL);
+  EXPECT_EQ(physical_plan->kelvin()->plan()->FindNodesThatMatch(MemorySink()).size(), 2);
+}
+
+TEST_F(CoordinatorTest, independent_kelvin_subplans_spread_across_kelvins) {
+  auto ps = LoadDistributedStatePb(kOnePEMThreeKelvinsDistributedState);
+  auto coordinator = Coordinator::Create(compiler_state_.get(), ps).ConsumeValueOrDie();
+  coordinator->SetSpreadKelvinSubplans(true);
+
+  compiler_state_->relation_map()->emplace("table", MakeRelation());
+  MakeMemSink(MakeMemSource(MakeRelation()), "out1");
+  MakeMemSink(MakeMemSource(MakeRelation()), "out2");
+  ResolveTypesRule rule(compiler_state_.get());
+  ASSERT_OK(rule.Execute(graph.get()));
+
+  auto physical_plan = coordinator->Coordinate(graph.get()).ConsumeValueOrDie();
+  ASSERT_EQ(physical_plan->dag().nodes().size(), 3UL);
+  ASSERT_EQ(physical_plan->secondary_kelvins().size(), 1UL);
+  auto kelvin_instance = physical_plan->kelvin();
+  auto secondary_instance = physical_plan->secondary_kelvins()[0];
+  EXPECT_NE(kelvin_instance->QueryBrokerAddress(), secondary_instance->QueryBrokerAddress());
+
+  // The PEM sends to both Kelvins, and the secondary Kelvin forwards its results.
+  auto pem_instance = physical_plan->Get(1);
+  EXPECT_THAT(pem_instance->carnot_info().query_broker_address(), ContainsRegex("pem"));
+  EXPECT_THAT(physical_plan->dag().DependenciesOf(pem_instance->id()),
+              UnorderedElementsAre(kelvin_instance->id(), secondary_instance->id()));
+  EXPECT_THAT(physical_plan->dag().DependenciesOf(secondary_instance->id()),
+              ElementsAre(kelvin_instance->id()));
+
+  // The Kelvin still produces both results.
+  IR* kelvin_plan = kelvin_instance->plan();
+  EXPECT_EQ(kelvin_plan->FindNodesThatMatch(MemorySink()).size(), 2);
+  EXPECT_EQ(kelvin_plan->FindNodesThatMatch(GRPCSourceGroup()).size(), 2);
+  EXPECT_EQ(kelvin_plan->FindNodesThatMatch(GRPCSink()).size(), 0);
+
+  IR* secondary_plan = secondary_instance->plan();
+  EXPECT_EQ(secondary_plan->FindNodesThatMatch(MemorySink()).size(), 0);
+  auto grpc_src_nodes = secondary_plan->FindNodesThatMatch(GRPCSourceGroup());
+  ASSERT_EQ(grpc_src_nodes.size(), 1);
+  auto grpc_src = static_cast<GRPCSourceGroupIR*>(grpc_src_nodes[0]);
+  ASSERT_EQ(grpc_src->Children().size(), 1);
+  EXPECT_MATCH(grpc_src->Children()[0], InternalGRPCSink());
+}
+
 constexpr char kBadAgentSpecificationState[] = R"proto(
 carnot_info {
   query_broker_address: "pem"
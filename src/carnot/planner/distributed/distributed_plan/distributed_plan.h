@@ -158,11 +158,23 @@ class DistributedPlan {
 
   CarnotInstance* kelvin() const { return kelvin_; }
 
+  /**
+   * @brief Adds a Kelvin that runs part of the Kelvin plan alongside kelvin(). Secondary Kelvins
+   * forward their results to kelvin(), which remains the only Kelvin sending results out.
+   */
+  void AddSecondaryKelvin(CarnotInstance* kelvin) {
+    DCHECK(id_to_node_map_.contains(kelvin->id()));
+    secondary_kelvins_.push_back(kelvin);
+  }
+
+  const std::vector<CarnotInstance*>& secondary_kelvins() const { return secondary_kelvins_; }
+
  private:
   plan::DAG dag_;
   absl::flat_hash_map<int64_t, std::unique_ptr<CarnotInstance>> id_to_node_map_;
   absl::flat_hash_map<IR*, absl::flat_hash_set<int64_t>> plan_to_agent_map_;
   CarnotInstance* kelvin_ = nullptr;
+  std::vector<CarnotInstance*> secondary_kelvins_;
   std::vector<std::unique_ptr<IR>> plan_pool_;
   absl::flat_hash_map<int64_t, IR*> agent_to_plan_map_;
   absl::flat_hash_map<sole::uuid, int64_t> uuid_to_id_map_;
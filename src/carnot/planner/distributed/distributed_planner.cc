@@ -45,28 +45,62 @@ Status StitchPlan(DistributedPlan* distributed_plan) {
   DCHECK(distributed_plan);
   auto remote_carnot = distributed_plan->kelvin();
   DCHECK(remote_carnot);
-  auto remote_node_id = remote_carnot->id();
   IR* remote_plan = remote_carnot->plan();
   DCHECK(remote_plan);
+  std::vector<CarnotInstance*> kelvins = {remote_carnot};
+  kelvins.insert(kelvins.end(), distributed_plan->secondary_kelvins().begin(),
+                 distributed_plan->secondary_kelvins().end());
 
   DistributedSetSourceGroupGRPCAddressRule set_grpc_address_rule;
-  PL_RETURN_IF_ERROR(set_grpc_address_rule.Apply(remote_carnot));
+  for (CarnotInstance* kelvin : kelvins) {
+    PL_RETURN_IF_ERROR(set_grpc_address_rule.Apply(kelvin));
+  }
 
-  // Connect the plans.
+  // Connect the data store plans to the Kelvins that their data stores send data to.
+  const plan::DAG& dag = distributed_plan->dag();
   for (const auto& [plan, agents] : distributed_plan->plan_to_agent_map()) {
-    PL_ASSIGN_OR_RETURN(auto did_connect_plan, AssociateDistributedPlanEdgesRule::ConnectGraphs(
-                                                   plan, agents, remote_plan));
+    absl::flat_hash_set<int64_t> destinations;
+    for (int64_t agent : agents) {
+      for (int64_t destination : dag.DependenciesOf(agent)) {
+        destinations.insert(destination);
+      }
+    }
+    bool did_connect_plan = false;
+    for (int64_t destination : destinations) {
+      PL_ASSIGN_OR_RETURN(auto did_connect_kelvin,
+                          AssociateDistributedPlanEdgesRule::ConnectGraphs(
+                              plan, agents, distributed_plan->Get(destination)->plan()));
+      did_connect_plan |= did_connect_kelvin;
+    }
     DCHECK(did_connect_plan);
   }
 
-  // TODO(philkuz) make this connect to self without a grpc bridge.
-  PL_RETURN_IF_ERROR(
-      AssociateDistributedPlanEdgesRule::ConnectGraphs(remote_plan, {remote_node_id}, remote_plan));
+  // Secondary Kelvins send their data on to other Kelvins, ending at the one that produces the
+  // query results.
+  for (CarnotInstance* kelvin : distributed_plan->secondary_kelvins()) {
+    bool did_connect_plan = false;
+    for (int64_t destination : dag.DependenciesOf(kelvin->id())) {
+      IR* destination_plan = distributed_plan->Get(destination)->plan();
+      PL_ASSIGN_OR_RETURN(auto did_connect_kelvin,
+                          AssociateDistributedPlanEdgesRule::ConnectGraphs(
+                              kelvin->plan(), {kelvin->id()}, destination_plan));
+      did_connect_plan |= did_connect_kelvin;
+    }
+    DCHECK(did_connect_plan);
+  }
 
-  // Expand GRPCSourceGroups in the remote_plan.
-  GRPCSourceGroupConversionRule conversion_rule;
-  PL_RETURN_IF_ERROR(conversion_rule.Execute(remote_plan));
-  return MergeSameNodeGRPCBridgeRule(remote_node_id).Execute(remote_plan).status();
+  for (CarnotInstance* kelvin : kelvins) {
+    // TODO(philkuz) make this connect to self without a grpc bridge.
+    PL_RETURN_IF_ERROR(AssociateDistributedPlanEdgesRule::ConnectGraphs(
+        kelvin->plan(), {kelvin->id()}, kelvin->plan()));
+
+    // Expand GRPCSourceGroups in the Kelvin plan.
+    GRPCSourceGroupConversionRule conversion_rule;
+    PL_RETURN_IF_ERROR(conversion_rule.Execute(kelvin->plan()));
+    MergeSameNodeGRPCBridgeRule merge_rule(kelvin->id(), kelvin->carnot_info().grpc_address());
+    PL_RETURN_IF_ERROR(merge_rule.Execute(kelvin->plan()).status());
+  }
+  return Status::OK();
 }
 
 StatusOr<std::unique_ptr<DistributedPlan>> DistributedPlanner::Plan(
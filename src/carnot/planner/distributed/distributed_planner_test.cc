@@ -20,6 +20,7 @@
 #include <google/protobuf/text_format.h>
 #include <gtest/gtest.h>
 
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -27,6 +28,7 @@
 
 #include "src/carnot/planner/compiler/analyzer/resolve_types_rule.h"
 #include "src/carnot/planner/compiler/test_utils.h"
+#include "src/carnot/planner/distributed/coordinator/coordinator.h"
 #include "src/carnot/planner/distributed/distributed_planner.h"
 #include "src/carnot/planner/ir/ir.h"
 #include "src/carnot/planner/rules/rules.h"
@@ -44,6 +46,7 @@ using ::testing::ContainsRegex;
 using ::testing::ElementsAre;
 using ::testing::UnorderedElementsAreArray;
 using testutils::DistributedRulesTest;
+using testutils::kOnePEMThreeKelvinsDistributedState;
 using testutils::kThreePEMsOneKelvinDistributedState;
 
 constexpr char kOnePEMOneKelvinDistributedState[] = R"proto(
@@ -213,6 +216,63 @@ TEST_F(DistributedPlannerTest, three_agents_one_kelvin) {
   EXPECT_THAT(grpc_sink_destinations, UnorderedElementsAreArray(grpc_source_ids));
 }
 
+TEST_F(DistributedPlannerTest, independent_subplans_on_two_kelvins) {
+  FLAGS_planner_spread_kelvin_subplans = true;
+  compiler_state_->relation_map()->emplace("table", MakeRelation());
+  MakeMemSink(MakeMemSource(MakeRelation()), "out1");
+  MakeMemSink(MakeMemSource(MakeRelation()), "out2");
+
+  ResolveTypesRule rule(compiler_state_.get());
+  ASSERT_OK(rule.Execute(graph.get()));
+
+  distributedpb::DistributedState ps_pb =
+      LoadDistributedStatePb(kOnePEMThreeKelvinsDistributedState);
+  std::unique_ptr<DistributedPlanner> physical_planner =
+      DistributedPlanner::Create().ConsumeValueOrDie();
+  auto physical_plan_or_s = physical_planner->Plan(ps_pb, compiler_state_.get(), graph.get());
+  FLAGS_planner_spread_kelvin_subplans = false;
+  ASSERT_OK(physical_plan_or_s);
+  std::unique_ptr<DistributedPlan> physical_plan = physical_plan_or_s.ConsumeValueOrDie();
+
+  ASSERT_EQ(physical_plan->secondary_kelvins().size(), 1UL);
+  CarnotInstance* kelvin = physical_plan->kelvin();
+  CarnotInstance* secondary_kelvin = physical_plan->secondary_kelvins()[0];
+  const std::string& kelvin_address = kelvin->carnot_info().grpc_address();
+  const std::string& secondary_address = secondary_kelvin->carnot_info().grpc_address();
+  ASSERT_NE(kelvin_address, secondary_address);
+
+  // The PEM sends one table to each Kelvin.
+  auto pem_instance = physical_plan->Get(1);
+  std::vector<std::string> pem_destinations;
+  for (IRNode* node : pem_instance->plan()->FindNodesOfType(IRNodeType::kGRPCSink)) {
+    pem_destinations.push_back(static_cast<GRPCSinkIR*>(node)->destination_address());
+  }
+  EXPECT_THAT(pem_destinations, UnorderedElementsAreArray({kelvin_address, secondary_address}));
+
+  // The secondary Kelvin keeps the bridge to the Kelvin, which is the one producing the results.
+  IR* secondary_plan = secondary_kelvin->plan();
+  EXPECT_EQ(secondary_plan->FindNodesOfType(IRNodeType::kMemorySink).size(), 0);
+  EXPECT_EQ(secondary_plan->FindNodesOfType(IRNodeType::kGRPCSourceGroup).size(), 0);
+  std::vector<IRNode*> secondary_sinks = secondary_plan->FindNodesOfType(IRNodeType::kGRPCSink);
+  ASSERT_EQ(secondary_sinks.size(), 1);
+  auto secondary_sink = static_cast<GRPCSinkIR*>(secondary_sinks[0]);
+  EXPECT_EQ(secondary_sink->destination_address(), kelvin_address);
+
+  IR* kelvin_plan = kelvin->plan();
+  EXPECT_EQ(kelvin_plan->FindNodesOfType(IRNodeType::kMemorySink).size(), 2);
+  EXPECT_EQ(kelvin_plan->FindNodesOfType(IRNodeType::kGRPCSink).size(), 0);
+  EXPECT_EQ(kelvin_plan->FindNodesOfType(IRNodeType::kGRPCSourceGroup).size(), 0);
+  std::vector<int64_t> kelvin_source_ids;
+  for (IRNode* node : kelvin_plan->FindNodesOfType(IRNodeType::kGRPCSource)) {
+    kelvin_source_ids.push_back(node->id());
+  }
+  ASSERT_EQ(kelvin_source_ids.size(), 2);
+  ASSERT_TRUE(secondary_sink->agent_id_to_destination_id().contains(secondary_kelvin->id()));
+  EXPECT_THAT(kelvin_source_ids,
+              ::testing::Contains(
+                  secondary_sink->agent_id_to_destination_id().at(secondary_kelvin->id())));
+}
+
 using DistributedPlannerUDTFTests = DistributedRulesTest;
 TEST_F(DistributedPlannerUDTFTests, UDTFOnlyOnPEMsDoesntRunOnKelvin) {
   uint32_t asid = 123;
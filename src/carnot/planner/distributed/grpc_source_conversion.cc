@@ -109,6 +109,10 @@ StatusOr<bool> MergeSameNodeGRPCBridgeRule::Apply(IRNode* ir_node) {
     return false;
   }
   GRPCSinkIR* grpc_sink = static_cast<GRPCSinkIR*>(ir_node);
+  if (!current_grpc_address_.empty() &&
+      grpc_sink->destination_address() != current_grpc_address_) {
+    return false;
+  }
   DCHECK(grpc_sink->agent_id_to_destination_id().contains(current_agent_id_))
       << "Expected the grpc sink to contain this current agent ID as a a target";
   int64_t dest_id = grpc_sink->agent_id_to_destination_id().at(current_agent_id_);
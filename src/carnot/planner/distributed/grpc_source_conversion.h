@@ -72,11 +72,19 @@ class MergeSameNodeGRPCBridgeRule : public Rule {
       : Rule(nullptr, /*use_topo*/ false, /*reverse_topological_execution*/ false),
         current_agent_id_(current_agent_id) {}
 
+  // Only merges the bridges whose GRPCSink sends to current_grpc_address, leaving the bridges to
+  // other nodes in place.
+  MergeSameNodeGRPCBridgeRule(int64_t current_agent_id, const std::string& current_grpc_address)
+      : Rule(nullptr, /*use_topo*/ false, /*reverse_topological_execution*/ false),
+        current_agent_id_(current_agent_id),
+        current_grpc_address_(current_grpc_address) {}
+
  protected:
   StatusOr<bool> Apply(IRNode* ir_node) override;
 
  private:
   int64_t current_agent_id_;
+  std::string current_grpc_address_;
 };
 
 }  // namespace distributed
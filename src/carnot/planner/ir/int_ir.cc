@@ -41,6 +41,7 @@ Status IntIR::Init(int64_t val) {
 Status IntIR::CopyFromNodeImpl(const IRNode* node, absl::flat_hash_map<const IRNode*, IRNode*>*) {
   const IntIR* int_ir = static_cast<const IntIR*>(node);
   val_ = int_ir->val_;
+  relative_to_now_ = int_ir->relative_to_now_;
   return Status::OK();
 }
 
@@ -42,6 +42,11 @@ class IntIR : public DataIR {
   Status Init(int64_t val);
 
   int64_t val() const { return val_; }
+  // Whether the value was computed from the current time, eg. `px.now() - px.minutes(5)`.
+  // PlanCache moves such values forward when it reuses a plan.
+  bool relative_to_now() const { return relative_to_now_; }
+  void set_relative_to_now(bool relative_to_now) { relative_to_now_ = relative_to_now; }
+  void ShiftRelativeTime(int64_t delta_ns) { val_ += delta_ns; }
   Status CopyFromNodeImpl(const IRNode* node,
                           absl::flat_hash_map<const IRNode*, IRNode*>* copied_nodes_map) override;
 
@@ -65,6 +70,7 @@ class IntIR : public DataIR {
 
  private:
   int64_t val_;
+  bool relative_to_now_ = false;
 };
 
 }  // namespace planner
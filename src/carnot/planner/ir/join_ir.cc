@@ -16,6 +16,7 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 #include <map>
+#include <utility>
 
 #include "src/carnot/planner/ir/column_ir.h"
 #include "src/carnot/planner/ir/ir.h"
@@ -51,6 +52,29 @@ Status JoinIR::CopyFromNodeImpl(const IRNode* node,
 
   PL_RETURN_IF_ERROR(SetJoinColumns(new_left_columns, new_right_columns));
   suffix_strs_ = join_node->suffix_strs_;
+  specified_as_right_ = join_node->specified_as_right_;
+  return Status::OK();
+}
+
+Status JoinIR::SwapParents() {
+  DCHECK_EQ(parents().size(), 2UL) << "There should be exactly two parents.";
+  std::vector<OperatorIR*> old_parents = parents();
+  for (OperatorIR* parent : old_parents) {
+    PL_RETURN_IF_ERROR(RemoveParent(parent));
+  }
+  PL_RETURN_IF_ERROR(AddParent(old_parents[1]));
+  PL_RETURN_IF_ERROR(AddParent(old_parents[0]));
+
+  for (auto* columns : {&left_on_columns_, &right_on_columns_, &output_columns_}) {
+    for (ColumnIR* col : *columns) {
+      DCHECK_LT(col->container_op_parent_idx(), 2);
+      col->SetContainingOperatorParentIdx(1 - col->container_op_parent_idx());
+    }
+  }
+  if (suffix_strs_.size() == 2) {
+    std::swap(suffix_strs_[0], suffix_strs_[1]);
+  }
+  specified_as_right_ = !specified_as_right_;
   return Status::OK();
 }
 
@@ -92,8 +116,15 @@ Status JoinIR::ToProto(planpb::Operator* op) const {
   pb->set_type(join_enum_type);
   for (int64_t i = 0; i < static_cast<int64_t>(left_on_columns_.size()); i++) {
     auto eq_condition = pb->add_equality_conditions();
-    PL_ASSIGN_OR_RETURN(auto left_index, left_on_columns_[i]->GetColumnIndex());
-    PL_ASSIGN_OR_RETURN(auto right_index, right_on_columns_[i]->GetColumnIndex());
+    // The equality conditions index into parent 0 and parent 1, which are not the user's left and
+    // right parents once the parents have been swapped.
+    ColumnIR* left_col = left_on_columns_[i];
+    ColumnIR* right_col = right_on_columns_[i];
+    if (left_col->container_op_parent_idx() == 1) {
+      std::swap(left_col, right_col);
+    }
+    PL_ASSIGN_OR_RETURN(auto left_index, left_col->GetColumnIndex());
+    PL_ASSIGN_OR_RETURN(auto right_index, right_col->GetColumnIndex());
     eq_condition->set_left_column_index(left_index);
     eq_condition->set_right_column_index(right_index);
   }
@@ -90,6 +90,14 @@ class JoinIR : public OperatorIR {
                           const std::vector<ColumnIR*>& columns);
   bool specified_as_right() const { return specified_as_right_; }
 
+  /**
+   * @brief Swaps the two parents of the join, keeping the output of the join the same. The
+   * executor builds its hash table from parent 0 and probes it with parent 1, so this switches the
+   * build and probe sides. The join columns, suffixes and left/right bookkeeping are all updated to
+   * refer to the new parent order.
+   */
+  Status SwapParents();
+
   StatusOr<std::vector<absl::flat_hash_set<std::string>>> RequiredInputColumns() const override;
 
   const std::tuple<std::shared_ptr<TableType>, std::shared_ptr<TableType>> left_right_table_types()
@@ -130,6 +130,8 @@ Status MemorySourceIR::CopyFromNodeImpl(
   time_set_ = source_ir->time_set_;
   time_start_ns_ = source_ir->time_start_ns_;
   time_stop_ns_ = source_ir->time_stop_ns_;
+  time_start_relative_to_now_ = source_ir->time_start_relative_to_now_;
+  time_stop_relative_to_now_ = source_ir->time_stop_relative_to_now_;
   column_names_ = source_ir->column_names_;
   column_index_map_set_ = source_ir->column_index_map_set_;
   column_index_map_ = source_ir->column_index_map_;
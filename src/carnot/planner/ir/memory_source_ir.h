@@ -78,9 +78,29 @@ class MemorySourceIR : public OperatorIR {
    * source look at all data.
    *
    */
-  void ClearTimeNS() { time_set_ = false; }
+  void ClearTimeNS() {
+    time_set_ = false;
+    SetTimesRelativeToNow(false, false);
+  }
   bool IsTimeSet() const { return time_set_; }
 
+  // Whether the start and stop times were computed from the current time, eg.
+  // `start_time='-5m'`. PlanCache moves such times forward when it reuses a plan.
+  void SetTimesRelativeToNow(bool start_relative, bool stop_relative) {
+    time_start_relative_to_now_ = start_relative;
+    time_stop_relative_to_now_ = stop_relative;
+  }
+  bool time_start_relative_to_now() const { return time_start_relative_to_now_; }
+  bool time_stop_relative_to_now() const { return time_stop_relative_to_now_; }
+  void ShiftRelativeTimes(int64_t delta_ns) {
+    if (time_start_relative_to_now_) {
+      time_start_ns_ += delta_ns;
+    }
+    if (time_stop_relative_to_now_) {
+      time_stop_ns_ += delta_ns;
+    }
+  }
+
   std::string DebugString() const override;
 
   int64_t time_start_ns() const { return time_start_ns_; }
@@ -136,6 +156,8 @@ class MemorySourceIR : public OperatorIR {
   bool time_set_ = false;
   int64_t time_start_ns_ = 0;
   int64_t time_stop_ns_ = 0;
+  bool time_start_relative_to_now_ = false;
+  bool time_stop_relative_to_now_ = false;
 
   // Hold of columns in the order that they are selected.
   std::vector<std::string> column_names_;
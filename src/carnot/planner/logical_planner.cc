@@ -18,7 +18,11 @@
 
 #include "src/carnot/planner/logical_planner.h"
 
+#include <memory>
+#include <mutex>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "src/shared/scriptspb/scripts.pb.h"
 
@@ -50,6 +54,18 @@ StatusOr<std::unique_ptr<RelationMap>> MakeRelationMapFromDistributedState(
   return rel_map;
 }
 
+TableStatsMap MakeTableStatsFromDistributedState(
+    const distributedpb::DistributedState& state_pb) {
+  TableStatsMap table_stats;
+  for (const auto& schema_info : state_pb.schema_info()) {
+    if (!schema_info.has_stats()) {
+      continue;
+    }
+    table_stats[schema_info.name()].num_rows = schema_info.stats().num_rows();
+  }
+  return table_stats;
+}
+
 static inline RedactionOptions RedactionOptionsFromPb(
     const distributedpb::RedactionOptions& redaction_options) {
   RedactionOptions options;
@@ -60,7 +76,7 @@ static inline RedactionOptions RedactionOptionsFromPb(
 
 StatusOr<std::unique_ptr<CompilerState>> CreateCompilerState(
     const distributedpb::LogicalPlannerState& logical_state, RegistryInfo* registry_info,
-    int64_t max_output_rows_per_table) {
+    int64_t max_output_rows_per_table, int64_t time_now_ns) {
   PL_ASSIGN_OR_RETURN(std::unique_ptr<RelationMap> rel_map,
                       MakeRelationMapFromDistributedState(logical_state.distributed_state()));
 
@@ -73,11 +89,14 @@ StatusOr<std::unique_ptr<CompilerState>> CreateCompilerState(
       {"pgsql_events", {"req", "resp"}},
       {"redis_events", {"req_args", "resp"}}};
   // Create a CompilerState obj using the relation map and grabbing the current time.
-  return std::make_unique<planner::CompilerState>(
-      std::move(rel_map), sensitive_columns, registry_info, px::CurrentTimeNS(),
+  auto compiler_state = std::make_unique<planner::CompilerState>(
+      std::move(rel_map), sensitive_columns, registry_info, time_now_ns,
       max_output_rows_per_table, logical_state.result_address(),
       logical_state.result_ssl_targetname(),
       RedactionOptionsFromPb(logical_state.redaction_options()));
+  compiler_state->set_table_stats(
+      MakeTableStatsFromDistributedState(logical_state.distributed_state()));
+  return compiler_state;
 }
 
 StatusOr<std::unique_ptr<LogicalPlanner>> LogicalPlanner::Create(const udfspb::UDFInfo& udf_info) {
@@ -90,6 +109,8 @@ Status LogicalPlanner::Init(const udfspb::UDFInfo& udf_info) {
   compiler_ = compiler::Compiler();
   registry_info_ = std::make_unique<planner::RegistryInfo>();
   PL_RETURN_IF_ERROR(registry_info_->Init(udf_info));
+  // The cached plans were compiled against the previous registry.
+  plan_cache_.Clear();
 
   PL_ASSIGN_OR_RETURN(distributed_planner_, distributed::DistributedPlanner::Create());
   return Status::OK();
@@ -98,20 +119,32 @@ Status LogicalPlanner::Init(const udfspb::UDFInfo& udf_info) {
 StatusOr<std::unique_ptr<distributed::DistributedPlan>> LogicalPlanner::Plan(
     const distributedpb::LogicalPlannerState& logical_state,
     const plannerpb::QueryRequest& query_request) {
-  // Compile into the IR.
-  auto ms = logical_state.plan_options().max_output_rows_per_table();
-  VLOG(1) << "Max output rows: " << ms;
-  PL_ASSIGN_OR_RETURN(std::unique_ptr<CompilerState> compiler_state,
-                      CreateCompilerState(logical_state, registry_info_.get(), ms));
+  int64_t time_now_ns = px::CurrentTimeNS();
+  std::string cache_key = PlanCache::Key(logical_state, query_request);
+  std::shared_ptr<PlanCache::Entry> compiled = plan_cache_.Get(cache_key, time_now_ns);
+  if (compiled == nullptr) {
+    // Compile into the IR.
+    auto ms = logical_state.plan_options().max_output_rows_per_table();
+    VLOG(1) << "Max output rows: " << ms;
+    compiled = std::make_shared<PlanCache::Entry>();
+    compiled->time_now_ns = time_now_ns;
+    PL_ASSIGN_OR_RETURN(
+        compiled->compiler_state,
+        CreateCompilerState(logical_state, registry_info_.get(), ms, time_now_ns));
+
+    std::vector<plannerpb::FuncToExecute> exec_funcs(query_request.exec_funcs().begin(),
+                                                     query_request.exec_funcs().end());
+    PL_ASSIGN_OR_RETURN(compiled->plan,
+                        compiler_.CompileToIR(query_request.query_str(),
+                                              compiled->compiler_state.get(), exec_funcs));
+    plan_cache_.Insert(cache_key, compiled);
+  }
 
-  std::vector<plannerpb::FuncToExecute> exec_funcs(query_request.exec_funcs().begin(),
-                                                   query_request.exec_funcs().end());
-  PL_ASSIGN_OR_RETURN(
-      std::shared_ptr<IR> single_node_plan,
-      compiler_.CompileToIR(query_request.query_str(), compiler_state.get(), exec_funcs));
   // Create the distributed plan.
-  return distributed_planner_->Plan(logical_state.distributed_state(), compiler_state.get(),
-                                    single_node_plan.get());
+  std::lock_guard<std::mutex> lock(compiled->mutex);
+  PL_RETURN_IF_ERROR(PlanCache::ResolveTimeNow(compiled.get(), time_now_ns));
+  return distributed_planner_->Plan(logical_state.distributed_state(),
+                                    compiled->compiler_state.get(), compiled->plan.get());
 }
 
 StatusOr<std::unique_ptr<compiler::MutationsIR>> LogicalPlanner::CompileTrace(
@@ -121,7 +154,8 @@ StatusOr<std::unique_ptr<compiler::MutationsIR>> LogicalPlanner::CompileTrace(
   auto ms = logical_state.plan_options().max_output_rows_per_table();
   VLOG(1) << "Max output rows: " << ms;
   PL_ASSIGN_OR_RETURN(std::unique_ptr<CompilerState> compiler_state,
-                      CreateCompilerState(logical_state, registry_info_.get(), ms));
+                      CreateCompilerState(logical_state, registry_info_.get(), ms,
+                                          px::CurrentTimeNS()));
 
   std::vector<plannerpb::FuncToExecute> exec_funcs(mutations_req.exec_funcs().begin(),
                                                    mutations_req.exec_funcs().end());
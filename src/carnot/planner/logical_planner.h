@@ -25,6 +25,7 @@
 #include "src/carnot/planner/compiler_state/compiler_state.h"
 #include "src/carnot/planner/distributed/distributed_plan/distributed_plan.h"
 #include "src/carnot/planner/distributed/distributed_planner.h"
+#include "src/carnot/planner/plan_cache.h"
 #include "src/carnot/planner/plannerpb/func_args.pb.h"
 #include "src/carnot/planner/probes/probes.h"
 #include "src/shared/scriptspb/scripts.pb.h"
@@ -48,7 +49,8 @@ class LogicalPlanner : public NotCopyable {
   static StatusOr<std::unique_ptr<LogicalPlanner>> Create(const udfspb::UDFInfo& udf_info);
 
   /**
-   * @brief Takes in a logical plan and outputs the distributed plan.
+   * @brief Takes in a logical plan and outputs the distributed plan. The compiled plans of recent
+   * queries are cached, so that planning a script again only redoes the distributed planning.
    *
    * @param logical_state: the distributed layout of the vizier instance.
    * @param query: QueryRequest
@@ -65,6 +67,8 @@ class LogicalPlanner : public NotCopyable {
   Status Init(std::unique_ptr<planner::RegistryInfo> registry_info);
   Status Init(const udfspb::UDFInfo& udf_info);
 
+  const PlanCache& plan_cache() const { return plan_cache_; }
+
  protected:
   LogicalPlanner() {}
 
@@ -72,6 +76,7 @@ class LogicalPlanner : public NotCopyable {
   compiler::Compiler compiler_;
   std::unique_ptr<distributed::Planner> distributed_planner_;
   std::unique_ptr<planner::RegistryInfo> registry_info_;
+  PlanCache plan_cache_;
 };
 
 }  // namespace planner
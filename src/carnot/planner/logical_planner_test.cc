@@ -71,12 +71,52 @@ TEST_F(LogicalPlannerTest, distributed_plan_test_basic_queries) {
   EXPECT_OK(plan->ToProto());
 }
 
+TEST_F(LogicalPlannerTest, plans_from_cache) {
+  auto planner = LogicalPlanner::Create(info_).ConsumeValueOrDie();
+  auto query = MakeQueryRequest("import px\npx.display(px.DataFrame('table1'), 'out')");
+  auto plan1 = planner->Plan(testutils::CreateOnePEMOneKelvinPlannerState(), query);
+  ASSERT_OK(plan1);
+  EXPECT_EQ(0, planner->plan_cache().stats().hits);
+
+  // The cached plan is coordinated again for the current agents.
+  auto plan2 = planner->Plan(testutils::CreateTwoPEMsOneKelvinPlannerState(), query);
+  ASSERT_OK(plan2);
+  EXPECT_EQ(1, planner->plan_cache().stats().hits);
+  EXPECT_EQ(plan1.ConsumeValueOrDie()->dag().nodes().size() + 1,
+            plan2.ConsumeValueOrDie()->dag().nodes().size());
+}
+
 constexpr char kSimpleQueryDefaultLimit[] = R"pxl(
 import px
 t1 = px.DataFrame(table='http_events', start_time='-120s', select=['time_'])
 px.display(t1)
 )pxl";
 
+int64_t MemorySourceStartTime(distributed::DistributedPlan* plan) {
+  for (int64_t id : plan->dag().TopologicalSort()) {
+    for (IRNode* node : plan->Get(id)->plan()->FindNodesOfType(IRNodeType::kMemorySource)) {
+      return static_cast<MemorySourceIR*>(node)->time_start_ns();
+    }
+  }
+  return 0;
+}
+
+TEST_F(LogicalPlannerTest, cached_plans_resolve_relative_times) {
+  auto planner = LogicalPlanner::Create(info_).ConsumeValueOrDie();
+  auto state = testutils::CreateTwoPEMsOneKelvinPlannerState(testutils::kHttpEventsSchema);
+  auto query = MakeQueryRequest(kSimpleQueryDefaultLimit);
+  auto plan1 = planner->Plan(state, query).ConsumeValueOrDie();
+  int64_t start_time1 = MemorySourceStartTime(plan1.get());
+  auto plan2 = planner->Plan(state, query).ConsumeValueOrDie();
+  int64_t start_time2 = MemorySourceStartTime(plan2.get());
+
+  // start_time='-120s' is moved to the time of the second query rather than expiring the plan.
+  EXPECT_EQ(1, planner->plan_cache().stats().hits);
+  EXPECT_GT(start_time1, 0);
+  EXPECT_LT(start_time1, start_time2);
+  EXPECT_EQ(start_time1, MemorySourceStartTime(plan1.get()));
+}
+
 TEST_F(LogicalPlannerTest, max_output_rows) {
   auto planner = LogicalPlanner::Create(info_).ConsumeValueOrDie();
   auto state = testutils::CreateTwoPEMsOneKelvinPlannerState(testutils::kHttpEventsSchema);
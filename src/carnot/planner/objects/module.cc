@@ -31,6 +31,13 @@ StatusOr<std::shared_ptr<Module>> Module::Create(std::string_view module_text,
   return module;
 }
 
+StatusOr<std::shared_ptr<Module>> Module::Create(const pypa::AstModulePtr& ast,
+                                                 ASTVisitor* visitor) {
+  std::shared_ptr<Module> module(new Module(visitor));
+  PL_RETURN_IF_ERROR(module->Init(ast));
+  return module;
+}
+
 StatusOr<std::shared_ptr<QLObject>> Module::GetAttributeImpl(const pypa::AstPtr& ast,
                                                              std::string_view name) const {
   if (!var_table_->HasVariable(name)) {
@@ -43,6 +50,10 @@ Status Module::Init(std::string_view module_text) {
   Parser parser;
   PL_ASSIGN_OR_RETURN(pypa::AstModulePtr ast,
                       parser.Parse(module_text.data(), /* parse_doc_strings */ true));
+  return Init(ast);
+}
+
+Status Module::Init(const pypa::AstModulePtr& ast) {
   var_table_ = VarTable::Create();
   module_visitor_ = ast_visitor()->CreateModuleVisitor(var_table_);
   PL_RETURN_IF_ERROR(module_visitor_->ProcessModuleNode(ast));
@@ -54,12 +54,24 @@ class Module : public QLObject {
   static StatusOr<std::shared_ptr<Module>> Create(std::string_view module_text,
                                                   ASTVisitor* visitor);
 
+  /**
+   * @brief Create from an already parsed module, so that modules used by every compilation only
+   * need to be parsed once.
+   *
+   * @param ast the parsed module text, which is not modified.
+   * @param visitor
+   * @return StatusOr<std::shared_ptr<Module>>
+   */
+  static StatusOr<std::shared_ptr<Module>> Create(const pypa::AstModulePtr& ast,
+                                                  ASTVisitor* visitor);
+
  protected:
   explicit Module(ASTVisitor* visitor) : QLObject(ModuleType, visitor) {}
   StatusOr<std::shared_ptr<QLObject>> GetAttributeImpl(const pypa::AstPtr& ast,
                                                        std::string_view name) const override;
 
   Status Init(std::string_view module_text);
+  Status Init(const pypa::AstModulePtr& ast);
   bool HasNonMethodAttribute(std::string_view /* name */) const override { return true; }
 
  private:
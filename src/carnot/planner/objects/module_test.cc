@@ -23,6 +23,7 @@
 
 #include "src/carnot/planner/objects/module.h"
 #include "src/carnot/planner/objects/test_utils.h"
+#include "src/carnot/planner/parser/parser.h"
 
 namespace px {
 namespace carnot {
@@ -82,6 +83,20 @@ TEST_F(ModuleTest, load_and_use_modules) {
   EXPECT_MATCH(free_var_obj->node(), String("imfree"));
 }
 
+TEST_F(ModuleTest, create_from_parsed_module) {
+  Parser parser;
+  ASSERT_OK_AND_ASSIGN(pypa::AstModulePtr module_ast, parser.Parse(kModulePxl));
+
+  // The same AST can back several modules.
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_OK_AND_ASSIGN(std::shared_ptr<Module> module,
+                         Module::Create(module_ast, ast_visitor.get()));
+    ASSERT_OK_AND_ASSIGN(auto funcs, module->GetMethod("funcs"));
+    ASSERT_OK_AND_ASSIGN(auto union_obj, funcs->Call({}, ast));
+    EXPECT_MATCH(union_obj->node(), Union());
+  }
+}
+
 }  // namespace compiler
 }  // namespace planner
 }  // namespace carnot
@@ -201,7 +201,8 @@ Status PixieModule::RegisterUDTFs() {
 StatusOr<QLObjectPtr> NowEval(CompilerState* compiler_state, IR* graph, const pypa::AstPtr& ast,
                               const ParsedArgs&, ASTVisitor* visitor) {
   PL_ASSIGN_OR_RETURN(IntIR * time_now,
-                      graph->CreateNode<IntIR>(ast, compiler_state->time_now().val));
+                      graph->CreateNode<IntIR>(ast, compiler_state->relative_time_now().val));
+  time_now->set_relative_to_now(true);
   return ExprObject::Create(time_now, visitor);
 }
 
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/planner/plan_cache.h"
+
+#include <string_view>
+#include <utility>
+
+#include <absl/strings/str_cat.h>
+
+#include "src/carnot/planner/ir/pattern_match.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+
+namespace {
+
+// Length prefixes keep the key unambiguous, eg. a script can't run into the arguments.
+void AppendKeyPart(std::string_view part, std::string* key) {
+  absl::StrAppend(key, part.size(), ":", part);
+}
+
+int64_t SizeClass(int64_t num_rows) {
+  int64_t size_class = 0;
+  for (; num_rows >= 10; num_rows /= 10) {
+    ++size_class;
+  }
+  return size_class;
+}
+
+}  // namespace
+
+std::string PlanCache::Key(const distributedpb::LogicalPlannerState& logical_state,
+                           const plannerpb::QueryRequest& query_request) {
+  std::string key;
+  AppendKeyPart(query_request.SerializeAsString(), &key);
+  // Only the schemas matter for compilation; the agents that have them only matter for the
+  // distributed planning step, which runs for every query.
+  for (const auto& schema_info : logical_state.distributed_state().schema_info()) {
+    AppendKeyPart(schema_info.name(), &key);
+    AppendKeyPart(schema_info.relation().SerializeAsString(), &key);
+    // Table sizes only pick between equivalent plans, so a plan is reused until the size of a
+    // table changes by an order of magnitude.
+    if (schema_info.has_stats()) {
+      AppendKeyPart(absl::StrCat(SizeClass(schema_info.stats().num_rows())), &key);
+    }
+  }
+  AppendKeyPart(absl::StrCat(logical_state.plan_options().max_output_rows_per_table()), &key);
+  AppendKeyPart(logical_state.result_address(), &key);
+  AppendKeyPart(logical_state.result_ssl_targetname(), &key);
+  AppendKeyPart(logical_state.redaction_options().SerializeAsString(), &key);
+  return key;
+}
+
+std::shared_ptr<PlanCache::Entry> PlanCache::Get(const std::string& key, int64_t time_now_ns) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    ++stats_.misses;
+    return nullptr;
+  }
+  auto entry_it = it->second;
+  const Entry& entry = *entry_it->second;
+  if (entry.compiler_state->time_now_used() &&
+      time_now_ns - entry.time_now_ns > opts_.max_time_skew.count()) {
+    index_.erase(it);
+    entries_.erase(entry_it);
+    ++stats_.misses;
+    return nullptr;
+  }
+  entries_.splice(entries_.begin(), entries_, entry_it);
+  ++stats_.hits;
+  return entry_it->second;
+}
+
+Status PlanCache::ResolveTimeNow(Entry* entry, int64_t time_now_ns) {
+  // Plans that are tied to their compile time are used as is while they are in the cache.
+  if (entry->compiler_state->time_now_used()) {
+    return Status::OK();
+  }
+  int64_t delta_ns = time_now_ns - entry->time_now_ns;
+  if (delta_ns == 0) {
+    return Status::OK();
+  }
+  for (int64_t id : entry->plan->dag().nodes()) {
+    IRNode* node = entry->plan->Get(id);
+    if (Match(node, Int())) {
+      auto int_node = static_cast<IntIR*>(node);
+      if (int_node->relative_to_now()) {
+        int_node->ShiftRelativeTime(delta_ns);
+      }
+    } else if (Match(node, MemorySource())) {
+      static_cast<MemorySourceIR*>(node)->ShiftRelativeTimes(delta_ns);
+    }
+  }
+  entry->compiler_state->set_time_now(time_now_ns);
+  entry->time_now_ns = time_now_ns;
+  return Status::OK();
+}
+
+void PlanCache::Insert(const std::string& key, std::shared_ptr<Entry> entry) {
+  if (opts_.capacity == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    it->second->second = std::move(entry);
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return;
+  }
+  if (entries_.size() >= opts_.capacity) {
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+  entries_.emplace_front(key, std::move(entry));
+  index_[key] = entries_.begin();
+}
+
+void PlanCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  index_.clear();
+  entries_.clear();
+}
+
+size_t PlanCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include <absl/container/flat_hash_map.h>
+
+#include "src/carnot/planner/compiler_state/compiler_state.h"
+#include "src/carnot/planner/distributedpb/distributed_plan.pb.h"
+#include "src/carnot/planner/ir/ir.h"
+#include "src/carnot/planner/plannerpb/func_args.pb.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+
+/**
+ * @brief PlanCache keeps the compiled single node plans of recently planned queries. Planning the
+ * same script again, with the same arguments, schemas and options, then only needs the
+ * distributed planning step, which depends on the agents that are currently up.
+ *
+ * The current time is a parameter of the cached plans: times relative to now, eg. from
+ * `start_time='-5m'` or `px.now()`, are marked in the IR and moved to the current time by
+ * ResolveTimeNow() whenever a plan is reused. Plans that used the time in any other way are only
+ * reused within max_time_skew of when they were compiled. The registry isn't part of the key, so
+ * the cache must be cleared when the registry changes.
+ */
+class PlanCache : public NotCopyable {
+ public:
+  struct Options {
+    size_t capacity = 256;
+    // How long plans that depend on the current time in ways that can't be re-resolved are kept.
+    std::chrono::nanoseconds max_time_skew = std::chrono::seconds{1};
+  };
+
+  struct Entry {
+    // The time the plan's times relative to now are currently resolved to.
+    int64_t time_now_ns = 0;
+    std::unique_ptr<CompilerState> compiler_state;
+    std::shared_ptr<IR> plan;
+    // Distributed planning can update the compiler state, so only one caller may use an entry at a
+    // time.
+    std::mutex mutex;
+  };
+
+  struct Stats {
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+  };
+
+  PlanCache() : PlanCache(Options{}) {}
+  explicit PlanCache(const Options& opts) : opts_(opts) {}
+
+  /**
+   * @brief Returns the cache key of a query. The key covers everything that compilation depends
+   * on other than the registry and the current time.
+   */
+  static std::string Key(const distributedpb::LogicalPlannerState& logical_state,
+                         const plannerpb::QueryRequest& query_request);
+
+  /**
+   * @brief Returns the entry for the key, or nullptr if there isn't one that is still valid at
+   * time_now_ns.
+   */
+  std::shared_ptr<Entry> Get(const std::string& key, int64_t time_now_ns);
+
+  /**
+   * @brief Moves the times relative to now in the entry's plan to time_now_ns. The caller must
+   * hold the entry's mutex.
+   */
+  static Status ResolveTimeNow(Entry* entry, int64_t time_now_ns);
+
+  /**
+   * @brief Adds an entry, evicting the least recently used one if the cache is full.
+   */
+  void Insert(const std::string& key, std::shared_ptr<Entry> entry);
+
+  void Clear();
+  size_t size() const;
+  const Stats& stats() const { return stats_; }
+
+ private:
+  using EntryList = std::list<std::pair<std::string, std::shared_ptr<Entry>>>;
+
+  const Options opts_;
+  mutable std::mutex mutex_;
+  // Ordered from the most to the least recently used.
+  EntryList entries_;
+  absl::flat_hash_map<std::string, EntryList::iterator> index_;
+  Stats stats_;
+};
+
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+#include "src/carnot/planner/plan_cache.h"
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+
+std::shared_ptr<PlanCache::Entry> MakeEntry(int64_t time_now_ns, bool read_time_now) {
+  auto entry = std::make_shared<PlanCache::Entry>();
+  entry->time_now_ns = time_now_ns;
+  entry->compiler_state = std::make_unique<CompilerState>(
+      std::make_unique<RelationMap>(), /* registry_info */ nullptr, time_now_ns, "result:1234");
+  if (read_time_now) {
+    entry->compiler_state->time_now();
+  }
+  entry->plan = std::make_shared<IR>();
+  return entry;
+}
+
+plannerpb::QueryRequest MakeQueryRequest(const std::string& query) {
+  plannerpb::QueryRequest query_request;
+  query_request.set_query_str(query);
+  return query_request;
+}
+
+TEST(PlanCacheTest, key_covers_compilation_inputs) {
+  distributedpb::LogicalPlannerState state;
+  auto schema_info = state.mutable_distributed_state()->add_schema_info();
+  schema_info->set_name("table1");
+  auto query = MakeQueryRequest("import px\npx.display(px.DataFrame('table1'))");
+  std::string key = PlanCache::Key(state, query);
+
+  // The agents that have a schema don't change the compiled plan.
+  distributedpb::LogicalPlannerState more_agents = state;
+  more_agents.mutable_distributed_state()->add_carnot_info()->set_query_broker_address("pem");
+  EXPECT_EQ(key, PlanCache::Key(more_agents, query));
+
+  auto query_with_args = query;
+  query_with_args.add_exec_funcs()->set_func_name("f");
+  EXPECT_NE(key, PlanCache::Key(state, query_with_args));
+
+  distributedpb::LogicalPlannerState other_schema = state;
+  other_schema.mutable_distributed_state()->mutable_schema_info(0)->set_name("table2");
+  EXPECT_NE(key, PlanCache::Key(other_schema, query));
+
+  distributedpb::LogicalPlannerState other_limit = state;
+  other_limit.mutable_plan_options()->set_max_output_rows_per_table(10);
+  EXPECT_NE(key, PlanCache::Key(other_limit, query));
+}
+
+TEST(PlanCacheTest, plans_tied_to_compile_time_expire) {
+  PlanCache::Options opts;
+  opts.max_time_skew = std::chrono::nanoseconds{100};
+  PlanCache cache(opts);
+  cache.Insert("resolvable", MakeEntry(1000, /* read_time_now */ false));
+  cache.Insert("tied", MakeEntry(1000, /* read_time_now */ true));
+
+  EXPECT_NE(nullptr, cache.Get("tied", 1100));
+  EXPECT_EQ(nullptr, cache.Get("tied", 1101));
+  EXPECT_NE(nullptr, cache.Get("resolvable", 1000000));
+  EXPECT_EQ(nullptr, cache.Get("missing", 1000));
+  EXPECT_EQ(2, cache.stats().hits);
+  EXPECT_EQ(2, cache.stats().misses);
+  EXPECT_EQ(1, cache.size());
+}
+
+TEST(PlanCacheTest, resolves_times_relative_to_now) {
+  auto entry = MakeEntry(1000, /* read_time_now */ false);
+  auto ast = std::make_shared<pypa::Ast>(pypa::AstType::Bool);
+  IntIR* relative = entry->plan->CreateNode<IntIR>(ast, 900).ConsumeValueOrDie();
+  relative->set_relative_to_now(true);
+  IntIR* absolute = entry->plan->CreateNode<IntIR>(ast, 900).ConsumeValueOrDie();
+
+  ASSERT_OK(PlanCache::ResolveTimeNow(entry.get(), 1500));
+  EXPECT_EQ(1400, relative->val());
+  EXPECT_EQ(900, absolute->val());
+  EXPECT_EQ(1500, entry->time_now_ns);
+  EXPECT_EQ(1500, entry->compiler_state->relative_time_now().val);
+
+  // Plans that used the time in other ways aren't moved.
+  auto tied = MakeEntry(1000, /* read_time_now */ true);
+  IntIR* tied_value = tied->plan->CreateNode<IntIR>(ast, 900).ConsumeValueOrDie();
+  tied_value->set_relative_to_now(true);
+  ASSERT_OK(PlanCache::ResolveTimeNow(tied.get(), 1500));
+  EXPECT_EQ(900, tied_value->val());
+}
+
+TEST(PlanCacheTest, bounded_size) {
+  PlanCache::Options opts;
+  opts.capacity = 2;
+  PlanCache cache(opts);
+  cache.Insert("a", MakeEntry(0, false));
+  cache.Insert("b", MakeEntry(0, false));
+  // "a" is used more recently than "b", so "b" is evicted.
+  EXPECT_NE(nullptr, cache.Get("a", 0));
+  cache.Insert("c", MakeEntry(0, false));
+  EXPECT_EQ(2, cache.size());
+  EXPECT_NE(nullptr, cache.Get("a", 0));
+  EXPECT_EQ(nullptr, cache.Get("b", 0));
+  EXPECT_NE(nullptr, cache.Get("c", 0));
+
+  cache.Clear();
+  EXPECT_EQ(0, cache.size());
+}
+
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -19,8 +19,11 @@
 #include "src/carnot/planner/probes/probes.h"
 #include "external/gogo_grpc_proto/github.com/gogo/protobuf/gogoproto/gogo.pb.h"
 
+#include <algorithm>
 #include <utility>
 
+#include <absl/strings/str_join.h>
+
 namespace px {
 namespace carnot {
 namespace planner {
@@ -66,6 +69,22 @@ Status ProbeOutput::ToOutputProto(carnot::planner::dynamic_tracing::ir::logical:
   for (const auto& col : col_names_) {
     pb->add_fields(col);
   }
+  if (has_aggregation_) {
+    *pb->mutable_aggregation() = aggregation_;
+  }
+  return Status::OK();
+}
+
+Status ProbeOutput::SetAggregation(
+    const carnot::planner::dynamic_tracing::ir::logical::OutputAggregation& aggregation) {
+  if (aggregation.op() != carnot::planner::dynamic_tracing::ir::logical::OutputAggregation::COUNT &&
+      std::find(col_names_.begin(), col_names_.end(), aggregation.value_field()) ==
+          col_names_.end()) {
+    return error::InvalidArgument("Aggregated value field '$0' is not an output column of [$1]",
+                                  aggregation.value_field(), absl::StrJoin(col_names_, ","));
+  }
+  has_aggregation_ = true;
+  aggregation_ = aggregation;
   return Status::OK();
 }
 
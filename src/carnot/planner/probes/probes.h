@@ -58,6 +58,16 @@ class ProbeOutput {
 
   void set_name(const std::string& output_name) { output_name_ = output_name; }
 
+  /**
+   * @brief Aggregates this output inside BPF instead of writing a row per call. The value field
+   * must be one of the output columns, unless the op is a COUNT.
+   *
+   * @param aggregation the aggregation to apply.
+   * @return error if the value field is not an output column.
+   */
+  Status SetAggregation(
+      const carnot::planner::dynamic_tracing::ir::logical::OutputAggregation& aggregation);
+
  private:
   // Output name is the name of the output to write.
   std::string output_name_;
@@ -65,6 +75,9 @@ class ProbeOutput {
   std::vector<std::string> col_names_;
   // Var names are the ids of the variables to write to those columns.
   std::vector<std::string> var_names_;
+  // Whether the output is aggregated inside BPF, and how.
+  bool has_aggregation_ = false;
+  carnot::planner::dynamic_tracing::ir::logical::OutputAggregation aggregation_;
 };
 
 class TracepointIR {
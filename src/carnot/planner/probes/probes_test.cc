@@ -420,6 +420,57 @@ TEST_F(ProbeCompilerTest, parse_probe_no_return_value) {
           "Improper probe definition: missing output spec of probe, add a return statement"));
 }
 
+constexpr char kAggregatedProbePxlTpl[] = R"pxl(
+import pxtrace
+import px
+
+@pxtrace.probe("MyFunc", aggregate='$0', value_field='$1')
+def probe_func():
+    return [{'id': pxtrace.ArgExpr('id')},
+            {'latency': pxtrace.FunctionLatency()}]
+
+pxtrace.UpsertTracepoint('http_return',
+                         'http_return_table',
+                         probe_func,
+                         px.uint128("7654e321-e89b-12d3-a456-426655440000"),
+                         "5m")
+)pxl";
+
+constexpr char kAggregatedOutputPb[] = R"proto(
+name: "http_return_table"
+fields: "id"
+fields: "latency"
+aggregation {
+  op: LOG2_HISTOGRAM
+  value_field: "latency"
+}
+)proto";
+
+TEST_F(ProbeCompilerTest, parse_aggregated_probe) {
+  ASSERT_OK_AND_ASSIGN(
+      auto probe_ir,
+      CompileProbeScript(absl::Substitute(kAggregatedProbePxlTpl, "log2_histogram", "latency")));
+  plannerpb::CompileMutationsResponse pb;
+  EXPECT_OK(probe_ir->ToProto(&pb));
+  ASSERT_EQ(pb.mutations_size(), 1);
+  const auto& spec = pb.mutations()[0].trace().programs(0).spec();
+  ASSERT_EQ(spec.outputs_size(), 1);
+  EXPECT_THAT(spec.outputs(0), testing::proto::EqualsProto(kAggregatedOutputPb));
+
+  auto probe_ir_or_s = CompileProbeScript(absl::Substitute(kAggregatedProbePxlTpl, "max", ""));
+  ASSERT_NOT_OK(probe_ir_or_s);
+  EXPECT_THAT(probe_ir_or_s.status(), HasCompilerError("Unknown aggregate 'max'"));
+
+  probe_ir_or_s = CompileProbeScript(absl::Substitute(kAggregatedProbePxlTpl, "sum", ""));
+  ASSERT_NOT_OK(probe_ir_or_s);
+  EXPECT_THAT(probe_ir_or_s.status(), HasCompilerError("Aggregate 'sum' requires a value_field"));
+
+  probe_ir_or_s = CompileProbeScript(absl::Substitute(kAggregatedProbePxlTpl, "sum", "size"));
+  ASSERT_NOT_OK(probe_ir_or_s);
+  EXPECT_THAT(probe_ir_or_s.status().msg(),
+              ContainsRegex("Aggregated value field 'size' is not an output column"));
+}
+
 constexpr char kProbeDefNoUpsertPxl[] = R"pxl(
 import pxtrace
 import px
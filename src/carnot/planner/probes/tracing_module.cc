@@ -19,6 +19,8 @@
 #include "src/carnot/planner/probes/tracing_module.h"
 #include <sole.hpp>
 
+#include <absl/strings/ascii.h>
+
 #include "src/carnot/planner/objects/collection_object.h"
 #include "src/carnot/planner/objects/dict_object.h"
 #include "src/carnot/planner/objects/expr_object.h"
@@ -92,7 +94,8 @@ StatusOr<std::shared_ptr<TraceModule>> TraceModule::Create(MutationsIR* mutation
 Status TraceModule::Init() {
   PL_ASSIGN_OR_RETURN(
       std::shared_ptr<FuncObject> probe_fn,
-      FuncObject::Create(kProbeTraceDefinition, {"fn_name"}, {},
+      FuncObject::Create(kProbeTraceDefinition, {"fn_name", "aggregate", "value_field"},
+                         {{"aggregate", "''"}, {"value_field", "''"}},
                          /* has_variable_len_args */ false,
                          /* has_variable_len_kwargs */ false,
                          std::bind(ProbeHandler::Probe, mutations_ir_, std::placeholders::_1,
@@ -198,20 +201,42 @@ StatusOr<QLObjectPtr> ProbeHandler::Probe(MutationsIR* mutations_ir, const pypa:
                                           const ParsedArgs& args, ASTVisitor* visitor) {
   DCHECK(mutations_ir);
   PL_ASSIGN_OR_RETURN(StringIR * function_name_ir, GetArgAs<StringIR>(ast, args, "fn_name"));
+  PL_ASSIGN_OR_RETURN(StringIR * aggregate_ir, GetArgAs<StringIR>(ast, args, "aggregate"));
+  PL_ASSIGN_OR_RETURN(StringIR * value_field_ir, GetArgAs<StringIR>(ast, args, "value_field"));
+
+  // A null aggregation means that every call writes a row.
+  std::shared_ptr<OutputAggregation> aggregation;
+  if (!aggregate_ir->str().empty()) {
+    aggregation = std::make_shared<OutputAggregation>();
+    OutputAggregation::Op op;
+    if (!OutputAggregation::Op_Parse(absl::AsciiStrToUpper(aggregate_ir->str()), &op)) {
+      return aggregate_ir->CreateIRNodeError(
+          "Unknown aggregate '$0', expected one of 'count', 'sum' or 'log2_histogram'",
+          aggregate_ir->str());
+    }
+    if (op != OutputAggregation::COUNT && value_field_ir->str().empty()) {
+      return aggregate_ir->CreateIRNodeError("Aggregate '$0' requires a value_field",
+                                             aggregate_ir->str());
+    }
+    aggregation->set_op(op);
+    aggregation->set_value_field(value_field_ir->str());
+  } else if (!value_field_ir->str().empty()) {
+    return value_field_ir->CreateIRNodeError("value_field is only valid with an aggregate");
+  }
 
   return FuncObject::Create(
       TraceModule::kProbeTraceDefinition, {"fn"}, {},
       /* has_variable_len_args */ false,
       /* has_variable_len_kwargs */ false,
-      std::bind(&ProbeHandler::Decorator, mutations_ir, function_name_ir->str(),
+      std::bind(&ProbeHandler::Decorator, mutations_ir, function_name_ir->str(), aggregation,
                 std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
       visitor);
 }
 
-StatusOr<QLObjectPtr> ProbeHandler::Decorator(MutationsIR* mutations_ir,
-                                              const std::string& function_name,
-                                              const pypa::AstPtr& ast, const ParsedArgs& args,
-                                              ASTVisitor* visitor) {
+StatusOr<QLObjectPtr> ProbeHandler::Decorator(
+    MutationsIR* mutations_ir, const std::string& function_name,
+    const std::shared_ptr<OutputAggregation>& aggregation, const pypa::AstPtr& ast,
+    const ParsedArgs& args, ASTVisitor* visitor) {
   auto fn = args.GetArg("fn");
   PL_ASSIGN_OR_RETURN(auto func, GetCallMethod(ast, fn));
   // mutations_ir->AddFunc(func);
@@ -220,8 +245,8 @@ StatusOr<QLObjectPtr> ProbeHandler::Decorator(MutationsIR* mutations_ir,
       "wrapper", {}, {},
       /* has_variable_len_args */ false,
       /* has_variable_len_kwargs */ false,
-      std::bind(&ProbeHandler::Wrapper, mutations_ir, function_name, func, std::placeholders::_1,
-                std::placeholders::_2, std::placeholders::_3),
+      std::bind(&ProbeHandler::Wrapper, mutations_ir, function_name, aggregation, func,
+                std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
       visitor);
 }
 
@@ -278,6 +303,7 @@ Status ParseOutput(TracepointIR* probe, const QLObjectPtr& probe_output) {
 
 StatusOr<QLObjectPtr> ProbeHandler::Wrapper(MutationsIR* mutations_ir,
                                             const std::string& function_name,
+                                            const std::shared_ptr<OutputAggregation>& aggregation,
                                             const std::shared_ptr<FuncObject> wrapped_func,
                                             const pypa::AstPtr& ast, const ParsedArgs&,
                                             ASTVisitor* visitor) {
@@ -297,6 +323,12 @@ StatusOr<QLObjectPtr> ProbeHandler::Wrapper(MutationsIR* mutations_ir,
     return wrapped_result->CreateError(
         "Improper probe definition: missing output spec of probe, add a return statement");
   }
+  if (aggregation != nullptr) {
+    auto s = probe->output()->SetAggregation(*aggregation);
+    if (!s.ok()) {
+      return wrapped_result->CreateError(s.msg());
+    }
+  }
 
   mutations_ir->EndProbe();
   PL_ASSIGN_OR_RETURN(auto probe_obj, ProbeObject::Create(visitor, probe));
@@ -196,6 +196,12 @@ class TraceModule : public QLObject {
 
   Args:
     trace_fn (str): The func to trace. For go, the format is `<package_name>.<func_name>`.
+    aggregate (str, optional): Aggregates the output inside the kernel instead of
+      writing a row per call. One of 'count', 'sum' or 'log2_histogram'. Rows are
+      keyed by process and the remaining integer output columns, and are written
+      periodically with the call count and the sum of `value_field`.
+    value_field (str, optional): The output column to sum, and to bucket for
+      'log2_histogram'. Required unless `aggregate` is 'count'.
 
   Returns:
     Func: The wrapped probe function.
@@ -261,6 +267,8 @@ class TraceModule : public QLObject {
 
 class ProbeHandler {
  public:
+  using OutputAggregation = carnot::planner::dynamic_tracing::ir::logical::OutputAggregation;
+
   /**
    * @brief ProbeHandler is the handler for the @px.probe decorator. I find the structure of
    * decorators very confusing, but they are basically deeply nested functions. For
@@ -301,9 +309,12 @@ class ProbeHandler {
   static StatusOr<QLObjectPtr> Probe(MutationsIR* mutations_ir, const pypa::AstPtr& ast,
                                      const ParsedArgs& args, ASTVisitor* visitor);
   static StatusOr<QLObjectPtr> Decorator(MutationsIR* mutations_ir,
-                                         const std::string& function_name, const pypa::AstPtr& ast,
-                                         const ParsedArgs& args, ASTVisitor* visitor);
+                                         const std::string& function_name,
+                                         const std::shared_ptr<OutputAggregation>& aggregation,
+                                         const pypa::AstPtr& ast, const ParsedArgs& args,
+                                         ASTVisitor* visitor);
   static StatusOr<QLObjectPtr> Wrapper(MutationsIR* mutations_ir, const std::string& function_name,
+                                       const std::shared_ptr<OutputAggregation>& aggregation,
                                        const std::shared_ptr<FuncObject> func_obj,
                                        const pypa::AstPtr& ast, const ParsedArgs& args,
                                        ASTVisitor* visitor);
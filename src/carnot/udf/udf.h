@@ -74,6 +74,15 @@ class AnyUDA : public BaseFunc {
  *      Status Init(FunctionContext *ctx, UDFValue... init_args) {}
  *  This function is called once during initialization of each instance (many instances
  *  may exists in a given query). The arguments are as provided by the query.
+ *
+ * Single argument UDFs whose Exec is expensive (ie. a metadata lookup) can also implement:
+ *      static constexpr bool MemoizeWithinBatch() { return true; }
+ *  The Exec function is then only called once per distinct input value in each batch, and the
+ *  result is reused for every other row with the same value. Memoized UDFs can additionally
+ *  implement:
+ *      void Prefetch(FunctionContext *ctx, const std::vector<UDFValue>& distinct_values) {}
+ *  which is called with the distinct input values of each batch before Exec, so that slow work
+ *  (ie. network lookups) can be done for the whole batch at once.
  */
 class ScalarUDF : public AnyUDF {
  public:
@@ -188,6 +197,20 @@ static constexpr types::DataType ReturnTypeHelper(ReturnType (TUDF::*)(Types...)
   return types::ValueTypeTraits<ReturnType>::data_type;
 }
 
+// SFINAE test for MemoizeWithinBatch fn.
+template <typename T, typename = void>
+struct has_udf_memoize_fn : std::false_type {};
+
+template <typename T>
+struct has_udf_memoize_fn<T, std::void_t<decltype(&T::MemoizeWithinBatch)>> : std::true_type {};
+
+// SFINAE test for Prefetch fn.
+template <typename T, typename = void>
+struct has_udf_prefetch_fn : std::false_type {};
+
+template <typename T>
+struct has_udf_prefetch_fn<T, std::void_t<decltype(&T::Prefetch)>> : std::true_type {};
+
 template <typename T, typename = void>
 struct check_init_fn {};
 
@@ -228,6 +251,26 @@ class ScalarUDFTraits {
    */
   static constexpr bool HasExecutor() { return has_udf_executor_fn<T>::value; }
 
+  /**
+   * Checks if the results of Exec can be reused for repeated inputs within a batch.
+   * @return true if the UDF opted in to per-batch memoization.
+   */
+  template <typename Q = T, std::enable_if_t<has_udf_memoize_fn<Q>::value, void>* = nullptr>
+  static constexpr bool MemoizeWithinBatch() {
+    return Q::MemoizeWithinBatch();
+  }
+
+  template <typename Q = T, std::enable_if_t<!has_udf_memoize_fn<Q>::value, void>* = nullptr>
+  static constexpr bool MemoizeWithinBatch() {
+    return false;
+  }
+
+  /**
+   * Checks if the UDF wants the distinct inputs of each batch before Exec is called.
+   * @return true if it has a Prefetch function.
+   */
+  static constexpr bool HasPrefetch() { return has_udf_prefetch_fn<T>::value; }
+
   template <typename Q = T, std::enable_if_t<ScalarUDFTraits<Q>::HasInit(), void>* = nullptr>
   static constexpr auto InitArguments() {
     return GetArgumentTypesHelper(&Q::Init);
@@ -20,6 +20,9 @@
 #include <arrow/pretty_print.h>
 
 #include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
 
 #include "src/carnot/udf/udf_definition.h"
 #include "src/common/testing/testing.h"
@@ -67,6 +70,36 @@ class InitArgUDF : public ScalarUDF {
   int64_t i_;
 };
 
+class MemoizedUDF : public ScalarUDF {
+ public:
+  types::StringValue Exec(FunctionContext*, types::StringValue str) {
+    ++invoke_count;
+    return absl::StrCat(str, "_", invoke_count);
+  }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
+
+  int invoke_count = 0;
+};
+
+class PrefetchUDF : public ScalarUDF {
+ public:
+  types::Int64Value Exec(FunctionContext*, types::StringValue str) { return prefetched.at(str); }
+
+  static constexpr bool MemoizeWithinBatch() { return true; }
+
+  void Prefetch(FunctionContext*, const std::vector<types::StringValue>& distinct) {
+    prefetched.clear();
+    for (const auto& str : distinct) {
+      prefetched[str] = str.size();
+    }
+    ++num_prefetches;
+  }
+
+  std::map<std::string, int64_t> prefetched;
+  int num_prefetches = 0;
+};
+
 TEST(UDFDefinition, no_args) {
   auto ctx = FunctionContext(nullptr, nullptr);
   ScalarUDFDefinition def("noargudf");
@@ -161,6 +194,69 @@ TEST(UDFDefinition, init_args) {
   EXPECT_EQ("init_arg, 10, hello", out[2]);
 }
 
+TEST(UDFDefinition, memoize_within_batch) {
+  auto ctx = FunctionContext(nullptr, nullptr);
+  ScalarUDFDefinition def("memoized");
+  EXPECT_OK(def.Init<MemoizedUDF>());
+
+  types::StringValueColumnWrapper inputs({"a", "b", "a", "a", "b", "c"});
+  types::StringValueColumnWrapper out(inputs.Size());
+  auto u = def.Make();
+  EXPECT_OK(def.ExecBatch(u.get(), &ctx, {&inputs}, &out, inputs.Size()));
+
+  EXPECT_EQ(3, static_cast<MemoizedUDF*>(u.get())->invoke_count);
+  EXPECT_EQ("a_1", out[0]);
+  EXPECT_EQ("b_2", out[1]);
+  EXPECT_EQ("a_1", out[2]);
+  EXPECT_EQ("a_1", out[3]);
+  EXPECT_EQ("b_2", out[4]);
+  EXPECT_EQ("c_3", out[5]);
+
+  // The memo only lives for a single batch.
+  types::StringValueColumnWrapper out2(inputs.Size());
+  EXPECT_OK(def.ExecBatch(u.get(), &ctx, {&inputs}, &out2, inputs.Size()));
+  EXPECT_EQ(6, static_cast<MemoizedUDF*>(u.get())->invoke_count);
+  EXPECT_EQ("a_4", out2[0]);
+}
+
+TEST(UDFDefinition, memoize_within_batch_arrow) {
+  auto ctx = FunctionContext(nullptr, nullptr);
+  std::vector<types::StringValue> inputs = {"a", "b", "a", "b"};
+  auto inputs_arrow = ToArrow(inputs, arrow::default_memory_pool());
+
+  auto output_builder = std::make_shared<arrow::StringBuilder>();
+  auto u = std::make_shared<MemoizedUDF>();
+  EXPECT_OK(ScalarUDFWrapper<MemoizedUDF>::ExecBatchArrow(u.get(), &ctx, {inputs_arrow.get()},
+                                                          output_builder.get(), inputs.size()));
+
+  std::shared_ptr<arrow::Array> res;
+  EXPECT_TRUE(output_builder->Finish(&res).ok());
+  auto* res_arr = static_cast<arrow::StringArray*>(res.get());
+  EXPECT_EQ(2, u->invoke_count);
+  EXPECT_EQ("a_1", res_arr->GetString(0));
+  EXPECT_EQ("b_2", res_arr->GetString(1));
+  EXPECT_EQ("a_1", res_arr->GetString(2));
+  EXPECT_EQ("b_2", res_arr->GetString(3));
+}
+
+TEST(UDFDefinition, prefetch_distinct_values) {
+  auto ctx = FunctionContext(nullptr, nullptr);
+  ScalarUDFDefinition def("prefetch");
+  EXPECT_OK(def.Init<PrefetchUDF>());
+
+  types::StringValueColumnWrapper inputs({"a", "bb", "a", "ccc", "bb"});
+  types::Int64ValueColumnWrapper out(inputs.Size());
+  auto u = def.Make();
+  EXPECT_OK(def.ExecBatch(u.get(), &ctx, {&inputs}, &out, inputs.Size()));
+
+  auto* udf = static_cast<PrefetchUDF*>(u.get());
+  EXPECT_EQ(1, udf->num_prefetches);
+  EXPECT_EQ(3, udf->prefetched.size());
+  EXPECT_EQ(1, out[0].val);
+  EXPECT_EQ(2, out[1].val);
+  EXPECT_EQ(3, out[3].val);
+}
+
 // Test UDA, takes the min of two arguments and then sums them.
 class MinSumUDA : public udf::UDA {
  public:
@@ -22,8 +22,12 @@
 
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
+#include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
+
 #include "src/carnot/udf/udf.h"
 #include "src/carnot/udf/udtf.h"
 #include "src/common/base/base.h"
@@ -95,6 +99,26 @@ inline auto UnWrap<types::StringValue>(const types::StringValue& s) {
   return s;
 }
 
+/**
+ * Appends a single UDF result to the output builder. For strings, the data buffer is grown
+ * ahead of the append, so that the unsafe append is valid.
+ */
+template <typename TOutput, typename TRes>
+Status UnsafeAppendArrow(TOutput* out, const TRes& res, size_t* total_size, size_t* reserved) {
+  // We use doubling to make sure we minimize the number of allocations.
+  // PL_CARNOT_UPDATE_FOR_NEW_TYPES.
+  if constexpr (std::is_same_v<arrow::StringBuilder, TOutput>) {
+    *total_size += res.size();
+    while (*total_size >= *reserved) {
+      *reserved *= 2;
+      PL_RETURN_IF_ERROR(out->ReserveData(*reserved));
+    }
+  }
+  // This function is "safe" now because we manually allocated memory.
+  out->UnsafeAppend(res);
+  return Status::OK();
+}
+
 /**
  * This is the inner wrapper for the arrow type.
  * This performs type casting and storing the data in the output builder.
@@ -116,18 +140,98 @@ Status ExecWrapperArrow(TUDF* udf, FunctionContext* ctx, size_t count, TOutput*
   for (size_t idx = 0; idx < count; ++idx) {
     auto res = UnWrap(
         udf->Exec(ctx, types::GetValueFromArrowArray<exec_argument_types[I]>(args[I], idx)...));
+    PL_RETURN_IF_ERROR(UnsafeAppendArrow(out, res, &total_size, &reserved));
+  }
+  return Status::OK();
+}
+
+// Returns the key used to memoize a UDF value. Strings are viewed rather than copied, since the
+// memo table supports heterogeneous lookup.
+template <typename T>
+inline auto MemoKey(const T& v) {
+  return v.val;
+}
+
+template <>
+inline auto MemoKey<types::StringValue>(const types::StringValue& s) {
+  return std::string_view(s);
+}
 
-    // We use doubling to make sure we minimize the number of allocations.
-    // PL_CARNOT_UPDATE_FOR_NEW_TYPES.
-    if constexpr (std::is_same_v<arrow::StringBuilder, TOutput>) {
-      total_size += res.size();
-      while (total_size >= reserved) {
-        reserved *= 2;
-        PL_RETURN_IF_ERROR(out->ReserveData(reserved));
+/**
+ * This is the wrapper used for UDFs that opt in to MemoizeWithinBatch. Exec is only called
+ * for the first occurrence of each distinct input in the batch. If the UDF has a Prefetch
+ * function, it is first called with all the distinct inputs.
+ */
+template <typename TUDF, typename TOutput>
+Status MemoizedExecWrapper(TUDF* udf, FunctionContext* ctx, size_t count, TOutput* out,
+                           const std::vector<const types::BaseValueType*>& args) {
+  constexpr auto exec_argument_types = ScalarUDFTraits<TUDF>::ExecArguments();
+  static_assert(exec_argument_types.size() == 1,
+                "only single argument UDFs can be memoized within a batch");
+  using key_type = typename types::DataTypeTraits<exec_argument_types[0]>::native_type;
+
+  const auto* in = CastToUDFValueType<exec_argument_types[0]>(args[0]);
+  if constexpr (ScalarUDFTraits<TUDF>::HasPrefetch()) {
+    absl::flat_hash_set<key_type> seen;
+    std::vector<typename types::DataTypeTraits<exec_argument_types[0]>::value_type> distinct;
+    for (size_t idx = 0; idx < count; ++idx) {
+      if (seen.insert(key_type(MemoKey(in[idx]))).second) {
+        distinct.push_back(in[idx]);
       }
     }
-    // This function is "safe" now because we manually allocated memory.
-    out->UnsafeAppend(res);
+    udf->Prefetch(ctx, distinct);
+  }
+  absl::flat_hash_map<key_type, TOutput> memo;
+  for (size_t idx = 0; idx < count; ++idx) {
+    auto it = memo.find(MemoKey(in[idx]));
+    if (it == memo.end()) {
+      it = memo.emplace(key_type(MemoKey(in[idx])), udf->Exec(ctx, in[idx])).first;
+    }
+    out[idx] = it->second;
+  }
+  return Status::OK();
+}
+
+/**
+ * Arrow version of MemoizedExecWrapper.
+ */
+template <typename TUDF, typename TOutput>
+Status MemoizedExecWrapperArrow(TUDF* udf, FunctionContext* ctx, size_t count, TOutput* out,
+                                const std::vector<arrow::Array*>& args) {
+  static constexpr auto exec_argument_types = ScalarUDFTraits<TUDF>::ExecArguments();
+  static_assert(exec_argument_types.size() == 1,
+                "only single argument UDFs can be memoized within a batch");
+  using key_type = std::decay_t<decltype(
+      types::GetValueFromArrowArray<exec_argument_types[0]>(args[0], 0))>;
+  using result_type = std::decay_t<decltype(UnWrap(udf->Exec(ctx, std::declval<key_type>())))>;
+
+  CHECK(out->Reserve(count).ok());
+  size_t reserved = count * kStringAssumedSizeHeuristic;
+  size_t total_size = 0;
+  // PL_CARNOT_UPDATE_FOR_NEW_TYPES.
+  if constexpr (std::is_same_v<arrow::StringBuilder, TOutput>) {
+    CHECK(out->ReserveData(reserved).ok());
+  }
+  if constexpr (ScalarUDFTraits<TUDF>::HasPrefetch()) {
+    absl::flat_hash_set<key_type> seen;
+    std::vector<typename types::DataTypeTraits<exec_argument_types[0]>::value_type> distinct;
+    for (size_t idx = 0; idx < count; ++idx) {
+      auto key = types::GetValueFromArrowArray<exec_argument_types[0]>(args[0], idx);
+      if (seen.insert(key).second) {
+        distinct.emplace_back(std::move(key));
+      }
+    }
+    udf->Prefetch(ctx, distinct);
+  }
+  absl::flat_hash_map<key_type, result_type> memo;
+  for (size_t idx = 0; idx < count; ++idx) {
+    auto key = types::GetValueFromArrowArray<exec_argument_types[0]>(args[0], idx);
+    auto it = memo.find(key);
+    if (it == memo.end()) {
+      auto res = UnWrap(udf->Exec(ctx, key));
+      it = memo.emplace(std::move(key), std::move(res)).first;
+    }
+    PL_RETURN_IF_ERROR(UnsafeAppendArrow(out, it->second, &total_size, &reserved));
   }
   return Status::OK();
 }
@@ -200,10 +304,15 @@ struct ScalarUDFWrapper {
     // The outer wrapper just casts the output type and UDF type. We then pass in
     // the inputs with a sequence based on the number of arguments to iterate through and
     // cast the inputs.
-    return ExecWrapperArrow<TUDF>(
-        static_cast<TUDF*>(udf), ctx, count,
-        static_cast<typename types::DataTypeTraits<return_type>::arrow_builder_type*>(output),
-        inputs, std::make_index_sequence<exec_argument_types.size()>{});
+    auto* casted_output =
+        static_cast<typename types::DataTypeTraits<return_type>::arrow_builder_type*>(output);
+    if constexpr (ScalarUDFTraits<TUDF>::MemoizeWithinBatch()) {
+      return MemoizedExecWrapperArrow<TUDF>(static_cast<TUDF*>(udf), ctx, count, casted_output,
+                                            inputs);
+    } else {
+      return ExecWrapperArrow<TUDF>(static_cast<TUDF*>(udf), ctx, count, casted_output, inputs,
+                                    std::make_index_sequence<exec_argument_types.size()>{});
+    }
   }
 
   /**
@@ -241,9 +350,14 @@ struct ScalarUDFWrapper {
     // The outer wrapper just casts the output type and UDF type. We then pass in
     // the inputs with a sequence based on the number of arguments to iterate through and
     // cast the inputs.
-    return ExecWrapper<TUDF>(static_cast<TUDF*>(udf), ctx, count, casted_output,
-                             input_as_base_value,
-                             std::make_index_sequence<exec_argument_types.size()>{});
+    if constexpr (ScalarUDFTraits<TUDF>::MemoizeWithinBatch()) {
+      return MemoizedExecWrapper<TUDF>(static_cast<TUDF*>(udf), ctx, count, casted_output,
+                                       input_as_base_value);
+    } else {
+      return ExecWrapper<TUDF>(static_cast<TUDF*>(udf), ctx, count, casted_output,
+                               input_as_base_value,
+                               std::make_index_sequence<exec_argument_types.size()>{});
+    }
   }
 
   /**
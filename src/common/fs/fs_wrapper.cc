@@ -124,6 +124,16 @@ Status Remove(const std::filesystem::path& f) {
   return error::InvalidArgument("Could not delete $0 [ec=$1]", f.string(), ec.message());
 }
 
+Status Rename(const std::filesystem::path& from, const std::filesystem::path& to) {
+  std::error_code ec;
+  std::filesystem::rename(from, to, ec);
+  if (ec) {
+    return error::System("Failed to rename $0 to $1. Message: $2", from.string(), to.string(),
+                         ec.message());
+  }
+  return Status::OK();
+}
+
 StatusOr<bool> IsEmpty(const std::filesystem::path& f) {
   std::error_code ec;
   bool val = std::filesystem::is_empty(f, ec);
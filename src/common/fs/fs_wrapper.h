@@ -63,6 +63,10 @@ Status Copy(const std::filesystem::path& from, const std::filesystem::path& to,
             std::filesystem::copy_options options = std::filesystem::copy_options::none);
 Status Remove(const std::filesystem::path& f);
 
+// Renames from to to, replacing to if it exists. The replacement is atomic if both are on the same
+// file system.
+Status Rename(const std::filesystem::path& from, const std::filesystem::path& to);
+
 StatusOr<bool> IsEmpty(const std::filesystem::path& f);
 
 StatusOr<std::filesystem::path> Absolute(const std::filesystem::path& path);
@@ -107,6 +107,14 @@ TEST_F(FSWrapperTest, ExistsReturnsErrorForNonExistentFile) {
               StatusIs(statuspb::INVALID_ARGUMENT, HasSubstr("does not exist")));
 }
 
+TEST_F(FSWrapperTest, Rename) {
+  ASSERT_OK(CreateDirectories(tmp_dir_.path() / "from"));
+  ASSERT_OK(Rename(tmp_dir_.path() / "from", tmp_dir_.path() / "to"));
+  EXPECT_OK(Exists(tmp_dir_.path() / "to"));
+  EXPECT_NOT_OK(Exists(tmp_dir_.path() / "from"));
+  EXPECT_NOT_OK(Rename(tmp_dir_.path() / "from", tmp_dir_.path() / "to"));
+}
+
 TEST_F(FSWrapperTest, GetChildRelPath) {
   EXPECT_OK_AND_EQ(GetChildRelPath("/a/b", "/a/b"), "");
   EXPECT_OK_AND_EQ(GetChildRelPath("a/b", "a/b"), "");
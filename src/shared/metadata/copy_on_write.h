@@ -0,0 +1,97 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include <absl/container/flat_hash_set.h>
+
+#include "src/common/base/base.h"
+
+namespace px {
+namespace md {
+
+namespace internal {
+
+// Copies values that provide a Clone() method (e.g. polymorphic metadata objects) with it.
+template <typename T>
+auto CopyOf(const T& value, int) -> decltype(std::shared_ptr<T>(value.Clone())) {
+  return std::shared_ptr<T>(value.Clone());
+}
+
+template <typename T>
+std::shared_ptr<T> CopyOf(const T& value, long) {  // NOLINT(runtime/int)
+  return std::make_shared<T>(value);
+}
+
+}  // namespace internal
+
+/**
+ * CopyOnWriteOwner tracks the shared values that one metadata state may mutate in place.
+ *
+ * Metadata state snapshots share their maps and objects through shared_ptrs. A state owns the
+ * values that it created or copied itself, until it is cloned: from then on, all of its values are
+ * shared with the clone, and are copied on their first mutation. Ownership is tracked explicitly,
+ * rather than with shared_ptr::use_count(), since a use count that drops to 1 on another thread
+ * does not order that thread's last reads before our writes.
+ */
+class CopyOnWriteOwner : public NotCopyMoveable {
+ public:
+  /**
+   * Returns a mutable pointer to the value held by ptr, replacing it with a copy first if the
+   * value is not owned.
+   */
+  template <typename T>
+  T* MutableCopy(std::shared_ptr<T>* ptr) {
+    if (shared_.exchange(false, std::memory_order_relaxed)) {
+      owned_.clear();
+    }
+    if (!owned_.contains(ptr->get())) {
+      *ptr = internal::CopyOf(**ptr, 0);
+      owned_.insert(ptr->get());
+    }
+    return ptr->get();
+  }
+
+  /**
+   * Marks a value that was just created by the state as owned, so that it is not copied on its
+   * first mutation.
+   */
+  template <typename T>
+  void Own(const std::shared_ptr<T>& ptr) {
+    if (shared_.exchange(false, std::memory_order_relaxed)) {
+      owned_.clear();
+    }
+    owned_.insert(ptr.get());
+  }
+
+  /**
+   * Gives up the ownership of all the values, which are now shared with a clone. This may be
+   * called on a state that is read concurrently, but not concurrently with its mutations.
+   */
+  void MarkShared() const { shared_.store(true, std::memory_order_relaxed); }
+
+ private:
+  mutable std::atomic<bool> shared_ = false;
+  absl::flat_hash_set<const void*> owned_;
+};
+
+}  // namespace md
+}  // namespace px
@@ -19,6 +19,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <absl/container/flat_hash_set.h>
 
@@ -27,11 +28,26 @@
 namespace px {
 namespace md {
 
+namespace {
+
+// Sets index[key] = value. The index is only copied (if shared) when the entry changes.
+template <typename TMap>
+void UpdateIndex(CopyOnWriteOwner* cow, std::shared_ptr<TMap>* index,
+                 const typename TMap::key_type& key, const typename TMap::mapped_type& value) {
+  auto it = (*index)->find(key);
+  if (it != (*index)->end() && it->second == value) {
+    return;
+  }
+  (*cow->MutableCopy(index))[key] = value;
+}
+
+}  // namespace
+
 const K8sMetadataObject* K8sMetadataState::K8sMetadataObjectByID(UIDView id,
                                                                  K8sObjectType type) const {
-  auto it = k8s_objects_by_id_.find(id);
+  auto it = k8s_objects_by_id_->find(id);
 
-  if (it == k8s_objects_by_id_.end()) {
+  if (it == k8s_objects_by_id_->end()) {
     return nullptr;
   }
 
@@ -42,6 +58,14 @@ const K8sMetadataObject* K8sMetadataState::K8sMetadataObjectByID(UIDView id,
   return it->second.get();
 }
 
+K8sMetadataObject* K8sMetadataState::MutableK8sMetadataObjectByID(UIDView id) {
+  if (!k8s_objects_by_id_->contains(id)) {
+    return nullptr;
+  }
+  auto it = cow_.MutableCopy(&k8s_objects_by_id_)->find(id);
+  return cow_.MutableCopy(&it->second);
+}
+
 const PodInfo* K8sMetadataState::PodInfoByID(UIDView pod_id) const {
   auto type = K8sObjectType::kPod;
   return static_cast<const PodInfo*>(K8sMetadataObjectByID(pod_id, type));
@@ -58,61 +82,63 @@ const NamespaceInfo* K8sMetadataState::NamespaceInfoByID(UIDView ns_id) const {
 }
 
 const ContainerInfo* K8sMetadataState::ContainerInfoByID(CIDView id) const {
-  auto it = containers_by_id_.find(id);
+  auto it = containers_by_id_->find(id);
 
-  if (it == containers_by_id_.end()) {
+  if (it == containers_by_id_->end()) {
     return nullptr;
   }
 
   return it->second.get();
 }
 
+ContainerInfo* K8sMetadataState::MutableContainerInfoByID(CIDView id) {
+  if (!containers_by_id_->contains(id)) {
+    return nullptr;
+  }
+  auto it = cow_.MutableCopy(&containers_by_id_)->find(id);
+  return cow_.MutableCopy(&it->second);
+}
+
 UID K8sMetadataState::PodIDByName(K8sNameIdentView pod_name) const {
-  auto it = pods_by_name_.find(pod_name);
-  return (it == pods_by_name_.end()) ? "" : it->second;
+  auto it = pods_by_name_->find(pod_name);
+  return (it == pods_by_name_->end()) ? "" : it->second;
 }
 
 UID K8sMetadataState::PodIDByIP(std::string_view pod_ip) const {
-  auto it = pods_by_ip_.find(pod_ip);
-  return (it == pods_by_ip_.end()) ? "" : it->second;
+  auto it = pods_by_ip_->find(pod_ip);
+  return (it == pods_by_ip_->end()) ? "" : it->second;
 }
 
 UID K8sMetadataState::ServiceIDByClusterIP(std::string_view cluster_ip) const {
-  auto it = services_by_cluster_ip_.find(cluster_ip);
-  return (it == services_by_cluster_ip_.end()) ? "" : it->second;
+  auto it = services_by_cluster_ip_->find(cluster_ip);
+  return (it == services_by_cluster_ip_->end()) ? "" : it->second;
 }
 
 CID K8sMetadataState::ContainerIDByName(std::string_view container_name) const {
-  auto it = containers_by_name_.find(container_name);
-  return (it == containers_by_name_.end()) ? "" : it->second;
+  auto it = containers_by_name_->find(container_name);
+  return (it == containers_by_name_->end()) ? "" : it->second;
 }
 
 UID K8sMetadataState::ServiceIDByName(K8sNameIdentView service_name) const {
-  auto it = services_by_name_.find(service_name);
-  return (it == services_by_name_.end()) ? "" : it->second;
+  auto it = services_by_name_->find(service_name);
+  return (it == services_by_name_->end()) ? "" : it->second;
 }
 
 UID K8sMetadataState::NamespaceIDByName(K8sNameIdentView namespace_name) const {
-  auto it = namespaces_by_name_.find(namespace_name);
-  return (it == namespaces_by_name_.end()) ? "" : it->second;
+  auto it = namespaces_by_name_->find(namespace_name);
+  return (it == namespaces_by_name_->end()) ? "" : it->second;
 }
 
 std::unique_ptr<K8sMetadataState> K8sMetadataState::Clone() const {
   auto other = std::make_unique<K8sMetadataState>();
+  cow_.MarkShared();
 
   other->pod_cidrs_ = pod_cidrs_;
   other->service_cidr_ = service_cidr_;
 
-  other->k8s_objects_by_id_.reserve(k8s_objects_by_id_.size());
-  for (const auto& [k, v] : k8s_objects_by_id_) {
-    other->k8s_objects_by_id_[k] = v->Clone();
-  }
-
-  other->containers_by_id_.reserve(containers_by_id_.size());
-  for (const auto& [k, v] : containers_by_id_) {
-    other->containers_by_id_[k] = v->Clone();
-  }
-
+  // The maps, and the objects in them, are shared until either state mutates them.
+  other->k8s_objects_by_id_ = k8s_objects_by_id_;
+  other->containers_by_id_ = containers_by_id_;
   other->pods_by_name_ = pods_by_name_;
   other->services_by_name_ = services_by_name_;
   other->namespaces_by_name_ = namespaces_by_name_;
@@ -128,20 +154,20 @@ std::string K8sMetadataState::DebugString(int indent_level) const {
   std::string prefix = Indent(indent_level);
 
   str += prefix + "K8s Objects:\n";
-  for (const auto& it : k8s_objects_by_id_) {
+  for (const auto& it : *k8s_objects_by_id_) {
     str += absl::Substitute("$0\n", it.second->DebugString(indent_level + 1));
   }
   str += "\n";
   str += prefix + "Containers:\n";
-  for (const auto& it : containers_by_id_) {
+  for (const auto& it : *containers_by_id_) {
     str += absl::Substitute("$0\n", it.second->DebugString(indent_level + 1));
   }
   str += "\n";
   str += prefix + "IPs:\n";
-  for (const auto& [k, v] : pods_by_ip_) {
+  for (const auto& [k, v] : *pods_by_ip_) {
     str += absl::Substitute("pod_id: $0, ip: $1\n", v, k);
   }
-  for (const auto& [k, v] : services_by_cluster_ip_) {
+  for (const auto& [k, v] : *services_by_cluster_ip_) {
     str += absl::Substitute("service_id: $0, cluster_ip: $1\n", v, k);
   }
 
@@ -159,13 +185,13 @@ Status K8sMetadataState::HandlePodUpdate(const PodUpdate& update) {
   const std::string& name = update.name();
   const std::string& ns = update.namespace_();
 
-  auto it = k8s_objects_by_id_.find(object_uid);
-  if (it == k8s_objects_by_id_.end()) {
+  if (!k8s_objects_by_id_->contains(object_uid)) {
     auto pod = std::make_unique<PodInfo>(update);
     VLOG(1) << "Adding Pod: " << pod->DebugString();
-    it = k8s_objects_by_id_.try_emplace(object_uid, std::move(pod)).first;
+    auto it = cow_.MutableCopy(&k8s_objects_by_id_)->try_emplace(object_uid, std::move(pod)).first;
+    cow_.Own(it->second);
   }
-  auto pod_info = static_cast<PodInfo*>(it->second.get());
+  auto pod_info = static_cast<PodInfo*>(MutableK8sMetadataObjectByID(object_uid));
 
   // We always just add to the container set even if the container is stopped.
   // We expect all cleanup to happen periodically to allow stale objects to be queried for some
@@ -174,7 +200,8 @@ Status K8sMetadataState::HandlePodUpdate(const PodUpdate& update) {
   // state might be periodically inconsistent.
 
   for (const auto& cid : update.container_ids()) {
-    if (containers_by_id_.find(cid) == containers_by_id_.end()) {
+    const ContainerInfo* container_info = ContainerInfoByID(cid);
+    if (container_info == nullptr) {
       // We should be resilient to the case where we happened to miss a pod update
       // in the stream of events. If we did miss a pod update, just skip adding the
       // pod to this particular service to avoid dangling references.
@@ -183,7 +210,9 @@ Status K8sMetadataState::HandlePodUpdate(const PodUpdate& update) {
     }
 
     pod_info->AddContainer(cid);
-    containers_by_id_[cid]->set_pod_id(object_uid);
+    if (container_info->pod_id() != object_uid) {
+      MutableContainerInfoByID(cid)->set_pod_id(object_uid);
+    }
   }
 
   pod_info->set_start_time_ns(update.start_timestamp_ns());
@@ -196,10 +225,10 @@ Status K8sMetadataState::HandlePodUpdate(const PodUpdate& update) {
   pod_info->set_phase_message(update.message());
   pod_info->set_phase_reason(update.reason());
 
-  pods_by_name_[{ns, name}] = object_uid;
+  UpdateIndex(&cow_, &pods_by_name_, {ns, name}, object_uid);
   // Filter out daemonsets which don't have their own, unique podIP.
   if (update.host_ip() != update.pod_ip() && update.pod_ip() != "") {
-    pods_by_ip_[update.pod_ip()] = object_uid;
+    UpdateIndex(&cow_, &pods_by_ip_, update.pod_ip(), object_uid);
   }
 
   return Status::OK();
@@ -208,21 +237,21 @@ Status K8sMetadataState::HandlePodUpdate(const PodUpdate& update) {
 Status K8sMetadataState::HandleContainerUpdate(const ContainerUpdate& update) {
   const CID& cid = update.cid();
 
-  auto it = containers_by_id_.find(cid);
-  if (it == containers_by_id_.end()) {
+  if (!containers_by_id_->contains(cid)) {
     auto container = std::make_unique<ContainerInfo>(update);
     VLOG(1) << "Adding Container: " << container->DebugString();
-    it = containers_by_id_.try_emplace(cid, std::move(container)).first;
+    auto it = cow_.MutableCopy(&containers_by_id_)->try_emplace(cid, std::move(container)).first;
+    cow_.Own(it->second);
   }
   VLOG(1) << "container update: " << update.name();
 
-  auto* container_info = it->second.get();
+  auto* container_info = MutableContainerInfoByID(cid);
   container_info->set_stop_time_ns(update.stop_timestamp_ns());
   container_info->set_state(ConvertToContainerState(update.container_state()));
   container_info->set_state_message(update.message());
   container_info->set_state_reason(update.reason());
 
-  containers_by_name_[update.name()] = cid;
+  UpdateIndex(&cow_, &containers_by_name_, update.name(), cid);
 
   return Status::OK();
 }
@@ -232,26 +261,29 @@ Status K8sMetadataState::HandleServiceUpdate(const ServiceUpdate& update) {
   const std::string& name = update.name();
   const std::string& ns = update.namespace_();
 
-  auto it = k8s_objects_by_id_.find(service_uid);
-  if (it == k8s_objects_by_id_.end()) {
+  if (!k8s_objects_by_id_->contains(service_uid)) {
     auto service = std::make_unique<ServiceInfo>(service_uid, ns, name);
     VLOG(1) << "Adding Service: " << service->DebugString();
-    it = k8s_objects_by_id_.try_emplace(service_uid, std::move(service)).first;
+    auto it =
+        cow_.MutableCopy(&k8s_objects_by_id_)->try_emplace(service_uid, std::move(service)).first;
+    cow_.Own(it->second);
   }
-  auto service_info = static_cast<ServiceInfo*>(it->second.get());
+  auto service_info = static_cast<ServiceInfo*>(MutableK8sMetadataObjectByID(service_uid));
 
   for (const auto& uid : update.pod_ids()) {
-    if (k8s_objects_by_id_.find(uid) == k8s_objects_by_id_.end()) {
+    auto it = k8s_objects_by_id_->find(uid);
+    if (it == k8s_objects_by_id_->end()) {
       // We should be resilient to the case where we happened to miss a pod update
       // in the stream of events. If we did miss a pod update, just skip adding the
       // pod to this particular service to avoid dangling references.
       LOG(INFO) << absl::Substitute("Didn't find pod UID $0 for service $1/$2", uid, ns, name);
       continue;
     }
-    ECHECK(k8s_objects_by_id_[uid]->type() == K8sObjectType::kPod);
+    ECHECK(it->second->type() == K8sObjectType::kPod);
     // We add the service uid to the pod. Lifetime of service still handled by the service object.
-    PodInfo* pod_info = static_cast<PodInfo*>(k8s_objects_by_id_[uid].get());
-    pod_info->AddService(service_uid);
+    if (!static_cast<const PodInfo*>(it->second.get())->services().contains(service_uid)) {
+      static_cast<PodInfo*>(MutableK8sMetadataObjectByID(uid))->AddService(service_uid);
+    }
   }
   if (update.start_timestamp_ns() != 0) {
     service_info->set_start_time_ns(update.start_timestamp_ns());
@@ -260,7 +292,7 @@ Status K8sMetadataState::HandleServiceUpdate(const ServiceUpdate& update) {
     service_info->set_stop_time_ns(update.stop_timestamp_ns());
   }
   if (update.cluster_ip() != "") {
-    services_by_cluster_ip_[update.cluster_ip()] = service_uid;
+    UpdateIndex(&cow_, &services_by_cluster_ip_, update.cluster_ip(), service_uid);
     service_info->set_cluster_ip(update.cluster_ip());
   }
   if (update.external_ips().size()) {
@@ -270,7 +302,7 @@ Status K8sMetadataState::HandleServiceUpdate(const ServiceUpdate& update) {
   }
 
   VLOG(1) << "service update: " << update.name();
-  services_by_name_[{ns, name}] = service_uid;
+  UpdateIndex(&cow_, &services_by_name_, {ns, name}, service_uid);
   return Status::OK();
 }
 
@@ -279,20 +311,21 @@ Status K8sMetadataState::HandleNamespaceUpdate(const NamespaceUpdate& update) {
   const std::string& name = update.name();
   const std::string& ns = update.name();
 
-  auto it = k8s_objects_by_id_.find(namespace_uid);
-  if (it == k8s_objects_by_id_.end()) {
+  if (!k8s_objects_by_id_->contains(namespace_uid)) {
     auto ns_obj = std::make_unique<NamespaceInfo>(namespace_uid, ns, name);
     VLOG(1) << "Adding Namespace: " << ns_obj->DebugString();
-    it = k8s_objects_by_id_.try_emplace(namespace_uid, std::move(ns_obj)).first;
+    auto it =
+        cow_.MutableCopy(&k8s_objects_by_id_)->try_emplace(namespace_uid, std::move(ns_obj)).first;
+    cow_.Own(it->second);
   }
-  auto ns_info = static_cast<NamespaceInfo*>(it->second.get());
+  auto ns_info = static_cast<NamespaceInfo*>(MutableK8sMetadataObjectByID(namespace_uid));
 
   ns_info->set_start_time_ns(update.start_timestamp_ns());
   ns_info->set_stop_time_ns(update.stop_timestamp_ns());
 
   VLOG(1) << "namespace update: " << update.name();
 
-  namespaces_by_name_[{ns, name}] = namespace_uid;
+  UpdateIndex(&cow_, &namespaces_by_name_, {ns, name}, namespace_uid);
   return Status::OK();
 }
 
@@ -310,37 +343,39 @@ bool IsExpired(const T& obj, int64_t retention_time, int64_t now) {
 Status K8sMetadataState::CleanupExpiredMetadata(int64_t retention_time_ns) {
   int64_t now = CurrentTimeNS();
 
-  for (auto iter = k8s_objects_by_id_.begin(); iter != k8s_objects_by_id_.end();) {
-    const auto& k8s_object = iter->second;
-
-    if (!IsExpired(*k8s_object, retention_time_ns, now)) {
-      ++iter;
-      continue;
+  // Find the expired objects first, so that the maps are only copied (if shared with a clone)
+  // when something is actually removed.
+  std::vector<std::shared_ptr<K8sMetadataObject>> expired_k8s_objects;
+  for (const auto& [id, k8s_object] : *k8s_objects_by_id_) {
+    if (IsExpired(*k8s_object, retention_time_ns, now)) {
+      expired_k8s_objects.push_back(k8s_object);
     }
+  }
 
+  for (const auto& k8s_object : expired_k8s_objects) {
     switch (k8s_object->type()) {
       case K8sObjectType::kPod:
         if (PodIDByName(std::make_pair(k8s_object->ns(), k8s_object->name())) ==
             k8s_object->uid()) {
-          pods_by_name_.erase({k8s_object->ns(), k8s_object->name()});
+          cow_.MutableCopy(&pods_by_name_)->erase({k8s_object->ns(), k8s_object->name()});
         }
         if (PodIDByIP(static_cast<PodInfo*>(k8s_object.get())->pod_ip()) ==
             k8s_object
                 ->uid()) {  // There could be a new pod assigned to the podIP now, we should only
                             // delete the IP from the map if it belongs to the terminated pod.
-          pods_by_ip_.erase(static_cast<PodInfo*>(k8s_object.get())->pod_ip());
+          cow_.MutableCopy(&pods_by_ip_)->erase(static_cast<PodInfo*>(k8s_object.get())->pod_ip());
         }
         break;
       case K8sObjectType::kNamespace:
         if (NamespaceIDByName(std::make_pair(k8s_object->ns(), k8s_object->name())) ==
             k8s_object->uid()) {
-          namespaces_by_name_.erase({k8s_object->ns(), k8s_object->name()});
+          cow_.MutableCopy(&namespaces_by_name_)->erase({k8s_object->ns(), k8s_object->name()});
         }
         break;
       case K8sObjectType::kService:
         if (ServiceIDByName(std::make_pair(k8s_object->ns(), k8s_object->name())) ==
             k8s_object->uid()) {
-          services_by_name_.erase({k8s_object->ns(), k8s_object->name()});
+          cow_.MutableCopy(&services_by_name_)->erase({k8s_object->ns(), k8s_object->name()});
         }
         break;
       default:
@@ -348,19 +383,19 @@ Status K8sMetadataState::CleanupExpiredMetadata(int64_t retention_time_ns) {
                                         static_cast<int>(k8s_object->type()));
     }
 
-    k8s_objects_by_id_.erase(iter++);
+    cow_.MutableCopy(&k8s_objects_by_id_)->erase(k8s_object->uid());
   }
 
-  for (auto iter = containers_by_id_.begin(); iter != containers_by_id_.end();) {
-    const auto& cinfo = iter->second;
-
-    if (!IsExpired(*cinfo, retention_time_ns, now)) {
-      ++iter;
-      continue;
+  std::vector<std::shared_ptr<ContainerInfo>> expired_containers;
+  for (const auto& [cid, cinfo] : *containers_by_id_) {
+    if (IsExpired(*cinfo, retention_time_ns, now)) {
+      expired_containers.push_back(cinfo);
     }
+  }
 
-    containers_by_name_.erase(cinfo->name());
-    containers_by_id_.erase(iter++);
+  for (const auto& cinfo : expired_containers) {
+    cow_.MutableCopy(&containers_by_name_)->erase(cinfo->name());
+    cow_.MutableCopy(&containers_by_id_)->erase(cinfo->cid());
   }
 
   return Status::OK();
@@ -372,10 +407,9 @@ std::shared_ptr<AgentMetadataState> AgentMetadataState::CloneToShared() const {
   state->epoch_id_ = epoch_id_;
   state->asid_ = asid_;
   state->k8s_metadata_state_ = k8s_metadata_state_->Clone();
-  state->pids_by_upid_.reserve(pids_by_upid_.size());
-  for (const auto& [k, v] : pids_by_upid_) {
-    state->pids_by_upid_[k] = v->Clone();
-  }
+  // The PIDs are shared until either state mutates them.
+  cow_.MarkShared();
+  state->pids_by_upid_ = pids_by_upid_;
   state->upids_ = upids_;
   return state;
 }
@@ -389,8 +423,8 @@ std::string AgentMetadataState::DebugString(int indent_level) const {
   str += prefix + absl::Substitute("EpochID: $0\n", epoch_id_);
   str += prefix + absl::Substitute("LastUpdateTS: $0\n", last_update_ts_ns_);
   str += prefix + k8s_metadata_state_->DebugString(indent_level);
-  str += prefix + absl::Substitute("PIDS($0)\n", pids_by_upid_.size());
-  for (const auto& [upid, upid_info] : pids_by_upid_) {
+  str += prefix + absl::Substitute("PIDS($0)\n", pids_by_upid_->size());
+  for (const auto& [upid, upid_info] : *pids_by_upid_) {
     str += prefix + absl::Substitute("$0\n", upid_info->DebugString());
   }
 
@@ -28,6 +28,7 @@
 
 #include "src/common/base/base.h"
 #include "src/shared/k8s/metadatapb/metadata.pb.h"
+#include "src/shared/metadata/copy_on_write.h"
 #include "src/shared/metadata/k8s_objects.h"
 #include "src/shared/metadata/pids.h"
 #include "src/shared/upid/upid.h"
@@ -40,8 +41,14 @@ using ContainerInfoUPtr = std::unique_ptr<ContainerInfo>;
 using PIDInfoUPtr = std::unique_ptr<PIDInfo>;
 using AgentID = sole::uuid;
 
+using PIDInfoByUPIDMap = absl::flat_hash_map<UPID, std::shared_ptr<PIDInfo>>;
+
 /**
  * This class contains all kubernetes relate metadata.
+ *
+ * Clones share their maps and objects, which are copied on the first mutation (see
+ * CopyOnWriteOwner),
+ * so a clone only costs as much as the updates applied to it.
  */
 class K8sMetadataState : NotCopyable {
  public:
@@ -99,6 +106,8 @@ class K8sMetadataState : NotCopyable {
   using ContainersByNameMap = absl::flat_hash_map<std::string, CID>;
   using PodsByPodIpMap = absl::flat_hash_map<std::string, UID>;
   using ServicesByServiceIpMap = absl::flat_hash_map<std::string, UID>;
+  using K8sObjectsByIDMap = absl::flat_hash_map<UID, std::shared_ptr<K8sMetadataObject>>;
+  using ContainersByIDMap = absl::flat_hash_map<CID, std::shared_ptr<ContainerInfo>>;
 
   void set_service_cidr(CIDRBlock cidr) {
     if (!service_cidr_.has_value() || service_cidr_.value() != cidr) {
@@ -112,7 +121,7 @@ class K8sMetadataState : NotCopyable {
 
   const std::vector<CIDRBlock>& pod_cidrs() const { return pod_cidrs_; }
 
-  const PodsByNameMap& pods_by_name() const { return pods_by_name_; }
+  const PodsByNameMap& pods_by_name() const { return *pods_by_name_; }
 
   /**
    * PodInfoByID gets an unowned pointer to the Pod. This pointer will remain active
@@ -150,6 +159,14 @@ class K8sMetadataState : NotCopyable {
    */
   const ContainerInfo* ContainerInfoByID(CIDView id) const;
 
+  /**
+   * MutableContainerInfoByID returns the container info by ID, for modification.
+   * If the container info is shared with a clone of this state, it is copied first.
+   * @param id The ID of the container.
+   * @return ContainerInfo or nullptr if not found.
+   */
+  ContainerInfo* MutableContainerInfoByID(CIDView id);
+
   /**
    * ContainerIDByName returns the ContainerID for the container of the given name.
    * @param container_name the container name
@@ -196,11 +213,13 @@ class K8sMetadataState : NotCopyable {
 
   Status CleanupExpiredMetadata(int64_t retention_time_ns);
 
-  absl::flat_hash_map<CID, ContainerInfoUPtr>& containers_by_id() { return containers_by_id_; }
+  const ContainersByIDMap& containers_by_id() const { return *containers_by_id_; }
   std::string DebugString(int indent_level = 0) const;
 
  private:
   const K8sMetadataObject* K8sMetadataObjectByID(UIDView id, K8sObjectType type) const;
+  // Returns a mutable pointer to the K8s object, copying it (and the map) if shared with a clone.
+  K8sMetadataObject* MutableK8sMetadataObjectByID(UIDView id);
 
   // The CIDR block used for services inside the cluster.
   std::optional<CIDRBlock> service_cidr_;
@@ -208,41 +227,49 @@ class K8sMetadataState : NotCopyable {
   // The CIDRs used for pods inside the cluster.
   std::vector<CIDRBlock> pod_cidrs_;
 
+  // Tracks which of the maps below, and of the objects in them, this state may mutate in place.
+  CopyOnWriteOwner cow_;
+
+  // The maps below are shared with clones. Mutate them through cow_.MutableCopy().
+
   // This stores K8s native objects (services, pods, etc).
-  absl::flat_hash_map<UID, K8sMetadataObjectUPtr> k8s_objects_by_id_;
+  std::shared_ptr<K8sObjectsByIDMap> k8s_objects_by_id_ = std::make_shared<K8sObjectsByIDMap>();
 
   // This stores container objects, complementing k8s_objects_by_id_.
-  absl::flat_hash_map<CID, ContainerInfoUPtr> containers_by_id_;
+  std::shared_ptr<ContainersByIDMap> containers_by_id_ = std::make_shared<ContainersByIDMap>();
 
   /**
    * Mapping of pods by name.
    */
-  PodsByNameMap pods_by_name_;
+  std::shared_ptr<PodsByNameMap> pods_by_name_ = std::make_shared<PodsByNameMap>();
 
   /**
    * Mapping of services by name.
    */
-  ServicesByNameMap services_by_name_;
+  std::shared_ptr<ServicesByNameMap> services_by_name_ = std::make_shared<ServicesByNameMap>();
 
   /**
    * Mapping of namespaces by name.
    */
-  NamespacesByNameMap namespaces_by_name_;
+  std::shared_ptr<NamespacesByNameMap> namespaces_by_name_ =
+      std::make_shared<NamespacesByNameMap>();
 
   /**
    * Mapping of containers by name.
    */
-  ContainersByNameMap containers_by_name_;
+  std::shared_ptr<ContainersByNameMap> containers_by_name_ =
+      std::make_shared<ContainersByNameMap>();
 
   /**
    * Mapping of Pods by host ip.
    */
-  PodsByPodIpMap pods_by_ip_;
+  std::shared_ptr<PodsByPodIpMap> pods_by_ip_ = std::make_shared<PodsByPodIpMap>();
 
   /**
    * Mapping of Services by Cluster IP.
    */
-  ServicesByServiceIpMap services_by_cluster_ip_;
+  std::shared_ptr<ServicesByServiceIpMap> services_by_cluster_ip_ =
+      std::make_shared<ServicesByServiceIpMap>();
 };
 
 class AgentMetadataState : NotCopyable {
@@ -277,9 +304,9 @@ class AgentMetadataState : NotCopyable {
 
   std::shared_ptr<AgentMetadataState> CloneToShared() const;
 
-  PIDInfo* GetPIDByUPID(UPID upid) const {
-    auto it = pids_by_upid_.find(upid);
-    if (it != pids_by_upid_.end()) {
+  const PIDInfo* GetPIDByUPID(UPID upid) const {
+    auto it = pids_by_upid_->find(upid);
+    if (it != pids_by_upid_->end()) {
       return it->second.get();
     }
     return nullptr;
@@ -289,23 +316,27 @@ class AgentMetadataState : NotCopyable {
     DCHECK(pid_info != nullptr);
     DCHECK_EQ(pid_info->stop_time_ns(), 0);
 
-    pids_by_upid_[upid] = std::move(pid_info);
-    upids_.insert(upid);
+    auto& pid_info_ptr = (*cow_.MutableCopy(&pids_by_upid_))[upid];
+    pid_info_ptr = std::move(pid_info);
+    cow_.Own(pid_info_ptr);
+    cow_.MutableCopy(&upids_)->insert(upid);
   }
 
   void MarkUPIDAsStopped(UPID upid, int64_t ts) {
-    auto* pid_info = GetPIDByUPID(upid);
-    if (pid_info != nullptr) {
-      pid_info->set_stop_time_ns(ts);
-      upids_.erase(upid);
-    } else {
-      DCHECK(!upids_.contains(upid));
+    if (!pids_by_upid_->contains(upid)) {
+      DCHECK(!upids_->contains(upid));
+      return;
+    }
+    auto& pid_info = cow_.MutableCopy(&pids_by_upid_)->find(upid)->second;
+    cow_.MutableCopy(&pid_info)->set_stop_time_ns(ts);
+    if (upids_->contains(upid)) {
+      cow_.MutableCopy(&upids_)->erase(upid);
     }
   }
 
-  const absl::flat_hash_map<UPID, PIDInfoUPtr>& pids_by_upid() const { return pids_by_upid_; }
+  const PIDInfoByUPIDMap& pids_by_upid() const { return *pids_by_upid_; }
 
-  const absl::flat_hash_set<md::UPID>& upids() const { return upids_; }
+  const absl::flat_hash_set<md::UPID>& upids() const { return *upids_; }
 
   std::string DebugString(int indent_level = 0) const;
 
@@ -330,17 +361,23 @@ class AgentMetadataState : NotCopyable {
 
   std::unique_ptr<K8sMetadataState> k8s_metadata_state_;
 
+  // Tracks which of the PID maps below, and of their PIDInfos, this state may mutate in place.
+  CopyOnWriteOwner cow_;
+
   /**
    * Mapping of PIDs by UPID for active pods on the system.
+   * Shared with clones; mutate through cow_.MutableCopy().
    */
-  absl::flat_hash_map<UPID, PIDInfoUPtr> pids_by_upid_;
+  std::shared_ptr<PIDInfoByUPIDMap> pids_by_upid_ = std::make_shared<PIDInfoByUPIDMap>();
 
   /**
    * All active UPIDs. Unlike pids_by_upid_, this does not contain stopped pids.
    * While this set could be reconstructed from pids_by_upid_,
    * it is tracked separately as a performance optimization.
+   * Shared with clones; mutate through cow_.MutableCopy().
    */
-  absl::flat_hash_set<md::UPID> upids_;
+  std::shared_ptr<absl::flat_hash_set<md::UPID>> upids_ =
+      std::make_shared<absl::flat_hash_set<md::UPID>>();
 };
 
 }  // namespace md
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+
+#include "src/common/benchmark/benchmark.h"
+#include "src/shared/metadata/metadata_state.h"
+
+using ::px::md::AgentMetadataState;
+using ::px::md::K8sMetadataState;
+using ::px::md::PIDInfo;
+using ::px::md::UPID;
+
+namespace {
+
+K8sMetadataState::ContainerUpdate ContainerUpdate(int i) {
+  K8sMetadataState::ContainerUpdate update;
+  update.set_cid(absl::StrCat("container", i, "_uid"));
+  update.set_name(absl::StrCat("container", i));
+  update.set_namespace_("ns0");
+  update.set_start_timestamp_ns(100);
+  update.set_container_state(px::shared::k8s::metadatapb::CONTAINER_STATE_RUNNING);
+  return update;
+}
+
+K8sMetadataState::PodUpdate PodUpdate(int i) {
+  K8sMetadataState::PodUpdate update;
+  update.set_uid(absl::StrCat("pod", i, "_uid"));
+  update.set_name(absl::StrCat("pod", i));
+  update.set_namespace_("ns0");
+  update.set_start_timestamp_ns(100);
+  update.add_container_ids(absl::StrCat("container", i, "_uid"));
+  update.set_pod_ip(absl::StrCat("10.", i / 65536, ".", (i / 256) % 256, ".", i % 256));
+  update.set_node_name("node0");
+  update.set_phase(px::shared::k8s::metadatapb::RUNNING);
+  return update;
+}
+
+// Creates a state with one container and one process per pod.
+std::unique_ptr<AgentMetadataState> CreateState(int num_pods) {
+  auto state = std::make_unique<AgentMetadataState>(/* asid */ 1);
+  for (int i = 0; i < num_pods; ++i) {
+    PL_CHECK_OK(state->k8s_metadata_state()->HandleContainerUpdate(ContainerUpdate(i)));
+    PL_CHECK_OK(state->k8s_metadata_state()->HandlePodUpdate(PodUpdate(i)));
+    UPID upid(1, i, 1000);
+    state->AddUPID(upid, std::make_unique<PIDInfo>(upid, "cmdline", absl::StrCat("container", i)));
+  }
+  return state;
+}
+
+}  // namespace
+
+// Cost of taking a snapshot of the state, as done at the start of every metadata update.
+static void BM_CloneToShared(benchmark::State& state) {  // NOLINT
+  std::unique_ptr<AgentMetadataState> md_state = CreateState(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(md_state->CloneToShared());
+  }
+}
+
+// Cost of a metadata update that modifies a single pod and a single process.
+static void BM_CloneAndUpdate(benchmark::State& state) {  // NOLINT
+  std::shared_ptr<AgentMetadataState> md_state = CreateState(state.range(0))->CloneToShared();
+  K8sMetadataState::PodUpdate pod_update = PodUpdate(0);
+  int64_t ts = 0;
+  for (auto _ : state) {
+    std::shared_ptr<AgentMetadataState> next = md_state->CloneToShared();
+    pod_update.set_stop_timestamp_ns(++ts);
+    PL_CHECK_OK(next->k8s_metadata_state()->HandlePodUpdate(pod_update));
+    next->MarkUPIDAsStopped(UPID(1, 0, 1000), ts);
+    md_state = std::move(next);
+  }
+}
+
+BENCHMARK(BM_CloneToShared)->RangeMultiplier(10)->Range(100, 100000);
+BENCHMARK(BM_CloneAndUpdate)->RangeMultiplier(10)->Range(100, 100000);
@@ -169,6 +169,37 @@ TEST(K8sMetadataStateTest, CloneCopiedCIDR) {
   EXPECT_EQ(service_cidr.prefix_length, state_copy->service_cidr()->prefix_length);
 }
 
+TEST(K8sMetadataStateTest, CloneSharesUntilModified) {
+  K8sMetadataState state;
+
+  K8sMetadataState::ContainerUpdate container_update;
+  ASSERT_TRUE(TextFormat::MergeFromString(kContainer0UpdatePbTxt, &container_update));
+  K8sMetadataState::PodUpdate pod_update;
+  ASSERT_TRUE(TextFormat::MergeFromString(kPod0UpdatePbTxt, &pod_update));
+  ASSERT_OK(state.HandleContainerUpdate(container_update));
+  ASSERT_OK(state.HandlePodUpdate(pod_update));
+
+  auto state_copy = state.Clone();
+
+  // Unmodified objects are shared.
+  EXPECT_EQ(state_copy->PodInfoByID("pod0_uid"), state.PodInfoByID("pod0_uid"));
+  EXPECT_EQ(state_copy->ContainerInfoByID("container0_uid"),
+            state.ContainerInfoByID("container0_uid"));
+
+  // Modifying the copy does not affect the original.
+  container_update.set_message("another container message");
+  ASSERT_OK(state_copy->HandleContainerUpdate(container_update));
+  EXPECT_EQ("another container message",
+            state_copy->ContainerInfoByID("container0_uid")->state_message());
+  EXPECT_EQ("a container message", state.ContainerInfoByID("container0_uid")->state_message());
+  EXPECT_EQ(state_copy->PodInfoByID("pod0_uid"), state.PodInfoByID("pod0_uid"));
+
+  ASSERT_OK(state_copy->CleanupExpiredMetadata(/* retention_time_ns */ 0));
+  EXPECT_EQ(nullptr, state_copy->PodInfoByID("pod0_uid"));
+  EXPECT_NE(nullptr, state.PodInfoByID("pod0_uid"));
+  EXPECT_EQ("pod0_uid", state.PodIDByName({"ns0", "pod0"}));
+}
+
 TEST(K8sMetadataStateTest, HandleContainerUpdate) {
   K8sMetadataState state;
 
@@ -421,5 +452,43 @@ TEST(K8sMetadataStateTest, CleanupExpiredMetadata) {
   }
 }
 
+TEST(AgentMetadataStateTest, CloneToSharedSharesUntilModified) {
+  AgentMetadataState state(/* asid */ 1);
+  UPID upid0(1, 100, 1000);
+  UPID upid1(1, 101, 1000);
+  state.AddUPID(upid0, std::make_unique<PIDInfo>(upid0, "cmdline0", "container0_uid"));
+  state.AddUPID(upid1, std::make_unique<PIDInfo>(upid1, "cmdline1", "container0_uid"));
+
+  std::shared_ptr<AgentMetadataState> state_copy = state.CloneToShared();
+  EXPECT_EQ(state_copy->GetPIDByUPID(upid0), state.GetPIDByUPID(upid0));
+
+  state_copy->MarkUPIDAsStopped(upid0, /* ts */ 2000);
+  EXPECT_EQ(2000, state_copy->GetPIDByUPID(upid0)->stop_time_ns());
+  EXPECT_EQ(0, state.GetPIDByUPID(upid0)->stop_time_ns());
+  EXPECT_THAT(state_copy->upids(), UnorderedElementsAre(upid1));
+  EXPECT_THAT(state.upids(), UnorderedElementsAre(upid0, upid1));
+
+  // The unmodified PID is still shared.
+  EXPECT_EQ(state_copy->GetPIDByUPID(upid1), state.GetPIDByUPID(upid1));
+}
+
+TEST(AgentMetadataStateTest, CloneToSharedCopiesValuesOfEitherState) {
+  AgentMetadataState state(/* asid */ 1);
+  UPID upid0(1, 100, 1000);
+  state.AddUPID(upid0, std::make_unique<PIDInfo>(upid0, "cmdline0", "container0_uid"));
+
+  // The values that the state created are mutated in place until it is cloned.
+  const PIDInfo* pid_info = state.GetPIDByUPID(upid0);
+  state.MarkUPIDAsStopped(upid0, /* ts */ 1000);
+  EXPECT_EQ(pid_info, state.GetPIDByUPID(upid0));
+
+  // Once cloned, mutating the original state does not affect the clone either.
+  std::shared_ptr<AgentMetadataState> state_copy = state.CloneToShared();
+  state.MarkUPIDAsStopped(upid0, /* ts */ 2000);
+  EXPECT_EQ(2000, state.GetPIDByUPID(upid0)->stop_time_ns());
+  EXPECT_EQ(1000, state_copy->GetPIDByUPID(upid0)->stop_time_ns());
+  EXPECT_NE(state_copy->GetPIDByUPID(upid0), state.GetPIDByUPID(upid0));
+}
+
 }  // namespace md
 }  // namespace px
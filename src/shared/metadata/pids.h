@@ -49,7 +49,7 @@ class PIDInfo {
 
   const CID& cid() const { return cid_; }
 
-  std::unique_ptr<PIDInfo> Clone() {
+  std::unique_ptr<PIDInfo> Clone() const {
     auto pid_info = std::make_unique<PIDInfo>(*this);
     return pid_info;
   }
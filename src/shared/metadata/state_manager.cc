@@ -166,6 +166,19 @@ StatusOr<UPID> InitUPID(const system::ProcParser& proc_parser, uint32_t asid, ui
   return UPID(asid, pid, pid_start_time);
 }
 
+// Returns true if the PIDs of the UPIDs are exactly the given PIDs.
+bool SamePIDs(const absl::flat_hash_set<UPID>& upids, const absl::flat_hash_set<uint32_t>& pids) {
+  if (upids.size() != pids.size()) {
+    return false;
+  }
+  for (const auto& upid : upids) {
+    if (!pids.contains(upid.pid())) {
+      return false;
+    }
+  }
+  return true;
+}
+
 }  // namespace
 
 void ProcessContainerPIDUpdates(
@@ -221,7 +234,12 @@ Status ProcessPIDUpdates(
     int64_t ts, const system::ProcParser& proc_parser, AgentMetadataState* md,
     CGroupMetadataReader* md_reader,
     moodycamel::BlockingConcurrentQueue<std::unique_ptr<PIDStatusEvent>>* pid_updates) {
-  const auto& k8s_md_state = md->k8s_metadata_state();
+  K8sMetadataState* k8s_md_state = md->k8s_metadata_state();
+
+  // Containers are shared with the previous metadata state, and copied when modified.
+  // So only the containers whose PIDs changed are modified, after iterating over all of them.
+  std::vector<std::pair<CID, int64_t>> stopped_containers;
+  std::vector<std::pair<CID, absl::flat_hash_set<UPID>>> container_upids;
 
   for (const auto& [cid, cinfo] : k8s_md_state->containers_by_id()) {
     if (cinfo->stop_time_ns() != 0) {
@@ -249,7 +267,7 @@ Status ProcessPIDUpdates(
     if (pod_info->stop_time_ns() != 0) {
       VLOG(1) << absl::Substitute("Found a running container in a deleted pod [cid=$0, pod_id=$1]",
                                   cid, pod_id);
-      cinfo->set_stop_time_ns(pod_info->stop_time_ns());
+      stopped_containers.emplace_back(cid, pod_info->stop_time_ns());
       continue;
     }
 
@@ -267,17 +285,30 @@ Status ProcessPIDUpdates(
       // NOTE: Currently, MDS sends pods that do no belong to this Agent, so this is actually
       // required to avoid repeatedly printing out the warning message above.
       if (error::IsNotFound(s)) {
-        cinfo->set_stop_time_ns(ts);
+        stopped_containers.emplace_back(cid, ts);
         for (const auto& upid : cinfo->active_upids()) {
           md->MarkUPIDAsStopped(upid, ts);
         }
-        cinfo->mutable_active_upids()->clear();
+        container_upids.emplace_back(cid, absl::flat_hash_set<UPID>{});
       }
       continue;
     }
 
-    ProcessContainerPIDUpdates(cid, ts, proc_parser, md, cinfo->mutable_active_upids(),
-                               &cgroups_active_pids, pid_updates);
+    if (SamePIDs(cinfo->active_upids(), cgroups_active_pids)) {
+      continue;
+    }
+
+    absl::flat_hash_set<UPID> upids = cinfo->active_upids();
+    ProcessContainerPIDUpdates(cid, ts, proc_parser, md, &upids, &cgroups_active_pids,
+                               pid_updates);
+    container_upids.emplace_back(cid, std::move(upids));
+  }
+
+  for (const auto& [cid, stop_time_ns] : stopped_containers) {
+    k8s_md_state->MutableContainerInfoByID(cid)->set_stop_time_ns(stop_time_ns);
+  }
+  for (auto& [cid, upids] : container_upids) {
+    *k8s_md_state->MutableContainerInfoByID(cid)->mutable_active_upids() = std::move(upids);
   }
 
   return Status::OK();
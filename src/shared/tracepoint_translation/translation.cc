@@ -53,6 +53,13 @@ void CopyOutput(const carnot::planner::dynamic_tracing::ir::logical::Output& in,
   for (const auto& field : in.fields()) {
     out->add_fields(field);
   }
+  if (in.has_aggregation()) {
+    auto* aggregation = out->mutable_aggregation();
+    // The planner and Stirling define the same aggregation ops.
+    aggregation->set_op(static_cast<stirling::dynamic_tracing::ir::shared::OutputAggregation::Op>(
+        in.aggregation().op()));
+    aggregation->set_value_field(in.aggregation().value_field());
+  }
 }
 
 void CopyArg(const carnot::planner::dynamic_tracing::ir::logical::Argument& in,
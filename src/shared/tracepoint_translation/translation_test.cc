@@ -273,5 +273,49 @@ TEST_F(TracepointManagerTest, BPFTraceDeployment) {
               testing::proto::Partially(testing::proto::EqualsProto(kStirlingBPFTraceDeployment)));
 }
 
+constexpr char kPlannerAggregatedOutput[] = R"(
+programs {
+  spec {
+    outputs {
+      name: "latency_histogram"
+      fields: "stream_id"
+      fields: "latency"
+      aggregation {
+        op: LOG2_HISTOGRAM
+        value_field: "latency"
+      }
+    }
+  }
+}
+)";
+
+constexpr char kStirlingAggregatedOutput[] = R"(
+tracepoints {
+  program {
+    outputs {
+      name: "latency_histogram"
+      fields: "stream_id"
+      fields: "latency"
+      aggregation {
+        op: LOG2_HISTOGRAM
+        value_field: "latency"
+      }
+    }
+  }
+}
+)";
+
+TEST_F(TracepointManagerTest, AggregatedOutput) {
+  PlannerDeployment planner_deployment;
+  CHECK(TextFormat::ParseFromString(kPlannerAggregatedOutput, &planner_deployment));
+
+  StirlingDeployment stirling_deployment;
+
+  ConvertPlannerTracepointToStirlingTracepoint(planner_deployment, &stirling_deployment);
+
+  EXPECT_THAT(stirling_deployment,
+              testing::proto::Partially(testing::proto::EqualsProto(kStirlingAggregatedOutput)));
+}
+
 }  // namespace tracepoint
 }  // namespace px
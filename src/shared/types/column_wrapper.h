@@ -58,6 +58,7 @@ class ColumnWrapper {
   virtual const BaseValueType* UnsafeRawData() const = 0;
   virtual DataType data_type() const = 0;
   virtual size_t Size() const = 0;
+  virtual size_t Capacity() const = 0;
   virtual bool Empty() const = 0;
   virtual int64_t Bytes() const = 0;
 
@@ -112,6 +113,7 @@ class ColumnWrapperTmpl : public ColumnWrapper {
   DataType data_type() const override { return ValueTypeTraits<T>::data_type; }
 
   size_t Size() const override { return data_.size(); }
+  size_t Capacity() const override { return data_.capacity(); }
   bool Empty() const override { return data_.empty(); }
 
   std::shared_ptr<arrow::Array> ConvertToArrow(arrow::MemoryPool* mem_pool) override {
@@ -122,7 +124,7 @@ class ColumnWrapperTmpl : public ColumnWrapper {
 
   T& operator[](size_t idx) { return data_[idx]; }
 
-  void Append(T val) { data_.push_back(val); }
+  void Append(T val) { data_.push_back(std::move(val)); }
 
   void Reserve(size_t size) override { data_.reserve(size); }
 
@@ -293,7 +295,7 @@ inline void ColumnWrapper::Append(TValueType val) {
   CHECK_EQ(data_type(), ValueTypeTraits<TValueType>::data_type)
       << "Expect " << ToString(data_type()) << " got "
       << ToString(ValueTypeTraits<TValueType>::data_type);
-  static_cast<ColumnWrapperTmpl<TValueType>*>(this)->Append(val);
+  static_cast<ColumnWrapperTmpl<TValueType>*>(this)->Append(std::move(val));
 }
 
 template <class TValueType>
@@ -311,7 +313,7 @@ inline TValueType ColumnWrapper::Get(size_t idx) const {
 template <class TValueType>
 inline void ColumnWrapper::AppendNoTypeCheck(TValueType val) {
   DCHECK_EQ(data_type(), ValueTypeTraits<TValueType>::data_type);
-  static_cast<ColumnWrapperTmpl<TValueType>*>(this)->Append(val);
+  static_cast<ColumnWrapperTmpl<TValueType>*>(this)->Append(std::move(val));
 }
 
 template <class TValueType>
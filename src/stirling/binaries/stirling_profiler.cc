@@ -16,9 +16,13 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <algorithm>
 #include <csignal>
 #include <iostream>
+#include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 
 #include "src/common/base/base.h"
 #include "src/shared/upid/upid.h"
@@ -70,31 +74,81 @@ Status ParseArgs(int argc, char** argv) {
   return Status::OK();
 }
 
+// Stack trace ID => folded stack trace string, from stack_trace_strings.beta, for the target PID.
+absl::flat_hash_map<int64_t, std::string> g_stack_trace_strs;
+
+// Stack trace ID and count of the records of stack_traces_v2.beta for the target PID,
+// for which the stack trace string has not been received yet.
+std::vector<std::pair<int64_t, int64_t>> g_pending_stack_traces;
+
+// The strings are pushed along with the stack traces that first use them, so a record only stays
+// pending if its string was lost. The oldest records are dropped beyond this limit.
+constexpr size_t kMaxPendingStackTraces = 10000;
+
+void PrintStackTraces() {
+  auto iter = std::remove_if(g_pending_stack_traces.begin(), g_pending_stack_traces.end(),
+                             [](const std::pair<int64_t, int64_t>& id_and_count) {
+                               auto str_iter = g_stack_trace_strs.find(id_and_count.first);
+                               if (str_iter == g_stack_trace_strs.end()) {
+                                 return false;
+                               }
+                               std::cout << str_iter->second << " " << id_and_count.second << "\n";
+                               g_data_received = true;
+                               return true;
+                             });
+  g_pending_stack_traces.erase(iter, g_pending_stack_traces.end());
+
+  if (g_pending_stack_traces.size() > kMaxPendingStackTraces) {
+    const size_t num_dropped = g_pending_stack_traces.size() - kMaxPendingStackTraces;
+    LOG(WARNING) << absl::Substitute("Dropping $0 stack traces without a stack trace string.",
+                                     num_dropped);
+    g_pending_stack_traces.erase(g_pending_stack_traces.begin(),
+                                 g_pending_stack_traces.begin() + num_dropped);
+  }
+}
+
 Status StirlingWrapperCallback(uint64_t table_id, TabletID /* tablet_id */,
                                std::unique_ptr<ColumnWrapperRecordBatch> record_batch) {
   // Find the table info from the publications.
   auto iter = g_table_info_map.find(table_id);
   CHECK(iter != g_table_info_map.end());
   const InfoClass& table_info = iter->second;
-  CHECK_EQ(table_info.schema().name(), "stack_traces.beta");
 
-  auto& upid_col = (*record_batch)[px::stirling::kStackTraceUPIDIdx];
-  auto& stack_trace_str_col = (*record_batch)[px::stirling::kStackTraceStackTraceStrIdx];
-  auto& count_col = (*record_batch)[px::stirling::kStackTraceCountIdx];
+  // stack_traces.beta has the same records as stack_traces_v2.beta, with the strings inline.
+  if (table_info.schema().name() == "stack_traces.beta") {
+    return Status::OK();
+  }
+
+  if (table_info.schema().name() == "stack_trace_strings.beta") {
+    auto& upid_col = (*record_batch)[px::stirling::kStackTraceStringsUPIDIdx];
+    auto& id_col = (*record_batch)[px::stirling::kStackTraceStringsStackTraceIDIdx];
+    auto& stack_trace_str_col = (*record_batch)[px::stirling::kStackTraceStringsStackTraceStrIdx];
+    for (size_t i = 0; i < id_col->Size(); ++i) {
+      UPID upid(upid_col->Get<px::types::UInt128Value>(i).val);
+
+      if (g_args.pid == upid.pid()) {
+        g_stack_trace_strs[id_col->Get<px::types::Int64Value>(i).val] =
+            stack_trace_str_col->Get<px::types::StringValue>(i);
+      }
+    }
+  } else {
+    CHECK_EQ(table_info.schema().name(), "stack_traces_v2.beta");
+
+    auto& upid_col = (*record_batch)[px::stirling::kStackTraceV2UPIDIdx];
+    auto& id_col = (*record_batch)[px::stirling::kStackTraceV2StackTraceIDIdx];
+    auto& count_col = (*record_batch)[px::stirling::kStackTraceV2CountIdx];
 
-  std::string out;
-  for (size_t i = 0; i < stack_trace_str_col->Size(); ++i) {
-    UPID upid(upid_col->Get<px::types::UInt128Value>(i).val);
+    for (size_t i = 0; i < id_col->Size(); ++i) {
+      UPID upid(upid_col->Get<px::types::UInt128Value>(i).val);
 
-    if (g_args.pid == upid.pid()) {
-      std::cout << stack_trace_str_col->Get<px::types::StringValue>(i);
-      std::cout << " ";
-      std::cout << count_col->Get<px::types::Int64Value>(i).val;
-      std::cout << "\n";
+      if (g_args.pid == upid.pid()) {
+        g_pending_stack_traces.emplace_back(id_col->Get<px::types::Int64Value>(i).val,
+                                            count_col->Get<px::types::Int64Value>(i).val);
+      }
     }
   }
 
-  g_data_received = true;
+  PrintStackTraces();
 
   return Status::OK();
 }
@@ -0,0 +1,71 @@
+/*
+ * This code runs using bpf in the Linux kernel.
+ * Copyright 2018- The Pixie Authors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * SPDX-License-Identifier: GPL-2.0
+ */
+
+// LINT_C_FILE: Do not remove this line. It ensures cpplint treats this as a C file.
+
+#include "src/stirling/bpf_tools/bcc_bpf/task_struct_utils.h"
+#include "src/stirling/bpf_tools/bcc_bpf_intf/proc_event.h"
+
+// Reports process creation and termination to user-space,
+// so that the set of live processes can be maintained without rescanning /proc.
+BPF_PERF_OUTPUT(proc_events);
+
+int on_task_newtask(struct tracepoint__task__task_newtask* args) {
+  // Threads are not processes.
+  if (args->clone_flags & CLONE_THREAD) {
+    return 0;
+  }
+
+  struct proc_event_t event = {};
+  event.type = kProcEventFork;
+  event.upid.tgid = args->pid;
+  proc_events.perf_submit(args, &event, sizeof(event));
+  return 0;
+}
+
+int on_sched_process_exec(struct tracepoint__sched__sched_process_exec* args) {
+  uint64_t id = bpf_get_current_pid_tgid();
+
+  struct proc_event_t event = {};
+  event.type = kProcEventExec;
+  event.upid.tgid = id >> 32;
+  event.upid.start_time_ticks = get_tgid_start_time();
+  proc_events.perf_submit(args, &event, sizeof(event));
+  return 0;
+}
+
+int on_sched_process_exit(struct tracepoint__sched__sched_process_exit* args) {
+  uint64_t id = bpf_get_current_pid_tgid();
+  uint32_t tgid = id >> 32;
+  uint32_t pid = id;
+
+  // Only report the exit of the thread group leader.
+  if (pid != tgid) {
+    return 0;
+  }
+
+  struct proc_event_t event = {};
+  event.type = kProcEventExit;
+  event.upid.tgid = tgid;
+  event.upid.start_time_ticks = get_tgid_start_time();
+  proc_events.perf_submit(args, &event, sizeof(event));
+  return 0;
+}
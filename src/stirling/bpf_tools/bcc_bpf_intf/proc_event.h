@@ -0,0 +1,37 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "src/stirling/bpf_tools/bcc_bpf_intf/upid.h"
+
+enum proc_event_type_t {
+  kProcEventUnknown,
+  // A new process was created by fork()/clone(), without CLONE_THREAD.
+  // The start time of the child is not known in BPF, and is left as zero.
+  kProcEventFork,
+  // A process called exec().
+  kProcEventExec,
+  // The thread group leader of a process exited.
+  kProcEventExit,
+};
+
+struct proc_event_t {
+  enum proc_event_type_t type;
+  struct upid_t upid;
+};
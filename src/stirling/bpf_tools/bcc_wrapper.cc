@@ -22,20 +22,57 @@
 #include <sys/mount.h>
 
 #include <iostream>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <utility>
 
 #include <magic_enum.hpp>
+#include <prometheus/counter.h>
+#include <prometheus/histogram.h>
 
 #include "src/common/base/base.h"
 #include "src/common/fs/fs_wrapper.h"
+#include "src/common/metrics/metrics.h"
+#include "src/common/perf/elapsed_timer.h"
 #include "src/common/system/config.h"
+#include "src/stirling/bpf_tools/task_struct_offsets_cache.h"
 #include "src/stirling/bpf_tools/task_struct_resolver.h"
 #include "src/stirling/utils/linux_headers.h"
 
+DEFINE_string(stirling_bpf_cache_dir, "",
+              "If not empty, the task_struct offsets that BPF programs need when the linux headers "
+              "do not match the host are persisted in this directory, so that restarts of "
+              "Stirling on the same kernel do not resolve them again.");
+
 namespace px {
 namespace stirling {
 namespace bpf_tools {
 
+namespace {
+
+void ObserveInitPhase(const std::string& phase, const ElapsedTimer& timer) {
+  static auto& family = prometheus::BuildHistogram()
+                            .Name("stirling_bpf_init_phase_seconds")
+                            .Help("Time spent in each phase of initializing a BPF program.")
+                            .Register(GetMetricsRegistry());
+  family
+      .Add({{"phase", phase}},
+           prometheus::Histogram::BucketBoundaries{0.01, 0.1, 0.5, 1, 2, 5, 10, 30, 60})
+      .Observe(timer.ElapsedTime_us() / 1.0E6);
+}
+
+prometheus::Counter& TaskStructOffsetsLookupCounter(const std::string& result) {
+  static auto& family = prometheus::BuildCounter()
+                            .Name("stirling_bpf_task_struct_offsets_lookups")
+                            .Help("Lookups of the task_struct offsets needed by BPF programs, by "
+                                  "where they were found.")
+                            .Register(GetMetricsRegistry());
+  return family.Add({{"result", result}});
+}
+
+}  // namespace
+
 // TODO(yzhao): Read CPU count during runtime and set maxactive to Multiplier * N_CPU. That way, we
 // can be relatively more secure against increase of CPU count. Note the default multiplier is 2,
 // which is not sufficient, as indicated in Hipster shop.
@@ -97,15 +134,50 @@ StatusOr<utils::TaskStructOffsets> GetTaskStructOffsets(bool always_infer_task_s
   // There is a flag to force the task struct fields resolution, in case we don't trust the
   // local headers, and for testing purposes.
   bool potentially_mismatched_headers = utils::g_packaged_headers_installed;
-  if (potentially_mismatched_headers || always_infer_task_struct_offsets) {
-    LOG(INFO) << "Resolving task_struct offsets.";
+  if (!potentially_mismatched_headers && !always_infer_task_struct_offsets) {
+    return offsets;
+  }
 
+  if (always_infer_task_struct_offsets) {
+    LOG(INFO) << "Resolving task_struct offsets.";
     PL_ASSIGN_OR_RETURN(offsets, ResolveTaskStructOffsets());
+  } else {
+    // Resolving the offsets compiles and runs a BPF program of its own, and the offsets only
+    // depend on the running kernel. So they are resolved once per process, and persisted across
+    // restarts if there is a cache directory.
+    static std::mutex mu;
+    static std::optional<utils::TaskStructOffsets> resolved_offsets;
+    std::lock_guard<std::mutex> lock(mu);
+    if (resolved_offsets.has_value()) {
+      TaskStructOffsetsLookupCounter("memory").Increment();
+      return resolved_offsets.value();
+    }
 
-    LOG(INFO) << absl::Substitute("Task struct offsets: group_leader=$0 real_start_time=$1",
-                                  offsets.group_leader_offset, offsets.real_start_time_offset);
+    std::optional<TaskStructOffsetsCache> cache;
+    if (!FLAGS_stirling_bpf_cache_dir.empty()) {
+      PL_ASSIGN_OR_RETURN(std::string kernel_key, TaskStructOffsetsCache::RunningKernelKey());
+      cache.emplace(FLAGS_stirling_bpf_cache_dir, std::move(kernel_key));
+      resolved_offsets = cache->Lookup();
+    }
+
+    if (resolved_offsets.has_value()) {
+      TaskStructOffsetsLookupCounter("disk").Increment();
+      offsets = resolved_offsets.value();
+    } else {
+      TaskStructOffsetsLookupCounter("resolved").Increment();
+      LOG(INFO) << "Resolving task_struct offsets.";
+      PL_ASSIGN_OR_RETURN(offsets, ResolveTaskStructOffsets());
+      resolved_offsets = offsets;
+      if (cache.has_value()) {
+        Status s = cache->Insert(offsets);
+        LOG_IF(WARNING, !s.ok()) << absl::Substitute(
+            "Could not persist task_struct offsets: $0", s.msg());
+      }
+    }
   }
 
+  LOG(INFO) << absl::Substitute("Task struct offsets: group_leader=$0 real_start_time=$1",
+                                offsets.group_leader_offset, offsets.real_start_time_offset);
   return offsets;
 }
 
@@ -118,7 +190,9 @@ Status BCCWrapper::InitBPFProgram(std::string_view bpf_program, std::vector<std:
     return error::PermissionDenied("BCC currently only supported as the root user.");
   }
 
+  ElapsedTimer timer;
   if (requires_linux_headers) {
+    timer.Start();
     PL_ASSIGN_OR_RETURN(utils::KernelVersion kernel_version, utils::GetKernelVersion());
 
     // This function will setup linux headers for BPF code deployment.
@@ -132,6 +206,7 @@ Status BCCWrapper::InitBPFProgram(std::string_view bpf_program, std::vector<std:
 
     LOG(INFO) << absl::Substitute("Using linux headers found at $0 for BCC runtime.",
                                   sys_headers_dir.string());
+    ObserveInitPhase("linux_headers", timer);
 
     // When Linux headers are requested, the BPF code requires various defines to compile:
     //  - START_BOOTTIME_VARNAME: The name of the task_struct variable containing the boottime.
@@ -147,8 +222,10 @@ Status BCCWrapper::InitBPFProgram(std::string_view bpf_program, std::vector<std:
         kernel_version.code() >= kLinux5p5VersionCode ? "start_boottime" : "real_start_time";
 
     // When there are mismatched headers, this determines offsets for required task_struct members.
+    timer.Start();
     PL_ASSIGN_OR_RETURN(TaskStructOffsets offsets,
                         GetTaskStructOffsets(always_infer_task_struct_offsets));
+    ObserveInitPhase("task_struct_offsets", timer);
 
     cflags.push_back(absl::Substitute("-DSTART_BOOTTIME_VARNAME=$0", boottime_varname));
     cflags.push_back(
@@ -159,10 +236,12 @@ Status BCCWrapper::InitBPFProgram(std::string_view bpf_program, std::vector<std:
 
   PL_RETURN_IF_ERROR(MountDebugFS());
 
+  timer.Start();
   auto init_res = bpf_.init(std::string(bpf_program), cflags);
   if (!init_res.ok()) {
     return error::Internal("Unable to initialize BCC BPF program: $0", init_res.msg());
   }
+  ObserveInitPhase("compile", timer);
   return Status::OK();
 }
 
@@ -339,6 +339,8 @@ class BCCWrapper {
     return bpf_.get_hash_table<TKeyType, TValueType>(table_name);
   }
 
+  ebpf::BPFTable GetTable(const std::string& table_name) { return bpf_.get_table(table_name); }
+
   template <typename TValueType>
   ebpf::BPFArrayTable<TValueType> GetArrayTable(const std::string& table_name) {
     return bpf_.get_array_table<TValueType>(table_name);
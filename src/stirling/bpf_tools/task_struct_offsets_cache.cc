@@ -0,0 +1,108 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "src/stirling/bpf_tools/task_struct_offsets_cache.h"
+
+#include <sys/utsname.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include <absl/strings/numbers.h>
+#include <absl/strings/str_split.h>
+
+#include "src/common/base/file.h"
+#include "src/common/fs/fs_wrapper.h"
+
+namespace px {
+namespace stirling {
+namespace bpf_tools {
+
+namespace {
+
+// Bump this whenever the format of the entry changes, so that entries persisted by an older
+// version are ignored.
+constexpr std::string_view kFormatVersion = "1";
+
+// Both offsets are of 8-byte fields (a pointer and a u64) well within task_struct, which is a few
+// KiB. Anything else means the entry is corrupt.
+constexpr uint64_t kMaxTaskStructOffset = 64 * 1024;
+
+bool IsValidOffset(uint64_t offset) {
+  return offset != 0 && offset < kMaxTaskStructOffset && offset % 8 == 0;
+}
+
+}  // namespace
+
+StatusOr<std::string> TaskStructOffsetsCache::RunningKernelKey() {
+  struct utsname buffer;
+  if (uname(&buffer) != 0) {
+    return error::Internal("Could not determine kernel version (uname): $0", strerror(errno));
+  }
+  return absl::StrCat(buffer.release, " ", buffer.version);
+}
+
+std::optional<utils::TaskStructOffsets> TaskStructOffsetsCache::Lookup() const {
+  StatusOr<std::string> entry = ReadFileToString(EntryPath().string());
+  if (!entry.ok()) {
+    return std::nullopt;
+  }
+
+  // The entry has one line each for the format version, the kernel key and the offsets.
+  std::vector<std::string_view> lines = absl::StrSplit(entry.ValueOrDie(), '\n');
+  if (lines.size() != 4 || lines[0] != kFormatVersion || lines[1] != kernel_key_ ||
+      !lines[3].empty()) {
+    VLOG(1) << absl::Substitute("Ignoring task_struct offsets persisted at $0.",
+                                EntryPath().string());
+    return std::nullopt;
+  }
+  std::vector<std::string_view> values = absl::StrSplit(lines[2], ' ');
+  utils::TaskStructOffsets offsets;
+  if (values.size() != 2 || !absl::SimpleAtoi(values[0], &offsets.real_start_time_offset) ||
+      !absl::SimpleAtoi(values[1], &offsets.group_leader_offset) ||
+      !IsValidOffset(offsets.real_start_time_offset) ||
+      !IsValidOffset(offsets.group_leader_offset) ||
+      offsets.real_start_time_offset == offsets.group_leader_offset) {
+    LOG(WARNING) << absl::Substitute("Ignoring invalid task_struct offsets persisted at $0.",
+                                     EntryPath().string());
+    return std::nullopt;
+  }
+  return offsets;
+}
+
+Status TaskStructOffsetsCache::Insert(const utils::TaskStructOffsets& offsets) const {
+  PL_RETURN_IF_ERROR(fs::CreateDirectories(cache_dir_));
+
+  // Write the entry next to its final path, so that the rename is atomic. The temporary file is
+  // unique to this process, in case several share the cache directory.
+  std::filesystem::path tmp_path = absl::StrCat(EntryPath().string(), ".tmp.", getpid());
+  Status s = WriteFileFromString(
+      tmp_path.string(),
+      absl::StrCat(kFormatVersion, "\n", kernel_key_, "\n", offsets.real_start_time_offset, " ",
+                   offsets.group_leader_offset, "\n"));
+  if (s.ok()) {
+    s = fs::Rename(tmp_path, EntryPath());
+  }
+  if (!s.ok()) {
+    PL_UNUSED(fs::Remove(tmp_path));
+  }
+  return s;
+}
+
+}  // namespace bpf_tools
+}  // namespace stirling
+}  // namespace px
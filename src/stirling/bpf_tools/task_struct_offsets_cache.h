@@ -0,0 +1,75 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "src/common/base/base.h"
+#include "src/stirling/bpf_tools/task_struct_resolver.h"
+
+namespace px {
+namespace stirling {
+namespace bpf_tools {
+
+/**
+ * Persists the TaskStructOffsets resolved on a host, so that restarts of Stirling on the same
+ * kernel can skip ResolveTaskStructOffsets(), which compiles and runs a BPF program of its own.
+ *
+ * The offsets only depend on the build of the running kernel, so a single entry is kept,
+ * tagged with the kernel it was resolved on. Entries of another kernel are ignored.
+ */
+class TaskStructOffsetsCache {
+ public:
+  /**
+   * @param cache_dir Directory in which the offsets are persisted.
+   * @param kernel_key Identifies the build of the running kernel; see RunningKernelKey().
+   */
+  TaskStructOffsetsCache(std::filesystem::path cache_dir, std::string kernel_key)
+      : cache_dir_(std::move(cache_dir)), kernel_key_(std::move(kernel_key)) {}
+
+  /**
+   * Returns a key that identifies the build of the running kernel: its release and version,
+   * as reported by uname(2).
+   */
+  static StatusOr<std::string> RunningKernelKey();
+
+  /**
+   * Returns the persisted offsets, if they were resolved on the same kernel and look valid.
+   */
+  std::optional<utils::TaskStructOffsets> Lookup() const;
+
+  /**
+   * Persists the offsets. The entry is written to a temporary file that then replaces the
+   * previous entry, so concurrent readers never see a partially written entry.
+   */
+  Status Insert(const utils::TaskStructOffsets& offsets) const;
+
+ private:
+  std::filesystem::path EntryPath() const { return cache_dir_ / "task_struct_offsets"; }
+
+  const std::filesystem::path cache_dir_;
+  const std::string kernel_key_;
+};
+
+}  // namespace bpf_tools
+}  // namespace stirling
+}  // namespace px
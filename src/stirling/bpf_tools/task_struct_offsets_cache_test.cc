@@ -0,0 +1,106 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "src/stirling/bpf_tools/task_struct_offsets_cache.h"
+
+#include <filesystem>
+
+#include "src/common/base/file.h"
+#include "src/common/testing/temp_dir.h"
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace stirling {
+namespace bpf_tools {
+
+using utils::TaskStructOffsets;
+
+TEST(TaskStructOffsetsCacheTest, persists_across_instances) {
+  testing::TempDir tmp_dir;
+  TaskStructOffsets offsets{.real_start_time_offset = 1696, .group_leader_offset = 1512};
+
+  {
+    TaskStructOffsetsCache cache(tmp_dir.path() / "cache", "5.10.0 #1 SMP");
+    EXPECT_EQ(cache.Lookup(), std::nullopt);
+    ASSERT_OK(cache.Insert(offsets));
+  }
+
+  TaskStructOffsetsCache cache(tmp_dir.path() / "cache", "5.10.0 #1 SMP");
+  EXPECT_EQ(cache.Lookup(), offsets);
+}
+
+TEST(TaskStructOffsetsCacheTest, ignores_other_kernels) {
+  testing::TempDir tmp_dir;
+  TaskStructOffsets offsets{.real_start_time_offset = 1696, .group_leader_offset = 1512};
+  ASSERT_OK(TaskStructOffsetsCache(tmp_dir.path(), "5.10.0 #1 SMP").Insert(offsets));
+
+  EXPECT_EQ(TaskStructOffsetsCache(tmp_dir.path(), "5.10.0 #2 SMP").Lookup(), std::nullopt);
+}
+
+TEST(TaskStructOffsetsCacheTest, ignores_garbage) {
+  testing::TempDir tmp_dir;
+  ASSERT_OK(WriteFileFromString((tmp_dir.path() / "task_struct_offsets").string(), "garbage"));
+
+  EXPECT_EQ(TaskStructOffsetsCache(tmp_dir.path(), "5.10.0 #1 SMP").Lookup(), std::nullopt);
+}
+
+TEST(TaskStructOffsetsCacheTest, ignores_invalid_offsets) {
+  testing::TempDir tmp_dir;
+  auto entry_path = (tmp_dir.path() / "task_struct_offsets").string();
+  TaskStructOffsetsCache cache(tmp_dir.path(), "5.10.0 #1 SMP");
+
+  ASSERT_OK(WriteFileFromString(entry_path, "1\n5.10.0 #1 SMP\n1696 1512\n"));
+  EXPECT_NE(cache.Lookup(), std::nullopt);
+
+  // Truncated.
+  ASSERT_OK(WriteFileFromString(entry_path, "1\n5.10.0 #1 SMP\n1696 15"));
+  EXPECT_EQ(cache.Lookup(), std::nullopt);
+  // Zero, misaligned, out of range and equal offsets.
+  ASSERT_OK(WriteFileFromString(entry_path, "1\n5.10.0 #1 SMP\n0 1512\n"));
+  EXPECT_EQ(cache.Lookup(), std::nullopt);
+  ASSERT_OK(WriteFileFromString(entry_path, "1\n5.10.0 #1 SMP\n1697 1512\n"));
+  EXPECT_EQ(cache.Lookup(), std::nullopt);
+  ASSERT_OK(WriteFileFromString(entry_path, "1\n5.10.0 #1 SMP\n1696 1048576\n"));
+  EXPECT_EQ(cache.Lookup(), std::nullopt);
+  ASSERT_OK(WriteFileFromString(entry_path, "1\n5.10.0 #1 SMP\n1512 1512\n"));
+  EXPECT_EQ(cache.Lookup(), std::nullopt);
+}
+
+TEST(TaskStructOffsetsCacheTest, insert_replaces_entry) {
+  testing::TempDir tmp_dir;
+  TaskStructOffsetsCache cache(tmp_dir.path(), "5.10.0 #1 SMP");
+  ASSERT_OK(cache.Insert({.real_start_time_offset = 1696, .group_leader_offset = 1512}));
+  TaskStructOffsets offsets{.real_start_time_offset = 1704, .group_leader_offset = 1520};
+  ASSERT_OK(cache.Insert(offsets));
+  EXPECT_EQ(cache.Lookup(), offsets);
+
+  // Only the entry is left behind.
+  int num_files = 0;
+  for ([[maybe_unused]] const auto& f : std::filesystem::directory_iterator(tmp_dir.path())) {
+    ++num_files;
+  }
+  EXPECT_EQ(num_files, 1);
+}
+
+TEST(TaskStructOffsetsCacheTest, running_kernel_key) {
+  ASSERT_OK_AND_ASSIGN(std::string key, TaskStructOffsetsCache::RunningKernelKey());
+  EXPECT_FALSE(key.empty());
+}
+
+}  // namespace bpf_tools
+}  // namespace stirling
+}  // namespace px
@@ -57,7 +57,7 @@ class ConnectorContext {
   /**
    * Return detailed information on UPIDs.
    */
-  virtual const absl::flat_hash_map<md::UPID, md::PIDInfoUPtr>& GetPIDInfoMap() const = 0;
+  virtual const md::PIDInfoByUPIDMap& GetPIDInfoMap() const = 0;
 
   /**
    * Return K8s information (Pod and container information)
@@ -95,7 +95,7 @@ class AgentContext : public ConnectorContext {
     return agent_metadata_state_->upids();
   }
 
-  const absl::flat_hash_map<md::UPID, md::PIDInfoUPtr>& GetPIDInfoMap() const override {
+  const md::PIDInfoByUPIDMap& GetPIDInfoMap() const override {
     return agent_metadata_state_->pids_by_upid();
   }
 
@@ -114,9 +114,18 @@ class AgentContext : public ConnectorContext {
  */
 class StandaloneContext : public ConnectorContext {
  public:
-  StandaloneContext() {
-    // The context consists of all PIDs, but no pods/containers.
-    upids_ = ListUPIDs(system::Config::GetInstance().proc_path(), 0);
+  // The context consists of all PIDs, but no pods/containers.
+  StandaloneContext()
+      : StandaloneContext(std::make_shared<const absl::flat_hash_set<md::UPID>>(
+            ListUPIDs(system::Config::GetInstance().proc_path(), 0))) {}
+
+  /**
+   * @param upids The set of UPIDs, when already known (e.g. from a ProcLifecycleTracker),
+   * so that /proc need not be scanned.
+   */
+  explicit StandaloneContext(std::shared_ptr<const absl::flat_hash_set<md::UPID>> upids)
+      : upids_(std::move(upids)) {
+    DCHECK(upids_ != nullptr);
 
     // Cannot be empty, otherwise stirling will wait indefinitely. Since StandaloneContext is used
     // for local environment, set it such that localhost (127.0.0.1) will be treated as outside of
@@ -127,10 +136,10 @@ class StandaloneContext : public ConnectorContext {
 
   uint32_t GetASID() const override { return 0; }
 
-  const absl::flat_hash_set<md::UPID>& GetUPIDs() const override { return upids_; }
+  const absl::flat_hash_set<md::UPID>& GetUPIDs() const override { return *upids_; }
 
-  const absl::flat_hash_map<md::UPID, md::PIDInfoUPtr>& GetPIDInfoMap() const override {
-    static const absl::flat_hash_map<md::UPID, md::PIDInfoUPtr> kEmpty;
+  const md::PIDInfoByUPIDMap& GetPIDInfoMap() const override {
+    static const md::PIDInfoByUPIDMap kEmpty;
     return kEmpty;
   }
 
@@ -145,7 +154,7 @@ class StandaloneContext : public ConnectorContext {
 
  private:
   std::vector<CIDRBlock> cidrs_;
-  absl::flat_hash_set<md::UPID> upids_;
+  std::shared_ptr<const absl::flat_hash_set<md::UPID>> upids_;
 };
 
 }  // namespace stirling
@@ -33,24 +33,65 @@ namespace stirling {
 using types::ColumnWrapper;
 using types::DataType;
 
-DataTable::DataTable(uint64_t id, const DataTableSchema& schema) : id_(id), table_schema_(schema) {}
+DataTable::DataTable(uint64_t id, const DataTableSchema& schema)
+    : id_(id), table_schema_(schema), column_subscribed_(schema.elements().size(), true) {}
+
+Status DataTable::UnsubscribeColumn(std::string_view col_name) {
+  const auto& elements = table_schema_.elements();
+  for (size_t i = 0; i < elements.size(); ++i) {
+    if (elements[i].name() != col_name) {
+      continue;
+    }
+    if (table_schema_.tabletized() && i == table_schema_.tabletization_key()) {
+      return error::InvalidArgument("Column $0 of table $1 is the tabletization key.", col_name,
+                                    table_schema_.name());
+    }
+    column_subscribed_[i] = false;
+    return Status::OK();
+  }
+  return error::NotFound("Table $0 has no column $1.", table_schema_.name(), col_name);
+}
 
 void DataTable::InitBuffers(types::ColumnWrapperRecordBatch* record_batch_ptr) {
   DCHECK(record_batch_ptr != nullptr);
   DCHECK(record_batch_ptr->empty());
 
+  const size_t reserved_records = ReservedRecordsPerTablet();
+
+  // Reuse the buffers of a previous batch if there are any, since they are already allocated.
+  if (!spare_record_batches_.empty()) {
+    *record_batch_ptr = std::move(spare_record_batches_.back());
+    spare_record_batches_.pop_back();
+    for (auto& col : *record_batch_ptr) {
+      // Release the buffers of a spare batch that outgrew what this table now pushes.
+      if (col->Capacity() > 2 * reserved_records) {
+        col->ShrinkToFit();
+      }
+      col->Reserve(reserved_records);
+    }
+    return;
+  }
+
   for (const auto& element : table_schema_.elements()) {
     px::types::DataType type = element.type();
 
 #define TYPE_CASE(_dt_)                           \
   auto col = types::ColumnWrapper::Make(_dt_, 0); \
-  col->Reserve(kTargetCapacity);                  \
+  col->Reserve(reserved_records);                 \
   record_batch_ptr->push_back(col);
     PL_SWITCH_FOREACH_DATATYPE(type, TYPE_CASE);
 #undef TYPE_CASE
   }
 }
 
+size_t DataTable::ReservedRecordsPerTablet() const {
+  // Leave some headroom over the average, so that a push slightly larger than usual does not
+  // reallocate every column.
+  size_t expected = ExpectedBatchSize() + ExpectedBatchSize() / 4;
+  expected /= std::max<size_t>(tablets_.size(), 1);
+  return std::clamp(expected, kMinReservedRecords, kMaxReservedRecords);
+}
+
 Tablet* DataTable::GetTablet(types::TabletIDView tablet_id) {
   auto& tablet = tablets_[tablet_id];
   if (tablet.records.empty()) {
@@ -59,10 +100,36 @@ Tablet* DataTable::GetTablet(types::TabletIDView tablet_id) {
   return &tablet;
 }
 
+namespace {
+
+bool IsIdentityPermutation(const std::vector<size_t>& indexes) {
+  for (size_t i = 0; i < indexes.size(); ++i) {
+    if (indexes[i] != i) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Whether the columns use most of their capacity. The table store accounts for the size of the
+// values only, so columns with much unused capacity would hide memory from it.
+bool NearCapacity(const types::ColumnWrapperRecordBatch& records) {
+  for (const auto& col : records) {
+    if (4 * col->Size() < 3 * col->Capacity()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
 std::vector<TaggedRecordBatch> DataTable::ConsumeRecords() {
   std::vector<TaggedRecordBatch> tablets_out;
   absl::flat_hash_map<types::TabletID, Tablet> carryover_tablets;
   uint64_t next_start_time = start_time_;
+  size_t num_records = 0;
+  size_t num_carryover_records = 0;
 
   for (auto& [tablet_id, tablet] : tablets_) {
     // Sort based on times.
@@ -84,6 +151,8 @@ std::vector<TaggedRecordBatch> DataTable::ConsumeRecords() {
     int num_expired = positions[0];
     int num_pushable = positions[1] - positions[0];
     int num_carryover = tablet.times.size() - positions[1];
+    num_records += tablet.times.size();
+    num_carryover_records += num_carryover;
 
     // Case 1: Expired records. Just print a message.
     VLOG_IF(1, num_expired > 0) << absl::Substitute(
@@ -93,14 +162,25 @@ std::vector<TaggedRecordBatch> DataTable::ConsumeRecords() {
 
     // Case 2: Pushable records. Copy to output.
     if (num_pushable > 0) {
-      // TODO(oazizi): Consider VectorView to avoid copying.
-      std::vector<size_t> push_indexes(sort_indexes.begin() + num_expired,
-                                       sort_indexes.end() - num_carryover);
       types::ColumnWrapperRecordBatch pushable_records;
-      for (auto& col : tablet.records) {
-        pushable_records.push_back(col->MoveIndexes(push_indexes));
+      uint64_t last_time = 0;
+      if (static_cast<size_t>(num_pushable) == tablet.times.size() &&
+          IsIdentityPermutation(sort_indexes) && NearCapacity(tablet.records)) {
+        // All records are pushed in the order they were appended, which is the common case,
+        // so the columns are handed off as they are instead of being copied into new columns.
+        // Columns that are mostly empty are copied into columns of the right size instead, and
+        // kept for the next tablet.
+        last_time = tablet.times.back();
+        pushable_records = std::move(tablet.records);
+      } else {
+        // TODO(oazizi): Consider VectorView to avoid copying.
+        std::vector<size_t> push_indexes(sort_indexes.begin() + num_expired,
+                                         sort_indexes.end() - num_carryover);
+        for (auto& col : tablet.records) {
+          pushable_records.push_back(col->MoveIndexes(push_indexes));
+        }
+        last_time = tablet.times[push_indexes.back()];
       }
-      uint64_t last_time = tablet.times[push_indexes.back()];
       next_start_time = std::max(next_start_time, last_time);
       tablets_out.push_back(TaggedRecordBatch{tablet_id, std::move(pushable_records)});
     }
@@ -122,11 +202,44 @@ std::vector<TaggedRecordBatch> DataTable::ConsumeRecords() {
       carryover_tablets[tablet_id] =
           Tablet{tablet_id, std::move(times), std::move(carryover_records)};
     }
+
+    // Unless they were handed off, the values of the columns have all been moved out by now.
+    // Keep the emptied columns around for the next tablet, so their buffers are not reallocated.
+    if (!tablet.records.empty() && spare_record_batches_.size() < kMaxSpareRecordBatches) {
+      for (auto& col : tablet.records) {
+        col->Clear();
+        if (col->Capacity() > kMaxReservedRecords) {
+          col->ShrinkToFit();
+        }
+      }
+      spare_record_batches_.push_back(std::move(tablet.records));
+    }
+  }
+  // Keep no more spare batches than there were tablets, which is about as many as the next call
+  // will need.
+  if (spare_record_batches_.size() > tablets_.size()) {
+    spare_record_batches_.resize(tablets_.size());
   }
   tablets_ = std::move(carryover_tablets);
 
   start_time_ = next_start_time;
 
+  // Update the expected batch size with the number of records appended since the last call,
+  // as an exponential moving average with a weight of 1/4 for the newest sample.
+  DCHECK_GE(num_records, num_carryover_records_);
+  const int64_t num_appended = num_records - num_carryover_records_;
+  expected_batch_size_fp_ +=
+      ((num_appended << kBatchSizeFracBits) - expected_batch_size_fp_) / 4;
+  num_carryover_records_ = num_carryover_records;
+
+  // Carried over records start the next batch, so make room for it up front.
+  const size_t reserved_records = ReservedRecordsPerTablet();
+  for (auto& [tablet_id, tablet] : tablets_) {
+    for (auto& col : tablet.records) {
+      col->Reserve(reserved_records);
+    }
+  }
+
   return tablets_out;
 }
 
@@ -21,6 +21,8 @@
 #include <algorithm>
 #include <limits>
 #include <memory>
+#include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -84,6 +86,19 @@ class DataTable : public NotCopyable {
     cutoff_time_ = cutoff_time;
   }
 
+  /**
+   * Stops collecting a column. RecordBuilders append an empty string to an unsubscribed string
+   * column in place of the value they are given, so the schema of the table stays the same while
+   * large values that nobody queries are freed right away. Other columns are cheap and keep their
+   * values. Connectors can also check ColumnSubscribed() to skip producing values altogether.
+   *
+   * @param col_name Name of the column to stop collecting.
+   * @return error if the column does not exist or is the tabletization key.
+   */
+  Status UnsubscribeColumn(std::string_view col_name);
+
+  bool ColumnSubscribed(size_t col_index) const { return column_subscribed_[col_index]; }
+
   /**
    * Return current occupancy of the Data Table.
    *
@@ -106,6 +121,18 @@ class DataTable : public NotCopyable {
    */
   double OccupancyPct() const { return 1.0 * Occupancy() / kTargetCapacity; }
 
+  /**
+   * Number of records the table is expected to hold when it is next consumed. This is a moving
+   * average of the number of records appended between previous calls to ConsumeRecords(), so it
+   * tracks the ingest rate of the table at the connector's push frequency. It sizes the column
+   * buffers of new tablets; it does not affect when the table is pushed.
+   *
+   * @return size_t expected number of records per push.
+   */
+  size_t ExpectedBatchSize() const {
+    return (expected_batch_size_fp_ + (1 << (kBatchSizeFracBits - 1))) >> kBatchSizeFracBits;
+  }
+
   // Example usage:
   // DataTable::RecordBuilder<&kTable> r(data_table, time);
   // r.Append<r.ColIndex("field0")>(val0);
@@ -130,14 +157,15 @@ class DataTable : public NotCopyable {
   class RecordBuilder {
    public:
     RecordBuilder(DataTable* data_table, types::TabletIDView tablet_id, uint64_t time = 0)
-        : tablet_(*data_table->GetTablet(tablet_id)) {
+        : tablet_(*data_table->GetTablet(tablet_id)),
+          column_subscribed_(data_table->column_subscribed_) {
       static_assert(schema->tabletized());
       tablet_id_ = tablet_id;
       Init(time);
     }
 
     explicit RecordBuilder(DataTable* data_table, uint64_t time = 0)
-        : tablet_(*data_table->GetTablet("")) {
+        : tablet_(*data_table->GetTablet("")), column_subscribed_(data_table->column_subscribed_) {
       static_assert(!schema->tabletized());
       Init(time);
     }
@@ -145,6 +173,10 @@ class DataTable : public NotCopyable {
     // For convenience, a wrapper around ColIndex() in the DataTableSchema class.
     constexpr uint32_t ColIndex(std::string_view name) { return schema->ColIndex(name); }
 
+    // Whether the value of the column is kept. Values that are expensive to produce should only
+    // be produced for subscribed columns.
+    bool Subscribed(size_t col_index) const { return column_subscribed_[col_index]; }
+
     // The argument type is inferred by the table schema and the column index.
     // Any string larger than TMaxStringBytes size will be truncated before being placed in the
     // record.
@@ -159,6 +191,9 @@ class DataTable : public NotCopyable {
       if constexpr (std::is_same_v<typename types::DataTypeTraits<
                                        schema->elements()[TIndex].type()>::value_type,
                                    types::StringValue>) {
+        if (!column_subscribed_[TIndex]) {
+          std::string().swap(val);
+        }
         if (val.size() > TMaxStringBytes) {
           val.resize(TMaxStringBytes);
           val.append(kTruncatedMsg);
@@ -195,6 +230,7 @@ class DataTable : public NotCopyable {
     }
 
     Tablet& tablet_;
+    const std::vector<bool>& column_subscribed_;
     std::bitset<schema->elements().size()> signature_;
     types::TabletIDView tablet_id_ = "";
   };
@@ -208,14 +244,18 @@ class DataTable : public NotCopyable {
   class DynamicRecordBuilder {
    public:
     DynamicRecordBuilder(DataTable* data_table, types::TabletIDView tablet_id, uint64_t time = 0)
-        : schema_(data_table->table_schema_), tablet_(*data_table->GetTablet(tablet_id)) {
+        : schema_(data_table->table_schema_),
+          column_subscribed_(data_table->column_subscribed_),
+          tablet_(*data_table->GetTablet(tablet_id)) {
       DCHECK(schema_.tabletized());
       tablet_id_ = tablet_id;
       Init(time);
     }
 
     explicit DynamicRecordBuilder(DataTable* data_table, uint64_t time = 0)
-        : schema_(data_table->table_schema_), tablet_(*data_table->GetTablet("")) {
+        : schema_(data_table->table_schema_),
+          column_subscribed_(data_table->column_subscribed_),
+          tablet_(*data_table->GetTablet("")) {
       DCHECK(!schema_.tabletized());
       Init(time);
     }
@@ -224,6 +264,9 @@ class DataTable : public NotCopyable {
     template <typename TValueType, const size_t TMaxStringBytes = 1024>
     inline void Append(size_t col_index, TValueType val) {
       if constexpr (std::is_same_v<TValueType, types::StringValue>) {
+        if (!column_subscribed_[col_index]) {
+          std::string().swap(val);
+        }
         if (val.size() > TMaxStringBytes) {
           val.resize(TMaxStringBytes);
           val.append(kTruncatedMsg);
@@ -254,6 +297,7 @@ class DataTable : public NotCopyable {
 
     static constexpr int kMaxSupportedColumns = 64;
     const DataTableSchema& schema_;
+    const std::vector<bool>& column_subscribed_;
     std::bitset<kMaxSupportedColumns> signature_ = 0;
     Tablet& tablet_;
     types::TabletIDView tablet_id_ = "";
@@ -265,23 +309,53 @@ class DataTable : public NotCopyable {
   // ColumnWrapper specific members
   static constexpr size_t kTargetCapacity = 1024;
 
+  // Bounds on the number of records reserved in the column buffers of a tablet.
+  static constexpr size_t kMinReservedRecords = 16;
+  static constexpr size_t kMaxReservedRecords = 4 * kTargetCapacity;
+
+  // Bound on the number of emptied record batches kept for reuse.
+  static constexpr size_t kMaxSpareRecordBatches = 8;
+
   // Unique ID set by InfoClassManager.
   const uint64_t id_;
 
   // Initialize a new Active record batch.
   void InitBuffers(types::ColumnWrapperRecordBatch* record_batch_ptr);
 
+  // Number of records to reserve in the column buffers of a tablet, based on the expected batch
+  // size shared among the tablets.
+  size_t ReservedRecordsPerTablet() const;
+
   // Get a pointer to the Tablet, for appending. Used by RecordBuilder.
   Tablet* GetTablet(types::TabletIDView tablet_id);
 
   // Table schema: a DataElement to describe each column.
   const DataTableSchema& table_schema_;
 
+  // Whether the values of each column are kept; see UnsubscribeColumn().
+  std::vector<bool> column_subscribed_;
+
   // Key is tablet id, value is tablet records.
   absl::flat_hash_map<types::TabletID, Tablet> tablets_;
 
+  // Record batches whose values were moved out by ConsumeRecords(). Their columns are empty, but
+  // keep their buffers, and are used by InitBuffers() before allocating new columns. Both the
+  // number of batches and the capacity of their columns are bounded.
+  std::vector<types::ColumnWrapperRecordBatch> spare_record_batches_;
+
   uint64_t start_time_ = 0;
 
+  // See ExpectedBatchSize(), in fixed point with kBatchSizeFracBits fractional bits, so that the
+  // average converges to the actual ingest rate instead of stalling short of it. Starts out at the
+  // target capacity, so that tables reserve as much as they used to until their actual ingest rate
+  // is known.
+  static constexpr int kBatchSizeFracBits = 8;
+  int64_t expected_batch_size_fp_ = int64_t{kTargetCapacity} << kBatchSizeFracBits;
+
+  // Number of records carried over by the last call to ConsumeRecords(), which are not counted
+  // again as newly appended records.
+  size_t num_carryover_records_ = 0;
+
   // The cutoff time is an optional field that sets up to which time
   // data source can guarantee that all events have been observed.
   // Used particularly by the socket tracer which receives asynchronous
@@ -69,6 +69,100 @@ TEST_F(DataTableTest, ResultIsSorted) {
   }
 }
 
+// The columns of the first, unsorted, batch are reused for the second one. No values should leak
+// between batches.
+TEST_F(DataTableTest, ReusedBuffers) {
+  for (int t : {20, 10, 30}) {
+    DataTable::RecordBuilder<&kSchema> r(data_table_.get(), t);
+    r.Append<r.ColIndex("time_")>(t);
+    r.Append<r.ColIndex("x")>(t);
+    r.Append<r.ColIndex("s")>(std::to_string(t));
+  }
+  std::vector<TaggedRecordBatch> record_batches = data_table_->ConsumeRecords();
+  ASSERT_EQ(record_batches.size(), 1);
+  ASSERT_EQ(record_batches[0].records[0]->Size(), 3);
+  EXPECT_EQ(record_batches[0].records[2]->Get<types::StringValue>(0), "10");
+
+  for (int t : {40, 50}) {
+    DataTable::RecordBuilder<&kSchema> r(data_table_.get(), t);
+    r.Append<r.ColIndex("time_")>(t);
+    r.Append<r.ColIndex("x")>(t);
+    r.Append<r.ColIndex("s")>(std::to_string(t));
+  }
+  record_batches = data_table_->ConsumeRecords();
+  ASSERT_EQ(record_batches.size(), 1);
+  types::ColumnWrapperRecordBatch& rb = record_batches[0].records;
+  ASSERT_EQ(rb[0]->Size(), 2);
+  EXPECT_EQ(rb[0]->Get<types::Time64NSValue>(0), 40);
+  EXPECT_EQ(rb[1]->Get<types::Int64Value>(1), 50);
+  EXPECT_EQ(rb[2]->Get<types::StringValue>(0), "40");
+  EXPECT_EQ(rb[2]->Get<types::StringValue>(1), "50");
+}
+
+// Whether handed off or copied, pushed columns do not hold much more capacity than values, since
+// the table store does not see that capacity.
+TEST_F(DataTableTest, PushedColumnsFitTheirValues) {
+  int t = 0;
+  for (int n : {3, 1000, 3}) {
+    for (int i = 0; i < n; ++i, ++t) {
+      DataTable::RecordBuilder<&kSchema> r(data_table_.get(), t);
+      r.Append<r.ColIndex("time_")>(t);
+      r.Append<r.ColIndex("x")>(t);
+      r.Append<r.ColIndex("s")>(std::to_string(t));
+    }
+    std::vector<TaggedRecordBatch> record_batches = data_table_->ConsumeRecords();
+    ASSERT_EQ(record_batches.size(), 1);
+    for (const auto& col : record_batches[0].records) {
+      ASSERT_EQ(col->Size(), n);
+      EXPECT_GE(4 * col->Size(), 3 * col->Capacity());
+    }
+  }
+}
+
+TEST_F(DataTableTest, ExpectedBatchSize) {
+  // Until the table has been consumed, it expects full batches.
+  EXPECT_EQ(data_table_->ExpectedBatchSize(), 1024);
+
+  // A steady ingest of 8 records per push pulls the expectation towards 8.
+  for (int i = 0; i < 32; ++i) {
+    for (int j = 0; j < 8; ++j) {
+      DataTable::RecordBuilder<&kSchema> r(data_table_.get());
+      r.Append<r.ColIndex("time_")>(0);
+      r.Append<r.ColIndex("x")>(j);
+      r.Append<r.ColIndex("s")>("a");
+    }
+    data_table_->ConsumeRecords();
+  }
+  EXPECT_EQ(data_table_->ExpectedBatchSize(), 8);
+
+  // Carried over records are only counted once.
+  for (int j = 0; j < 8; ++j) {
+    DataTable::RecordBuilder<&kSchema> r(data_table_.get(), 100 + j);
+    r.Append<r.ColIndex("time_")>(100 + j);
+    r.Append<r.ColIndex("x")>(j);
+    r.Append<r.ColIndex("s")>("a");
+  }
+  data_table_->SetConsumeRecordsCutoffTime(103);
+  data_table_->ConsumeRecords();
+  EXPECT_EQ(data_table_->ExpectedBatchSize(), 8);
+  data_table_->SetConsumeRecordsCutoffTime(107);
+  data_table_->ConsumeRecords();
+  EXPECT_EQ(data_table_->ExpectedBatchSize(), 6);
+
+  // The expectation converges from below as well, all the way to the actual ingest rate.
+  for (int i = 0; i < 32; ++i) {
+    for (int j = 0; j < 40; ++j) {
+      DataTable::RecordBuilder<&kSchema> r(data_table_.get(), 200);
+      r.Append<r.ColIndex("time_")>(200);
+      r.Append<r.ColIndex("x")>(j);
+      r.Append<r.ColIndex("s")>("a");
+    }
+    data_table_->SetConsumeRecordsCutoffTime(200);
+    data_table_->ConsumeRecords();
+  }
+  EXPECT_EQ(data_table_->ExpectedBatchSize(), 40);
+}
+
 // No time passed to RecordBuilder, so all timestamps should be zero.
 // That means there should never be any expired or carry-over records.
 // Also, nothing should be sorted in any way.
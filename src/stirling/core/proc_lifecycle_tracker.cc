@@ -0,0 +1,176 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/stirling/core/proc_lifecycle_tracker.h"
+
+#include <string>
+
+#include "src/common/base/file.h"
+#include "src/common/system/proc_parser.h"
+#include "src/stirling/bpf_tools/bcc_bpf_intf/proc_event.h"
+#include "src/stirling/bpf_tools/macros.h"
+#include "src/stirling/core/connector_context.h"
+
+BPF_SRC_STRVIEW(proc_lifecycle_bcc_script, proc_lifecycle);
+
+namespace px {
+namespace stirling {
+
+namespace {
+
+const auto kTracepoints = MakeArray<bpf_tools::TracepointSpec>({
+    {"task:task_newtask", "on_task_newtask"},
+    {"sched:sched_process_exec", "on_sched_process_exec"},
+    {"sched:sched_process_exit", "on_sched_process_exit"},
+});
+
+// Returns true once every thread of the process has exited. When only the thread group leader
+// exits, its /proc entry stays as a zombie while the other threads of the process keep running.
+bool ProcessExited(const std::filesystem::path& proc_path, const md::UPID& upid) {
+  const std::filesystem::path proc_pid_path = proc_path / std::to_string(upid.pid());
+  StatusOr<int64_t> start_time = system::GetPIDStartTimeTicks(proc_pid_path);
+  if (!start_time.ok() || start_time.ValueOrDie() != upid.start_ts()) {
+    return true;
+  }
+
+  // The state follows the command name, which is in parentheses and may contain spaces.
+  StatusOr<std::string> stat = ReadFileToString(proc_pid_path / "stat");
+  if (!stat.ok()) {
+    return true;
+  }
+  const std::string& stat_str = stat.ValueOrDie();
+  const size_t comm_end = stat_str.rfind(')');
+  if (comm_end == std::string::npos || comm_end + 2 >= stat_str.size()) {
+    return true;
+  }
+  const char state = stat_str[comm_end + 2];
+  if (state != 'Z' && state != 'X') {
+    // The leader is still exiting, or it was replaced by another thread that called exec().
+    return false;
+  }
+
+  // The zombie leader is the last task listed once all other threads are gone.
+  std::error_code ec;
+  int num_tasks = 0;
+  for (auto iter = std::filesystem::directory_iterator(proc_pid_path / "task", ec);
+       !ec && iter != std::filesystem::directory_iterator(); iter.increment(ec)) {
+    ++num_tasks;
+  }
+  return ec || num_tasks <= 1;
+}
+
+}  // namespace
+
+StatusOr<std::unique_ptr<ProcLifecycleTracker>> ProcLifecycleTracker::Create(
+    std::filesystem::path proc_path, std::chrono::milliseconds rescan_period) {
+  std::unique_ptr<ProcLifecycleTracker> tracker(
+      new ProcLifecycleTracker(std::move(proc_path), rescan_period));
+  PL_RETURN_IF_ERROR(tracker->Init());
+  return tracker;
+}
+
+Status ProcLifecycleTracker::Init() {
+  PL_RETURN_IF_ERROR(InitBPFProgram(proc_lifecycle_bcc_script));
+  for (const auto& tracepoint : kTracepoints) {
+    PL_RETURN_IF_ERROR(AttachTracepoint(tracepoint));
+  }
+  PL_RETURN_IF_ERROR(OpenPerfBuffer(
+      {"proc_events", &ProcLifecycleTracker::HandleProcEvent,
+       &ProcLifecycleTracker::HandleProcEventLoss, /* size_bytes */ 256 * 1024},
+      this));
+
+  // The tracepoints are attached before the initial scan, so no process is missed in between.
+  Rescan();
+  snapshot_ = std::make_shared<const absl::flat_hash_set<md::UPID>>(upids_);
+  return Status::OK();
+}
+
+void ProcLifecycleTracker::HandleProcEvent(void* cb_cookie, void* data, int /*data_size*/) {
+  DCHECK(cb_cookie != nullptr) << "Perf buffer callback not set-up properly. Missing cb_cookie.";
+  auto* tracker = static_cast<ProcLifecycleTracker*>(cb_cookie);
+  const auto& event = *static_cast<const proc_event_t*>(data);
+
+  switch (event.type) {
+    case kProcEventFork: {
+      const std::filesystem::path proc_pid_path =
+          tracker->proc_path_ / std::to_string(event.upid.pid);
+      StatusOr<int64_t> start_time = system::GetPIDStartTimeTicks(proc_pid_path);
+      if (!start_time.ok()) {
+        // The process already exited.
+        return;
+      }
+      tracker->added_upids_.emplace(/* asid */ 0, event.upid.pid, start_time.ValueOrDie());
+      break;
+    }
+    case kProcEventExec:
+      tracker->added_upids_.emplace(/* asid */ 0, event.upid.pid, event.upid.start_time_ticks);
+      break;
+    case kProcEventExit:
+      tracker->exiting_upids_.emplace(/* asid */ 0, event.upid.pid, event.upid.start_time_ticks);
+      break;
+    default:
+      LOG(DFATAL) << absl::Substitute("Unexpected process event type $0", event.type);
+  }
+}
+
+void ProcLifecycleTracker::HandleProcEventLoss(void* cb_cookie, uint64_t lost) {
+  DCHECK(cb_cookie != nullptr) << "Perf buffer callback not set-up properly. Missing cb_cookie.";
+  VLOG(1) << absl::Substitute("Lost $0 process events, will rescan /proc.", lost);
+  static_cast<ProcLifecycleTracker*>(cb_cookie)->events_lost_ = true;
+}
+
+void ProcLifecycleTracker::Rescan() {
+  upids_ = ListUPIDs(proc_path_);
+  events_lost_ = false;
+  last_rescan_ = std::chrono::steady_clock::now();
+}
+
+std::shared_ptr<const absl::flat_hash_set<md::UPID>> ProcLifecycleTracker::Update() {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  PollPerfBuffers();
+
+  bool changed = false;
+  for (const auto& upid : added_upids_) {
+    changed |= upids_.insert(upid).second;
+  }
+  added_upids_.clear();
+
+  // A process whose leader exited stays in the set until its remaining threads exit too.
+  for (auto iter = exiting_upids_.begin(); iter != exiting_upids_.end();) {
+    if (upids_.contains(*iter) && !ProcessExited(proc_path_, *iter)) {
+      ++iter;
+      continue;
+    }
+    changed |= upids_.erase(*iter) > 0;
+    exiting_upids_.erase(iter++);
+  }
+
+  if (events_lost_ || std::chrono::steady_clock::now() - last_rescan_ >= rescan_period_) {
+    Rescan();
+    changed = true;
+  }
+
+  if (changed) {
+    snapshot_ = std::make_shared<const absl::flat_hash_set<md::UPID>>(upids_);
+  }
+  return snapshot_;
+}
+
+}  // namespace stirling
+}  // namespace px
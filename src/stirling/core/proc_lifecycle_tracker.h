@@ -0,0 +1,90 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include <absl/container/flat_hash_set.h>
+
+#include "src/common/base/base.h"
+#include "src/shared/upid/upid.h"
+#include "src/stirling/bpf_tools/bcc_wrapper.h"
+
+namespace px {
+namespace stirling {
+
+/**
+ * Maintains the set of live UPIDs incrementally, from process fork/exec/exit events reported
+ * by BPF tracepoints. This replaces a full scan of /proc on every context update.
+ *
+ * Events can be lost if the perf buffer overflows, so the set is also periodically reconciled
+ * against /proc, and immediately after any loss of events.
+ */
+class ProcLifecycleTracker : public bpf_tools::BCCWrapper, public NotCopyMoveable {
+ public:
+  static StatusOr<std::unique_ptr<ProcLifecycleTracker>> Create(
+      std::filesystem::path proc_path, std::chrono::milliseconds rescan_period);
+
+  /**
+   * Applies the process events received since the last call, rescanning /proc if due.
+   * Safe to call from multiple threads.
+   *
+   * @return The current set of UPIDs. The returned snapshot is immutable, and the same snapshot
+   * is returned until the set changes.
+   */
+  std::shared_ptr<const absl::flat_hash_set<md::UPID>> Update();
+
+ private:
+  ProcLifecycleTracker(std::filesystem::path proc_path, std::chrono::milliseconds rescan_period)
+      : proc_path_(std::move(proc_path)), rescan_period_(rescan_period) {}
+
+  Status Init();
+
+  static void HandleProcEvent(void* cb_cookie, void* data, int data_size);
+  static void HandleProcEventLoss(void* cb_cookie, uint64_t lost);
+
+  void Rescan();
+
+  const std::filesystem::path proc_path_;
+  const std::chrono::milliseconds rescan_period_;
+
+  std::mutex mutex_;
+
+  // The current set of UPIDs. Copied into a new snapshot whenever it changes.
+  absl::flat_hash_set<md::UPID> upids_;
+  std::shared_ptr<const absl::flat_hash_set<md::UPID>> snapshot_;
+
+  // UPIDs created by the events of the current poll. Events from different CPUs are not ordered,
+  // so all additions are applied before any removal.
+  absl::flat_hash_set<md::UPID> added_upids_;
+
+  // UPIDs whose thread group leader exited. They are removed from upids_ once all the threads of
+  // the process have exited, which can be later than the leader.
+  absl::flat_hash_set<md::UPID> exiting_upids_;
+
+  bool events_lost_ = false;
+  std::chrono::steady_clock::time_point last_rescan_;
+};
+
+}  // namespace stirling
+}  // namespace px
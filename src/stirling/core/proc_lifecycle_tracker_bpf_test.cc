@@ -0,0 +1,128 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/stirling/core/proc_lifecycle_tracker.h"
+
+#include <pthread.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "src/common/base/file.h"
+#include "src/common/exec/subprocess.h"
+#include "src/common/system/proc_parser.h"
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace stirling {
+
+// A long rescan period ensures that the test observes the BPF events, and not the /proc rescan.
+constexpr std::chrono::milliseconds kRescanPeriod = std::chrono::hours(1);
+
+// Other processes on the host come and go while the test runs, so the tests only look at the
+// processes they start, and poll until the expected change shows up.
+constexpr std::chrono::seconds kTimeout{10};
+
+class ProcLifecycleTrackerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_OK_AND_ASSIGN(tracker_, ProcLifecycleTracker::Create(proc_path_, kRescanPeriod));
+  }
+
+  md::UPID UPIDOf(int pid) {
+    return md::UPID(
+        0, pid,
+        system::GetPIDStartTimeTicks(proc_path_ / std::to_string(pid)).ConsumeValueOrDie());
+  }
+
+  bool Tracked(const md::UPID& upid) { return tracker_->Update()->contains(upid); }
+
+  // Polls until cond is true, returning false if it is still false after kTimeout.
+  static bool PollUntil(const std::function<bool()>& cond) {
+    const auto deadline = std::chrono::steady_clock::now() + kTimeout;
+    while (!cond()) {
+      if (std::chrono::steady_clock::now() > deadline) {
+        return false;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return true;
+  }
+
+  const std::filesystem::path proc_path_ = system::Config::GetInstance().proc_path();
+  std::unique_ptr<ProcLifecycleTracker> tracker_;
+};
+
+TEST_F(ProcLifecycleTrackerTest, TracksProcessStartAndExit) {
+  // The initial scan includes this process.
+  const md::UPID self_upid = UPIDOf(getpid());
+  EXPECT_TRUE(Tracked(self_upid));
+
+  SubProcess proc;
+  ASSERT_OK(proc.Start({"sleep", "1000"}));
+  const md::UPID child_upid = UPIDOf(proc.child_pid());
+  EXPECT_TRUE(PollUntil([&]() { return Tracked(child_upid); }));
+
+  proc.Kill();
+  proc.Wait();
+  EXPECT_TRUE(PollUntil([&]() { return !Tracked(child_upid); }));
+  EXPECT_TRUE(Tracked(self_upid));
+}
+
+TEST_F(ProcLifecycleTrackerTest, KeepsProcessWhoseLeaderExited) {
+  const pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+  if (pid == 0) {
+    // The leader exits, and the process lives on in its other thread until it is killed.
+    pthread_t thread;
+    pthread_create(
+        &thread, nullptr,
+        [](void*) -> void* {
+          while (true) {
+            pause();
+          }
+        },
+        nullptr);
+    pthread_exit(nullptr);
+  }
+
+  const md::UPID child_upid = UPIDOf(pid);
+  EXPECT_TRUE(PollUntil([&]() { return Tracked(child_upid); }));
+
+  // Wait until the leader is a zombie, then give the tracker time to see its exit event.
+  EXPECT_TRUE(PollUntil([&]() {
+    StatusOr<std::string> stat = ReadFileToString(proc_path_ / std::to_string(pid) / "stat");
+    return stat.ok() && absl::StrContains(stat.ValueOrDie(), ") Z ");
+  }));
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(Tracked(child_upid));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  kill(pid, SIGKILL);
+  waitpid(pid, nullptr, 0);
+  EXPECT_TRUE(PollUntil([&]() { return !Tracked(child_upid); }));
+}
+
+}  // namespace stirling
+}  // namespace px
@@ -103,6 +103,28 @@ TEST(RecordBuilder, UnfilledColNames) {
   EXPECT_THAT(r.UnfilledColNames(), IsEmpty());
 }
 
+TEST(RecordBuilder, UnsubscribedColumn) {
+  DataTable data_table(/*id*/ 0, kTableSchema);
+  ASSERT_OK(data_table.UnsubscribeColumn("c"));
+  EXPECT_NOT_OK(data_table.UnsubscribeColumn("d"));
+
+  DataTable::RecordBuilder<&kTableSchema> r(&data_table);
+  EXPECT_TRUE(r.Subscribed(r.ColIndex("b")));
+  EXPECT_FALSE(r.Subscribed(r.ColIndex("c")));
+  r.Append<r.ColIndex("a")>(1);
+  r.Append<r.ColIndex("b")>("foo");
+  r.Append<r.ColIndex("c")>("bar");
+
+  std::vector<TaggedRecordBatch> tablets = data_table.ConsumeRecords();
+  ASSERT_EQ(tablets.size(), 1);
+  types::ColumnWrapperRecordBatch& record_batch = tablets[0].records;
+
+  // The schema is unchanged, but the unsubscribed column only holds an empty placeholder.
+  ASSERT_THAT(record_batch, Each(ColWrapperSizeIs(1)));
+  EXPECT_EQ(record_batch[1]->Get<types::StringValue>(0), "foo");
+  EXPECT_THAT(record_batch[2]->Get<types::StringValue>(0), IsEmpty());
+}
+
 TEST(DynamicRecordBuilder, StringMaxSize) {
   DataTable data_table(/*id*/ 0, kTableSchema);
 
@@ -142,6 +164,24 @@ TEST(DynamicRecordBuilder, MissingColumn) {
 #endif
 }
 
+TEST(DynamicRecordBuilder, UnsubscribedColumn) {
+  DataTable data_table(/*id*/ 0, kTableSchema);
+  ASSERT_OK(data_table.UnsubscribeColumn("b"));
+
+  DataTable::DynamicRecordBuilder r(&data_table);
+  r.Append<types::Int64Value>(0, 1);
+  r.Append<types::StringValue>(1, "foo");
+  r.Append<types::StringValue>(2, "bar");
+
+  std::vector<TaggedRecordBatch> tablets = data_table.ConsumeRecords();
+  ASSERT_EQ(tablets.size(), 1);
+  types::ColumnWrapperRecordBatch& record_batch = tablets[0].records;
+
+  ASSERT_THAT(record_batch, Each(ColWrapperSizeIs(1)));
+  EXPECT_THAT(record_batch[1]->Get<types::StringValue>(0), IsEmpty());
+  EXPECT_EQ(record_batch[2]->Get<types::StringValue>(0), "bar");
+}
+
 TEST(DynamicRecordBuilder, Duplicate) {
   DataTable data_table(/*id*/ 0, kTableSchema);
 
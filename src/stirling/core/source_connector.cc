@@ -25,6 +25,11 @@
 
 #include "src/stirling/core/source_connector.h"
 
+DEFINE_uint32(stirling_max_push_delay_ms,
+              gflags::Uint32FromEnv("PL_STIRLING_MAX_PUSH_DELAY_MS", 0),
+              "The longest time that a connector holds back a small batch of records, to push them "
+              "together with later records. 0 pushes every period, regardless of size.");
+
 namespace px {
 namespace stirling {
 
@@ -54,6 +59,30 @@ void SourceConnector::TransferData(ConnectorContext* ctx,
   sampling_freq_mgr_.Reset();
 }
 
+bool SourceConnector::PushRequired(const std::vector<DataTable*>& data_tables) {
+  size_t num_records = 0;
+  for (const auto* data_table : data_tables) {
+    if (data_table->OccupancyPct() >= 1.0) {
+      return true;
+    }
+    num_records += data_table->Occupancy();
+  }
+
+  if (!push_freq_mgr_.Expired()) {
+    return false;
+  }
+
+  // Every push becomes a separate record batch in the table store, so tiny batches cost more
+  // than they deliver. Skip this period if the records can still wait for the next one.
+  const auto max_delay = std::chrono::milliseconds(FLAGS_stirling_max_push_delay_ms);
+  const auto next_push_time = px::chrono::coarse_steady_clock::now() + push_freq_mgr_.period();
+  if (num_records < kMinPushRecords && next_push_time - last_push_time_ <= max_delay) {
+    push_freq_mgr_.Reset();
+    return false;
+  }
+  return true;
+}
+
 void SourceConnector::PushData(DataPushCallback agent_callback,
                                const std::vector<DataTable*>& data_tables) {
   for (auto* data_table : data_tables) {
@@ -69,6 +98,7 @@ void SourceConnector::PushData(DataPushCallback agent_callback,
     }
   }
   push_freq_mgr_.Reset();
+  last_push_time_ = px::chrono::coarse_steady_clock::now();
 }
 
 Status SourceConnector::Stop() {
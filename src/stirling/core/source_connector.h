@@ -64,6 +64,14 @@ class SourceConnector : public NotCopyable {
    */
   void TransferData(ConnectorContext* ctx, const std::vector<DataTable*>& data_tables);
 
+  /**
+   * Returns whether the data tables should be pushed now. Tables holding a full batch are always
+   * pushed. Otherwise, the tables are pushed when the push period expires, unless they hold only a
+   * few records and --stirling_max_push_delay_ms is set; those are then held back to be batched
+   * with later records, for up to that long since the last push.
+   */
+  bool PushRequired(const std::vector<DataTable*>& data_tables);
+
   /**
    * Pushes data in data tables into table store.
    */
@@ -149,6 +157,10 @@ class SourceConnector : public NotCopyable {
   FrequencyManager sampling_freq_mgr_;
   FrequencyManager push_freq_mgr_;
 
+  // Pushes with fewer records than this are deferred; see PushRequired().
+  static constexpr size_t kMinPushRecords = 64;
+  px::chrono::coarse_steady_clock::time_point last_push_time_ = {};
+
   // Debug members.
   int debug_level_ = 0;
   absl::flat_hash_set<int> pids_to_trace_;
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "src/stirling/core/source_connector.h"
+
+DECLARE_uint32(stirling_max_push_delay_ms);
+
+namespace px {
+namespace stirling {
+
+using std::chrono_literals::operator""ms;
+
+class TestConnector : public SourceConnector {
+ public:
+  static constexpr DataElement kElements[] = {
+      {"time_", "time", types::DataType::TIME64NS, types::SemanticType::ST_NONE,
+       types::PatternType::METRIC_COUNTER},
+  };
+  static constexpr auto kTable =
+      DataTableSchema("test_table", "This is the table description", kElements);
+  static constexpr auto kTables = MakeArray(kTable);
+
+  TestConnector() : SourceConnector("test_connector", kTables) {}
+
+  void SetPushPeriod(std::chrono::milliseconds period) {
+    push_freq_mgr_.set_period(period);
+    push_freq_mgr_.Reset();
+  }
+
+ protected:
+  Status InitImpl() override { return Status::OK(); }
+  void TransferDataImpl(ConnectorContext*, const std::vector<DataTable*>&) override {}
+  Status StopImpl() override { return Status::OK(); }
+};
+
+class PushRequiredTest : public ::testing::Test {
+ protected:
+  PushRequiredTest() : data_table_(/*id*/ 0, TestConnector::kTable) {}
+
+  void SetUp() override { saved_max_push_delay_ms_ = FLAGS_stirling_max_push_delay_ms; }
+  void TearDown() override { FLAGS_stirling_max_push_delay_ms = saved_max_push_delay_ms_; }
+
+  void AppendRecords(int n) {
+    for (int i = 0; i < n; ++i) {
+      DataTable::RecordBuilder<&TestConnector::kTable> r(&data_table_);
+      r.Append<r.ColIndex("time_")>(i);
+    }
+  }
+
+  void Push() {
+    auto callback = [](uint32_t, types::TabletID,
+                       std::unique_ptr<types::ColumnWrapperRecordBatch>) { return Status::OK(); };
+    connector_.PushData(callback, data_tables_);
+  }
+
+  TestConnector connector_;
+  DataTable data_table_;
+  std::vector<DataTable*> data_tables_ = {&data_table_};
+  uint32_t saved_max_push_delay_ms_ = 0;
+};
+
+TEST_F(PushRequiredTest, FullBatchIsPushedBeforePeriodExpires) {
+  connector_.SetPushPeriod(3600 * 1000ms);
+  AppendRecords(1);
+  EXPECT_FALSE(connector_.PushRequired(data_tables_));
+
+  AppendRecords(1023);
+  EXPECT_TRUE(connector_.PushRequired(data_tables_));
+}
+
+TEST_F(PushRequiredTest, SmallBatchIsPushedEveryPeriodByDefault) {
+  FLAGS_stirling_max_push_delay_ms = 0;
+  connector_.SetPushPeriod(0ms);
+  AppendRecords(1);
+  Push();
+
+  AppendRecords(1);
+  EXPECT_TRUE(connector_.PushRequired(data_tables_));
+}
+
+TEST_F(PushRequiredTest, SmallBatchIsDeferred) {
+  FLAGS_stirling_max_push_delay_ms = 3600 * 1000;
+  connector_.SetPushPeriod(0ms);
+  AppendRecords(1);
+  Push();
+
+  AppendRecords(1);
+  EXPECT_FALSE(connector_.PushRequired(data_tables_));
+
+  // Enough records for a push are not held back.
+  AppendRecords(63);
+  EXPECT_TRUE(connector_.PushRequired(data_tables_));
+}
+
+TEST_F(PushRequiredTest, SmallBatchIsPushedAfterMaxDelay) {
+  FLAGS_stirling_max_push_delay_ms = 20;
+  connector_.SetPushPeriod(0ms);
+  AppendRecords(1);
+  Push();
+
+  AppendRecords(1);
+  EXPECT_FALSE(connector_.PushRequired(data_tables_));
+
+  std::this_thread::sleep_for(50ms);
+  EXPECT_TRUE(connector_.PushRequired(data_tables_));
+}
+
+}  // namespace stirling
+}  // namespace px
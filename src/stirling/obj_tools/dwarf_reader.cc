@@ -21,6 +21,7 @@
 #include <algorithm>
 
 #include <llvm/DebugInfo/DIContext.h>
+#include <llvm/DebugInfo/DWARF/DWARFAcceleratorTable.h>
 #include <llvm/Object/ObjectFile.h>
 
 #include "src/shared/types/typespb/wrapper/types_pb_wrapper.h"
@@ -98,6 +99,14 @@ StatusOr<std::unique_ptr<DwarfReader>> DwarfReader::CreateIndexingAll(
   return dwarf_reader;
 }
 
+StatusOr<std::unique_ptr<DwarfReader>> DwarfReader::CreateIndexingOnDemand(
+    const std::filesystem::path& path) {
+  PL_ASSIGN_OR_RETURN(auto dwarf_reader, CreateWithoutIndexing(path));
+  dwarf_reader->index_on_demand_ = true;
+  dwarf_reader->units_to_index_ = dwarf_reader->UnitsNotInAcceleratorTable();
+  return dwarf_reader;
+}
+
 StatusOr<std::unique_ptr<DwarfReader>> DwarfReader::CreateWithSelectiveIndexing(
     const std::filesystem::path& path, const std::vector<SymbolSearchPattern>& symbol_patterns) {
   PL_ASSIGN_OR_RETURN(auto dwarf_reader, CreateWithoutIndexing(path));
@@ -146,6 +155,15 @@ bool IsIndexedType(llvm::dwarf::Tag tag) {
 
 bool IsNamespace(llvm::dwarf::Tag tag) { return tag == llvm::dwarf::DW_TAG_namespace; }
 
+bool IsDeclaration(const llvm::DWARFDie& die) {
+  auto value_or = GetAttribute(die, llvm::dwarf::DW_AT_declaration);
+  if (value_or.ok()) {
+    DCHECK(value_or.ValueOrDie().getForm() == llvm::dwarf::DW_FORM_flag_present)
+        << "DW_AT_declaration should be of DW_FORM_flag_present. DIE: " << Dump(die);
+  }
+  return value_or.ok();
+}
+
 }  // namespace
 
 Status DwarfReader::DetectSourceLanguage() {
@@ -174,80 +192,218 @@ Status DwarfReader::DetectSourceLanguage() {
 
 void DwarfReader::IndexDIEs(
     const std::optional<std::vector<SymbolSearchPattern>>& symbol_search_patterns_opt) {
-  absl::flat_hash_map<const llvm::DWARFDebugInfoEntry*, std::string> dwarf_entry_names;
-
-  // Map from DW_AT_specification to DIE. Only DW_TAG_subprogram can have this attribute.
-  // Also only applies to CPP binaries.
-  absl::flat_hash_map<uint64_t, DWARFDie> fn_spec_offsets;
-
   DWARFContext::unit_iterator_range units = dwarf_context_->normal_units();
   for (const std::unique_ptr<llvm::DWARFUnit>& unit : units) {
-    for (const llvm::DWARFDebugInfoEntry& entry : unit->dies()) {
-      DWARFDie die = {unit.get(), &entry};
+    IndexUnit(unit.get(), symbol_search_patterns_opt);
+  }
+}
 
-      if (die.isSubprogramDIE()) {
-        auto spec_or =
-            AdaptLLVMOptional(llvm::dwarf::toReference(die.find(llvm::dwarf::DW_AT_specification)),
-                              "Could not find attribute DW_AT_specification");
-        if (spec_or.ok()) {
-          fn_spec_offsets[spec_or.ValueOrDie()] = die;
-        }
+void DwarfReader::IndexUnit(
+    llvm::DWARFUnit* unit,
+    const std::optional<std::vector<SymbolSearchPattern>>& symbol_search_patterns_opt) {
+  absl::flat_hash_map<const llvm::DWARFDebugInfoEntry*, std::string> dwarf_entry_names;
+
+  for (const llvm::DWARFDebugInfoEntry& entry : unit->dies()) {
+    DWARFDie die = {unit, &entry};
+
+    if (die.isSubprogramDIE()) {
+      DWARFDie spec_die = die.getAttributeValueAsReferencedDie(llvm::dwarf::DW_AT_specification);
+      if (spec_die.isValid()) {
+        RecordFnSpec(spec_die, die);
       }
+    }
 
-      // TODO(oazizi/yzhao): Change to use the demangled name of DW_AT_linkage_name as the key to
-      // index the function DIE. That removes the need of using manually-assembled names (through
-      // parent DIE).
+    // TODO(oazizi/yzhao): Change to use the demangled name of DW_AT_linkage_name as the key to
+    // index the function DIE. That removes the need of using manually-assembled names (through
+    // parent DIE).
 
-      auto name = std::string(GetShortName(die));
+    auto name = std::string(GetShortName(die));
 
-      if (name.empty()) {
-        continue;
-      }
+    if (name.empty()) {
+      continue;
+    }
 
-      // Only check matching if patterns are provided.
-      if (symbol_search_patterns_opt.has_value() &&
-          !MatchesSymbolAny(name, symbol_search_patterns_opt.value())) {
-        continue;
-      }
+    // Only check matching if patterns are provided.
+    if (symbol_search_patterns_opt.has_value() &&
+        !MatchesSymbolAny(name, symbol_search_patterns_opt.value())) {
+      continue;
+    }
 
-      llvm::dwarf::Tag tag = die.getTag();
+    llvm::dwarf::Tag tag = die.getTag();
 
-      if (IsIndexedType(tag) ||
-          // Namespace entry is processed here so that the name components can be generated.
-          IsNamespace(tag)) {
-        llvm::DWARFDie parent_die = die.getParent();
+    if (IsIndexedType(tag) ||
+        // Namespace entry is processed here so that the name components can be generated.
+        IsNamespace(tag)) {
+      llvm::DWARFDie parent_die = die.getParent();
 
-        if (parent_die.isValid()) {
-          const llvm::DWARFDebugInfoEntry* entry = parent_die.getDebugInfoEntry();
+      if (parent_die.isValid()) {
+        const llvm::DWARFDebugInfoEntry* entry = parent_die.getDebugInfoEntry();
 
-          if (entry != nullptr) {
-            auto iter = dwarf_entry_names.find(entry);
-            if (iter != dwarf_entry_names.end()) {
-              std::string_view parent_name = iter->second;
-              name = absl::StrCat(parent_name, "::", name);
-            }
+        if (entry != nullptr) {
+          auto iter = dwarf_entry_names.find(entry);
+          if (iter != dwarf_entry_names.end()) {
+            std::string_view parent_name = iter->second;
+            name = absl::StrCat(parent_name, "::", name);
           }
-          dwarf_entry_names[die.getDebugInfoEntry()] = name;
         }
+        dwarf_entry_names[die.getDebugInfoEntry()] = name;
+      }
 
-        if (IsIndexedType(tag)) {
-          InsertToDIEMap(std::move(name), tag, die);
+      if (tag == llvm::dwarf::DW_TAG_subprogram) {
+        // Index the definition in place of the declaration, if it was seen already.
+        auto spec_iter = fn_specs_.find(die.getOffset());
+        if (spec_iter != fn_specs_.end()) {
+          die = spec_iter->second;
+        } else if (IsDeclaration(die)) {
+          fn_decl_names_[die.getOffset()] = name;
         }
       }
+
+      if (IsIndexedType(tag)) {
+        InsertToDIEMap(std::move(name), tag, die);
+      }
     }
   }
+}
+
+void DwarfReader::RecordFnSpec(const DWARFDie& decl_die, const DWARFDie& def_die) {
+  fn_specs_[decl_die.getOffset()] = def_die;
 
+  // The declaration may be in a unit that was indexed before this one, e.g. with LTO. The name may
+  // also be indexed with the declaration of another unit, e.g. that of a class defined in a header.
+  auto name_iter = fn_decl_names_.find(decl_die.getOffset());
+  if (name_iter == fn_decl_names_.end()) {
+    return;
+  }
   auto& fn_dies = die_map_[llvm::dwarf::DW_TAG_subprogram];
+  auto iter = fn_dies.find(name_iter->second);
+  if (iter != fn_dies.end() && IsDeclaration(iter->second)) {
+    iter->second = def_die;
+  }
+}
+
+namespace {
+
+// Returns the name under which IndexUnit() would index the DIE, i.e. the short name qualified by
+// the names of the enclosing namespaces, classes, structs and functions.
+std::string QualifiedName(const DWARFDie& die) {
+  // Out-of-line definitions are scoped by their declaration, not by where they appear.
+  DWARFDie scope_die = die;
+  DWARFDie spec_die = die.getAttributeValueAsReferencedDie(llvm::dwarf::DW_AT_specification);
+  if (spec_die.isValid()) {
+    scope_die = spec_die;
+  }
+
+  std::string name(GetShortName(die));
+  for (DWARFDie parent = scope_die.getParent();
+       parent.isValid() && (IsIndexedType(parent.getTag()) || IsNamespace(parent.getTag()));
+       parent = parent.getParent()) {
+    std::string_view parent_name = GetShortName(parent);
+    if (parent_name.empty()) {
+      break;
+    }
+    name = absl::StrCat(parent_name, "::", name);
+  }
+  return name;
+}
+
+}  // namespace
+
+std::optional<DWARFDie> DwarfReader::FindInAcceleratorTable(std::string_view name,
+                                                            llvm::dwarf::Tag tag) {
+  // The accelerator table is keyed by short names, so strip any qualifiers,
+  // and check the full name of the candidates instead.
+  std::string_view short_name = name;
+  size_t pos = short_name.rfind("::");
+  if (pos != std::string_view::npos) {
+    short_name.remove_prefix(pos + 2);
+  }
 
-  for (auto iter = fn_dies.begin(); iter != fn_dies.end(); ++iter) {
-    uint64_t offset = iter->second.getOffset();
-    auto spec_iter = fn_spec_offsets.find(offset);
-    if (spec_iter == fn_spec_offsets.end()) {
+  const llvm::DWARFDebugNames& debug_names = dwarf_context_->getDebugNames();
+
+  std::optional<DWARFDie> result;
+  for (const llvm::DWARFDebugNames::Entry& entry :
+       debug_names.equal_range(llvm::StringRef(short_name.data(), short_name.size()))) {
+    if (entry.tag() != tag) {
+      continue;
+    }
+    llvm::Optional<uint64_t> cu_offset = entry.getCUOffset();
+    llvm::Optional<uint64_t> die_offset = entry.getDIEUnitOffset();
+    if (!cu_offset.hasValue() || !die_offset.hasValue()) {
       continue;
     }
-    // Replace the DIE with the DW_TAG_subprogram die that has DW_AT_specification attribute.
-    iter->second = spec_iter->second;
+    DWARFDie die = dwarf_context_->getDIEForOffset(cu_offset.getValue() + die_offset.getValue());
+    if (!die.isValid() || QualifiedName(die) != name) {
+      continue;
+    }
+    // Mimic IndexUnit(), which keeps the first DIE in the order of the debug info.
+    if (!result.has_value() || die.getOffset() < result->getOffset()) {
+      result = die;
+    }
+  }
+  return result;
+}
+
+std::vector<uint32_t> DwarfReader::UnitsNotInAcceleratorTable() const {
+  absl::flat_hash_set<uint64_t> covered_unit_offsets;
+  for (const llvm::DWARFDebugNames::NameIndex& name_index : dwarf_context_->getDebugNames()) {
+    for (uint32_t i = 0; i < name_index.getCUCount(); ++i) {
+      covered_unit_offsets.insert(name_index.getCUOffset(i));
+    }
+  }
+
+  std::vector<uint32_t> unit_indices;
+  for (uint32_t i = 0; i < dwarf_context_->getNumCompileUnits(); ++i) {
+    if (!covered_unit_offsets.contains(dwarf_context_->getUnitAtIndex(i)->getOffset())) {
+      unit_indices.push_back(i);
+    }
+  }
+  return unit_indices;
+}
+
+std::optional<DWARFDie> DwarfReader::FindOnDemand(const std::string& name, llvm::dwarf::Tag tag) {
+  // A declaration is only returned once the units that may hold the definition have been indexed,
+  // so that the result is the same as with CreateIndexingAll().
+  auto is_final = [this](const std::optional<DWARFDie>& die_opt) {
+    return die_opt.has_value() &&
+           (!IsDeclaration(die_opt.value()) || num_indexed_units_ == units_to_index_.size());
+  };
+
+  std::optional<DWARFDie> die_opt = FindInDIEMap(name, tag);
+  if (is_final(die_opt)) {
+    return die_opt;
+  }
+
+  auto& missing_names = missing_die_names_[tag];
+  if (missing_names.contains(name)) {
+    return std::nullopt;
+  }
+
+  std::optional<DWARFDie> table_die_opt = FindInAcceleratorTable(name, tag);
+  if (table_die_opt.has_value()) {
+    InsertToDIEMap(name, tag, table_die_opt.value());
+    die_opt = FindInDIEMap(name, tag);
+    if (is_final(die_opt)) {
+      return die_opt;
+    }
+  }
+
+  // The name is not in the accelerator table, if there is one (there is none in Golang binaries),
+  // or only its declaration is. Index the units that the table doesn't cover one at a time, so
+  // that units past the one defining the symbol are never parsed.
+  while (num_indexed_units_ < units_to_index_.size()) {
+    IndexUnit(dwarf_context_->getUnitAtIndex(units_to_index_[num_indexed_units_]), std::nullopt);
+    ++num_indexed_units_;
+
+    die_opt = FindInDIEMap(name, tag);
+    if (is_final(die_opt)) {
+      return die_opt;
+    }
   }
+
+  // All units have been searched, so remember the miss instead of repeating the lookup.
+  missing_names.insert(name);
+  return std::nullopt;
 }
 
 StatusOr<std::vector<DWARFDie>> DwarfReader::GetMatchingDIEs(
@@ -255,6 +411,13 @@ StatusOr<std::vector<DWARFDie>> DwarfReader::GetMatchingDIEs(
   DCHECK(dwarf_context_ != nullptr);
 
   // Special case for types that are indexed.
+  if (type_opt.has_value() && IsIndexedType(type_opt.value()) && index_on_demand_) {
+    auto die_opt = FindOnDemand(std::string(name), type_opt.value());
+    if (die_opt.has_value()) {
+      return std::vector<DWARFDie>{die_opt.value()};
+    }
+    return std::vector<DWARFDie>{};
+  }
   if (type_opt.has_value() && IsIndexedType(type_opt.value()) && !die_map_.empty()) {
     auto die_opt = FindInDIEMap(std::string(name), type_opt.value());
     if (die_opt.has_value()) {
@@ -611,15 +774,6 @@ std::vector<DWARFDie> GetChildDIEs(const DWARFDie& die, llvm::dwarf::Tag filter_
   return child_dies;
 }
 
-bool IsDeclaration(const llvm::DWARFDie& die) {
-  auto value_or = GetAttribute(die, llvm::dwarf::DW_AT_declaration);
-  if (value_or.ok()) {
-    DCHECK(value_or.ValueOrDie().getForm() == llvm::dwarf::DW_FORM_flag_present)
-        << "DW_AT_declaration should be of DW_FORM_flag_present. DIE: " << Dump(die);
-  }
-  return value_or.ok();
-}
-
 }  // namespace
 
 StatusOr<uint64_t> DwarfReader::GetStructByteSize(std::string_view struct_name) {
@@ -723,10 +877,15 @@ void DwarfReader::InsertToDIEMap(std::string name, llvm::dwarf::Tag tag, llvm::D
   // Only appears to happen with structs like the following:
   //  ThreadStart, _IO_FILE, _IO_marker, G, in6_addr
   // So probably okay for now. But need to be wary of this.
-  if (die_type_map.find(name) != die_type_map.end()) {
+  auto iter = die_type_map.find(name);
+  if (iter == die_type_map.end()) {
+    die_type_map[name] = die;
     return;
   }
-  die_type_map[name] = die;
+  // A declaration may come before the definition, e.g. in an earlier compilation unit.
+  if (IsDeclaration(iter->second) && !IsDeclaration(die)) {
+    iter->second = die;
+  }
 }
 
 std::optional<llvm::DWARFDie> DwarfReader::FindInDIEMap(const std::string& name,
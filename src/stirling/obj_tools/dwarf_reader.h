@@ -22,6 +22,7 @@
 #include <llvm/Support/TargetSelect.h>
 
 #include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
 
 #include <filesystem>
 #include <limits>
@@ -158,6 +159,17 @@ class DwarfReader {
       const std::filesystem::path& path);
   static StatusOr<std::unique_ptr<DwarfReader>> CreateIndexingAll(
       const std::filesystem::path& path);
+
+  /**
+   * Like CreateIndexingAll(), but the index is built as symbols are looked up:
+   * the .debug_names accelerator table is consulted first if the binary has one; otherwise
+   * the compilation units it doesn't cover are indexed one at a time until the symbol is found.
+   * Symbols that aren't found are remembered, so repeated misses are cheap.
+   * Callers that only query a few symbols avoid parsing (and holding in memory) the DIEs of
+   * every compilation unit.
+   */
+  static StatusOr<std::unique_ptr<DwarfReader>> CreateIndexingOnDemand(
+      const std::filesystem::path& path);
   static StatusOr<std::unique_ptr<DwarfReader>> CreateWithSelectiveIndexing(
       const std::filesystem::path& path, const std::vector<SymbolSearchPattern>& symbol_patterns);
 
@@ -308,6 +320,26 @@ class DwarfReader {
   // Otherwise, only the ones whose names match are indexed.
   void IndexDIEs(const std::optional<std::vector<SymbolSearchPattern>>& symbol_search_patterns_opt);
 
+  // Indexes the DIEs of a single compilation unit. See IndexDIEs().
+  void IndexUnit(llvm::DWARFUnit* unit,
+                 const std::optional<std::vector<SymbolSearchPattern>>& symbol_search_patterns_opt);
+
+  // Records that def_die defines the function declared by decl_die (through DW_AT_specification),
+  // so that the definition is indexed in place of the declaration. The two may be in different
+  // compilation units, indexed in either order.
+  void RecordFnSpec(const llvm::DWARFDie& decl_die, const llvm::DWARFDie& def_die);
+
+  // Returns the indices of the compilation units that the .debug_names accelerator tables don't
+  // cover, which on-demand lookups have to index.
+  std::vector<uint32_t> UnitsNotInAcceleratorTable() const;
+
+  // Looks up the DIE in the .debug_names accelerator table, if the binary has one.
+  std::optional<llvm::DWARFDie> FindInAcceleratorTable(std::string_view name,
+                                                       llvm::dwarf::Tag tag);
+
+  // Looks up the DIE in the index, extending the index as needed. See CreateIndexingOnDemand().
+  std::optional<llvm::DWARFDie> FindOnDemand(const std::string& name, llvm::dwarf::Tag tag);
+
   // Walks the struct_die for all members, recursively visiting any members which are also structs,
   // to capture information of all base type members of the struct in a flattened form.
   // See GetStructSpec() for the public interface, and the output format.
@@ -326,6 +358,22 @@ class DwarfReader {
 
   // Nested map: [tag][symbol_name] -> DWARFDie
   absl::flat_hash_map<llvm::dwarf::Tag, absl::flat_hash_map<std::string, llvm::DWARFDie>> die_map_;
+
+  // If true, die_map_ is extended lazily. See CreateIndexingOnDemand().
+  bool index_on_demand_ = false;
+
+  // The indices of the compilation units to index on demand, and how many of them, in order,
+  // have been indexed.
+  std::vector<uint32_t> units_to_index_;
+  size_t num_indexed_units_ = 0;
+
+  // Names that on-demand lookups didn't find, by tag.
+  absl::flat_hash_map<llvm::dwarf::Tag, absl::flat_hash_set<std::string>> missing_die_names_;
+
+  // Map from the offset of a function declaration to the DIE that defines it.
+  absl::flat_hash_map<uint64_t, llvm::DWARFDie> fn_specs_;
+  // Map from the offset of an indexed function declaration to its name in die_map_.
+  absl::flat_hash_map<uint64_t, std::string> fn_decl_names_;
 };
 
 }  // namespace obj_tools
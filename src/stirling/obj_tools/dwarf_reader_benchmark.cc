@@ -105,5 +105,23 @@ static void BM_indexed(benchmark::State& state) {
   }
 }
 
+// NOLINTNEXTLINE : runtime/references.
+static void BM_index_on_demand(benchmark::State& state) {
+  size_t num_lookup_iterations = state.range(0);
+
+  for (auto _ : state) {
+    SymAddrs symaddrs;
+
+    PL_ASSIGN_OR_EXIT(std::unique_ptr<DwarfReader> dwarf_reader,
+                      DwarfReader::CreateIndexingOnDemand(kBinary));
+
+    for (size_t i = 0; i < num_lookup_iterations; ++i) {
+      GetSymAddrs(dwarf_reader.get(), &symaddrs);
+      benchmark::DoNotOptimize(symaddrs);
+    }
+  }
+}
+
 BENCHMARK(BM_noindex)->RangeMultiplier(2)->Range(1, 16);
 BENCHMARK(BM_indexed)->RangeMultiplier(2)->Range(1, 16);
+BENCHMARK(BM_index_on_demand)->RangeMultiplier(2)->Range(1, 16);
@@ -28,6 +28,7 @@ constexpr std::string_view kTestGo1_17Binary =
 constexpr std::string_view kGoGRPCServer =
     "src/stirling/testing/demo_apps/go_grpc_tls_pl/server/server_/server";
 constexpr std::string_view kCppBinary = "src/stirling/obj_tools/testdata/cc/test_exe";
+constexpr std::string_view kCppMultiCUBinary = "src/stirling/obj_tools/testdata/cc/multi_cu_exe";
 constexpr std::string_view kGoBinaryUnconventional =
     "src/stirling/obj_tools/testdata/go/sockshop_payments_service";
 
@@ -46,13 +47,24 @@ using ::testing::UnorderedElementsAre;
 // Automatically converts ToString() to stream operator for gtest.
 using ::px::operator<<;
 
+enum class IndexMode {
+  kNone,
+  kAll,
+  kOnDemand,
+};
+
 struct DwarfReaderTestParam {
-  bool index;
+  IndexMode index;
 };
 
-auto CreateDwarfReader(const std::filesystem::path& path, bool indexing) {
-  if (indexing) {
-    return DwarfReader::CreateIndexingAll(path);
+auto CreateDwarfReader(const std::filesystem::path& path, IndexMode index_mode) {
+  switch (index_mode) {
+    case IndexMode::kAll:
+      return DwarfReader::CreateIndexingAll(path);
+    case IndexMode::kOnDemand:
+      return DwarfReader::CreateIndexingOnDemand(path);
+    case IndexMode::kNone:
+      break;
   }
   return DwarfReader::CreateWithoutIndexing(path);
 }
@@ -61,12 +73,14 @@ class DwarfReaderTest : public ::testing::TestWithParam<DwarfReaderTestParam> {
  protected:
   DwarfReaderTest()
       : kCppBinaryPath(px::testing::BazelBinTestFilePath(kCppBinary)),
+        kCppMultiCUBinaryPath(px::testing::BazelBinTestFilePath(kCppMultiCUBinary)),
         kGo1_16BinaryPath(px::testing::TestFilePath(kTestGo1_16Binary)),
         kGo1_17BinaryPath(px::testing::TestFilePath(kTestGo1_17Binary)),
         kGoServerBinaryPath(px::testing::BazelBinTestFilePath(kGoGRPCServer)),
         kGoBinaryUnconventionalPath(px::testing::TestFilePath(kGoBinaryUnconventional)) {}
 
   const std::string kCppBinaryPath;
+  const std::string kCppMultiCUBinaryPath;
   const std::string kGo1_16BinaryPath;
   const std::string kGo1_17BinaryPath;
   const std::string kGoServerBinaryPath;
@@ -114,6 +128,33 @@ TEST_P(DwarfReaderTest, GetMatchingDIEsReturnsEmptyVector) {
       IsEmpty());
 }
 
+// Tests that a failed lookup, which exhausts the units to index on demand, doesn't affect
+// later lookups.
+TEST_P(DwarfReaderTest, LookupAfterMiss) {
+  DwarfReaderTestParam p = GetParam();
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> dwarf_reader,
+                       CreateDwarfReader(kCppBinaryPath, p.index));
+
+  EXPECT_NOT_OK(dwarf_reader->GetStructByteSize("non-existent-name"));
+  EXPECT_OK_AND_EQ(dwarf_reader->GetStructByteSize("ABCStruct32"), 12);
+  EXPECT_NOT_OK(dwarf_reader->GetStructByteSize("non-existent-name"));
+}
+
+// Tests that the definitions are found when an earlier compilation unit only has declarations.
+// Without an index, all the matching DIEs are returned, so only the indexing modes are tested.
+TEST_F(DwarfReaderTest, CppDefinitionInLaterUnit) {
+  for (IndexMode index_mode : {IndexMode::kAll, IndexMode::kOnDemand}) {
+    ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> dwarf_reader,
+                         CreateDwarfReader(kCppMultiCUBinaryPath, index_mode));
+
+    EXPECT_OK_AND_EQ(dwarf_reader->GetStructByteSize("MultiCUStruct"), 16);
+    // Parameters only have locations in the definition of a function.
+    EXPECT_OK(dwarf_reader->GetArgumentLocation("MultiCUStructSum", "s"));
+    EXPECT_OK(dwarf_reader->GetArgumentLocation("MultiCUClass::Method", "x"));
+    EXPECT_OK(dwarf_reader->GetArgumentLocation("MultiCUClass::Method", "y"));
+  }
+}
+
 TEST_P(DwarfReaderTest, CppGetStructByteSize) {
   DwarfReaderTestParam p = GetParam();
   ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> dwarf_reader,
@@ -620,8 +661,9 @@ TEST_P(DwarfReaderTest, GoFunctionVarLocationConsistency) {
 }
 
 INSTANTIATE_TEST_SUITE_P(DwarfReaderParameterizedTest, DwarfReaderTest,
-                         ::testing::Values(DwarfReaderTestParam{true},
-                                           DwarfReaderTestParam{false}));
+                         ::testing::Values(DwarfReaderTestParam{IndexMode::kAll},
+                                           DwarfReaderTestParam{IndexMode::kOnDemand},
+                                           DwarfReaderTestParam{IndexMode::kNone}));
 
 }  // namespace obj_tools
 }  // namespace stirling
@@ -44,8 +44,48 @@ struct LowercaseHex {
   static inline constexpr int kSizePerByte = 2;
   static inline constexpr bool kKeepPrintableChars = false;
 };
+
+// Returns the "desc" field of an ELF note section, as a lowercase hex string.
+std::string NoteDescHex(const ELFIO::section* psec) {
+  // Structure of a note section:
+  //    namesz :   32-bit, size of "name" field
+  //    descsz :   32-bit, size of "desc" field
+  //    type   :   32-bit, vendor specific "type"
+  //    name   :   "namesz" bytes, null-terminated string
+  //    desc   :   "descsz" bytes, binary data
+  int32_t name_size =
+      utils::LEndianBytesToInt<int32_t>(std::string_view(psec->get_data(), sizeof(int32_t)));
+  int32_t desc_size = utils::LEndianBytesToInt<int32_t>(
+      std::string_view(psec->get_data() + sizeof(int32_t), sizeof(int32_t)));
+
+  int32_t desc_pos = 3 * sizeof(int32_t) + name_size;
+  std::string_view desc = std::string_view(psec->get_data() + desc_pos, desc_size);
+
+  return BytesToString<LowercaseHex>(desc);
+}
+
 }  // namespace
 
+StatusOr<std::string> ElfReader::BuildID() {
+  // Go binaries carry their own build ID note. Prefer the GNU one when both are present,
+  // since it is what debug files are keyed on too.
+  std::string go_build_id;
+  ELFIO::Elf_Half sec_num = elf_reader_.sections.size();
+  for (int i = 0; i < sec_num; ++i) {
+    ELFIO::section* psec = elf_reader_.sections[i];
+    if (psec->get_name() == ".note.gnu.build-id") {
+      return NoteDescHex(psec);
+    }
+    if (psec->get_name() == ".note.go.buildid") {
+      go_build_id = NoteDescHex(psec);
+    }
+  }
+  if (!go_build_id.empty()) {
+    return go_build_id;
+  }
+  return error::NotFound("No build ID found in $0", binary_path_);
+}
+
 Status ElfReader::LocateDebugSymbols(const std::filesystem::path& debug_file_dir) {
   std::string build_id;
   std::string debug_link;
@@ -66,21 +106,7 @@ Status ElfReader::LocateDebugSymbols(const std::filesystem::path& debug_file_dir
 
     // Method 1: build-id.
     if (psec->get_name() == ".note.gnu.build-id") {
-      // Structure of this section:
-      //    namesz :   32-bit, size of "name" field
-      //    descsz :   32-bit, size of "desc" field
-      //    type   :   32-bit, vendor specific "type"
-      //    name   :   "namesz" bytes, null-terminated string
-      //    desc   :   "descsz" bytes, binary data
-      int32_t name_size =
-          utils::LEndianBytesToInt<int32_t>(std::string_view(psec->get_data(), sizeof(int32_t)));
-      int32_t desc_size = utils::LEndianBytesToInt<int32_t>(
-          std::string_view(psec->get_data() + sizeof(int32_t), sizeof(int32_t)));
-
-      int32_t desc_pos = 3 * sizeof(int32_t) + name_size;
-      std::string_view desc = std::string_view(psec->get_data() + desc_pos, desc_size);
-
-      build_id = BytesToString<LowercaseHex>(desc);
+      build_id = NoteDescHex(psec);
       VLOG(1) << absl::Substitute("Found build-id: $0", build_id);
     }
 
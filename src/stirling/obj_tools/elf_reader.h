@@ -50,6 +50,15 @@ class ElfReader {
 
   std::filesystem::path& debug_symbols_path() { return debug_symbols_path_; }
 
+  /**
+   * Returns the build ID of the binary, as a lowercase hex string.
+   * Uses the GNU build-id note if present, otherwise the Go build ID note.
+   * Identical builds of a binary share a build ID, so it can be used as a cache key.
+   *
+   * @return The build ID, or error::NotFound if the binary has none.
+   */
+  StatusOr<std::string> BuildID();
+
   struct SymbolInfo {
     std::string name;
     int type = -1;
@@ -195,6 +195,16 @@ TEST(ElfReaderTest, ExternalDebugSymbolsBuildID) {
                      ElementsAre(SymbolNameIs("CanYouFindThis")));
 }
 
+TEST(ElfReaderTest, BuildID) {
+  const std::string stripped_bin =
+      px::testing::TestFilePath("src/stirling/obj_tools/testdata/cc/stripped_test_exe");
+
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<ElfReader> elf_reader, ElfReader::Create(stripped_bin));
+
+  // Matches the location of the external debug file under testdata/cc/usr/lib/debug/.build-id.
+  EXPECT_OK_AND_EQ(elf_reader->BuildID(), "7deb0e3f89deba61");
+}
+
 TEST(ElfReaderTest, ExternalDebugSymbolsDebugLink) {
   const std::string stripped_bin =
       px::testing::BazelBinTestFilePath("src/stirling/obj_tools/testdata/cc/test_exe_debuglink");
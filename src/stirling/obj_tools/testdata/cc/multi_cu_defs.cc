@@ -0,0 +1,33 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/stirling/obj_tools/testdata/cc/multi_cu.h"
+
+struct MultiCUStruct {
+  int64_t a;
+  int32_t b;
+};
+
+int64_t MultiCUClass::Method(int64_t x, int32_t y) { return base + x + y; }
+
+MultiCUStruct* NewMultiCUStruct() {
+  static MultiCUStruct s = {4, 5};
+  return &s;
+}
+
+int64_t MultiCUStructSum(const MultiCUStruct* s) { return s->a + s->b; }
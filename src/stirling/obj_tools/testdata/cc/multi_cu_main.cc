@@ -0,0 +1,29 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// This executable is only for testing purposes.
+// This unit only has the declarations of the struct and functions defined in multi_cu_defs.cc,
+// and comes first in the debug info.
+
+#include "src/stirling/obj_tools/testdata/cc/multi_cu.h"
+
+int main() {
+  MultiCUClass c = {1};
+  MultiCUStruct* s = NewMultiCUStruct();
+  return static_cast<int>(c.Method(2, 3) + MultiCUStructSum(s));
+}
@@ -218,6 +218,66 @@ TEST_F(GoHTTPDynamicTraceTest, TraceReturnValue) {
   }
 }
 
+constexpr char kCountTraceProgram[] = R"(
+tracepoints {
+  program {
+    language: GOLANG
+    outputs {
+      name: "probe_WriteDataPadded_count"
+      fields: "end_stream"
+      aggregation { op: COUNT }
+    }
+    probes: {
+      name: "probe_WriteDataPadded"
+      tracepoint: {
+        symbol: "golang.org/x/net/http2.(*Framer).WriteDataPadded"
+        type: LOGICAL
+      }
+      args {
+        id: "end_stream"
+        expr: "endStream"
+      }
+      output_actions {
+        output_name: "probe_WriteDataPadded_count"
+        variable_names: "end_stream"
+      }
+    }
+  }
+}
+)";
+
+TEST_F(GoHTTPDynamicTraceTest, DrainCountedProbe) {
+  ASSERT_NO_FATAL_FAILURE(InitTestFixturesAndRunTestProgram(kCountTraceProgram));
+  std::vector<TaggedRecordBatch> tablets = GetRecords();
+
+  ASSERT_FALSE(tablets.empty());
+
+  const DataTableSchema& schema = connector_->table_schemas()[0];
+  const size_t upid_idx = schema.ColIndex("upid");
+  const size_t count_idx = schema.ColIndex("count");
+
+  {
+    types::ColumnWrapperRecordBatch records =
+        FindRecordsMatchingPID(tablets[0].records, upid_idx, s_.child_pid());
+
+    // Every call is counted once, over the rows of the different end_stream values.
+    int64_t num_calls = 0;
+    for (size_t i = 0; i < records[count_idx]->Size(); ++i) {
+      num_calls += records[count_idx]->Get<types::Int64Value>(i).val;
+    }
+    EXPECT_EQ(num_calls, 200);
+  }
+
+  // The server made no calls since the previous drain, which removed the entries it read, so the
+  // next drain has no rows for it.
+  tablets = GetRecords();
+  for (const auto& tablet : tablets) {
+    types::ColumnWrapperRecordBatch records =
+        FindRecordsMatchingPID(tablet.records, upid_idx, s_.child_pid());
+    EXPECT_THAT(records, Each(ColWrapperSizeIs(0)));
+  }
+}
+
 class CPPDynamicTraceTest : public ::testing::Test {
  protected:
   void InitTestFixturesAndRunTestProgram(const std::string& text_pb) {
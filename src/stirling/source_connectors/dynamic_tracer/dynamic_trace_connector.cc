@@ -18,22 +18,28 @@
 
 #include "src/stirling/source_connectors/dynamic_tracer/dynamic_trace_connector.h"
 
-#include <rapidjson/document.h>
-#include <rapidjson/pointer.h>
-#include <rapidjson/stringbuffer.h>
-#include <rapidjson/writer.h>
-
+#include <cstring>
 #include <map>
+#include <utility>
+
+#include <prometheus/counter.h>
 
 #include "src/common/base/base.h"
+#include "src/common/metrics/metrics.h"
 #include "src/shared/types/typespb/wrapper/types_pb_wrapper.h"
+#include "src/stirling/source_connectors/dynamic_tracer/dynamic_tracing/code_gen.h"
 #include "src/stirling/source_connectors/dynamic_tracer/dynamic_tracing/dynamic_tracer.h"
+#include "src/stirling/source_connectors/dynamic_tracer/struct_blob_decoder.h"
 
 namespace px {
 namespace stirling {
 
 using ::google::protobuf::RepeatedPtrField;
 
+using ::px::stirling::dynamic_tracing::AggregationMapName;
+using ::px::stirling::dynamic_tracing::AggregationStateArrayName;
+using ::px::stirling::dynamic_tracing::kAggregationActiveMapIdx;
+using ::px::stirling::dynamic_tracing::kAggregationDropsIdx;
 using ::px::stirling::dynamic_tracing::ir::physical::Field;
 using ::px::stirling::dynamic_tracing::ir::physical::Struct;
 using ::px::stirling::dynamic_tracing::ir::physical::StructSpec;
@@ -173,12 +179,21 @@ Status DynamicTraceConnector::InitImpl() {
   sampling_freq_mgr_.set_period(kSamplingPeriod);
   push_freq_mgr_.set_period(kPushPeriod);
 
+  PL_RETURN_IF_ERROR(BuildColumnDecoders(bcc_program_.perf_buffer_specs.front().output));
+
   PL_RETURN_IF_ERROR(InitBPFProgram(bcc_program_.code));
 
   for (const auto& uprobe_spec : bcc_program_.uprobe_specs) {
     PL_RETURN_IF_ERROR(AttachUProbe(uprobe_spec));
   }
 
+  if (bcc_program_.perf_buffer_specs.front().aggregated) {
+    // The output is aggregated in two BPF maps, which are drained in turn in TransferData(). Each
+    // drain writes a row per key, so only drain as often as data is pushed.
+    sampling_freq_mgr_.set_period(kPushPeriod);
+    return Status::OK();
+  }
+
   // TODO(yzhao/oazizi): Might need to change this if we need to support multiple perf buffers.
   bpf_tools::PerfBufferSpec spec = {
       .name = bcc_program_.perf_buffer_specs.front().name,
@@ -191,85 +206,6 @@ Status DynamicTraceConnector::InitImpl() {
   return Status::OK();
 }
 
-namespace {
-
-// Parses the content of the input bytes based on the schema in the StructSpec,
-// and returns the content as JSON string.
-StatusOr<std::string> ParseStructBlobToJSON(const StructSpec& struct_spec, std::string_view bytes) {
-  rapidjson::Document d;
-  d.SetObject();
-  for (const auto& entry : struct_spec.entries()) {
-    const void* ptr = bytes.data() + entry.offset();
-
-#define CASE(type)                                        \
-  {                                                       \
-    type tmp = MemCpy<type>(ptr);                         \
-    rapidjson::Pointer(entry.path().c_str()).Set(d, tmp); \
-    break;                                                \
-  }
-    switch (entry.type()) {
-      case ScalarType::BOOL:
-        CASE(bool);
-      case ScalarType::INT:
-        CASE(int);
-      case ScalarType::INT8:
-        CASE(int8_t);
-      case ScalarType::INT16:
-        CASE(int16_t);
-      case ScalarType::INT32:
-        CASE(int32_t);
-      case ScalarType::INT64:
-        CASE(int64_t);
-      case ScalarType::UINT:
-        CASE(unsigned int);
-      case ScalarType::UINT8:
-        CASE(uint8_t);
-      case ScalarType::UINT16:
-        CASE(uint16_t);
-      case ScalarType::UINT32:
-        CASE(uint32_t);
-      case ScalarType::UINT64:
-        CASE(uint64_t);
-      case ScalarType::SHORT:
-        // NOLINTNEXTLINE(runtime/int)
-        CASE(short);
-      case ScalarType::USHORT:
-        // NOLINTNEXTLINE(runtime/int)
-        CASE(unsigned short);
-      case ScalarType::LONG:
-        // NOLINTNEXTLINE(runtime/int)
-        CASE(long);
-      case ScalarType::ULONG:
-        // NOLINTNEXTLINE(runtime/int)
-        CASE(unsigned long);
-      case ScalarType::LONGLONG:
-        // NOLINTNEXTLINE(runtime/int)
-        CASE(int64_t);  // NOTE: had to change from "long long" for rapidjson
-      case ScalarType::ULONGLONG:
-        // NOLINTNEXTLINE(runtime/int)
-        CASE(uint64_t);  // NOTE: had to change from "unsigned long long" for rapidjson
-      case ScalarType::CHAR:
-        CASE(char);
-      case ScalarType::UCHAR:
-        CASE(unsigned char);
-      case ScalarType::FLOAT:
-        CASE(float);
-      case ScalarType::DOUBLE:
-        CASE(double);
-      case ScalarType::VOID_POINTER:
-        CASE(uint64_t);
-      default:
-        LOG(DFATAL) << absl::Substitute("Unhandled type=$0", entry.type());
-    }
-  }
-#undef CASE
-
-  rapidjson::StringBuffer sb;
-  rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
-  d.Accept(writer);
-  return std::string(sb.GetString());
-}
-
 // Reads a byte sequence representing a packed C/C++ struct, and extract the values of the fields.
 class StructDecoder {
  public:
@@ -334,7 +270,8 @@ class StructDecoder {
     return s;
   }
 
-  StatusOr<std::string> ExtractStructBlobAsJSON(const RepeatedPtrField<StructSpec>& struct_specs) {
+  StatusOr<std::string> ExtractStructBlobAsJSON(
+      const std::vector<StructBlobDecoder>& blob_decoders) {
     PL_ASSIGN_OR_RETURN(size_t len, ExtractField<size_t>());
     PL_ASSIGN_OR_RETURN(int8_t idx, ExtractField<int8_t>());
 
@@ -352,22 +289,48 @@ class StructDecoder {
     }
 
     // This tells which StructSpec actually describes the data.
-    ECHECK_LT(idx, struct_specs.size());
-    return ParseStructBlobToJSON(struct_specs.Get(idx), bytes);
+    if (static_cast<size_t>(idx) >= blob_decoders.size()) {
+      return error::Internal("Struct blob index $0 is out of range, there are $1 StructSpecs.", idx,
+                             blob_decoders.size());
+    }
+    std::string json;
+    blob_decoders[idx].AppendJSON(bytes, &json);
+    return json;
   }
 
  private:
   std::string_view buf_;
 };
 
-Status FillColumn(StructDecoder* struct_decoder, DataTable::DynamicRecordBuilder* r, size_t col_idx,
-                  ScalarType type, const RepeatedPtrField<StructSpec>& col_decoder) {
-#define WRITE_COLUMN(field_type, column_type)                                        \
-  {                                                                                  \
-    PL_ASSIGN_OR_RETURN(field_type val, struct_decoder->ExtractField<field_type>()); \
-    r->Append(col_idx, column_type(val));                                            \
-    break;                                                                           \
-  }
+namespace {
+
+using ColumnDecoder =
+    std::function<Status(StructDecoder*, uint32_t, DataTable::DynamicRecordBuilder*)>;
+
+template <typename TFieldType, typename TColumnType>
+ColumnDecoder ScalarColumnDecoder(size_t col_idx) {
+  return [col_idx](StructDecoder* struct_decoder, uint32_t /*asid*/,
+                   DataTable::DynamicRecordBuilder* r) -> Status {
+    PL_ASSIGN_OR_RETURN(TFieldType val, struct_decoder->ExtractField<TFieldType>());
+    r->Append(col_idx, TColumnType(val));
+    return Status::OK();
+  };
+}
+
+template <StatusOr<std::string> (StructDecoder::*TExtractFn)()>
+ColumnDecoder StringColumnDecoder(size_t col_idx) {
+  return [col_idx](StructDecoder* struct_decoder, uint32_t /*asid*/,
+                   DataTable::DynamicRecordBuilder* r) -> Status {
+    PL_ASSIGN_OR_RETURN(std::string val, (struct_decoder->*TExtractFn)());
+    r->Append(col_idx, types::StringValue(std::move(val)));
+    return Status::OK();
+  };
+}
+
+StatusOr<ColumnDecoder> MakeColumnDecoder(size_t col_idx, ScalarType type,
+                                          const RepeatedPtrField<StructSpec>& struct_specs) {
+#define WRITE_COLUMN(field_type, column_type) \
+  return ScalarColumnDecoder<field_type, column_type>(col_idx)
 
   // TODO(yzhao): Right now only support scalar types. We should replace type with ScalarType
   // in Struct::Field.
@@ -424,67 +387,172 @@ Status FillColumn(StructDecoder* struct_decoder, DataTable::DynamicRecordBuilder
       WRITE_COLUMN(double, types::Float64Value);
     case ScalarType::VOID_POINTER:
       WRITE_COLUMN(uint64_t, types::Int64Value);
-    case ScalarType::STRING: {
-      PL_ASSIGN_OR_RETURN(std::string val, struct_decoder->ExtractString());
-      r->Append(col_idx, types::StringValue(val));
-      break;
-    }
-    case ScalarType::BYTE_ARRAY: {
-      PL_ASSIGN_OR_RETURN(std::string val, struct_decoder->ExtractByteArrayAsHex());
-      r->Append(col_idx, types::StringValue(val));
-      break;
-    }
+    case ScalarType::STRING:
+      return StringColumnDecoder<&StructDecoder::ExtractString>(col_idx);
+    case ScalarType::BYTE_ARRAY:
+      return StringColumnDecoder<&StructDecoder::ExtractByteArrayAsHex>(col_idx);
     case ScalarType::STRUCT_BLOB: {
-      PL_ASSIGN_OR_RETURN(std::string val, struct_decoder->ExtractStructBlobAsJSON(col_decoder));
-      r->Append(col_idx, types::StringValue(val));
-      break;
+      // The JSON layout of each StructSpec is planned here, rather than for every event.
+      std::vector<StructBlobDecoder> blob_decoders;
+      for (const auto& struct_spec : struct_specs) {
+        blob_decoders.emplace_back(struct_spec);
+      }
+      return ColumnDecoder([col_idx, blob_decoders = std::move(blob_decoders)](
+                               StructDecoder* struct_decoder, uint32_t /*asid*/,
+                               DataTable::DynamicRecordBuilder* r) -> Status {
+        PL_ASSIGN_OR_RETURN(std::string val,
+                            struct_decoder->ExtractStructBlobAsJSON(blob_decoders));
+        r->Append(col_idx, types::StringValue(std::move(val)));
+        return Status::OK();
+      });
     }
     case ScalarType::UNKNOWN:
       return error::Internal("Unknown scalar type should not be used.");
     case ScalarType::ScalarType_INT_MIN_SENTINEL_DO_NOT_USE_:
     case ScalarType::ScalarType_INT_MAX_SENTINEL_DO_NOT_USE_:
-      LOG(DFATAL) << "Impossible enum value";
       break;
   }
 #undef WRITE_COLUMN
 
-  return Status::OK();
+  return error::Internal("Impossible enum value $0.", type);
 }
 
 }  // namespace
 
-Status DynamicTraceConnector::AppendRecord(const Struct& st, uint32_t asid, std::string_view buf,
-                                           DataTable* data_table) {
-  StructDecoder struct_decoder(buf);
-  DataTable::DynamicRecordBuilder r(data_table);
+Status DynamicTraceConnector::BuildColumnDecoders(const Struct& st) {
+  column_decoders_.clear();
 
-  int col_idx = 0;
+  size_t col_idx = 0;
   for (int i = 0; i < st.fields_size(); ++i) {
     auto& field = st.fields(i);
 
     if (field.name() == "time_") {
-      PL_ASSIGN_OR_RETURN(uint64_t ktime_ns, struct_decoder.ExtractField<uint64_t>());
-      int64_t time = ConvertToRealTime(ktime_ns);
-      r.Append(col_idx++, types::Time64NSValue(time));
+      column_decoders_.push_back([this, col_idx](StructDecoder* struct_decoder, uint32_t /*asid*/,
+                                                 DataTable::DynamicRecordBuilder* r) -> Status {
+        PL_ASSIGN_OR_RETURN(uint64_t ktime_ns, struct_decoder->ExtractField<uint64_t>());
+        int64_t time = ConvertToRealTime(ktime_ns);
+        r->Append(col_idx, types::Time64NSValue(time));
+        return Status::OK();
+      });
     } else if ((field.name() == "tgid_") && (i + 1 < st.fields_size()) &&
                (st.fields(i + 1).name() == "tgid_start_time_")) {
       // If we see "tgid_" and "tgid_start_time_" back-to-back, then we automatically create UPID.
-      PL_ASSIGN_OR_RETURN(uint32_t tgid, struct_decoder.ExtractField<uint32_t>());
-      PL_ASSIGN_OR_RETURN(uint64_t tgid_start_time, struct_decoder.ExtractField<uint64_t>());
-      md::UPID upid(asid, tgid, tgid_start_time);
-      r.Append(col_idx++, types::UInt128Value(upid.value()));
+      column_decoders_.push_back([col_idx](StructDecoder* struct_decoder, uint32_t asid,
+                                           DataTable::DynamicRecordBuilder* r) -> Status {
+        PL_ASSIGN_OR_RETURN(uint32_t tgid, struct_decoder->ExtractField<uint32_t>());
+        PL_ASSIGN_OR_RETURN(uint64_t tgid_start_time, struct_decoder->ExtractField<uint64_t>());
+        md::UPID upid(asid, tgid, tgid_start_time);
+        r->Append(col_idx, types::UInt128Value(upid.value()));
+        return Status::OK();
+      });
 
       // Consume the extra tgid_start_time_ column.
       ++i;
     } else {
-      PL_RETURN_IF_ERROR(
-          FillColumn(&struct_decoder, &r, col_idx++, field.type(), field.blob_decoders()));
+      PL_ASSIGN_OR_RETURN(ColumnDecoder column_decoder,
+                          MakeColumnDecoder(col_idx, field.type(), field.blob_decoders()));
+      column_decoders_.push_back(std::move(column_decoder));
     }
+    ++col_idx;
   }
 
   return Status::OK();
 }
 
+Status DynamicTraceConnector::AppendRecord(uint32_t asid, std::string_view buf,
+                                           DataTable* data_table) {
+  StructDecoder struct_decoder(buf);
+  DataTable::DynamicRecordBuilder r(data_table);
+
+  for (const auto& column_decoder : column_decoders_) {
+    PL_RETURN_IF_ERROR(column_decoder(&struct_decoder, asid, &r));
+  }
+
+  return Status::OK();
+}
+
+namespace {
+
+// Gives access to the raw bytes of the entries of a BPF map, whose key and value types are only
+// known at runtime.
+class RawBPFTable : public ebpf::BPFTable {
+ public:
+  explicit RawBPFTable(const ebpf::BPFTable& table) : ebpf::BPFTable(table) {}
+
+  size_t key_size() const { return desc.key_size; }
+  size_t value_size() const { return desc.leaf_size; }
+
+  std::vector<std::string> Keys() {
+    std::vector<std::string> keys;
+    std::string key(key_size(), '\0');
+    for (bool found = first(key.data()); found; found = next(key.data(), key.data())) {
+      keys.push_back(key);
+    }
+    return keys;
+  }
+
+  bool Lookup(std::string_view key, char* value) {
+    return lookup(const_cast<char*>(key.data()), value);
+  }
+
+  bool Remove(std::string_view key) { return remove(const_cast<char*>(key.data())); }
+};
+
+prometheus::Counter& AggregationMapDropsCounter(const std::string& output) {
+  static auto& family = prometheus::BuildCounter()
+                            .Name("stirling_dynamic_trace_aggregation_map_drops")
+                            .Help("Calls of aggregated dynamic trace outputs that were dropped "
+                                  "because the BPF map was full.")
+                            .Register(GetMetricsRegistry());
+  return family.Add({{"output", output}});
+}
+
+}  // namespace
+
+void DynamicTraceConnector::DrainAggregationMap(uint32_t asid, DataTable* data_table) {
+  const std::string& output_name = bcc_program_.perf_buffer_specs.front().name;
+  ebpf::BPFArrayTable<uint64_t> state =
+      GetArrayTable<uint64_t>(AggregationStateArrayName(output_name));
+
+  // Switch the probes to the other map, so that the entries of the drained map can be removed
+  // without losing calls. A probe that read the map index just before the switch can still update
+  // the drained map after its entry was read; that call is lost, as in the perf profiler.
+  const int drained_map_idx = active_aggregation_map_idx_;
+  const ebpf::StatusTuple s =
+      state.update_value(kAggregationActiveMapIdx, 1 - active_aggregation_map_idx_);
+  if (!s.ok()) {
+    LOG(ERROR) << absl::Substitute("Failed to switch the BPF map of $0, message: $1", output_name,
+                                   s.msg());
+    return;
+  }
+  active_aggregation_map_idx_ = 1 - active_aggregation_map_idx_;
+
+  RawBPFTable table(GetTable(AggregationMapName(output_name, drained_map_idx)));
+  DCHECK_EQ(table.value_size(), sizeof(AggregateValue));
+
+  // Each row is the drain time, followed by the key and value of an entry.
+  std::string row(sizeof(uint64_t) + table.key_size() + sizeof(AggregateValue), '\0');
+  const uint64_t ktime_ns = CurrentSteadyTimeNS();
+  std::memcpy(row.data(), &ktime_ns, sizeof(ktime_ns));
+  char* key_ptr = row.data() + sizeof(uint64_t);
+  char* value_ptr = key_ptr + table.key_size();
+
+  for (const std::string& key : table.Keys()) {
+    if (!table.Lookup(key, value_ptr)) {
+      continue;
+    }
+    std::memcpy(key_ptr, key.data(), key.size());
+    ECHECK_OK(AppendRecord(asid, row, data_table));
+    table.Remove(key);
+  }
+
+  uint64_t drops = 0;
+  if (state.get_value(kAggregationDropsIdx, drops).ok() && drops > prev_aggregation_map_drops_) {
+    AggregationMapDropsCounter(output_name).Increment(drops - prev_aggregation_map_drops_);
+    prev_aggregation_map_drops_ = drops;
+  }
+}
+
 void DynamicTraceConnector::TransferDataImpl(ConnectorContext* ctx,
                                              const std::vector<DataTable*>& data_tables) {
   DCHECK_EQ(data_tables.size(), 1)
@@ -495,13 +563,15 @@ void DynamicTraceConnector::TransferDataImpl(ConnectorContext* ctx,
     return;
   }
 
+  if (bcc_program_.perf_buffer_specs.front().aggregated) {
+    DrainAggregationMap(ctx->GetASID(), data_table);
+    return;
+  }
+
   PollPerfBuffers();
 
   for (const auto& item : data_items_) {
-    // TODO(yzhao): Right now only support scalar types. We should replace type with ScalarType
-    // in Struct::Field.
-    ECHECK_OK(AppendRecord(bcc_program_.perf_buffer_specs.front().output, ctx->GetASID(), item,
-                           data_table));
+    ECHECK_OK(AppendRecord(ctx->GetASID(), item, data_table));
   }
 
   data_items_.clear();
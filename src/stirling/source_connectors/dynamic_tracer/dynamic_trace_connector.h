@@ -19,6 +19,7 @@
 #pragma once
 
 #include <deque>
+#include <functional>
 #include <memory>
 #include <string>
 #include <utility>
@@ -32,6 +33,8 @@
 namespace px {
 namespace stirling {
 
+class StructDecoder;
+
 class DynamicTraceConnector : public SourceConnector, public bpf_tools::BCCWrapper {
  public:
   static constexpr auto kSamplingPeriod = std::chrono::milliseconds{100};
@@ -62,8 +65,19 @@ class DynamicTraceConnector : public SourceConnector, public bpf_tools::BCCWrapp
   Status StopImpl() override { return Status::OK(); }
 
  private:
-  Status AppendRecord(const ::px::stirling::dynamic_tracing::ir::physical::Struct& st,
-                      uint32_t asid, std::string_view buf, DataTable* data_table);
+  // Decodes a column of an event from the perf buffer, and appends it to the record.
+  using ColumnDecoder = std::function<Status(StructDecoder* struct_decoder, uint32_t asid,
+                                             DataTable::DynamicRecordBuilder* r)>;
+
+  // Picks the decoder of each column of the output struct, so that events are decoded without
+  // inspecting the field types again.
+  Status BuildColumnDecoders(const ::px::stirling::dynamic_tracing::ir::physical::Struct& st);
+
+  Status AppendRecord(uint32_t asid, std::string_view buf, DataTable* data_table);
+
+  // Switches the probes of an aggregated output to its other BPF map, and then moves every entry
+  // of the map they were updating into the data table, a row per entry.
+  void DrainAggregationMap(uint32_t asid, DataTable* data_table);
 
   // Describes the output table column types.
   std::unique_ptr<DynamicDataTableSchema> table_schema_;
@@ -71,8 +85,25 @@ class DynamicTraceConnector : public SourceConnector, public bpf_tools::BCCWrapp
   // The actual dynamic trace program.
   dynamic_tracing::BCCProgram bcc_program_;
 
+  // The decoders of the output table columns, in column order.
+  std::vector<ColumnDecoder> column_decoders_;
+
   // A buffer to hold raw data items from the perf buffer.
   std::deque<std::string> data_items_;
+
+  // The value struct of the BPF map entries of an aggregated output, as generated by the
+  // Dwarvifier.
+  struct AggregateValue {
+    uint64_t count = 0;
+    int64_t sum = 0;
+  };
+
+  // The index of the BPF map of an aggregated output that the probes update.
+  int active_aggregation_map_idx_ = 0;
+
+  // The count of calls dropped because the BPF map of an aggregated output was full, as of the
+  // previous drain.
+  uint64_t prev_aggregation_map_drops_ = 0;
 };
 
 // Converts proto specification of columns into the form that is used by TableSchema.
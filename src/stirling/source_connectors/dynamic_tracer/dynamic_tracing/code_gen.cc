@@ -31,6 +31,10 @@
 #include "src/stirling/obj_tools/elf_reader.h"
 #include "src/stirling/source_connectors/dynamic_tracer/dynamic_tracing/types.h"
 
+DEFINE_uint32(stirling_dynamic_trace_aggregation_map_size, 10240,
+              "The maximum number of keys of each BPF map of an aggregated dynamic trace output. "
+              "Calls with a new key are dropped once the map is full.");
+
 namespace px {
 namespace stirling {
 namespace dynamic_tracing {
@@ -39,6 +43,7 @@ using ::px::stirling::bpf_tools::BPFProbeAttachType;
 using ::px::stirling::bpf_tools::UProbeSpec;
 using ::px::stirling::dynamic_tracing::ir::physical::BinaryExpression;
 using ::px::stirling::dynamic_tracing::ir::physical::Field;
+using ::px::stirling::dynamic_tracing::ir::physical::MapAggregateAction;
 using ::px::stirling::dynamic_tracing::ir::physical::MapDeleteAction;
 using ::px::stirling::dynamic_tracing::ir::physical::MapStashAction;
 using ::px::stirling::dynamic_tracing::ir::physical::PerCPUArray;
@@ -55,6 +60,7 @@ using ::px::stirling::dynamic_tracing::ir::physical::Variable;
 using ::px::stirling::dynamic_tracing::ir::shared::BPFHelper;
 using ::px::stirling::dynamic_tracing::ir::shared::Condition;
 using ::px::stirling::dynamic_tracing::ir::shared::Map;
+using ::px::stirling::dynamic_tracing::ir::shared::OutputAggregation;
 using ::px::stirling::dynamic_tracing::ir::shared::Printk;
 using ::px::stirling::dynamic_tracing::ir::shared::ScalarType;
 using ::px::stirling::dynamic_tracing::ir::shared::Tracepoint;
@@ -578,8 +584,106 @@ std::string GenMapDeleteAction(const MapDeleteAction& action) {
   return absl::Substitute("$0.delete(&$1);", action.map_name(), action.key_variable_name());
 }
 
-std::string GenPerfBufferOutput(const PerfBufferOutput& output) {
-  return absl::Substitute("BPF_PERF_OUTPUT($0);", output.name());
+std::string AggregationMapName(std::string_view output_name, int map_idx) {
+  return absl::StrCat(output_name, map_idx == 0 ? "_a" : "_b");
+}
+
+std::string AggregationStateArrayName(std::string_view output_name) {
+  return absl::StrCat(output_name, "_state");
+}
+
+StatusOr<std::vector<std::string>> GenMapAggregateAction(const Struct& key_struct,
+                                                         const MapAggregateAction& action) {
+  const bool has_value = action.op() != OutputAggregation::COUNT;
+  const bool has_bucket = action.op() == OutputAggregation::LOG2_HISTOGRAM;
+
+  if (key_struct.fields_size() != action.key_variable_names_size() + (has_bucket ? 1 : 0)) {
+    return error::InvalidArgument("Key struct '$0' of BPF map '$1' has $2 fields, expect $3",
+                                  key_struct.name(), action.map_name(), key_struct.fields_size(),
+                                  action.key_variable_names_size() + (has_bucket ? 1 : 0));
+  }
+  if (has_value && action.value_variable_name().empty()) {
+    return error::InvalidArgument("BPF map '$0' aggregates values, but has no value variable",
+                                  action.map_name());
+  }
+
+  std::string key_var_name = absl::StrCat(action.map_name(), "_key");
+  std::string init_var_name = absl::StrCat(action.map_name(), "_agg_init");
+  std::string agg_var_name = absl::StrCat(action.map_name(), "_agg");
+  std::string active_idx_var_name = absl::StrCat(action.map_name(), "_active_idx");
+  std::string active_var_name = absl::StrCat(action.map_name(), "_active");
+  std::string drops_idx_var_name = absl::StrCat(action.map_name(), "_drops_idx");
+  std::string drops_var_name = absl::StrCat(action.map_name(), "_drops");
+  std::string state_array_name = AggregationStateArrayName(action.map_name());
+
+  std::vector<std::string> code_lines;
+
+  code_lines.push_back(absl::Substitute("struct $0 $1 = {};", key_struct.name(), key_var_name));
+  for (int i = 0; i < action.key_variable_names_size(); ++i) {
+    code_lines.push_back(absl::Substitute("$0.$1 = $2;", key_var_name, key_struct.fields(i).name(),
+                                          action.key_variable_names(i)));
+  }
+  if (has_bucket) {
+    code_lines.push_back(absl::Substitute("$0.$1 = pl_log2_bucket($2 > 0 ? $2 : 0);",
+                                          key_var_name, key_struct.fields().rbegin()->name(),
+                                          action.value_variable_name()));
+  }
+
+  code_lines.push_back(
+      absl::Substitute("struct $0 $1 = {};", action.value_struct_name(), init_var_name));
+  code_lines.push_back(absl::Substitute("int $0 = $1;", active_idx_var_name,
+                                        kAggregationActiveMapIdx));
+  code_lines.push_back(absl::Substitute("uint64_t* $0 = $1.lookup(&$2);", active_var_name,
+                                        state_array_name, active_idx_var_name));
+  code_lines.push_back(absl::Substitute("struct $0* $1 = NULL;", action.value_struct_name(),
+                                        agg_var_name));
+  code_lines.push_back(absl::Substitute("if ($0 != NULL && *$0 != 0) {", active_var_name));
+  code_lines.push_back(absl::Substitute("$0 = $1.lookup_or_init(&$2, &$3);", agg_var_name,
+                                        AggregationMapName(action.map_name(), 1), key_var_name,
+                                        init_var_name));
+  code_lines.push_back("} else {");
+  code_lines.push_back(absl::Substitute("$0 = $1.lookup_or_init(&$2, &$3);", agg_var_name,
+                                        AggregationMapName(action.map_name(), 0), key_var_name,
+                                        init_var_name));
+  code_lines.push_back("}");
+  code_lines.push_back(absl::Substitute("if ($0 != NULL) {", agg_var_name));
+  // The struct is packed, but map values are 8-byte aligned. The casts let the atomic adds be
+  // compiled into BPF_XADD, which requires aligned operands.
+  code_lines.push_back(
+      absl::Substitute("__sync_fetch_and_add((uint64_t*)&$0->count, 1);", agg_var_name));
+  if (has_value) {
+    code_lines.push_back(absl::Substitute("__sync_fetch_and_add((int64_t*)&$0->sum, $1);",
+                                          agg_var_name, action.value_variable_name()));
+  }
+  // The map is full, count the dropped call.
+  code_lines.push_back("} else {");
+  code_lines.push_back(
+      absl::Substitute("int $0 = $1;", drops_idx_var_name, kAggregationDropsIdx));
+  code_lines.push_back(absl::Substitute("uint64_t* $0 = $1.lookup(&$2);", drops_var_name,
+                                        state_array_name, drops_idx_var_name));
+  code_lines.push_back(absl::Substitute("if ($0 != NULL) {", drops_var_name));
+  code_lines.push_back(absl::Substitute("__sync_fetch_and_add($0, 1);", drops_var_name));
+  code_lines.push_back("}");
+  code_lines.push_back("}");
+
+  return code_lines;
+}
+
+std::vector<std::string> GenPerfBufferOutput(const PerfBufferOutput& output) {
+  if (output.has_aggregation()) {
+    // Aggregated outputs are drained from BPF hash maps, instead of polled from a perf buffer.
+    std::vector<std::string> code_lines;
+    for (int i = 0; i < 2; ++i) {
+      code_lines.push_back(absl::Substitute(
+          "BPF_HASH($0, struct $1, struct $2, $3);", AggregationMapName(output.name(), i),
+          output.struct_type(), output.value_struct_type(),
+          FLAGS_stirling_dynamic_trace_aggregation_map_size));
+    }
+    code_lines.push_back(
+        absl::Substitute("BPF_ARRAY($0, uint64_t, 2);", AggregationStateArrayName(output.name())));
+    return code_lines;
+  }
+  return {absl::Substitute("BPF_PERF_OUTPUT($0);", output.name())};
 }
 
 namespace {
@@ -860,6 +964,22 @@ StatusOr<std::vector<std::string>> BCCCodeGenerator::GenerateProbe(const Probe&
     MOVE_BACK_STR_VEC(GenPerfBufferOutputAction(*iter->second, action), &code_lines);
   }
 
+  for (const auto& action : probe.map_aggregate_actions()) {
+    for (const auto& var_name : action.key_variable_names()) {
+      PL_RETURN_IF_ERROR(CheckVarExists(vars, var_name,
+                                        absl::Substitute("BPF map '$0' key", action.map_name())));
+    }
+    if (action.op() != OutputAggregation::COUNT) {
+      PL_RETURN_IF_ERROR(CheckVarExists(vars, action.value_variable_name(),
+                                        absl::Substitute("BPF map '$0' value", action.map_name())));
+    }
+    auto iter = structs_.find(action.key_struct_name());
+    if (iter == structs_.end()) {
+      return error::InvalidArgument("Key struct '$0' is undefined", action.key_struct_name());
+    }
+    MOVE_BACK_STR_VEC(GenMapAggregateAction(*iter->second, action), &code_lines);
+  }
+
   for (const auto& printk : probe.printks()) {
     PL_ASSIGN_OR_RETURN(std::string code_line, GenPrintk(vars, printk));
     code_lines.push_back(std::move(code_line));
@@ -941,6 +1061,32 @@ std::vector<std::string> GenGOID() {
   };
 }
 
+// Returns floor(log2(x)), and 0 for 0. Unrolled, since BPF doesn't allow loops.
+std::vector<std::string> GenLog2Bucket() {
+  return {
+      "static __inline uint64_t pl_log2_bucket(uint64_t x) {",
+      "uint64_t r = 0;",
+      "if (x >> 32) { x >>= 32; r += 32; }",
+      "if (x >> 16) { x >>= 16; r += 16; }",
+      "if (x >> 8) { x >>= 8; r += 8; }",
+      "if (x >> 4) { x >>= 4; r += 4; }",
+      "if (x >> 2) { x >>= 2; r += 2; }",
+      "if (x >> 1) { r += 1; }",
+      "return r;",
+      "}",
+  };
+}
+
+bool HasLog2Histogram(const Program& program) {
+  for (const auto& output : program.outputs()) {
+    if (output.has_aggregation() &&
+        output.aggregation().op() == OutputAggregation::LOG2_HISTOGRAM) {
+      return true;
+    }
+  }
+  return false;
+}
+
 std::vector<std::string> GenUtilFNs() {
   std::vector<std::string> code_lines;
   MoveBackStrVec(GenNsecToClock(), &code_lines);
@@ -996,6 +1142,9 @@ StatusOr<std::vector<std::string>> BCCCodeGenerator::GenerateCodeLines() {
   MoveBackStrVec(GenIncludes(), &code_lines);
   MoveBackStrVec(GenMacros(), &code_lines);
   MoveBackStrVec(GenUtilFNs(), &code_lines);
+  if (HasLog2Histogram(program_)) {
+    MoveBackStrVec(GenLog2Bucket(), &code_lines);
+  }
   MoveBackStrVec(GenTypes(), &code_lines);
 
   for (const auto& st : program_.structs()) {
@@ -1027,7 +1176,7 @@ StatusOr<std::vector<std::string>> BCCCodeGenerator::GenerateCodeLines() {
   }
 
   for (const auto& output : program_.outputs()) {
-    code_lines.push_back(GenPerfBufferOutput(output));
+    MoveBackStrVec(GenPerfBufferOutput(output), &code_lines);
   }
 
   for (const auto& probe : program_.probes()) {
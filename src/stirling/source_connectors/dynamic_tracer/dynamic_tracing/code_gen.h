@@ -19,6 +19,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <absl/container/flat_hash_map.h>
@@ -49,6 +50,22 @@ StatusOr<std::vector<std::string>> GenStructVariable(const ir::physical::StructV
 // into a BPF map.
 StatusOr<std::vector<std::string>> GenMapStashAction(const ir::physical::MapStashAction& action);
 
+// An aggregated output is kept in two BPF hash maps. Probes update the one selected by the entry
+// at kAggregationActiveMapIdx of the state array, while user space drains the other one. The entry
+// at kAggregationDropsIdx counts the calls that were dropped because the map was full.
+std::string AggregationMapName(std::string_view output_name, int map_idx);
+std::string AggregationStateArrayName(std::string_view output_name);
+inline constexpr int kAggregationActiveMapIdx = 0;
+inline constexpr int kAggregationDropsIdx = 1;
+
+// Returns the code (in multiple lines) that adds a call to the entry of a BPF map that aggregates
+// an output. The key struct describes the fields of the map keys.
+StatusOr<std::vector<std::string>> GenMapAggregateAction(
+    const ir::physical::Struct& key_struct, const ir::physical::MapAggregateAction& action);
+
+// Returns the declarations of the perf buffer, or of the BPF maps of an aggregated output.
+std::vector<std::string> GenPerfBufferOutput(const ir::physical::PerfBufferOutput& output);
+
 // Returns the BCC code for the input physical IR.
 StatusOr<std::string> GenBCCProgram(const ir::physical::Program& program);
 
@@ -31,13 +31,16 @@ namespace dynamic_tracing {
 
 using ::google::protobuf::TextFormat;
 using ::px::stirling::dynamic_tracing::ir::physical::Field;
+using ::px::stirling::dynamic_tracing::ir::physical::MapAggregateAction;
 using ::px::stirling::dynamic_tracing::ir::physical::MapStashAction;
+using ::px::stirling::dynamic_tracing::ir::physical::PerfBufferOutput;
 using ::px::stirling::dynamic_tracing::ir::physical::PerfBufferOutputAction;
 using ::px::stirling::dynamic_tracing::ir::physical::Register;
 using ::px::stirling::dynamic_tracing::ir::physical::ScalarVariable;
 using ::px::stirling::dynamic_tracing::ir::physical::Struct;
 using ::px::stirling::dynamic_tracing::ir::physical::StructVariable;
 using ::px::stirling::dynamic_tracing::ir::shared::BPFHelper;
+using ::px::stirling::dynamic_tracing::ir::shared::OutputAggregation;
 using ::px::stirling::dynamic_tracing::ir::shared::ScalarType;
 using ::testing::ElementsAre;
 using ::testing::ElementsAreArray;
@@ -204,6 +207,98 @@ TEST(GenMapStashActionTest, StashMap) {
                      ElementsAre("if (foo == bar) {", "test.update(&foo, &bar);", "}"));
 }
 
+TEST(GenMapAggregateActionTest, Log2Histogram) {
+  Struct key_struct;
+  key_struct.set_name("out_key_t");
+
+  Field* field = nullptr;
+
+  field = key_struct.add_fields();
+  field->set_name("tgid_");
+  field->set_type(ScalarType::INT32);
+
+  field = key_struct.add_fields();
+  field->set_name("fd");
+  field->set_type(ScalarType::INT32);
+
+  field = key_struct.add_fields();
+  field->set_name("log2_bucket");
+  field->set_type(ScalarType::UINT64);
+
+  MapAggregateAction action;
+  action.set_map_name("out");
+  action.set_key_struct_name("out_key_t");
+  action.add_key_variable_names("tgid");
+  action.add_key_variable_names("fd");
+  action.set_value_struct_name("out_agg_t");
+  action.set_op(OutputAggregation::LOG2_HISTOGRAM);
+  action.set_value_variable_name("latency");
+
+  // Updates the active one of the two maps, and counts the calls dropped because it is full.
+  const std::vector<std::string> kLookupActiveMap = {
+      "int out_active_idx = 0;",
+      "uint64_t* out_active = out_state.lookup(&out_active_idx);",
+      "struct out_agg_t* out_agg = NULL;",
+      "if (out_active != NULL && *out_active != 0) {",
+      "out_agg = out_b.lookup_or_init(&out_key, &out_agg_init);",
+      "} else {",
+      "out_agg = out_a.lookup_or_init(&out_key, &out_agg_init);",
+      "}",
+      "if (out_agg != NULL) {",
+      "__sync_fetch_and_add((uint64_t*)&out_agg->count, 1);",
+  };
+  const std::vector<std::string> kCountDrop = {
+      "} else {",
+      "int out_drops_idx = 1;",
+      "uint64_t* out_drops = out_state.lookup(&out_drops_idx);",
+      "if (out_drops != NULL) {",
+      "__sync_fetch_and_add(out_drops, 1);",
+      "}",
+      "}",
+  };
+
+  std::vector<std::string> expected_code_lines = {
+      "struct out_key_t out_key = {};", "out_key.tgid_ = tgid;", "out_key.fd = fd;",
+      "out_key.log2_bucket = pl_log2_bucket(latency > 0 ? latency : 0);",
+      "struct out_agg_t out_agg_init = {};"};
+  expected_code_lines.insert(expected_code_lines.end(), kLookupActiveMap.begin(),
+                             kLookupActiveMap.end());
+  expected_code_lines.push_back("__sync_fetch_and_add((int64_t*)&out_agg->sum, latency);");
+  expected_code_lines.insert(expected_code_lines.end(), kCountDrop.begin(), kCountDrop.end());
+
+  ASSERT_OK_AND_THAT(GenMapAggregateAction(key_struct, action),
+                     ElementsAreArray(expected_code_lines));
+
+  // A count has no value, and so no bucket either.
+  key_struct.mutable_fields()->RemoveLast();
+  action.set_op(OutputAggregation::COUNT);
+  action.clear_value_variable_name();
+
+  expected_code_lines = {"struct out_key_t out_key = {};", "out_key.tgid_ = tgid;",
+                         "out_key.fd = fd;", "struct out_agg_t out_agg_init = {};"};
+  expected_code_lines.insert(expected_code_lines.end(), kLookupActiveMap.begin(),
+                             kLookupActiveMap.end());
+  expected_code_lines.insert(expected_code_lines.end(), kCountDrop.begin(), kCountDrop.end());
+
+  ASSERT_OK_AND_THAT(GenMapAggregateAction(key_struct, action),
+                     ElementsAreArray(expected_code_lines));
+}
+
+TEST(GenPerfBufferOutputTest, AggregatedOutput) {
+  PerfBufferOutput output;
+  output.set_name("out");
+  output.set_struct_type("out_key_t");
+  output.set_value_struct_type("out_agg_t");
+
+  EXPECT_THAT(GenPerfBufferOutput(output), ElementsAre("BPF_PERF_OUTPUT(out);"));
+
+  output.mutable_aggregation()->set_op(OutputAggregation::COUNT);
+  EXPECT_THAT(GenPerfBufferOutput(output),
+              ElementsAre("BPF_HASH(out_a, struct out_key_t, struct out_agg_t, 10240);",
+                          "BPF_HASH(out_b, struct out_key_t, struct out_agg_t, 10240);",
+                          "BPF_ARRAY(out_state, uint64_t, 2);"));
+}
+
 TEST(GenProgramTest, SpecsAndCode) {
   const std::string program_protobuf = R"proto(
                                        deployment_spec {
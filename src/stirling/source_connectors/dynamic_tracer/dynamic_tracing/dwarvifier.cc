@@ -122,6 +122,10 @@ class Dwarvifier {
   Status ProcessOutputAction(const ir::logical::OutputAction& output_action,
                              ir::physical::Probe* output_probe,
                              ir::physical::Program* output_program);
+  Status ProcessAggregateAction(const ir::logical::OutputAction& output_action,
+                                ir::physical::PerfBufferOutput* output,
+                                ir::physical::Probe* output_probe,
+                                ir::physical::Program* output_program);
 
   // TVarType can be ScalarVariable, StructVariable, etc.
   template <typename TVarType>
@@ -433,6 +437,9 @@ void Dwarvifier::GenerateOutput(const ir::logical::Output& output,
   o->mutable_fields()->CopyFrom(output.fields());
   // Also insert the name of the struct that holds the output variables.
   o->set_struct_type(StructTypeName(output.name()));
+  if (output.has_aggregation()) {
+    o->mutable_aggregation()->CopyFrom(output.aggregation());
+  }
 
   // Record this output (for quick lookup by GenerateProbe).
   outputs_[o->name()] = o;
@@ -1313,6 +1320,12 @@ std::string DataBufferArrayName(std::string_view output_name) {
 Status Dwarvifier::ProcessOutputAction(const ir::logical::OutputAction& output_action_in,
                                        ir::physical::Probe* output_probe,
                                        ir::physical::Program* output_program) {
+  auto output_iter = outputs_.find(output_action_in.output_name());
+  if (output_iter != outputs_.end() && output_iter->second->has_aggregation()) {
+    return ProcessAggregateAction(output_action_in, output_iter->second, output_probe,
+                                  output_program);
+  }
+
   std::string struct_type_name = StructTypeName(output_action_in.output_name());
   std::string data_buffer_array_name = DataBufferArrayName(output_action_in.output_name());
 
@@ -1350,6 +1363,148 @@ Status Dwarvifier::ProcessOutputAction(const ir::logical::OutputAction& output_a
   return Status::OK();
 }
 
+namespace {
+
+// The fields of the BPF map entries of aggregated outputs, in addition to the output fields.
+constexpr char kAggLog2BucketFieldName[] = "log2_bucket";
+constexpr char kAggCountFieldName[] = "count";
+constexpr char kAggSumFieldName[] = "sum";
+
+bool IsIntegerType(ir::shared::ScalarType type) {
+  switch (type) {
+    case ir::shared::ScalarType::BOOL:
+    case ir::shared::ScalarType::SHORT:
+    case ir::shared::ScalarType::USHORT:
+    case ir::shared::ScalarType::INT:
+    case ir::shared::ScalarType::UINT:
+    case ir::shared::ScalarType::LONG:
+    case ir::shared::ScalarType::ULONG:
+    case ir::shared::ScalarType::LONGLONG:
+    case ir::shared::ScalarType::ULONGLONG:
+    case ir::shared::ScalarType::INT8:
+    case ir::shared::ScalarType::INT16:
+    case ir::shared::ScalarType::INT32:
+    case ir::shared::ScalarType::INT64:
+    case ir::shared::ScalarType::UINT8:
+    case ir::shared::ScalarType::UINT16:
+    case ir::shared::ScalarType::UINT32:
+    case ir::shared::ScalarType::UINT64:
+    case ir::shared::ScalarType::CHAR:
+    case ir::shared::ScalarType::UCHAR:
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+Status Dwarvifier::ProcessAggregateAction(const ir::logical::OutputAction& output_action_in,
+                                          ir::physical::PerfBufferOutput* output,
+                                          ir::physical::Probe* output_probe,
+                                          ir::physical::Program* output_program) {
+  const ir::shared::OutputAggregation& aggregation = output->aggregation();
+  const bool has_value = aggregation.op() != ir::shared::OutputAggregation::COUNT;
+
+  if (output->fields_size() != output_action_in.variable_names_size()) {
+    return error::InvalidArgument(
+        "OutputAction to '$0' writes $1 variables, but the Output has $2 fields",
+        output_action_in.output_name(), output_action_in.variable_names_size(),
+        output->fields_size());
+  }
+
+  std::string key_struct_type_name = absl::StrCat(output->name(), "_key_t");
+  std::string value_struct_type_name = absl::StrCat(output->name(), "_agg_t");
+
+  auto* key_struct = output_program->add_structs();
+  key_struct->set_name(key_struct_type_name);
+
+  auto* aggregate_action = output_probe->add_map_aggregate_actions();
+  aggregate_action->set_map_name(output->name());
+  aggregate_action->set_key_struct_name(key_struct_type_name);
+  aggregate_action->set_value_struct_name(value_struct_type_name);
+  aggregate_action->set_op(aggregation.op());
+
+  auto add_key = [&](const std::string& field_name, const std::string& var_name) -> Status {
+    if (field_name == kAggLog2BucketFieldName || field_name == kAggCountFieldName ||
+        field_name == kAggSumFieldName) {
+      return error::InvalidArgument("Field name '$0' is reserved in aggregated output '$1'",
+                                    field_name, output->name());
+    }
+    auto iter = variables_.find(var_name);
+    if (iter == variables_.end()) {
+      return error::Internal("ProcessAggregateAction [output=$0]: Reference to unknown variable $1",
+                             output->name(), var_name);
+    }
+    if (!IsIntegerType(iter->second.type())) {
+      return error::InvalidArgument(
+          "Field '$0' of aggregated output '$1' has type $2, but keys must be integers",
+          field_name, output->name(), magic_enum::enum_name(iter->second.type()));
+    }
+    auto* struct_field = key_struct->add_fields();
+    struct_field->CopyFrom(iter->second);
+    struct_field->set_name(field_name);
+    aggregate_action->add_key_variable_names(var_name);
+    return Status::OK();
+  };
+
+  // The process is always part of the key, so that the rows are attributed to their UPID.
+  PL_RETURN_IF_ERROR(add_key(kTGIDVarName, kTGIDVarName));
+  PL_RETURN_IF_ERROR(add_key(kTGIDStartTimeVarName, kTGIDStartTimeVarName));
+
+  for (int i = 0; i < output->fields_size(); ++i) {
+    const std::string& var_name = output_action_in.variable_names(i);
+
+    if (has_value && output->fields(i) == aggregation.value_field()) {
+      auto iter = variables_.find(var_name);
+      if (iter == variables_.end()) {
+        return error::Internal(
+            "ProcessAggregateAction [output=$0]: Reference to unknown variable $1",
+            output->name(), var_name);
+      }
+      if (!IsIntegerType(iter->second.type())) {
+        return error::InvalidArgument(
+            "Value field '$0' of aggregated output '$1' has type $2, but must be an integer",
+            aggregation.value_field(), output->name(), magic_enum::enum_name(iter->second.type()));
+      }
+      aggregate_action->set_value_variable_name(var_name);
+      continue;
+    }
+
+    PL_RETURN_IF_ERROR(add_key(output->fields(i), var_name));
+  }
+
+  if (has_value && aggregate_action->value_variable_name().empty()) {
+    return error::InvalidArgument("Value field '$0' is not a field of aggregated output '$1'",
+                                  aggregation.value_field(), output->name());
+  }
+
+  if (aggregation.op() == ir::shared::OutputAggregation::LOG2_HISTOGRAM) {
+    auto* bucket_field = key_struct->add_fields();
+    bucket_field->set_name(kAggLog2BucketFieldName);
+    bucket_field->set_type(ir::shared::ScalarType::UINT64);
+  }
+
+  auto* value_struct = output_program->add_structs();
+  value_struct->set_name(value_struct_type_name);
+
+  auto* count_field = value_struct->add_fields();
+  count_field->set_name(kAggCountFieldName);
+  count_field->set_type(ir::shared::ScalarType::UINT64);
+
+  auto* sum_field = value_struct->add_fields();
+  sum_field->set_name(kAggSumFieldName);
+  sum_field->set_type(ir::shared::ScalarType::INT64);
+
+  output->set_struct_type(key_struct_type_name);
+  output->set_value_struct_type(value_struct_type_name);
+
+  structs_[key_struct_type_name] = key_struct;
+  structs_[value_struct_type_name] = value_struct;
+
+  return Status::OK();
+}
+
 }  // namespace dynamic_tracing
 }  // namespace stirling
 }  // namespace px
@@ -90,7 +90,34 @@ StatusOr<BCCProgram::PerfBufferSpec> GetPerfBufferSpec(
   BCCProgram::PerfBufferSpec pf_spec;
 
   pf_spec.name = output.name();
-  pf_spec.output = *iter->second;
+
+  if (!output.has_aggregation()) {
+    pf_spec.output = *iter->second;
+    return pf_spec;
+  }
+
+  auto value_iter = structs.find(output.value_struct_type());
+  if (value_iter == structs.end()) {
+    return error::InvalidArgument("Struct '$0' was not defined", output.value_struct_type());
+  }
+
+  pf_spec.aggregated = true;
+  pf_spec.output.set_name(output.struct_type());
+
+  auto* time_field = pf_spec.output.add_fields();
+  time_field->set_name("time_");
+  time_field->set_type(ir::shared::ScalarType::UINT64);
+
+  pf_spec.output.mutable_fields()->MergeFrom(iter->second->fields());
+  const ir::physical::Struct& value_struct = *value_iter->second;
+  int num_value_fields = value_struct.fields_size();
+  if (output.aggregation().op() == ir::shared::OutputAggregation::COUNT) {
+    // The sum is the last value field, and is meaningless when only counting calls.
+    --num_value_fields;
+  }
+  for (int i = 0; i < num_value_fields; ++i) {
+    pf_spec.output.add_fields()->CopyFrom(value_struct.fields(i));
+  }
 
   return pf_spec;
 }
@@ -115,7 +142,7 @@ StatusOr<ObjInfo> Prepare(const ir::logical::TracepointDeployment& input_program
   const auto& debug_symbols_path = obj_info.elf_reader->debug_symbols_path().string();
 
   obj_info.dwarf_reader =
-      DwarfReader::CreateIndexingAll(debug_symbols_path).ConsumeValueOr(nullptr);
+      DwarfReader::CreateIndexingOnDemand(debug_symbols_path).ConsumeValueOr(nullptr);
 
   return obj_info;
 }
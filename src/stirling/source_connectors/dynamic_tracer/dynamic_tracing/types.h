@@ -58,8 +58,14 @@ struct BCCProgram {
     std::string name;
     ir::physical::Struct output;
 
+    // If true, name is a BPF hash map that aggregates the output, instead of a perf buffer.
+    // Each drained row is laid out as the drain time, followed by the key and value of a map
+    // entry, which is what the output struct describes.
+    bool aggregated = false;
+
     std::string ToString() const {
-      return absl::Substitute("[name=$0 Output struct=$1]", name, output.DebugString());
+      return absl::Substitute("[name=$0 aggregated=$1 Output struct=$2]", name, aggregated,
+                              output.DebugString());
     }
   };
 
@@ -0,0 +1,330 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "src/stirling/source_connectors/dynamic_tracer/struct_blob_decoder.h"
+
+#include <rapidjson/document.h>
+#include <rapidjson/internal/dtoa.h>
+#include <rapidjson/pointer.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <utility>
+
+#include <absl/strings/ascii.h>
+#include <absl/strings/str_cat.h>
+#include <absl/strings/str_split.h>
+
+namespace px {
+namespace stirling {
+
+using ::px::stirling::dynamic_tracing::ir::physical::StructSpec;
+using ::px::stirling::dynamic_tracing::ir::shared::ScalarType;
+using ::px::utils::MemCpy;
+
+namespace {
+
+// Sets every entry of the StructSpec in a rapidjson document, and serializes the document.
+std::string StructBlobToJSONWithDocument(const StructSpec& struct_spec, std::string_view bytes) {
+  rapidjson::Document d;
+  d.SetObject();
+  for (const auto& entry : struct_spec.entries()) {
+    const void* ptr = bytes.data() + entry.offset();
+
+#define CASE(type)                                        \
+  {                                                       \
+    type tmp = MemCpy<type>(ptr);                         \
+    rapidjson::Pointer(entry.path().c_str()).Set(d, tmp); \
+    break;                                                \
+  }
+    switch (entry.type()) {
+      case ScalarType::BOOL:
+        CASE(bool);
+      case ScalarType::INT:
+        CASE(int);
+      case ScalarType::INT8:
+        CASE(int8_t);
+      case ScalarType::INT16:
+        CASE(int16_t);
+      case ScalarType::INT32:
+        CASE(int32_t);
+      case ScalarType::INT64:
+        CASE(int64_t);
+      case ScalarType::UINT:
+        CASE(unsigned int);
+      case ScalarType::UINT8:
+        CASE(uint8_t);
+      case ScalarType::UINT16:
+        CASE(uint16_t);
+      case ScalarType::UINT32:
+        CASE(uint32_t);
+      case ScalarType::UINT64:
+        CASE(uint64_t);
+      case ScalarType::SHORT:
+        // NOLINTNEXTLINE(runtime/int)
+        CASE(short);
+      case ScalarType::USHORT:
+        // NOLINTNEXTLINE(runtime/int)
+        CASE(unsigned short);
+      case ScalarType::LONG:
+        // NOLINTNEXTLINE(runtime/int)
+        CASE(long);
+      case ScalarType::ULONG:
+        // NOLINTNEXTLINE(runtime/int)
+        CASE(unsigned long);
+      case ScalarType::LONGLONG:
+        // NOLINTNEXTLINE(runtime/int)
+        CASE(int64_t);  // NOTE: had to change from "long long" for rapidjson
+      case ScalarType::ULONGLONG:
+        // NOLINTNEXTLINE(runtime/int)
+        CASE(uint64_t);  // NOTE: had to change from "unsigned long long" for rapidjson
+      case ScalarType::CHAR:
+        CASE(char);
+      case ScalarType::UCHAR:
+        CASE(unsigned char);
+      case ScalarType::FLOAT:
+        CASE(float);
+      case ScalarType::DOUBLE:
+        CASE(double);
+      case ScalarType::VOID_POINTER:
+        CASE(uint64_t);
+      default:
+        LOG(DFATAL) << absl::Substitute("Unhandled type=$0", entry.type());
+    }
+  }
+#undef CASE
+
+  rapidjson::StringBuffer sb;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
+  d.Accept(writer);
+  return std::string(sb.GetString());
+}
+
+// The functions below format a value the same way as rapidjson does once it is set in a document.
+// In particular, integer types narrower than int are promoted to int, so chars are numbers.
+template <typename TNative, typename TFormatted>
+void AppendInteger(const char* ptr, std::string* out) {
+  absl::StrAppend(out, static_cast<TFormatted>(MemCpy<TNative>(ptr)));
+}
+
+void AppendBool(const char* ptr, std::string* out) {
+  out->append(MemCpy<bool>(ptr) ? "true" : "false");
+}
+
+template <typename TNative>
+void AppendFloat(const char* ptr, std::string* out) {
+  double val = MemCpy<TNative>(ptr);
+  // rapidjson fails to write NaN and infinity, leaving the JSON truncated. Write null instead.
+  if (!std::isfinite(val)) {
+    out->append("null");
+    return;
+  }
+  char buf[25];
+  char* end = rapidjson::internal::dtoa(val, buf);
+  out->append(buf, end - buf);
+}
+
+using AppendFn = void (*)(const char* ptr, std::string* out);
+
+AppendFn AppendFnForType(ScalarType type) {
+  switch (type) {
+    case ScalarType::BOOL:
+      return &AppendBool;
+    case ScalarType::INT:
+      return &AppendInteger<int, int64_t>;
+    case ScalarType::INT8:
+      return &AppendInteger<int8_t, int64_t>;
+    case ScalarType::INT16:
+      return &AppendInteger<int16_t, int64_t>;
+    case ScalarType::INT32:
+      return &AppendInteger<int32_t, int64_t>;
+    case ScalarType::INT64:
+    case ScalarType::LONGLONG:
+      return &AppendInteger<int64_t, int64_t>;
+    case ScalarType::UINT:
+      return &AppendInteger<unsigned int, uint64_t>;
+    case ScalarType::UINT8:
+      return &AppendInteger<uint8_t, int64_t>;
+    case ScalarType::UINT16:
+      return &AppendInteger<uint16_t, int64_t>;
+    case ScalarType::UINT32:
+      return &AppendInteger<uint32_t, uint64_t>;
+    case ScalarType::UINT64:
+    case ScalarType::ULONGLONG:
+    case ScalarType::VOID_POINTER:
+      return &AppendInteger<uint64_t, uint64_t>;
+    case ScalarType::SHORT:
+      // NOLINTNEXTLINE(runtime/int)
+      return &AppendInteger<short, int64_t>;
+    case ScalarType::USHORT:
+      // NOLINTNEXTLINE(runtime/int)
+      return &AppendInteger<unsigned short, int64_t>;
+    case ScalarType::LONG:
+      // NOLINTNEXTLINE(runtime/int)
+      return &AppendInteger<long, int64_t>;
+    case ScalarType::ULONG:
+      // NOLINTNEXTLINE(runtime/int)
+      return &AppendInteger<unsigned long, uint64_t>;
+    case ScalarType::CHAR:
+      return &AppendInteger<char, int64_t>;
+    case ScalarType::UCHAR:
+      return &AppendInteger<unsigned char, int64_t>;
+    case ScalarType::FLOAT:
+      return &AppendFloat<float>;
+    case ScalarType::DOUBLE:
+      return &AppendFloat<double>;
+    default:
+      return nullptr;
+  }
+}
+
+// Splits a JSON pointer into its unescaped tokens. Fails for tokens that rapidjson treats as array
+// indices, and for anything but plain JSON pointers.
+bool ParsePointer(std::string_view path, std::vector<std::string>* tokens) {
+  if (path.empty() || path.front() != '/') {
+    return false;
+  }
+  path.remove_prefix(1);
+  for (std::string_view raw_token : absl::StrSplit(path, '/')) {
+    std::string token;
+    for (size_t i = 0; i < raw_token.size(); ++i) {
+      if (raw_token[i] != '~') {
+        token.push_back(raw_token[i]);
+      } else if (i + 1 < raw_token.size() && raw_token[i + 1] == '0') {
+        token.push_back('~');
+        ++i;
+      } else if (i + 1 < raw_token.size() && raw_token[i + 1] == '1') {
+        token.push_back('/');
+        ++i;
+      } else {
+        return false;
+      }
+    }
+    if (std::all_of(raw_token.begin(), raw_token.end(), absl::ascii_isdigit)) {
+      return false;
+    }
+    tokens->push_back(std::move(token));
+  }
+  return true;
+}
+
+std::string JSONString(std::string_view str) {
+  rapidjson::StringBuffer sb;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
+  writer.String(str.data(), str.size());
+  return std::string(sb.GetString(), sb.GetSize());
+}
+
+// A key of the JSON object, in the order keys are first set.
+struct Node {
+  // The key as a JSON string.
+  std::string key;
+  std::vector<size_t> children;
+  // The StructSpec entry of the value, or -1 for objects.
+  int entry_idx = -1;
+};
+
+}  // namespace
+
+StructBlobDecoder::StructBlobDecoder(const StructSpec& struct_spec) {
+  if (!Plan(struct_spec)) {
+    values_.clear();
+    suffix_.clear();
+    use_fallback_ = true;
+    fallback_spec_ = struct_spec;
+  }
+}
+
+bool StructBlobDecoder::Plan(const StructSpec& struct_spec) {
+  // Build the tree of keys, starting from the root object.
+  std::vector<Node> nodes(1);
+  for (int i = 0; i < struct_spec.entries_size(); ++i) {
+    const auto& entry = struct_spec.entries(i);
+    if (AppendFnForType(entry.type()) == nullptr) {
+      LOG(DFATAL) << absl::Substitute("Unhandled type=$0", entry.type());
+      continue;
+    }
+
+    std::vector<std::string> tokens;
+    if (!ParsePointer(entry.path(), &tokens)) {
+      return false;
+    }
+    size_t node = 0;
+    for (size_t t = 0; t < tokens.size(); ++t) {
+      if (nodes[node].entry_idx >= 0) {
+        // A value would be replaced by an object.
+        return false;
+      }
+      std::string key = JSONString(tokens[t]);
+      auto iter = std::find_if(nodes[node].children.begin(), nodes[node].children.end(),
+                               [&](size_t child) { return nodes[child].key == key; });
+      if (iter == nodes[node].children.end()) {
+        nodes.push_back(Node{std::move(key), {}, -1});
+        nodes[node].children.push_back(nodes.size() - 1);
+        node = nodes.size() - 1;
+      } else if (t + 1 == tokens.size()) {
+        // The path was already set, and would be replaced.
+        return false;
+      } else {
+        node = *iter;
+      }
+    }
+    nodes[node].entry_idx = i;
+  }
+
+  // Lay out the JSON with a depth-first walk of the tree.
+  std::string literal;
+  std::function<void(size_t)> layout = [&](size_t node) {
+    if (nodes[node].entry_idx >= 0) {
+      const auto& entry = struct_spec.entries(nodes[node].entry_idx);
+      values_.push_back(Value{std::move(literal), entry.offset(), AppendFnForType(entry.type())});
+      literal.clear();
+      return;
+    }
+    literal.push_back('{');
+    for (size_t i = 0; i < nodes[node].children.size(); ++i) {
+      size_t child = nodes[node].children[i];
+      if (i > 0) {
+        literal.push_back(',');
+      }
+      absl::StrAppend(&literal, nodes[child].key, ":");
+      layout(child);
+    }
+    literal.push_back('}');
+  };
+  layout(0);
+  suffix_ = std::move(literal);
+  return true;
+}
+
+void StructBlobDecoder::AppendJSON(std::string_view bytes, std::string* out) const {
+  if (use_fallback_) {
+    out->append(StructBlobToJSONWithDocument(fallback_spec_, bytes));
+    return;
+  }
+  for (const auto& value : values_) {
+    out->append(value.prefix);
+    value.append_fn(bytes.data() + value.offset, out);
+  }
+  out->append(suffix_);
+}
+
+}  // namespace stirling
+}  // namespace px
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "src/common/base/base.h"
+#include "src/stirling/source_connectors/dynamic_tracer/dynamic_tracing/ir/physicalpb/physical.pb.h"
+
+namespace px {
+namespace stirling {
+
+/**
+ * Decodes the bytes of a struct, as described by a StructSpec, into JSON.
+ *
+ * The entry paths of the StructSpec are JSON pointers. Rather than setting each of them in a JSON
+ * document for every event, the decoder lays out the JSON once, when it is created: every value
+ * is preceded by a literal of the keys and brackets in front of it. Decoding an event then only
+ * appends those literals and formats the values, without allocating anything but the output.
+ *
+ * The output is the same as setting the JSON pointers in a rapidjson document in entry order.
+ * StructSpecs whose paths can't be laid out ahead of time (array indices, or paths that overwrite
+ * each other) fall back to doing exactly that.
+ */
+class StructBlobDecoder {
+ public:
+  explicit StructBlobDecoder(const dynamic_tracing::ir::physical::StructSpec& struct_spec);
+
+  /**
+   * Appends the JSON of the struct in bytes to out.
+   */
+  void AppendJSON(std::string_view bytes, std::string* out) const;
+
+ private:
+  struct Value {
+    // The keys and brackets between the previous value and this one.
+    std::string prefix;
+    int32_t offset;
+    // Formats the value at the offset into the output.
+    void (*append_fn)(const char* ptr, std::string* out);
+  };
+
+  bool Plan(const dynamic_tracing::ir::physical::StructSpec& struct_spec);
+
+  std::vector<Value> values_;
+  // The brackets after the last value.
+  std::string suffix_;
+
+  // Set when the paths could not be laid out ahead of time.
+  bool use_fallback_ = false;
+  dynamic_tracing::ir::physical::StructSpec fallback_spec_;
+};
+
+}  // namespace stirling
+}  // namespace px
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "src/stirling/source_connectors/dynamic_tracer/struct_blob_decoder.h"
+
+#include <google/protobuf/text_format.h>
+
+#include <cstring>
+#include <string>
+
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace stirling {
+
+using ::px::stirling::dynamic_tracing::ir::physical::StructSpec;
+
+StructSpec ParseStructSpec(std::string_view text) {
+  StructSpec struct_spec;
+  CHECK(google::protobuf::TextFormat::ParseFromString(std::string(text), &struct_spec));
+  return struct_spec;
+}
+
+template <typename T>
+void Put(std::string* buf, size_t offset, T val) {
+  std::memcpy(buf->data() + offset, &val, sizeof(T));
+}
+
+std::string Decode(const StructSpec& struct_spec, std::string_view bytes) {
+  std::string json;
+  StructBlobDecoder(struct_spec).AppendJSON(bytes, &json);
+  return json;
+}
+
+TEST(StructBlobDecoderTest, NestedPaths) {
+  StructSpec struct_spec = ParseStructSpec(R"(
+      entries { offset: 0 size: 4 type: INT32 path: "/a" }
+      entries { offset: 4 size: 1 type: BOOL path: "/b/c" }
+      entries { offset: 8 size: 8 type: DOUBLE path: "/b/d" }
+      entries { offset: 16 size: 1 type: CHAR path: "/e" }
+      entries { offset: 24 size: 8 type: UINT64 path: "/b/f/g" }
+  )");
+
+  std::string buf(32, '\0');
+  Put<int32_t>(&buf, 0, -12);
+  Put<bool>(&buf, 4, true);
+  Put<double>(&buf, 8, 1.5);
+  Put<char>(&buf, 16, 'A');
+  Put<uint64_t>(&buf, 24, 18446744073709551615ULL);
+
+  EXPECT_EQ(Decode(struct_spec, buf),
+            R"({"a":-12,"b":{"c":true,"d":1.5,"f":{"g":18446744073709551615}},"e":65})");
+}
+
+TEST(StructBlobDecoderTest, EscapedKeys) {
+  StructSpec struct_spec = ParseStructSpec(R"(
+      entries { offset: 0 size: 4 type: FLOAT path: "/x~1y" }
+      entries { offset: 4 size: 2 type: SHORT path: "/q\"~0" }
+  )");
+
+  std::string buf(8, '\0');
+  Put<float>(&buf, 0, 0.25);
+  Put<int16_t>(&buf, 4, 7);
+
+  EXPECT_EQ(Decode(struct_spec, buf), R"({"x/y":0.25,"q\"~":7})");
+}
+
+TEST(StructBlobDecoderTest, NoEntries) { EXPECT_EQ(Decode(StructSpec(), ""), "{}"); }
+
+TEST(StructBlobDecoderTest, AppendsToOutput) {
+  StructSpec struct_spec = ParseStructSpec(R"(
+      entries { offset: 0 size: 4 type: UINT32 path: "/a" }
+  )");
+  StructBlobDecoder decoder(struct_spec);
+
+  std::string buf(4, '\0');
+  std::string json;
+  Put<uint32_t>(&buf, 0, 1);
+  decoder.AppendJSON(buf, &json);
+  Put<uint32_t>(&buf, 0, 2);
+  decoder.AppendJSON(buf, &json);
+
+  EXPECT_EQ(json, R"({"a":1}{"a":2})");
+}
+
+// Array indices can't be laid out ahead of time, and go through rapidjson instead.
+TEST(StructBlobDecoderTest, ArrayIndexFallback) {
+  StructSpec struct_spec = ParseStructSpec(R"(
+      entries { offset: 0 size: 4 type: INT path: "/arr/0" }
+      entries { offset: 4 size: 4 type: INT path: "/b" }
+  )");
+
+  std::string buf(8, '\0');
+  Put<int>(&buf, 0, 5);
+  Put<int>(&buf, 4, 6);
+
+  EXPECT_EQ(Decode(struct_spec, buf), R"({"arr":[5],"b":6})");
+}
+
+// A later path that replaces an earlier value is also left to rapidjson.
+TEST(StructBlobDecoderTest, OverwrittenPathFallback) {
+  StructSpec struct_spec = ParseStructSpec(R"(
+      entries { offset: 0 size: 4 type: INT path: "/a" }
+      entries { offset: 4 size: 4 type: INT path: "/a" }
+  )");
+
+  std::string buf(8, '\0');
+  Put<int>(&buf, 0, 5);
+  Put<int>(&buf, 4, 6);
+
+  EXPECT_EQ(Decode(struct_spec, buf), R"({"a":6})");
+}
+
+}  // namespace stirling
+}  // namespace px
@@ -32,6 +32,9 @@ BPF_SRC_STRVIEW(profiler_bcc_script, profiler);
 DEFINE_string(stirling_profiler_symbolizer, "bcc",
               "Choice of which symbolizer to use. Options: bcc, elf");
 DEFINE_bool(stirling_profiler_cache_symbols, true, "Whether to cache symbols");
+DEFINE_bool(stirling_profiler_stack_traces_beta, true,
+            "Whether to populate stack_traces.beta, which repeats the stack trace string in every "
+            "record, for scripts that don't read stack_traces_v2.beta yet.");
 
 DEFINE_uint32(stirling_perf_profiler_stats_logging_ratio,
               std::chrono::minutes(10) / px::stirling::PerfProfileConnector::kSamplingPeriod,
@@ -213,7 +216,7 @@ PerfProfileConnector::StackTraceHisto PerfProfileConnector::AggregateStackTraces
 }
 
 void PerfProfileConnector::CreateRecords(ebpf::BPFStackTable* stack_traces, ConnectorContext* ctx,
-                                         DataTable* data_table) {
+                                         const std::vector<DataTable*>& data_tables) {
   constexpr size_t kMaxSymbolSize = 512;
   constexpr size_t kMaxStackDepth = 64;
   constexpr size_t kMaxStackTraceSize = kMaxStackDepth * kMaxSymbolSize;
@@ -228,23 +231,53 @@ void PerfProfileConnector::CreateRecords(ebpf::BPFStackTable* stack_traces, Conn
 
   StackTraceHisto stack_trace_histogram = AggregateStackTraces(ctx, stack_traces);
 
+  DataTable* data_table =
+      FLAGS_stirling_profiler_stack_traces_beta ? data_tables[kPerfProfileTableNum] : nullptr;
+  DataTable* v2_table = data_tables[kStackTraceV2TableNum];
+  DataTable* strings_table = data_tables[kStackTraceStringsTableNum];
+
   constexpr auto age_tick_period = std::chrono::minutes(5);
   if (sampling_freq_mgr_.count() % (age_tick_period / kSamplingPeriod) == 0) {
     stack_trace_ids_.AgeTick();
   }
 
   for (const auto& [key, count] : stack_trace_histogram) {
-    DataTable::RecordBuilder<&kStackTraceTable> r(data_table, timestamp_ns);
+    bool new_in_generation = false;
+    const uint64_t stack_trace_id = stack_trace_ids_.Lookup(key, &new_in_generation);
+
+    if (data_table != nullptr) {
+      DataTable::RecordBuilder<&kStackTraceTable> r(data_table, timestamp_ns);
+      r.Append<r.ColIndex("time_")>(timestamp_ns);
+      r.Append<r.ColIndex("upid")>(key.upid.value());
+      r.Append<r.ColIndex("stack_trace_id")>(stack_trace_id);
+      r.Append<r.ColIndex("stack_trace"), kMaxStackTraceSize>(key.stack_trace_str);
+      r.Append<r.ColIndex("count")>(count);
+    }
+
+    if (v2_table != nullptr) {
+      DataTable::RecordBuilder<&kStackTraceV2Table> r(v2_table, timestamp_ns);
+      r.Append<r.ColIndex("time_")>(timestamp_ns);
+      r.Append<r.ColIndex("upid")>(key.upid.value());
+      r.Append<r.ColIndex("stack_trace_id")>(stack_trace_id);
+      r.Append<r.ColIndex("count")>(count);
+    }
 
-    r.Append<r.ColIndex("time_")>(timestamp_ns);
-    r.Append<r.ColIndex("upid")>(key.upid.value());
-    r.Append<r.ColIndex("stack_trace_id")>(stack_trace_ids_.Lookup(key));
-    r.Append<r.ColIndex("stack_trace"), kMaxStackTraceSize>(key.stack_trace_str);
-    r.Append<r.ColIndex("count")>(count);
+    // Stacks repeat almost entirely from one period to the next, so the string is only recorded
+    // when the ID is new to the current generation of the ID cache, rather than with every count.
+    // Re-recording it once per generation keeps it within reach of queries over recent data.
+    // The pxprofiler PxL module relies on this to read the strings from two periods back.
+    if (new_in_generation && strings_table != nullptr) {
+      DataTable::RecordBuilder<&kStackTraceStringsTable> s(strings_table, timestamp_ns);
+      s.Append<s.ColIndex("time_")>(timestamp_ns);
+      s.Append<s.ColIndex("upid")>(key.upid.value());
+      s.Append<s.ColIndex("stack_trace_id")>(stack_trace_id);
+      s.Append<s.ColIndex("stack_trace"), kMaxStackTraceSize>(key.stack_trace_str);
+    }
   }
 }
 
-void PerfProfileConnector::ProcessBPFStackTraces(ConnectorContext* ctx, DataTable* data_table) {
+void PerfProfileConnector::ProcessBPFStackTraces(ConnectorContext* ctx,
+                                                 const std::vector<DataTable*>& data_tables) {
   // Choose the maps to consume.
   const bool using_map_set_a = transfer_count_ % 2 == 0;
   auto& stack_traces = using_map_set_a ? stack_traces_a_ : stack_traces_b_;
@@ -263,7 +296,7 @@ void PerfProfileConnector::ProcessBPFStackTraces(ConnectorContext* ctx, DataTabl
   LOG_IF(ERROR, !s.ok()) << "Error writing transfer_count_";
 
   // Read BPF stack traces & histogram, build records, incorporate records to data table.
-  CreateRecords(stack_traces.get(), ctx, data_table);
+  CreateRecords(stack_traces.get(), ctx, data_tables);
 
   // Now that we've consumed the data, reset the sample count in BPF.
   profiler_state_->update_value(sample_count_idx, 0);
@@ -271,15 +304,9 @@ void PerfProfileConnector::ProcessBPFStackTraces(ConnectorContext* ctx, DataTabl
 
 void PerfProfileConnector::TransferDataImpl(ConnectorContext* ctx,
                                             const std::vector<DataTable*>& data_tables) {
-  DCHECK_EQ(data_tables.size(), 1);
-
-  auto* data_table = data_tables[0];
-
-  if (data_table == nullptr) {
-    return;
-  }
+  DCHECK_EQ(data_tables.size(), kTables.size());
 
-  ProcessBPFStackTraces(ctx, data_table);
+  ProcessBPFStackTraces(ctx, data_tables);
 
   // Cleanup the symbolizer so we don't leak memory.
   proc_tracker_.Update(ctx->GetUPIDs());
@@ -46,8 +46,12 @@ static constexpr std::string_view kNotSymbolizedMessage = "<not symbolized>";
 class PerfProfileConnector : public SourceConnector, public bpf_tools::BCCWrapper {
  public:
   static constexpr std::string_view kName = "perf_profiler";
-  static constexpr auto kTables = MakeArray(kStackTraceTable);
+  static constexpr auto kTables =
+      MakeArray(kStackTraceTable, kStackTraceV2Table, kStackTraceStringsTable);
   static constexpr uint32_t kPerfProfileTableNum = TableNum(kTables, kStackTraceTable);
+  static constexpr uint32_t kStackTraceV2TableNum = TableNum(kTables, kStackTraceV2Table);
+  static constexpr uint32_t kStackTraceStringsTableNum =
+      TableNum(kTables, kStackTraceStringsTable);
 
   // kBPFSamplingPeriod: the time interval in between stack trace samples.
   static constexpr auto kBPFSamplingPeriod = std::chrono::milliseconds{11};
@@ -75,11 +79,12 @@ class PerfProfileConnector : public SourceConnector, public bpf_tools::BCCWrappe
 
   explicit PerfProfileConnector(std::string_view source_name);
 
-  void ProcessBPFStackTraces(ConnectorContext* ctx, DataTable* data_table);
+  void ProcessBPFStackTraces(ConnectorContext* ctx, const std::vector<DataTable*>& data_tables);
 
-  // Read BPF data structures, build & incorporate records to the table.
+  // Read BPF data structures, build & incorporate records to the tables.
+  // The strings table may be null, if it is not subscribed to.
   void CreateRecords(ebpf::BPFStackTable* stack_traces, ConnectorContext* ctx,
-                     DataTable* data_table);
+                     const std::vector<DataTable*>& data_tables);
 
   StackTraceHisto AggregateStackTraces(ConnectorContext* ctx, ebpf::BPFStackTable* stack_traces);
 
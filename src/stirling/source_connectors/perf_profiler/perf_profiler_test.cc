@@ -56,7 +56,10 @@ class CPUPinnedBinaryRunner {
 
 class PerfProfileBPFTest : public ::testing::Test {
  public:
-  PerfProfileBPFTest() : data_table_(/*id*/ 0, kStackTraceTable) {}
+  PerfProfileBPFTest()
+      : legacy_table_(/*id*/ 0, kStackTraceTable),
+        data_table_(/*id*/ 1, kStackTraceV2Table),
+        strings_table_(/*id*/ 2, kStackTraceStringsTable) {}
 
  protected:
   void SetUp() override {
@@ -113,7 +116,9 @@ class PerfProfileBPFTest : public ::testing::Test {
     for (const auto row_idx : target_row_idxs) {
       // Build the histogram of observed stack traces here:
       // Also, track the cumulative sum (or total number of samples).
-      const std::string stack_trace_str = stack_traces_column_->Get<types::StringValue>(row_idx);
+      const int64_t stack_trace_id = trace_ids_column_->Get<types::Int64Value>(row_idx).val;
+      ASSERT_TRUE(stack_trace_strs_.contains(stack_trace_id));
+      const std::string& stack_trace_str = stack_trace_strs_[stack_trace_id];
       const int64_t count = counts_column_->Get<types::Int64Value>(row_idx).val;
       observed_stack_traces_[stack_trace_str] += count;
     }
@@ -190,7 +195,7 @@ class PerfProfileBPFTest : public ::testing::Test {
     };
 
     const std::vector<int> pids = GetSubProcessPids();
-    return FindRecordIdxMatchesPIDs(columns_, kStackTraceUPIDIdx, pids);
+    return FindRecordIdxMatchesPIDs(columns_, kStackTraceV2UPIDIdx, pids);
   }
 
   void ConsumeRecords() {
@@ -200,12 +205,31 @@ class PerfProfileBPFTest : public ::testing::Test {
     columns_ = tablets[0].records;
 
     PopulateColumnPtrs(columns_);
+
+    // Stack trace IDs are unique across processes, so the strings are simply keyed by ID.
+    for (const auto& tablet : strings_table_.ConsumeRecords()) {
+      const auto& ids = tablet.records[kStackTraceStringsStackTraceIDIdx];
+      const auto& strs = tablet.records[kStackTraceStringsStackTraceStrIdx];
+      for (size_t i = 0; i < ids->Size(); ++i) {
+        stack_trace_strs_[ids->Get<types::Int64Value>(i).val] = strs->Get<types::StringValue>(i);
+      }
+    }
+
+    // stack_traces.beta has the same records, with the strings inline.
+    const std::vector<TaggedRecordBatch> legacy_tablets = legacy_table_.ConsumeRecords();
+    ASSERT_EQ(legacy_tablets.size(), 1);
+    const auto& legacy_ids = legacy_tablets[0].records[kStackTraceStackTraceIDIdx];
+    const auto& legacy_strs = legacy_tablets[0].records[kStackTraceStackTraceStrIdx];
+    ASSERT_EQ(legacy_ids->Size(), trace_ids_column_->Size());
+    for (size_t i = 0; i < legacy_ids->Size(); ++i) {
+      EXPECT_EQ(stack_trace_strs_[legacy_ids->Get<types::Int64Value>(i).val],
+                legacy_strs->Get<types::StringValue>(i));
+    }
   }
 
   void PopulateColumnPtrs(const types::ColumnWrapperRecordBatch& columns) {
-    trace_ids_column_ = columns[kStackTraceStackTraceIDIdx];
-    stack_traces_column_ = columns[kStackTraceStackTraceStrIdx];
-    counts_column_ = columns[kStackTraceCountIdx];
+    trace_ids_column_ = columns[kStackTraceV2StackTraceIDIdx];
+    counts_column_ = columns[kStackTraceV2CountIdx];
     column_ptrs_populated_ = true;
   }
 
@@ -229,14 +253,18 @@ class PerfProfileBPFTest : public ::testing::Test {
 
   std::unique_ptr<SourceConnector> source_;
   std::unique_ptr<StandaloneContext> ctx_;
+  DataTable legacy_table_;
   DataTable data_table_;
-  const std::vector<DataTable*> data_tables_{&data_table_};
+  DataTable strings_table_;
+  const std::vector<DataTable*> data_tables_{&legacy_table_, &data_table_, &strings_table_};
 
   bool column_ptrs_populated_ = false;
   std::shared_ptr<types::ColumnWrapper> trace_ids_column_;
-  std::shared_ptr<types::ColumnWrapper> stack_traces_column_;
   std::shared_ptr<types::ColumnWrapper> counts_column_;
 
+  // Stack trace ID => folded stack trace string, from the stack trace strings table.
+  absl::flat_hash_map<int64_t, std::string> stack_trace_strs_;
+
   uint64_t cumulative_sum_ = 0;
   absl::flat_hash_map<std::string, uint64_t> observed_stack_traces_;
 
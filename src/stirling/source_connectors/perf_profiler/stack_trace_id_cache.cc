@@ -16,6 +16,7 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <chrono>
 #include <utility>
 
 #include "src/stirling/source_connectors/perf_profiler/stack_trace_id_cache.h"
@@ -23,14 +24,27 @@
 namespace px {
 namespace stirling {
 
-uint64_t StackTraceIDCache::Lookup(const SymbolicStackTrace& stack_trace) {
+StackTraceIDCache::StackTraceIDCache()
+    : StackTraceIDCache(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::system_clock::now().time_since_epoch())
+                            .count()) {}
+
+uint64_t StackTraceIDCache::Lookup(const SymbolicStackTrace& stack_trace,
+                                   bool* new_in_generation) {
   // Case 1: Stack trace ID is in the current set. Just return it.
   const auto it = stack_trace_ids_.find(stack_trace);
   if (it != stack_trace_ids_.end()) {
+    if (new_in_generation != nullptr) {
+      *new_in_generation = false;
+    }
     const uint64_t stack_trace_id = it->second;
     return stack_trace_id;
   }
 
+  if (new_in_generation != nullptr) {
+    *new_in_generation = true;
+  }
+
   // Case 2: Stack trace ID is in the previous set. Copy it to current set, and return it.
   const auto it2 = prev_stack_trace_ids_.find(stack_trace);
   if (it2 != prev_stack_trace_ids_.end()) {
@@ -31,7 +31,8 @@ namespace stirling {
 // We maintain these IDs for a number of reasons:
 //  1) The IDs enable more efficient aggregations across time samples in Carnot:
 //     aggregations with integers are more efficient than aggregations with strings.
-//  2) The IDs enable table normalization (future work).
+//  2) The IDs enable table normalization: stack_traces_v2.beta only references stack trace IDs,
+//     and the strings are recorded separately, when an ID is new to the current generation.
 //
 // As a cache, it should be noted that no guarantee is made that a stack trace from one time
 // period is assigned the same stack trace ID. Any consumer of the data can only assume that
@@ -46,7 +47,18 @@ namespace stirling {
 // the UI will aggregate the identical stack traces for us in the visualization.
 class StackTraceIDCache {
  public:
-  uint64_t Lookup(const SymbolicStackTrace& stack_trace);
+  // Assigns IDs starting after the current time in nanoseconds.
+  StackTraceIDCache();
+
+  // Assigns IDs starting at id_base + 1.
+  explicit StackTraceIDCache(uint64_t id_base) : next_stack_trace_id_(id_base) {}
+
+  /**
+   * Returns the ID of the stack trace, assigning a new one if needed.
+   * @param new_in_generation If not null, set to true if the stack trace had not yet been looked
+   *                          up since the last AgeTick().
+   */
+  uint64_t Lookup(const SymbolicStackTrace& stack_trace, bool* new_in_generation = nullptr);
   void AgeTick();
 
  private:
@@ -55,7 +67,9 @@ class StackTraceIDCache {
 
   // Tracks the next stack-trace-id to be assigned;
   // incremented by 1 for each such assignment.
-  uint64_t next_stack_trace_id_ = 0;
+  // Starts from the creation time, so that IDs are not reused after a restart of Stirling;
+  // consumers join stack_traces_v2.beta with the stack trace strings on the ID.
+  uint64_t next_stack_trace_id_;
 };
 
 }  // namespace stirling
@@ -18,6 +18,8 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+
 #include "src/stirling/source_connectors/perf_profiler/stack_trace_id_cache.h"
 
 namespace px {
@@ -51,5 +53,50 @@ TEST(StackTraceIDCache, Basic) {
   EXPECT_NE(stack_trace_ids.Lookup(kStackTrace2), id2);
 }
 
+TEST(StackTraceIDCache, NewInGeneration) {
+  StackTraceIDCache stack_trace_ids;
+
+  const md::UPID kUPID(1, 1, 1);
+  const SymbolicStackTrace kStackTrace1{kUPID, "a();b();c();"};
+
+  bool new_in_generation = false;
+
+  uint64_t id1 = stack_trace_ids.Lookup(kStackTrace1, &new_in_generation);
+  EXPECT_TRUE(new_in_generation);
+  EXPECT_EQ(stack_trace_ids.Lookup(kStackTrace1, &new_in_generation), id1);
+  EXPECT_FALSE(new_in_generation);
+
+  // The ID is kept across one generation, but is new to the generation, so that consumers of the
+  // ID are told about it again.
+  stack_trace_ids.AgeTick();
+  EXPECT_EQ(stack_trace_ids.Lookup(kStackTrace1, &new_in_generation), id1);
+  EXPECT_TRUE(new_in_generation);
+  EXPECT_EQ(stack_trace_ids.Lookup(kStackTrace1, &new_in_generation), id1);
+  EXPECT_FALSE(new_in_generation);
+}
+
+TEST(StackTraceIDCache, IDsStartAfterBase) {
+  const md::UPID kUPID(1, 1, 1);
+  const SymbolicStackTrace kStackTrace1{kUPID, "a();b();c();"};
+  const SymbolicStackTrace kStackTrace2{kUPID, "d();e();f();"};
+
+  StackTraceIDCache stack_trace_ids(/*id_base*/ 41);
+  EXPECT_EQ(stack_trace_ids.Lookup(kStackTrace1), 42U);
+  EXPECT_EQ(stack_trace_ids.Lookup(kStackTrace2), 43U);
+}
+
+TEST(StackTraceIDCache, IDsStartAfterCreationTime) {
+  const md::UPID kUPID(1, 1, 1);
+  const SymbolicStackTrace kStackTrace1{kUPID, "a();b();c();"};
+
+  // IDs are assigned far slower than one per nanosecond, so starting after the creation time
+  // keeps a restarted Stirling from reusing the IDs of the previous instance.
+  const uint64_t before = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::system_clock::now().time_since_epoch())
+                              .count();
+  StackTraceIDCache stack_trace_ids;
+  EXPECT_GT(stack_trace_ids.Lookup(kStackTrace1), before);
+}
+
 }  // namespace stirling
 }  // namespace px
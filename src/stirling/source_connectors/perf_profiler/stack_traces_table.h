@@ -47,11 +47,55 @@ static constexpr DataElement kElements[] = {
 constexpr auto kStackTraceTable = DataTableSchema(
         "stack_traces.beta",
         "Sampled stack traces of applications that identify hot-spots in application code. "
-        "Executable symbols are required for human-readable function names to be displayed.",
+        "Executable symbols are required for human-readable function names to be displayed. "
+        "Superseded by stack_traces_v2.beta, which doesn't repeat the stack trace strings.",
         kElements
 );
+
+static constexpr DataElement kV2Elements[] = {
+    canonical_data_elements::kTime,
+    canonical_data_elements::kUPID,
+    {"stack_trace_id",
+     "A unique identifier of the stack trace, for script-writing convenience. "
+     "String representation is in the `stack_trace` column of the stack_trace_strings.beta table.",
+     types::DataType::INT64, types::SemanticType::ST_NONE, types::PatternType::GENERAL},
+    {"count",
+     "Number of times the stack trace has been sampled.",
+     types::DataType::INT64, types::SemanticType::ST_NONE, types::PatternType::METRIC_GAUGE}
+};
+
+constexpr auto kStackTraceV2Table = DataTableSchema(
+        "stack_traces_v2.beta",
+        "Sampled stack traces of applications that identify hot-spots in application code. "
+        "Executable symbols are required for human-readable function names to be displayed. "
+        "Join with stack_trace_strings.beta on upid and stack_trace_id for the stack traces.",
+        kV2Elements
+);
+
+static constexpr DataElement kStringElements[] = {
+    canonical_data_elements::kTime,
+    canonical_data_elements::kUPID,
+    {"stack_trace_id",
+     "A unique identifier of the stack trace, referenced by the stack_traces_v2.beta table.",
+     types::DataType::INT64, types::SemanticType::ST_NONE, types::PatternType::GENERAL},
+    {"stack_trace",
+     "A stack trace within the sampled process, in folded format. "
+     "The call stack symbols are separated by semicolons. "
+     "If symbols cannot be resolved, addresses are populated instead.",
+     types::DataType::STRING, types::SemanticType::ST_NONE, types::PatternType::GENERAL},
+};
+
+constexpr auto kStackTraceStringsTable = DataTableSchema(
+        "stack_trace_strings.beta",
+        "The stack traces referenced by stack_traces_v2.beta. A stack trace is recorded when its "
+        "ID is assigned, and again every few minutes while it is still being sampled, rather than "
+        "with every sample.",
+        kStringElements
+);
 // clang-format on
 DEFINE_PRINT_TABLE(StackTrace)
+DEFINE_PRINT_TABLE(StackTraceV2)
+DEFINE_PRINT_TABLE(StackTraceStrings)
 
 constexpr int kStackTraceTimeIdx = kStackTraceTable.ColIndex("time_");
 constexpr int kStackTraceUPIDIdx = kStackTraceTable.ColIndex("upid");
@@ -59,5 +103,14 @@ constexpr int kStackTraceStackTraceIDIdx = kStackTraceTable.ColIndex("stack_trac
 constexpr int kStackTraceStackTraceStrIdx = kStackTraceTable.ColIndex("stack_trace");
 constexpr int kStackTraceCountIdx = kStackTraceTable.ColIndex("count");
 
+constexpr int kStackTraceV2UPIDIdx = kStackTraceV2Table.ColIndex("upid");
+constexpr int kStackTraceV2StackTraceIDIdx = kStackTraceV2Table.ColIndex("stack_trace_id");
+constexpr int kStackTraceV2CountIdx = kStackTraceV2Table.ColIndex("count");
+
+constexpr int kStackTraceStringsUPIDIdx = kStackTraceStringsTable.ColIndex("upid");
+constexpr int kStackTraceStringsStackTraceIDIdx =
+    kStackTraceStringsTable.ColIndex("stack_trace_id");
+constexpr int kStackTraceStringsStackTraceStrIdx = kStackTraceStringsTable.ColIndex("stack_trace");
+
 }  // namespace stirling
 }  // namespace px
@@ -16,6 +16,8 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <memory>
+#include <string>
 #include <utility>
 
 #include "src/stirling/bpf_tools/bcc_symbolizer.h"
@@ -60,9 +62,25 @@ StatusOr<std::unique_ptr<Symbolizer>> ElfSymbolizer::Create() {
   return symbolizer;
 }
 
-void ElfSymbolizer::DeleteUPID(const struct upid_t& upid) { symbolizers_.erase(upid); }
+void ElfSymbolizer::DeleteUPID(const struct upid_t& upid) {
+  auto iter = symbolizers_.find(upid);
+  if (iter == symbolizers_.end()) {
+    return;
+  }
+  symbolizers_.erase(iter);
+
+  // Drop the entries of binaries that are no longer used by any UPID.
+  for (auto it = binary_symbolizers_.begin(); it != binary_symbolizers_.end();) {
+    if (it->second.expired()) {
+      binary_symbolizers_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+}
 
-StatusOr<std::unique_ptr<ElfReader::Symbolizer>> CreateUPIDSymbolizer(const struct upid_t& upid) {
+StatusOr<std::shared_ptr<ElfReader::Symbolizer>> ElfSymbolizer::GetOrCreateBinarySymbolizer(
+    const struct upid_t& upid) {
   PL_ASSIGN_OR_RETURN(std::unique_ptr<FilePathResolver> fp_resolver,
                       FilePathResolver::Create(upid.pid));
   // TODO(yzhao): Might need to check the start time.
@@ -71,9 +89,19 @@ StatusOr<std::unique_ptr<ElfReader::Symbolizer>> CreateUPIDSymbolizer(const stru
   PL_ASSIGN_OR_RETURN(std::filesystem::path host_proc_exe, fp_resolver->ResolvePath(proc_exe));
   host_proc_exe = system::Config::GetInstance().ToHostPath(host_proc_exe);
   PL_ASSIGN_OR_RETURN(std::unique_ptr<ElfReader> elf_reader, ElfReader::Create(host_proc_exe));
-  PL_ASSIGN_OR_RETURN(std::unique_ptr<ElfReader::Symbolizer> upid_symbolizer,
-                      elf_reader->GetSymbolizer());
-  return upid_symbolizer;
+
+  // The symbol index holds addresses as they appear in the binary, so it can be shared by all
+  // processes running the same binary. The build ID identifies a binary across the different
+  // paths it has in different containers.
+  const std::string binary_key = elf_reader->BuildID().ValueOr(host_proc_exe.string());
+
+  std::weak_ptr<ElfReader::Symbolizer>& entry = binary_symbolizers_[binary_key];
+  std::shared_ptr<ElfReader::Symbolizer> binary_symbolizer = entry.lock();
+  if (binary_symbolizer == nullptr) {
+    PL_ASSIGN_OR_RETURN(binary_symbolizer, elf_reader->GetSymbolizer());
+    entry = binary_symbolizer;
+  }
+  return binary_symbolizer;
 }
 
 std::string_view EmptySymbolizerFn(const uintptr_t addr) {
@@ -90,10 +118,10 @@ SymbolizerFn ElfSymbolizer::GetSymbolizerFn(const struct upid_t& upid) {
     return SymbolizerFn(&(BogusKernelSymbolizerFn));
   }
 
-  std::unique_ptr<ElfReader::Symbolizer>& upid_symbolizer = symbolizers_[upid];
+  std::shared_ptr<ElfReader::Symbolizer>& upid_symbolizer = symbolizers_[upid];
   if (upid_symbolizer == nullptr) {
-    StatusOr<std::unique_ptr<ElfReader::Symbolizer>> upid_symbolizer_status =
-        CreateUPIDSymbolizer(upid);
+    StatusOr<std::shared_ptr<ElfReader::Symbolizer>> upid_symbolizer_status =
+        GetOrCreateBinarySymbolizer(upid);
     if (!upid_symbolizer_status.ok()) {
       VLOG(1) << absl::Substitute("Failed to create Symbolizer function for $0 [error=$1]",
                                   upid.pid, upid_symbolizer_status.ToString());
@@ -81,6 +81,7 @@ class BCCSymbolizer : public Symbolizer, public NotCopyMoveable {
 
 /**
  * A Symbolizer using the ElfReader symbolization core.
+ * The symbol index of a binary is built once and shared by all UPIDs running that binary.
  */
 class ElfSymbolizer : public Symbolizer, public NotCopyMoveable {
  public:
@@ -89,13 +90,23 @@ class ElfSymbolizer : public Symbolizer, public NotCopyMoveable {
   SymbolizerFn GetSymbolizerFn(const struct upid_t& upid) override;
   void DeleteUPID(const struct upid_t& upid) override;
 
+  size_t num_upids() const { return symbolizers_.size(); }
+  size_t num_binaries() const { return binary_symbolizers_.size(); }
+
  private:
+  using BinarySymbolizer = px::stirling::obj_tools::ElfReader::Symbolizer;
+
   ElfSymbolizer() = default;
 
-  // A symbolizer per UPID.
-  absl::flat_hash_map<struct upid_t,
-                      std::unique_ptr<px::stirling::obj_tools::ElfReader::Symbolizer>>
-      symbolizers_;
+  StatusOr<std::shared_ptr<BinarySymbolizer>> GetOrCreateBinarySymbolizer(
+      const struct upid_t& upid);
+
+  // The symbolizer used by each UPID. UPIDs running the same binary share one symbolizer.
+  absl::flat_hash_map<struct upid_t, std::shared_ptr<BinarySymbolizer>> symbolizers_;
+
+  // Symbolizers keyed by binary (build ID, or host path if the binary has no build ID).
+  // Entries are owned by the UPIDs above, so a symbol index is freed with its last UPID.
+  absl::flat_hash_map<std::string, std::weak_ptr<BinarySymbolizer>> binary_symbolizers_;
 };
 
 /**
@@ -65,6 +65,30 @@ TYPED_TEST(SymbolizerTest, UserSymbols) {
   EXPECT_EQ(symbolize(2), std::string("0x0000000000000002"));
 }
 
+TEST_F(ElfSymbolizerTest, SharedAcrossUPIDs) {
+  ElfSymbolizer& symbolizer = *static_cast<ElfSymbolizer*>(symbolizer_.get());
+
+  // Two UPIDs that run the same binary.
+  const struct upid_t upid1 = {.pid = static_cast<uint32_t>(getpid()), .start_time_ticks = 1};
+  const struct upid_t upid2 = {.pid = static_cast<uint32_t>(getpid()), .start_time_ticks = 2};
+
+  auto symbolize1 = symbolizer.GetSymbolizerFn(upid1);
+  auto symbolize2 = symbolizer.GetSymbolizerFn(upid2);
+  EXPECT_EQ(symbolize1(kFooAddr), "test::foo()");
+  EXPECT_EQ(symbolize2(kFooAddr), "test::foo()");
+  EXPECT_EQ(symbolizer.num_upids(), 2);
+  EXPECT_EQ(symbolizer.num_binaries(), 1);
+
+  // The shared index outlives the first UPID, and is released with the last one.
+  symbolizer.DeleteUPID(upid1);
+  EXPECT_EQ(symbolizer.num_binaries(), 1);
+  EXPECT_EQ(symbolize2(kBarAddr), "test::bar()");
+
+  symbolizer.DeleteUPID(upid2);
+  EXPECT_EQ(symbolizer.num_upids(), 0);
+  EXPECT_EQ(symbolizer.num_binaries(), 0);
+}
+
 TEST_F(BCCSymbolizerTest, KernelSymbols) {
   ASSERT_OK_AND_ASSIGN(std::unique_ptr<Symbolizer> symbolizer, BCCSymbolizer::Create());
 
@@ -109,6 +109,10 @@ BPF_PERCPU_ARRAY(conn_stats_event_buffer_heap, struct conn_stats_event_t, 1);
 // number of arrays with only 1 element.
 BPF_PERCPU_ARRAY(control_values, int64_t, kNumControlValues);
 
+// In-kernel data filters, maintained by user space. See trace_filter_config_t for details.
+BPF_ARRAY(trace_filter_config, struct trace_filter_config_t, 1);
+BPF_ARRAY(protocol_filter_map, struct protocol_filter_t, kNumProtocols);
+
 /***********************************************************
  * General helper functions
  ***********************************************************/
@@ -219,6 +223,126 @@ static __inline bool should_trace_protocol_data(const struct conn_info_t* conn_i
   return control & conn_info->role;
 }
 
+static __inline const struct protocol_filter_t* get_protocol_filter(
+    const struct conn_info_t* conn_info) {
+  uint32_t protocol = conn_info->protocol;
+  return protocol_filter_map.lookup(&protocol);
+}
+
+static __inline bool is_conn_sampled_out(const struct conn_info_t* conn_info) {
+  const struct protocol_filter_t* filter = get_protocol_filter(conn_info);
+  if (filter == NULL || filter->sampling_denominator <= 1) {
+    return false;
+  }
+  return conn_info->conn_id.tsid % filter->sampling_denominator != 0;
+}
+
+// Only the remote endpoint of a connection is known, so the port filter matches the port of the
+// peer. This excludes connections made by a traced client to a server on an excluded port, but not
+// connections accepted by a traced server on that port, whose remote port is ephemeral.
+static __inline bool is_remote_endpoint_excluded(const struct conn_info_t* conn_info) {
+  int kZero = 0;
+  const struct trace_filter_config_t* config = trace_filter_config.lookup(&kZero);
+  if (config == NULL) {
+    return false;
+  }
+
+  sa_family_t family = conn_info->addr.sa.sa_family;
+  if (family != AF_INET && family != AF_INET6) {
+    return false;
+  }
+
+  // sin_port and sin6_port share the same offset.
+  uint16_t port = conn_info->addr.in4.sin_port;
+#pragma unroll
+  for (int i = 0; i < MAX_PORT_FILTERS; ++i) {
+    if (config->excluded_ports[i] != 0 && config->excluded_ports[i] == port) {
+      return true;
+    }
+  }
+
+  if (family == AF_INET) {
+    uint32_t addr = conn_info->addr.in4.sin_addr.s_addr;
+#pragma unroll
+    for (int i = 0; i < MAX_CIDR_FILTERS; ++i) {
+      const struct ipv4_cidr_filter_t* cidr = &config->excluded_cidrs[i];
+      if (cidr->mask != 0 && (addr & cidr->mask) == cidr->addr) {
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+// Returns true if the path of the HTTP GET request in buf starts with one of the denied prefixes.
+// Only GET requests are considered, since that covers health checks and metrics scrapes,
+// and the fixed offset of the path keeps the check cheap.
+static __inline bool is_http_path_denied(const struct trace_filter_config_t* config,
+                                         const char* buf, size_t count) {
+  // Length of "GET ".
+  const size_t kPathOffset = 4;
+
+  char path[MAX_HTTP_PATH_FILTER_LEN] = {};
+  bpf_probe_read(&path, MAX_HTTP_PATH_FILTER_LEN, buf + kPathOffset);
+
+#pragma unroll
+  for (int f = 0; f < MAX_HTTP_PATH_FILTERS; ++f) {
+    const struct http_path_filter_t* filter = &config->http_path_deny_list[f];
+    if (filter->len == 0 || filter->len > MAX_HTTP_PATH_FILTER_LEN ||
+        kPathOffset + filter->len > count) {
+      continue;
+    }
+
+    bool match = true;
+#pragma unroll
+    for (int i = 0; i < MAX_HTTP_PATH_FILTER_LEN; ++i) {
+      if (i < filter->len && path[i] != filter->prefix[i]) {
+        match = false;
+      }
+    }
+    if (match) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Applies the HTTP path deny list to the data in buf. When a request is denied,
+// everything up to the next request on the connection is dropped too, which covers the rest of
+// the request and its response. Returns true if the data should be dropped.
+static __inline bool filter_http_data(struct conn_info_t* conn_info, const char* buf,
+                                      size_t count) {
+  if (conn_info->protocol != kProtocolHTTP) {
+    return false;
+  }
+
+  if (infer_http_message(buf, count) != kRequest) {
+    return conn_info->http_exchange_filtered;
+  }
+
+  int kZero = 0;
+  const struct trace_filter_config_t* config = trace_filter_config.lookup(&kZero);
+  if (config == NULL) {
+    conn_info->http_exchange_filtered = false;
+    return false;
+  }
+
+  conn_info->http_exchange_filtered =
+      buf[0] == 'G' && buf[1] == 'E' && buf[2] == 'T' && buf[3] == ' ' &&
+      is_http_path_denied(config, buf, count);
+  return conn_info->http_exchange_filtered;
+}
+
+// Caps the number of bytes of a single syscall that are submitted to user space.
+static __inline size_t capped_msg_size(const struct conn_info_t* conn_info, size_t count) {
+  const struct protocol_filter_t* filter = get_protocol_filter(conn_info);
+  if (filter == NULL || filter->max_msg_bytes == 0 || count <= filter->max_msg_bytes) {
+    return count;
+  }
+  return filter->max_msg_bytes;
+}
+
 static __inline bool is_stirling_tgid(const uint32_t tgid) {
   int idx = kStirlingTGIDIndex;
   int64_t* stirling_tgid = control_values.lookup(&idx);
@@ -644,8 +768,18 @@ static __inline bool should_send_data(uint32_t tgid, uint64_t conn_disabled_tsid
     return false;
   }
 
-  // Only trace data for protocols of interest, or if forced on.
-  return (force_trace_tgid || should_trace_protocol_data(conn_info));
+  // Forced tracing bypasses all other filters.
+  if (force_trace_tgid) {
+    return true;
+  }
+
+  // Only trace data for protocols of interest.
+  if (!should_trace_protocol_data(conn_info)) {
+    return false;
+  }
+
+  // Apply the filters configured by user space.
+  return !is_remote_endpoint_excluded(conn_info) && !is_conn_sampled_out(conn_info);
 }
 
 static __inline void update_conn_stats(struct pt_regs* ctx, struct conn_info_t* conn_info,
@@ -721,14 +855,17 @@ static __inline void process_data(const bool vecs, struct pt_regs* ctx, uint64_t
     // TODO(yzhao): Split the interface such that the singular buf case and multiple bufs in msghdr
     // are handled separately without mixed interface. The plan is to factor out helper functions
     // for lower-level functionalities, and call them separately for each case.
+    bool filtered = false;
     if (!vecs) {
       update_traffic_class(conn_info, direction, args->buf, bytes_count);
+      filtered = filter_http_data(conn_info, args->buf, bytes_count);
     } else {
       struct iovec iov_cpy;
       bpf_probe_read(&iov_cpy, sizeof(struct iovec), &args->iov[0]);
       // Ensure we are not reading beyond the available data.
       const size_t buf_size = iov_cpy.iov_len < bytes_count ? iov_cpy.iov_len : bytes_count;
       update_traffic_class(conn_info, direction, iov_cpy.iov_base, buf_size);
+      filtered = filter_http_data(conn_info, iov_cpy.iov_base, buf_size);
     }
 
     if (should_send_data(tgid, conn_disabled_tsid, force_trace_tgid, conn_info)) {
@@ -739,14 +876,37 @@ static __inline void process_data(const bool vecs, struct pt_regs* ctx, uint64_t
         return;
       }
 
-      // TODO(yzhao): Same TODO for split the interface.
-      if (!vecs) {
-        perf_submit_wrapper(ctx, direction, args->buf, bytes_count, conn_info, event);
+      // Filtered data is reported in a data-less event, like sendfile data, so that the
+      // position of the data stream stays contiguous.
+      if (filtered && !force_trace_tgid) {
+        event->attr.prepend_length_header = false;
+        event->attr.msg_size = bytes_count;
+        event->attr.msg_buf_size = 0;
+        socket_data_events.perf_submit(ctx, event, sizeof(event->attr));
       } else {
-        // TODO(yzhao): iov[0] is copied twice, once in calling update_traffic_class(), and here.
-        // This happens to the write probes as well, but the calls are placed in the entry and
-        // return probes respectively. Consider remove one copy.
-        perf_submit_iovecs(ctx, direction, args->iov, args->iovlen, bytes_count, conn_info, event);
+        const uint64_t pos = event->attr.pos;
+        const size_t submit_count = capped_msg_size(conn_info, bytes_count);
+
+        // TODO(yzhao): Same TODO for split the interface.
+        if (!vecs) {
+          perf_submit_wrapper(ctx, direction, args->buf, submit_count, conn_info, event);
+        } else {
+          // TODO(yzhao): iov[0] is copied twice, once in calling update_traffic_class(), and here.
+          // This happens to the write probes as well, but the calls are placed in the entry and
+          // return probes respectively. Consider remove one copy.
+          perf_submit_iovecs(ctx, direction, args->iov, args->iovlen, submit_count, conn_info,
+                             event);
+        }
+
+        // The bytes beyond the cap are reported in a data-less event, like sendfile data,
+        // so that user space fills them in rather than seeing a gap in the data stream.
+        if (submit_count < bytes_count) {
+          event->attr.pos = pos + submit_count;
+          event->attr.prepend_length_header = false;
+          event->attr.msg_size = bytes_count - submit_count;
+          event->attr.msg_buf_size = 0;
+          socket_data_events.perf_submit(ctx, event, sizeof(event->attr));
+        }
       }
     }
   }
@@ -28,6 +28,8 @@
 
 const char kControlMapName[] = "control_map";
 const char kControlValuesArrayName[] = "control_values";
+const char kTraceFilterConfigArrayName[] = "trace_filter_config";
+const char kProtocolFilterArrayName[] = "protocol_filter_map";
 
 const int64_t kTraceAllTGIDs = -1;
 
@@ -85,6 +87,10 @@ struct conn_info_t {
   size_t prev_count;
   char prev_buf[4];
   bool prepend_length_header;
+
+  // Set when an HTTP request was dropped by the in-kernel path filter.
+  // All data up to the next HTTP request (the rest of the request and its response) is dropped too.
+  bool http_exchange_filtered;
 };
 
 // This struct is a subset of conn_info_t. It is used to communicate connect/accept events.
@@ -206,6 +212,54 @@ struct socket_data_event_t {
   char msg[MAX_MSG_SIZE];
 };
 
+// In-kernel filters applied to the data of socket_data_events, before it is copied to user space.
+// The filters are maintained from user space, through the trace_filter_config and
+// protocol_filter_map arrays. A zeroed entry disables the corresponding filter.
+//
+// The sizes are kept small, because every entry is checked with an unrolled loop.
+#define MAX_PORT_FILTERS 8
+#define MAX_CIDR_FILTERS 8
+#define MAX_HTTP_PATH_FILTERS 4
+#define MAX_HTTP_PATH_FILTER_LEN 32
+
+struct ipv4_cidr_filter_t {
+  // Both in network byte order. A mask of 0 marks an unused entry.
+  uint32_t addr;
+  uint32_t mask;
+};
+
+struct http_path_filter_t {
+  // Number of valid bytes in prefix. A length of 0 marks an unused entry.
+  uint32_t len;
+  char prefix[MAX_HTTP_PATH_FILTER_LEN];
+};
+
+// Filters that apply to all protocols. There is a single element of this type.
+struct trace_filter_config_t {
+  // Remote ports (in network byte order) whose connections are not traced. 0 marks an unused entry.
+  // The local port is not matched, so this only filters on the client side of a connection.
+  uint16_t excluded_ports[MAX_PORT_FILTERS];
+
+  // Remote IPv4 address blocks whose connections are not traced.
+  struct ipv4_cidr_filter_t excluded_cidrs[MAX_CIDR_FILTERS];
+
+  // HTTP GET requests whose path starts with one of these prefixes are dropped,
+  // along with their responses.
+  struct http_path_filter_t http_path_deny_list[MAX_HTTP_PATH_FILTERS];
+};
+
+// Filters that apply per protocol. There is one element for each traffic_protocol_t.
+struct protocol_filter_t {
+  // The data of 1 in sampling_denominator connections is traced. 0 or 1 traces all connections.
+  // The choice is a function of the connection's tsid, so it is stable for a connection.
+  uint32_t sampling_denominator;
+
+  // The maximum bytes of a single syscall's data that are submitted to user space.
+  // The remainder is reported without its data, and filled in by user space. 0 means no limit
+  // beyond CHUNK_LIMIT * MAX_MSG_SIZE.
+  uint32_t max_msg_bytes;
+};
+
 #define CONN_OPEN (1 << 0)
 #define CONN_CLOSE (1 << 1)
 
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/stirling/source_connectors/socket_tracer/bpf_trace_filter.h"
+
+#include <arpa/inet.h>
+
+#include <cstring>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <absl/strings/match.h>
+#include <absl/strings/str_split.h>
+#include <absl/strings/strip.h>
+#include <magic_enum.hpp>
+
+#include "src/common/base/inet_utils.h"
+
+namespace px {
+namespace stirling {
+
+namespace {
+
+std::vector<std::string_view> SplitList(std::string_view list) {
+  return absl::StrSplit(list, ",", absl::SkipWhitespace());
+}
+
+Status ParseExcludedPorts(std::string_view list, trace_filter_config_t* config) {
+  std::vector<std::string_view> ports = SplitList(list);
+  if (ports.size() > MAX_PORT_FILTERS) {
+    return error::InvalidArgument("Too many excluded ports: $0 (max $1)", ports.size(),
+                                  MAX_PORT_FILTERS);
+  }
+  for (size_t i = 0; i < ports.size(); ++i) {
+    uint32_t port;
+    if (!absl::SimpleAtoi(ports[i], &port) || port == 0 || port > UINT16_MAX) {
+      return error::InvalidArgument("Invalid port: $0", ports[i]);
+    }
+    config->excluded_ports[i] = htons(static_cast<uint16_t>(port));
+  }
+  return Status::OK();
+}
+
+Status ParseExcludedCIDRs(std::string_view list, trace_filter_config_t* config) {
+  std::vector<std::string_view> cidrs = SplitList(list);
+  if (cidrs.size() > MAX_CIDR_FILTERS) {
+    return error::InvalidArgument("Too many excluded CIDR blocks: $0 (max $1)", cidrs.size(),
+                                  MAX_CIDR_FILTERS);
+  }
+  for (size_t i = 0; i < cidrs.size(); ++i) {
+    CIDRBlock block;
+    PL_RETURN_IF_ERROR(ParseCIDRBlock(absl::StripAsciiWhitespace(cidrs[i]), &block));
+    if (block.ip_addr.family != InetAddrFamily::kIPv4) {
+      return error::InvalidArgument("Only IPv4 CIDR blocks can be excluded in BPF: $0", cidrs[i]);
+    }
+    // A /0 block would exclude all traffic, and collides with the encoding of unused entries.
+    if (block.prefix_length == 0) {
+      return error::InvalidArgument("Invalid prefix length for an excluded CIDR block: $0",
+                                    cidrs[i]);
+    }
+    const uint32_t mask = htonl(~uint32_t{0} << (32 - block.prefix_length));
+    config->excluded_cidrs[i].mask = mask;
+    config->excluded_cidrs[i].addr = std::get<struct in_addr>(block.ip_addr.addr).s_addr & mask;
+  }
+  return Status::OK();
+}
+
+Status ParseHTTPPathDenyList(std::string_view list, trace_filter_config_t* config) {
+  std::vector<std::string_view> prefixes = SplitList(list);
+  if (prefixes.size() > MAX_HTTP_PATH_FILTERS) {
+    return error::InvalidArgument("Too many denied HTTP path prefixes: $0 (max $1)",
+                                  prefixes.size(), MAX_HTTP_PATH_FILTERS);
+  }
+  for (size_t i = 0; i < prefixes.size(); ++i) {
+    std::string_view prefix = absl::StripAsciiWhitespace(prefixes[i]);
+    if (prefix.size() > MAX_HTTP_PATH_FILTER_LEN) {
+      return error::InvalidArgument("HTTP path prefix is longer than $0 bytes: $1",
+                                    MAX_HTTP_PATH_FILTER_LEN, prefix);
+    }
+    config->http_path_deny_list[i].len = prefix.size();
+    std::memcpy(config->http_path_deny_list[i].prefix, prefix.data(), prefix.size());
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
+StatusOr<trace_filter_config_t> BuildTraceFilterConfig(std::string_view excluded_ports,
+                                                       std::string_view excluded_cidrs,
+                                                       std::string_view http_path_deny_prefixes) {
+  trace_filter_config_t config = {};
+  PL_RETURN_IF_ERROR(ParseExcludedPorts(excluded_ports, &config));
+  PL_RETURN_IF_ERROR(ParseExcludedCIDRs(excluded_cidrs, &config));
+  PL_RETURN_IF_ERROR(ParseHTTPPathDenyList(http_path_deny_prefixes, &config));
+  return config;
+}
+
+StatusOr<absl::flat_hash_map<traffic_protocol_t, uint32_t>> ParseProtocolValues(
+    std::string_view spec) {
+  constexpr std::string_view kProtocolPrefix = "kProtocol";
+
+  absl::flat_hash_map<traffic_protocol_t, uint32_t> result;
+  for (std::string_view entry : SplitList(spec)) {
+    std::pair<std::string_view, std::string_view> name_value =
+        absl::StrSplit(absl::StripAsciiWhitespace(entry), absl::MaxSplits(":", 1));
+
+    uint32_t value;
+    if (!absl::SimpleAtoi(name_value.second, &value)) {
+      return error::InvalidArgument("Invalid value in per-protocol setting: $0", entry);
+    }
+
+    bool found = false;
+    for (auto protocol : magic_enum::enum_values<traffic_protocol_t>()) {
+      std::string_view name = magic_enum::enum_name(protocol);
+      name.remove_prefix(kProtocolPrefix.size());
+      if (protocol != kProtocolUnknown && absl::EqualsIgnoreCase(name, name_value.first)) {
+        result[protocol] = value;
+        found = true;
+        break;
+      }
+    }
+    if (!found) {
+      return error::InvalidArgument("Unknown protocol in per-protocol setting: $0", entry);
+    }
+  }
+  return result;
+}
+
+}  // namespace stirling
+}  // namespace px
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <string_view>
+
+#include <absl/container/flat_hash_map.h>
+
+#include "src/common/base/base.h"
+#include "src/stirling/source_connectors/socket_tracer/bcc_bpf_intf/socket_trace.hpp"
+
+namespace px {
+namespace stirling {
+
+/**
+ * Builds the configuration of the in-kernel trace filters (see trace_filter_config_t).
+ *
+ * @param excluded_ports Comma-separated remote ports, e.g. "9090,10250". The local port is not
+ *                       matched, so only the client side of a connection is filtered.
+ * @param excluded_cidrs Comma-separated remote IPv4 CIDR blocks, e.g. "10.0.0.0/8".
+ * @param http_path_deny_prefixes Comma-separated HTTP path prefixes, e.g. "/healthz,/metrics".
+ * @return Error if any list is malformed or has more entries than the BPF side supports.
+ */
+StatusOr<trace_filter_config_t> BuildTraceFilterConfig(std::string_view excluded_ports,
+                                                       std::string_view excluded_cidrs,
+                                                       std::string_view http_path_deny_prefixes);
+
+/**
+ * Parses per-protocol values of the form "<protocol>:<value>,...", e.g. "http:10,mysql:2".
+ * Protocol names are the traffic_protocol_t names without the kProtocol prefix,
+ * and are matched case-insensitively.
+ */
+StatusOr<absl::flat_hash_map<traffic_protocol_t, uint32_t>> ParseProtocolValues(
+    std::string_view spec);
+
+}  // namespace stirling
+}  // namespace px
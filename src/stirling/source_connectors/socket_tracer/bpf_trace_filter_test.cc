@@ -0,0 +1,93 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <arpa/inet.h>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "src/common/testing/testing.h"
+#include "src/stirling/source_connectors/socket_tracer/bpf_trace_filter.h"
+
+namespace px {
+namespace stirling {
+
+using ::testing::Pair;
+using ::testing::UnorderedElementsAre;
+
+TEST(BuildTraceFilterConfigTest, EmptyListsDisableAllFilters) {
+  ASSERT_OK_AND_ASSIGN(trace_filter_config_t config, BuildTraceFilterConfig("", "", ""));
+  for (int i = 0; i < MAX_PORT_FILTERS; ++i) {
+    EXPECT_EQ(config.excluded_ports[i], 0);
+  }
+  for (int i = 0; i < MAX_CIDR_FILTERS; ++i) {
+    EXPECT_EQ(config.excluded_cidrs[i].mask, 0);
+  }
+  for (int i = 0; i < MAX_HTTP_PATH_FILTERS; ++i) {
+    EXPECT_EQ(config.http_path_deny_list[i].len, 0);
+  }
+}
+
+TEST(BuildTraceFilterConfigTest, Basic) {
+  ASSERT_OK_AND_ASSIGN(
+      trace_filter_config_t config,
+      BuildTraceFilterConfig("9090, 10250", "10.1.2.3/16", "/healthz,/metrics"));
+
+  EXPECT_EQ(config.excluded_ports[0], htons(9090));
+  EXPECT_EQ(config.excluded_ports[1], htons(10250));
+  EXPECT_EQ(config.excluded_ports[2], 0);
+
+  // The address is masked, so that BPF can compare it directly.
+  EXPECT_EQ(config.excluded_cidrs[0].addr, htonl(0x0a010000));
+  EXPECT_EQ(config.excluded_cidrs[0].mask, htonl(0xffff0000));
+  EXPECT_EQ(config.excluded_cidrs[1].mask, 0);
+
+  EXPECT_EQ(config.http_path_deny_list[0].len, 8);
+  EXPECT_EQ(std::string_view(config.http_path_deny_list[0].prefix, 8), "/healthz");
+  EXPECT_EQ(config.http_path_deny_list[1].len, 8);
+  EXPECT_EQ(std::string_view(config.http_path_deny_list[1].prefix, 8), "/metrics");
+  EXPECT_EQ(config.http_path_deny_list[2].len, 0);
+}
+
+TEST(BuildTraceFilterConfigTest, InvalidInputs) {
+  EXPECT_NOT_OK(BuildTraceFilterConfig("not_a_port", "", ""));
+  EXPECT_NOT_OK(BuildTraceFilterConfig("70000", "", ""));
+  EXPECT_NOT_OK(BuildTraceFilterConfig("1,2,3,4,5,6,7,8,9", "", ""));
+  EXPECT_NOT_OK(BuildTraceFilterConfig("", "0.0.0.0/0", ""));
+  EXPECT_NOT_OK(BuildTraceFilterConfig("", "::1/128", ""));
+  EXPECT_NOT_OK(BuildTraceFilterConfig("", "", "/a,/b,/c,/d,/e"));
+  EXPECT_NOT_OK(BuildTraceFilterConfig("", "", std::string(MAX_HTTP_PATH_FILTER_LEN + 1, 'x')));
+}
+
+TEST(ParseProtocolValuesTest, Basic) {
+  ASSERT_OK_AND_ASSIGN(auto values, ParseProtocolValues("http:10, MySQL:2"));
+  EXPECT_THAT(values, UnorderedElementsAre(Pair(kProtocolHTTP, 10), Pair(kProtocolMySQL, 2)));
+
+  ASSERT_OK_AND_ASSIGN(values, ParseProtocolValues(""));
+  EXPECT_TRUE(values.empty());
+}
+
+TEST(ParseProtocolValuesTest, InvalidInputs) {
+  EXPECT_NOT_OK(ParseProtocolValues("http"));
+  EXPECT_NOT_OK(ParseProtocolValues("http:abc"));
+  EXPECT_NOT_OK(ParseProtocolValues("gopher:1"));
+  EXPECT_NOT_OK(ParseProtocolValues("unknown:1"));
+}
+
+}  // namespace stirling
+}  // namespace px
@@ -0,0 +1,203 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/stirling/source_connectors/socket_tracer/go_symaddrs_cache.h"
+
+#include <unistd.h>
+
+#include <cstring>
+#include <utility>
+
+#include "src/common/base/file.h"
+#include "src/common/fs/fs_wrapper.h"
+
+namespace px {
+namespace stirling {
+
+namespace {
+
+// Bump this whenever the layout of the symaddrs structs changes,
+// so that entries persisted by an older version are ignored.
+constexpr uint32_t kFormatVersion = 1;
+
+// The struct sizes are recorded as well, as a guard against forgetting to bump the version.
+struct BlobHeader {
+  uint32_t version;
+  uint32_t common_size;
+  uint32_t tls_size;
+  uint32_t http2_size;
+  bool has_common;
+  bool has_tls;
+  bool has_http2;
+};
+
+constexpr BlobHeader kExpectedHeader = {
+    .version = kFormatVersion,
+    .common_size = sizeof(struct go_common_symaddrs_t),
+    .tls_size = sizeof(struct go_tls_symaddrs_t),
+    .http2_size = sizeof(struct go_http2_symaddrs_t),
+    .has_common = false,
+    .has_tls = false,
+    .has_http2 = false,
+};
+
+template <typename T>
+void AppendStruct(const std::optional<T>& val, std::string* blob) {
+  if (val.has_value()) {
+    blob->append(reinterpret_cast<const char*>(&val.value()), sizeof(T));
+  }
+}
+
+template <typename T>
+Status ExtractStruct(bool present, std::string_view* blob, std::optional<T>* val) {
+  if (!present) {
+    return Status::OK();
+  }
+  if (blob->size() < sizeof(T)) {
+    return error::Internal("Truncated symaddrs blob");
+  }
+  T tmp;
+  std::memcpy(&tmp, blob->data(), sizeof(T));
+  *val = tmp;
+  blob->remove_prefix(sizeof(T));
+  return Status::OK();
+}
+
+}  // namespace
+
+std::string SerializeGoSymAddrs(const GoSymAddrs& symaddrs) {
+  BlobHeader header = kExpectedHeader;
+  header.has_common = symaddrs.common.has_value();
+  header.has_tls = symaddrs.tls.has_value();
+  header.has_http2 = symaddrs.http2.has_value();
+
+  std::string blob(reinterpret_cast<const char*>(&header), sizeof(header));
+  AppendStruct(symaddrs.common, &blob);
+  AppendStruct(symaddrs.tls, &blob);
+  AppendStruct(symaddrs.http2, &blob);
+  return blob;
+}
+
+StatusOr<GoSymAddrs> DeserializeGoSymAddrs(std::string_view blob) {
+  if (blob.size() < sizeof(BlobHeader)) {
+    return error::Internal("Truncated symaddrs blob");
+  }
+  BlobHeader header;
+  std::memcpy(&header, blob.data(), sizeof(header));
+  blob.remove_prefix(sizeof(header));
+
+  if (header.version != kExpectedHeader.version ||
+      header.common_size != kExpectedHeader.common_size ||
+      header.tls_size != kExpectedHeader.tls_size ||
+      header.http2_size != kExpectedHeader.http2_size) {
+    return error::FailedPrecondition("Incompatible symaddrs blob [version=$0]", header.version);
+  }
+
+  GoSymAddrs symaddrs;
+  PL_RETURN_IF_ERROR(ExtractStruct(header.has_common, &blob, &symaddrs.common));
+  PL_RETURN_IF_ERROR(ExtractStruct(header.has_tls, &blob, &symaddrs.tls));
+  PL_RETURN_IF_ERROR(ExtractStruct(header.has_http2, &blob, &symaddrs.http2));
+  if (!blob.empty()) {
+    return error::Internal("Unexpected trailing bytes in symaddrs blob");
+  }
+  return symaddrs;
+}
+
+GoSymAddrsCache::GoSymAddrsCache(std::filesystem::path cache_dir)
+    : cache_dir_(std::move(cache_dir)) {
+  if (!cache_dir_.empty()) {
+    Status s = fs::CreateDirectories(cache_dir_);
+    LOG_IF(WARNING, !s.ok()) << absl::Substitute(
+        "Could not create Go symaddrs cache directory $0, entries will not be persisted: $1",
+        cache_dir_.string(), s.msg());
+  }
+}
+
+std::filesystem::path GoSymAddrsCache::EntryPath(const std::string& build_id) const {
+  return cache_dir_ / absl::StrCat(build_id, ".symaddrs");
+}
+
+const GoSymAddrs* GoSymAddrsCache::Lookup(const std::string& build_id) {
+  absl::MutexLock lock(&mu_);
+
+  auto iter = entries_.find(build_id);
+  if (iter != entries_.end()) {
+    return iter->second.get();
+  }
+
+  if (cache_dir_.empty()) {
+    return nullptr;
+  }
+
+  StatusOr<std::string> blob =
+      ReadFileToString(EntryPath(build_id).string(), std::ios_base::binary);
+  if (!blob.ok()) {
+    return nullptr;
+  }
+  StatusOr<GoSymAddrs> symaddrs = DeserializeGoSymAddrs(blob.ValueOrDie());
+  if (!symaddrs.ok()) {
+    VLOG(1) << absl::Substitute("Ignoring persisted symaddrs for build ID $0: $1", build_id,
+                                symaddrs.msg());
+    return nullptr;
+  }
+
+  auto& entry = entries_[build_id];
+  entry = std::make_unique<GoSymAddrs>(symaddrs.ConsumeValueOrDie());
+  return entry.get();
+}
+
+Status GoSymAddrsCache::Persist(const std::string& build_id, const GoSymAddrs& symaddrs) const {
+  // Write the entry next to its final path, so that the rename is atomic and readers never see a
+  // truncated entry. The temporary file is unique to this process, in case several share the
+  // cache directory.
+  std::filesystem::path entry_path = EntryPath(build_id);
+  std::filesystem::path tmp_path = absl::StrCat(entry_path.string(), ".tmp.", getpid());
+  Status s = WriteFileFromString(tmp_path.string(), SerializeGoSymAddrs(symaddrs),
+                                 std::ios_base::out | std::ios_base::binary);
+  if (s.ok()) {
+    s = fs::Rename(tmp_path, entry_path);
+  }
+  if (!s.ok()) {
+    PL_UNUSED(fs::Remove(tmp_path));
+  }
+  return s;
+}
+
+const GoSymAddrs* GoSymAddrsCache::Insert(const std::string& build_id,
+                                          const GoSymAddrs& symaddrs) {
+  absl::MutexLock lock(&mu_);
+
+  // Identical build IDs have identical symbol addresses, so an existing entry is kept as is.
+  // This also keeps pointers handed out by earlier calls valid.
+  auto [iter, inserted] = entries_.try_emplace(build_id);
+  if (!inserted) {
+    return iter->second.get();
+  }
+  iter->second = std::make_unique<GoSymAddrs>(symaddrs);
+
+  if (!cache_dir_.empty()) {
+    Status s = Persist(build_id, symaddrs);
+    LOG_IF(WARNING, !s.ok()) << absl::Substitute(
+        "Could not persist symaddrs for build ID $0: $1", build_id, s.msg());
+  }
+
+  return iter->second.get();
+}
+
+}  // namespace stirling
+}  // namespace px
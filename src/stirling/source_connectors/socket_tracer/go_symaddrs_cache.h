@@ -0,0 +1,108 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/synchronization/mutex.h>
+
+#include "src/common/base/base.h"
+#include "src/stirling/source_connectors/socket_tracer/bcc_bpf_intf/symaddrs.h"
+
+namespace px {
+namespace stirling {
+
+/**
+ * The symbol addresses of a Go binary that are needed to deploy the Go uprobes.
+ * An unset member means the binary does not have the symbols for that set of probes.
+ */
+struct GoSymAddrs {
+  std::optional<struct go_common_symaddrs_t> common;
+  std::optional<struct go_tls_symaddrs_t> tls;
+  std::optional<struct go_http2_symaddrs_t> http2;
+};
+
+/**
+ * A cache of GoSymAddrs keyed by the build ID of the binary.
+ *
+ * Resolving the symbol addresses requires indexing the DWARF info of the binary, which is
+ * expensive for large Go binaries. The same binary is typically run by many processes
+ * (e.g. every replica of a deployment), each with a different path on the host,
+ * so the cache is keyed on the build ID rather than the path.
+ *
+ * If a cache directory is provided, entries are also persisted there, one file per build ID,
+ * so they survive restarts of Stirling. Entries are never evicted: the number of distinct Go
+ * binaries on a node is small, and each entry is a few hundred bytes.
+ */
+class GoSymAddrsCache {
+ public:
+  /**
+   * @param cache_dir Directory in which to persist entries. If empty, entries are kept in memory
+   *                  only.
+   */
+  explicit GoSymAddrsCache(std::filesystem::path cache_dir = {});
+
+  /**
+   * Returns the cached symbol addresses of the binary with the given build ID,
+   * looking on disk if they are not in memory. Returns nullptr on a miss.
+   */
+  const GoSymAddrs* Lookup(const std::string& build_id);
+
+  /**
+   * Caches the symbol addresses of the binary with the given build ID,
+   * and returns a pointer to the cached copy. The pointer remains valid for the lifetime
+   * of the cache.
+   */
+  const GoSymAddrs* Insert(const std::string& build_id, const GoSymAddrs& symaddrs);
+
+  size_t size() const {
+    absl::MutexLock lock(&mu_);
+    return entries_.size();
+  }
+
+ private:
+  std::filesystem::path EntryPath(const std::string& build_id) const;
+
+  // Writes the entry to cache_dir_, atomically replacing any existing one.
+  Status Persist(const std::string& build_id, const GoSymAddrs& symaddrs) const;
+
+  const std::filesystem::path cache_dir_;
+
+  mutable absl::Mutex mu_;
+
+  // Values are held by pointer, so that pointers returned to callers are stable across rehashing.
+  absl::flat_hash_map<std::string, std::unique_ptr<GoSymAddrs>> entries_ ABSL_GUARDED_BY(mu_);
+};
+
+/**
+ * Serializes GoSymAddrs into a versioned binary blob, as persisted by GoSymAddrsCache.
+ */
+std::string SerializeGoSymAddrs(const GoSymAddrs& symaddrs);
+
+/**
+ * Inverse of SerializeGoSymAddrs(). Fails if the blob was written by an incompatible version.
+ */
+StatusOr<GoSymAddrs> DeserializeGoSymAddrs(std::string_view blob);
+
+}  // namespace stirling
+}  // namespace px
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/stirling/source_connectors/socket_tracer/go_symaddrs_cache.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "src/common/base/file.h"
+#include "src/common/testing/temp_dir.h"
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace stirling {
+
+GoSymAddrs TestSymAddrs() {
+  GoSymAddrs symaddrs;
+  symaddrs.common = go_common_symaddrs_t{};
+  symaddrs.common->net_TCPConn = 0x1234;
+  symaddrs.common->FD_Sysfd_offset = 16;
+  symaddrs.tls = go_tls_symaddrs_t{};
+  return symaddrs;
+}
+
+TEST(GoSymAddrsSerializationTest, RoundTrip) {
+  GoSymAddrs symaddrs = TestSymAddrs();
+
+  ASSERT_OK_AND_ASSIGN(GoSymAddrs result, DeserializeGoSymAddrs(SerializeGoSymAddrs(symaddrs)));
+  ASSERT_TRUE(result.common.has_value());
+  EXPECT_EQ(result.common->net_TCPConn, 0x1234);
+  EXPECT_EQ(result.common->FD_Sysfd_offset, 16);
+  EXPECT_TRUE(result.tls.has_value());
+  EXPECT_FALSE(result.http2.has_value());
+}
+
+TEST(GoSymAddrsSerializationTest, RejectsCorruptBlobs) {
+  std::string blob = SerializeGoSymAddrs(TestSymAddrs());
+
+  // Truncated.
+  EXPECT_NOT_OK(DeserializeGoSymAddrs(std::string_view(blob).substr(0, blob.size() - 1)));
+
+  // Trailing bytes.
+  EXPECT_NOT_OK(DeserializeGoSymAddrs(blob + "x"));
+
+  // Different version.
+  blob[0] ^= 0xff;
+  EXPECT_NOT_OK(DeserializeGoSymAddrs(blob));
+}
+
+TEST(GoSymAddrsCacheTest, InMemory) {
+  GoSymAddrsCache cache;
+
+  EXPECT_EQ(cache.Lookup("abcd"), nullptr);
+
+  const GoSymAddrs* inserted = cache.Insert("abcd", TestSymAddrs());
+  ASSERT_NE(inserted, nullptr);
+  EXPECT_EQ(cache.Lookup("abcd"), inserted);
+  EXPECT_EQ(cache.size(), 1);
+
+  // Re-inserting the same build ID keeps the existing entry.
+  EXPECT_EQ(cache.Insert("abcd", GoSymAddrs()), inserted);
+  EXPECT_TRUE(cache.Lookup("abcd")->common.has_value());
+}
+
+TEST(GoSymAddrsCacheTest, PersistedAcrossInstances) {
+  testing::TempDir tmp_dir;
+
+  {
+    GoSymAddrsCache cache(tmp_dir.path());
+    cache.Insert("abcd", TestSymAddrs());
+  }
+
+  GoSymAddrsCache cache(tmp_dir.path());
+  EXPECT_EQ(cache.size(), 0);
+  const GoSymAddrs* symaddrs = cache.Lookup("abcd");
+  ASSERT_NE(symaddrs, nullptr);
+  ASSERT_TRUE(symaddrs->common.has_value());
+  EXPECT_EQ(symaddrs->common->net_TCPConn, 0x1234);
+  EXPECT_EQ(cache.size(), 1);
+
+  EXPECT_EQ(cache.Lookup("efgh"), nullptr);
+
+  // Entries are renamed into place, so only the entry itself is left in the directory.
+  std::vector<std::string> files;
+  for (const auto& f : std::filesystem::directory_iterator(tmp_dir.path())) {
+    files.push_back(f.path().filename().string());
+  }
+  EXPECT_THAT(files, ::testing::ElementsAre("abcd.symaddrs"));
+}
+
+TEST(GoSymAddrsCacheTest, IgnoresCorruptPersistedEntries) {
+  testing::TempDir tmp_dir;
+  ASSERT_OK(WriteFileFromString((tmp_dir.path() / "abcd.symaddrs").string(), "garbage"));
+
+  GoSymAddrsCache cache(tmp_dir.path());
+  EXPECT_EQ(cache.Lookup("abcd"), nullptr);
+}
+
+}  // namespace stirling
+}  // namespace px
@@ -22,6 +22,7 @@
 
 #include <algorithm>
 #include <string>
+#include <tuple>
 #include <utility>
 
 namespace px {
@@ -34,13 +35,33 @@ namespace {
 HeadersMap GetHTTPHeadersMap(const phr_header* headers, size_t num_headers) {
   HeadersMap result;
   for (size_t i = 0; i < num_headers; i++) {
-    std::string name(headers[i].name, headers[i].name_len);
-    std::string value(headers[i].value, headers[i].value_len);
-    result.insert({name, value});
+    // Construct the strings in place, so each header is copied out of the buffer only once.
+    result.emplace(std::piecewise_construct,
+                   std::forward_as_tuple(headers[i].name, headers[i].name_len),
+                   std::forward_as_tuple(headers[i].value, headers[i].value_len));
   }
   return result;
 }
 
+// Returns true if the body must be kept whole, because it is transformed after stitching
+// (see PreProcessMessage()), and a truncated body would not survive the transformation.
+bool RequiresFullBody(const Message& message) {
+  const auto content_encoding_iter = message.headers.find(kContentEncoding);
+  return content_encoding_iter != message.headers.end() &&
+         content_encoding_iter->second == "gzip";
+}
+
+// Copies the body out of the data stream buffer. Only the head that can survive the truncation
+// in the data table is materialized; the rest of the body is only accounted for in body_size.
+void SetBody(std::string_view body, Message* result) {
+  result->body_size = body.size();
+  if (body.size() > kMaxBodyBytes && !RequiresFullBody(*result)) {
+    body = body.substr(0, kMaxBodyBytes);
+    result->body_truncated = true;
+  }
+  result->body = body;
+}
+
 }  // namespace
 
 //=============================================================================
@@ -70,6 +91,11 @@ ParseState ParseChunk(std::string_view* data, Message* result) {
     return ParseState::kInvalid;
   } else if (retval >= 0) {
     // Complete message.
+    result->body_size = buf_size;
+    if (buf_size > kMaxBodyBytes && !RequiresFullBody(*result)) {
+      buf_size = kMaxBodyBytes;
+      result->body_truncated = true;
+    }
     data_copy.resize(buf_size);
     result->body = std::move(data_copy);
     // phr_decode_chunked rewrites the buffer in place, removing chunked-encoding headers.
@@ -121,7 +147,7 @@ ParseState ParseBody(std::string_view* buf, Message* result) {
       return ParseState::kNeedsMoreData;
     }
 
-    result->body = buf->substr(0, len);
+    SetBody(buf->substr(0, len), result);
     buf->remove_prefix(std::min(len, buf->size()));
     return ParseState::kSuccess;
   }
@@ -188,7 +214,7 @@ ParseState ParseBody(std::string_view* buf, Message* result) {
     // Only the body that is present at the time is emitted, since we don't
     // know if the data is actually complete or not without a length.
 
-    result->body = *buf;
+    SetBody(*buf, result);
     buf->remove_prefix(buf->size());
     LOG_FIRST_N(WARNING, 10)
         << "HTTP message with no Content-Length or Transfer-Encoding may produce "
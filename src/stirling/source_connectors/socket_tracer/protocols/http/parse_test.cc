@@ -416,6 +416,41 @@ TEST_F(HTTPParserTest, ParseIncompleteHTTPResponseWithContentLengthHeader) {
   EXPECT_THAT(parsed_messages, ElementsAre(expected_message1));
 }
 
+TEST_F(HTTPParserTest, LargeBodyIsTruncatedAtParseTime) {
+  const std::string body(kMaxBodyBytes + 100, 'x');
+  const std::string buf = HTTPRespWithSizedBody(body);
+
+  std::deque<Message> parsed_messages;
+  ParseResult result = ParseFramesLoop(message_type_t::kResponse, buf, &parsed_messages);
+
+  EXPECT_EQ(ParseState::kSuccess, result.state);
+  EXPECT_EQ(buf.size(), result.end_position);
+  ASSERT_EQ(parsed_messages.size(), 1);
+  EXPECT_EQ(parsed_messages[0].body, body.substr(0, kMaxBodyBytes));
+  EXPECT_EQ(parsed_messages[0].body_size, body.size());
+  EXPECT_TRUE(parsed_messages[0].body_truncated);
+}
+
+TEST_F(HTTPParserTest, GzipBodyIsNotTruncatedAtParseTime) {
+  const std::string body(kMaxBodyBytes + 100, 'x');
+  const std::string buf = absl::Substitute(
+      "HTTP/1.1 200 OK\r\n"
+      "Content-Encoding: gzip\r\n"
+      "Content-Length: $0\r\n"
+      "\r\n"
+      "$1",
+      body.size(), body);
+
+  std::deque<Message> parsed_messages;
+  ParseResult result = ParseFramesLoop(message_type_t::kResponse, buf, &parsed_messages);
+
+  EXPECT_EQ(ParseState::kSuccess, result.state);
+  ASSERT_EQ(parsed_messages.size(), 1);
+  EXPECT_EQ(parsed_messages[0].body, body);
+  EXPECT_EQ(parsed_messages[0].body_size, body.size());
+  EXPECT_FALSE(parsed_messages[0].body_truncated);
+}
+
 TEST_F(HTTPParserTest, InvalidInput) {
   const std::string_view buf = " is awesome";
   std::deque<Message> parsed_messages;
@@ -52,6 +52,7 @@ void PreProcessMessage(Message* message) {
   auto content_type_iter = message->headers.find(http::kContentType);
   if (content_type_iter == message->headers.end()) {
     message->body = "<removed: unknown content-type>";
+    message->body_truncated = false;
     return;
   }
 
@@ -61,6 +62,7 @@ void PreProcessMessage(Message* message) {
        !kHTTPResponseHeaderFilter.exclusions.empty())) {
     if (!MatchesHTTPHeaders(message->headers, kHTTPResponseHeaderFilter)) {
       message->body = "<removed: non-text content-type>";
+      message->body_truncated = false;
       return;
     }
   }
@@ -74,7 +76,8 @@ void PreProcessMessage(Message* message) {
       LOG(WARNING) << "Unable to gunzip HTTP body.";
       message->body = "<Failed to gunzip body>";
     } else {
-      message->body = bodyOrErr.ValueOrDie();
+      message->body = bodyOrErr.ConsumeValueOrDie();
+      message->body_size = message->body.size();
     }
   }
 }
@@ -58,8 +58,16 @@ struct Message : public FrameBase {
   int resp_status = -1;
   std::string resp_message = "-";
 
+  // Only the head of the body (up to kMaxBodyBytes) is materialized at parse time,
+  // unless the body must be kept whole to be decoded later (e.g. gzip Content-Encoding).
   std::string body = "-";
 
+  // The size of the body on the wire, before any truncation.
+  size_t body_size = 0;
+
+  // If true, the tail of the body was not copied out of the data stream buffer.
+  bool body_truncated = false;
+
   // The number of bytes in the HTTP header, used in ByteSize(),
   // as an approximation of the size of the non-body fields.
   size_t headers_byte_size = 0;
@@ -71,10 +79,10 @@ struct Message : public FrameBase {
   std::string ToString() const override {
     return absl::Substitute(
         "[type=$0 minor_version=$1 headers=[$2] req_method=$3 "
-        "req_path=$4 resp_status=$5 resp_message=$6 body=$7]",
+        "req_path=$4 resp_status=$5 resp_message=$6 body=$7 body_size=$8 body_truncated=$9]",
         magic_enum::enum_name(type), minor_version,
         absl::StrJoin(headers, ",", absl::PairFormatter(":")), req_method, req_path, resp_status,
-        resp_message, body);
+        resp_message, body, body_size, body_truncated);
   }
 };
 
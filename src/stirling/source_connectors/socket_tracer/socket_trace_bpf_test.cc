@@ -514,6 +514,43 @@ TEST_F(SocketTraceBPFTest, LargeMessages) {
   EXPECT_EQ(server_send_data.substr(server_send_data.size() - 5, 5), ConstStringView("\0\0\0\0\0"));
 }
 
+// Tests that the bytes beyond the per-syscall cap are filled in, so that the messages after a
+// capped one still parse.
+TEST_F(SocketTraceBPFTest, CappedMessagesKeepStreamInSync) {
+  FLAGS_stirling_bpf_protocol_max_msg_bytes = "http:1024";
+  ASSERT_OK(source_->UpdateBPFTraceFilters());
+  FLAGS_stirling_bpf_protocol_max_msg_bytes = "";
+  ConfigureBPFCapture(traffic_protocol_t::kProtocolHTTP, kRoleClient);
+
+  StartTransferDataThread();
+
+  std::string large_response =
+      "HTTP/1.1 200 OK\r\n"
+      "Content-Type: application/json; msg1\r\n"
+      "Content-Length: 8192\r\n"
+      "\r\n";
+  large_response += std::string(8192, '+');
+
+  testing::SendRecvScript script({
+      {{kHTTPReqMsg1}, {large_response}},
+      {{kHTTPReqMsg2}, {kHTTPRespMsg2}},
+  });
+  testing::ClientServerSystem system;
+  system.RunClientServer<&TCPSocket::Read, &TCPSocket::Write>(script);
+
+  StopTransferDataThread();
+
+  std::vector<TaggedRecordBatch> tablets = ConsumeRecords(kHTTPTableNum);
+  ASSERT_FALSE(tablets.empty());
+
+  ColumnWrapperRecordBatch records =
+      FindRecordsMatchingPID(tablets[0].records, kHTTPUPIDIdx, system.ClientPID());
+
+  ASSERT_THAT(records, Each(ColWrapperSizeIs(2)));
+  EXPECT_THAT(records[kHTTPRespHeadersIdx]->Get<types::StringValue>(0), HasSubstr("msg1"));
+  EXPECT_THAT(records[kHTTPRespHeadersIdx]->Get<types::StringValue>(1), HasSubstr("msg2"));
+}
+
 constexpr std::string_view kHTTPRespMsgHeader =
     "HTTP/1.1 200 OK\r\n"
     "Content-Type: application/json; msg1\r\n"
@@ -38,6 +38,7 @@
 #include "src/stirling/bpf_tools/macros.h"
 #include "src/stirling/source_connectors/socket_tracer/bcc_bpf_intf/go_grpc_types.hpp"
 #include "src/stirling/source_connectors/socket_tracer/bcc_bpf_intf/socket_trace.hpp"
+#include "src/stirling/source_connectors/socket_tracer/bpf_trace_filter.h"
 #include "src/stirling/source_connectors/socket_tracer/conn_stats.h"
 #include "src/stirling/source_connectors/socket_tracer/proto/sock_event.pb.h"
 #include "src/stirling/source_connectors/socket_tracer/protocols/http/utils.h"
@@ -90,6 +91,24 @@ DEFINE_bool(stirling_enable_kafka_tracing, true,
 DEFINE_bool(stirling_disable_self_tracing, true,
             "If true, stirling will not trace and process syscalls made by itself.");
 
+DEFINE_string(stirling_bpf_excluded_ports, "",
+              "Comma-separated remote ports whose connections are not traced. "
+              "Only the remote port is matched, so this filters the client side of a connection, "
+              "not connections accepted on a local port. "
+              "Applied inside BPF, before data is copied to user space.");
+DEFINE_string(stirling_bpf_excluded_cidrs, "",
+              "Comma-separated remote IPv4 CIDR blocks whose connections are not traced. "
+              "Applied inside BPF, before data is copied to user space.");
+DEFINE_string(stirling_bpf_http_path_deny_prefixes, "",
+              "Comma-separated HTTP path prefixes (e.g. '/healthz,/metrics'). "
+              "GET requests with a matching path, and their responses, are dropped inside BPF.");
+DEFINE_string(stirling_bpf_protocol_sampling, "",
+              "Comma-separated <protocol>:<N> pairs (e.g. 'http:10'). The data of only 1 in N "
+              "connections of the protocol is traced. Protocols not listed are fully traced.");
+DEFINE_string(stirling_bpf_protocol_max_msg_bytes, "",
+              "Comma-separated <protocol>:<bytes> pairs. Caps the bytes of each syscall's data "
+              "that are copied to user space for the protocol.");
+
 DEFINE_uint32(messages_expiration_duration_secs, 10 * 60,
               "The duration for which a cached message to be erased.");
 DEFINE_uint32(messages_size_limit_bytes, 1024 * 1024,
@@ -213,6 +232,8 @@ Status SocketTraceConnector::InitImpl() {
     }
   }
 
+  PL_RETURN_IF_ERROR(UpdateBPFTraceFilters());
+
   PL_RETURN_IF_ERROR(TestOnlySetTargetPID(FLAGS_test_only_socket_trace_target_pid));
   if (FLAGS_stirling_disable_self_tracing) {
     PL_RETURN_IF_ERROR(DisableSelfTracing());
@@ -277,7 +298,15 @@ std::thread SocketTraceConnector::RunDeployUProbesThread(
   //               deployment will become asynchronous to TransferData(), and this may
   //               lead to non-determinism.
   if (state() != State::kUninitialized && !uprobe_mgr_.ThreadsRunning()) {
-    return uprobe_mgr_.RunDeployUProbesThread(pids);
+    // The conn trackers are not thread-safe, so the traffic per PID is snapshotted here,
+    // for the uprobe manager to deploy on the busiest processes first.
+    absl::flat_hash_map<uint32_t, uint64_t> pid_activity;
+    for (const ConnTracker* tracker : conn_trackers_mgr_.active_trackers()) {
+      pid_activity[tracker->conn_id().upid.pid] +=
+          tracker->GetStat(ConnTracker::StatKey::kBytesSent) +
+          tracker->GetStat(ConnTracker::StatKey::kBytesRecv);
+    }
+    return uprobe_mgr_.RunDeployUProbesThread(pids, std::move(pid_activity));
   }
   return {};
 }
@@ -451,6 +480,42 @@ Status SocketTraceConnector::UpdateBPFProtocolTraceRole(traffic_protocol_t proto
   return UpdatePerCPUArrayValue(static_cast<int>(protocol), role_mask, &control_map_handle);
 }
 
+Status SocketTraceConnector::UpdateBPFTraceFilters() {
+  PL_ASSIGN_OR_RETURN(trace_filter_config_t config,
+                      BuildTraceFilterConfig(FLAGS_stirling_bpf_excluded_ports,
+                                             FLAGS_stirling_bpf_excluded_cidrs,
+                                             FLAGS_stirling_bpf_http_path_deny_prefixes));
+  auto config_handle = GetArrayTable<trace_filter_config_t>(kTraceFilterConfigArrayName);
+  auto update_res = config_handle.update_value(0, config);
+  if (!update_res.ok()) {
+    return error::Internal(
+        absl::Substitute("Failed to set trace filter config, error message: $0", update_res.msg()));
+  }
+
+  PL_ASSIGN_OR_RETURN(auto sampling_denominators,
+                      ParseProtocolValues(FLAGS_stirling_bpf_protocol_sampling));
+  PL_ASSIGN_OR_RETURN(auto max_msg_bytes,
+                      ParseProtocolValues(FLAGS_stirling_bpf_protocol_max_msg_bytes));
+
+  auto protocol_filter_handle = GetArrayTable<protocol_filter_t>(kProtocolFilterArrayName);
+  for (const auto& p : magic_enum::enum_values<traffic_protocol_t>()) {
+    protocol_filter_t filter = {};
+    if (auto iter = sampling_denominators.find(p); iter != sampling_denominators.end()) {
+      filter.sampling_denominator = iter->second;
+    }
+    if (auto iter = max_msg_bytes.find(p); iter != max_msg_bytes.end()) {
+      filter.max_msg_bytes = iter->second;
+    }
+    update_res = protocol_filter_handle.update_value(static_cast<int>(p), filter);
+    if (!update_res.ok()) {
+      return error::Internal(absl::Substitute("Failed to set filter for protocol $0: $1",
+                                              magic_enum::enum_name(p), update_res.msg()));
+    }
+  }
+
+  return Status::OK();
+}
+
 Status SocketTraceConnector::TestOnlySetTargetPID(int64_t pid) {
   auto control_map_handle = GetPerCPUArrayTable<int64_t>(kControlValuesArrayName);
   return UpdatePerCPUArrayValue(kTargetTGIDIndex, pid, &control_map_handle);
@@ -633,6 +698,15 @@ void SocketTraceConnector::AppendMessage(ConnectorContext* ctx, const ConnTracke
     content_type = HTTPContentType::kJSON;
   }
 
+  // Bodies longer than kMaxBodyBytes were already cut to size at parse time, without copying their
+  // tail out of the data stream buffer. Tag them, so they render like any other truncated value.
+  if (req_message.body_truncated) {
+    req_message.body.append(DataTable::kTruncatedMsg);
+  }
+  if (resp_message.body_truncated) {
+    resp_message.body.append(DataTable::kTruncatedMsg);
+  }
+
   DataTable::RecordBuilder<&kHTTPTable> r(data_table, resp_message.timestamp_ns);
   r.Append<r.ColIndex("time_")>(resp_message.timestamp_ns);
   r.Append<r.ColIndex("upid")>(upid.value());
@@ -644,15 +718,18 @@ void SocketTraceConnector::AppendMessage(ConnectorContext* ctx, const ConnTracke
   r.Append<r.ColIndex("major_version")>(1);
   r.Append<r.ColIndex("minor_version")>(resp_message.minor_version);
   r.Append<r.ColIndex("content_type")>(static_cast<uint64_t>(content_type));
-  r.Append<r.ColIndex("req_headers"), kMaxHTTPHeadersBytes>(ToJSONString(req_message.headers));
+  // Serializing the headers is costly, so it is skipped when nobody collects them.
+  r.Append<r.ColIndex("req_headers"), kMaxHTTPHeadersBytes>(
+      r.Subscribed(r.ColIndex("req_headers")) ? ToJSONString(req_message.headers) : "");
   r.Append<r.ColIndex("req_method")>(std::move(req_message.req_method));
   r.Append<r.ColIndex("req_path")>(std::move(req_message.req_path));
-  r.Append<r.ColIndex("req_body_size")>(req_message.body.size());
+  r.Append<r.ColIndex("req_body_size")>(req_message.body_size);
   r.Append<r.ColIndex("req_body"), kMaxBodyBytes>(std::move(req_message.body));
-  r.Append<r.ColIndex("resp_headers"), kMaxHTTPHeadersBytes>(ToJSONString(resp_message.headers));
+  r.Append<r.ColIndex("resp_headers"), kMaxHTTPHeadersBytes>(
+      r.Subscribed(r.ColIndex("resp_headers")) ? ToJSONString(resp_message.headers) : "");
   r.Append<r.ColIndex("resp_status")>(resp_message.resp_status);
   r.Append<r.ColIndex("resp_message")>(std::move(resp_message.resp_message));
-  r.Append<r.ColIndex("resp_body_size")>(resp_message.body.size());
+  r.Append<r.ColIndex("resp_body_size")>(resp_message.body_size);
   r.Append<r.ColIndex("resp_body"), kMaxBodyBytes>(std::move(resp_message.body));
   r.Append<r.ColIndex("latency")>(
       CalculateLatency(req_message.timestamp_ns, resp_message.timestamp_ns));
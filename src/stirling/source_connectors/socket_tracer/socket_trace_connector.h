@@ -50,6 +50,7 @@
 DECLARE_uint32(stirling_conn_stats_sampling_ratio);
 DECLARE_bool(stirling_enable_periodic_bpf_map_cleanup);
 DECLARE_string(perf_buffer_events_output_path);
+DECLARE_string(stirling_bpf_protocol_max_msg_bytes);
 DECLARE_bool(stirling_enable_http_tracing);
 DECLARE_bool(stirling_enable_http2_tracing);
 DECLARE_bool(stirling_enable_mysql_tracing);
@@ -110,6 +111,11 @@ class SocketTraceConnector : public SourceConnector, public bpf_tools::BCCWrappe
   // Role_mask a bit mask, and represents the endpoint_role_t roles that are allowed to transfer
   // data from inside BPF to user-space.
   Status UpdateBPFProtocolTraceRole(traffic_protocol_t protocol, uint64_t role_mask);
+
+  // Writes the in-kernel data filters (excluded endpoints, HTTP path deny list, per-protocol
+  // sampling and size caps) from their flags to the BPF maps.
+  Status UpdateBPFTraceFilters();
+
   Status TestOnlySetTargetPID(int64_t pid);
   Status DisableSelfTracing();
 
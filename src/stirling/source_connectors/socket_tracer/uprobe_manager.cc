@@ -22,13 +22,19 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
 #include <filesystem>
 #include <map>
+#include <mutex>
+#include <optional>
+#include <thread>
 
 #include "src/common/base/base.h"
 #include "src/common/base/utils.h"
 #include "src/common/exec/subprocess.h"
 #include "src/common/fs/fs_wrapper.h"
+#include "src/common/metrics/metrics.h"
+#include "src/common/system/clock.h"
 #include "src/stirling/bpf_tools/macros.h"
 #include "src/stirling/obj_tools/dwarf_reader.h"
 #include "src/stirling/obj_tools/go_syms.h"
@@ -42,6 +48,17 @@ DEFINE_bool(stirling_rescan_for_dlopen, false,
 DEFINE_double(stirling_rescan_exp_backoff_factor, 2.0,
               "Exponential backoff factor used in decided how often to rescan binaries for "
               "dynamically loaded libraries");
+DEFINE_string(stirling_go_symaddrs_cache_dir, "",
+              "If not empty, the symbol addresses resolved from the DWARF info of Go binaries are "
+              "persisted in this directory, keyed by build ID, so that restarts of Stirling do not "
+              "need to re-index the same binaries.");
+DEFINE_int32(stirling_uprobe_deploy_threads, 4,
+             "Maximum number of threads used to analyze binaries for uprobe deployment. "
+             "Distinct binaries are analyzed concurrently, the busiest ones first.");
+DEFINE_uint64(stirling_uprobe_deploy_max_bytes, 1024 * 1024 * 1024,
+              "Maximum total size of the binaries analyzed concurrently for uprobe deployment. The "
+              "memory used to analyze a binary grows with its size. A larger binary is analyzed on "
+              "its own.");
 
 namespace px {
 namespace stirling {
@@ -49,8 +66,31 @@ namespace stirling {
 using ::px::stirling::obj_tools::DwarfReader;
 using ::px::stirling::obj_tools::ElfReader;
 
-UProbeManager::UProbeManager(bpf_tools::BCCWrapper* bcc) : bcc_(bcc) {
+namespace {
+
+prometheus::Histogram& TimeToTracedHistogram() {
+  static auto& family =
+      prometheus::BuildHistogram()
+          .Name("stirling_uprobe_time_to_traced_seconds")
+          .Help("Time from the start of a process until the Go uprobes are attached to it.")
+          .Register(GetMetricsRegistry());
+  return family.Add(
+      {}, prometheus::Histogram::BucketBoundaries{0.1, 0.5, 1, 2, 5, 10, 30, 60, 120, 300, 600});
+}
+
+double BootTimeSeconds() {
+  return std::chrono::duration<double>(chrono::boot_clock::now().time_since_epoch()).count();
+}
+
+}  // namespace
+
+UProbeManager::UProbeManager(bpf_tools::BCCWrapper* bcc)
+    : bcc_(bcc),
+      start_time_ticks_(static_cast<int64_t>(BootTimeSeconds() *
+                                             system::Config::GetInstance().KernelTicksPerSecond())),
+      time_to_traced_histogram_(TimeToTracedHistogram()) {
   proc_parser_ = std::make_unique<system::ProcParser>(system::Config::GetInstance());
+  go_symaddrs_cache_ = std::make_unique<GoSymAddrsCache>(FLAGS_stirling_go_symaddrs_cache_dir);
 }
 
 void UProbeManager::Init(bool enable_http2_tracing, bool disable_self_probing) {
@@ -139,39 +179,25 @@ Status UProbeManager::UpdateOpenSSLSymAddrs(std::filesystem::path libcrypto_path
   return Status::OK();
 }
 
-Status UProbeManager::UpdateGoCommonSymAddrs(ElfReader* elf_reader, DwarfReader* dwarf_reader,
-                                             const std::vector<int32_t>& pids) {
-  PL_ASSIGN_OR_RETURN(struct go_common_symaddrs_t symaddrs,
-                      GoCommonSymAddrs(elf_reader, dwarf_reader));
-
+void UProbeManager::UpdateGoCommonSymAddrs(const struct go_common_symaddrs_t& symaddrs,
+                                           const std::vector<int32_t>& pids) {
   for (auto& pid : pids) {
     go_common_symaddrs_map_->UpdateValue(pid, symaddrs);
   }
-
-  return Status::OK();
 }
 
-Status UProbeManager::UpdateGoHTTP2SymAddrs(ElfReader* elf_reader, DwarfReader* dwarf_reader,
-                                            const std::vector<int32_t>& pids) {
-  PL_ASSIGN_OR_RETURN(struct go_http2_symaddrs_t symaddrs,
-                      GoHTTP2SymAddrs(elf_reader, dwarf_reader));
-
+void UProbeManager::UpdateGoHTTP2SymAddrs(const struct go_http2_symaddrs_t& symaddrs,
+                                          const std::vector<int32_t>& pids) {
   for (auto& pid : pids) {
     go_http2_symaddrs_map_->UpdateValue(pid, symaddrs);
   }
-
-  return Status::OK();
 }
 
-Status UProbeManager::UpdateGoTLSSymAddrs(ElfReader* elf_reader, DwarfReader* dwarf_reader,
-                                          const std::vector<int32_t>& pids) {
-  PL_ASSIGN_OR_RETURN(struct go_tls_symaddrs_t symaddrs, GoTLSSymAddrs(elf_reader, dwarf_reader));
-
+void UProbeManager::UpdateGoTLSSymAddrs(const struct go_tls_symaddrs_t& symaddrs,
+                                        const std::vector<int32_t>& pids) {
   for (auto& pid : pids) {
     go_tls_symaddrs_map_->UpdateValue(pid, symaddrs);
   }
-
-  return Status::OK();
 }
 
 Status UProbeManager::UpdateNodeTLSWrapSymAddrs(int32_t pid, const std::filesystem::path& node_exe,
@@ -383,7 +409,7 @@ void UProbeManager::SetupGOIDMaps(const std::string& binary, const std::vector<i
 
 StatusOr<int> UProbeManager::AttachGoRuntimeUProbes(const std::string& binary,
                                                     obj_tools::ElfReader* elf_reader,
-                                                    obj_tools::DwarfReader* /* dwarf_reader */,
+                                                    const GoSymAddrs& /* symaddrs */,
                                                     const std::vector<int32_t>& /* pids */) {
   // Step 1: Update BPF symbols_map on all new PIDs.
   // TODO(oazizi): Implement this piece.
@@ -399,17 +425,18 @@ StatusOr<int> UProbeManager::AttachGoRuntimeUProbes(const std::string& binary,
 
 StatusOr<int> UProbeManager::AttachGoTLSUProbes(const std::string& binary,
                                                 obj_tools::ElfReader* elf_reader,
-                                                obj_tools::DwarfReader* dwarf_reader,
+                                                const GoSymAddrs& symaddrs,
                                                 const std::vector<int32_t>& pids) {
-  // Step 1: Update BPF symbols_map on all new PIDs.
-  Status s = UpdateGoTLSSymAddrs(elf_reader, dwarf_reader, pids);
-  if (!s.ok()) {
+  if (!symaddrs.tls.has_value()) {
     // Doesn't appear to be a binary with the mandatory symbols.
     // Might not even be a golang binary.
     // Either way, not of interest to probe.
     return 0;
   }
 
+  // Step 1: Update BPF symbols_map on all new PIDs.
+  UpdateGoTLSSymAddrs(symaddrs.tls.value(), pids);
+
   // Step 2: Deploy uprobes on all new binaries.
   auto result = go_tls_probed_binaries_.insert(binary);
   if (!result.second) {
@@ -425,14 +452,15 @@ StatusOr<int> UProbeManager::AttachGoTLSUProbes(const std::string& binary,
 // because of the mixed & duplicate data events from these 2 sources.
 StatusOr<int> UProbeManager::AttachGoHTTP2Probes(const std::string& binary,
                                                  obj_tools::ElfReader* elf_reader,
-                                                 obj_tools::DwarfReader* dwarf_reader,
+                                                 const GoSymAddrs& symaddrs,
                                                  const std::vector<int32_t>& pids) {
-  // Step 1: Update BPF symaddrs for this binary.
-  Status s = UpdateGoHTTP2SymAddrs(elf_reader, dwarf_reader, pids);
-  if (!s.ok()) {
+  if (!symaddrs.http2.has_value()) {
     return 0;
   }
 
+  // Step 1: Update BPF symaddrs for this binary.
+  UpdateGoHTTP2SymAddrs(symaddrs.http2.value(), pids);
+
   // Step 2: Deploy uprobes on all new binaries.
   auto result = go_http2_probed_binaries_.insert(binary);
   if (!result.second) {
@@ -479,11 +507,13 @@ std::map<std::string, std::vector<int32_t>> ConvertPIDsListToMap(
 
 }  // namespace
 
-std::thread UProbeManager::RunDeployUProbesThread(const absl::flat_hash_set<md::UPID>& pids) {
+std::thread UProbeManager::RunDeployUProbesThread(
+    const absl::flat_hash_set<md::UPID>& pids,
+    absl::flat_hash_map<uint32_t, uint64_t> pid_activity) {
   // Increment before starting thread to avoid race in case thread starts late.
   ++num_deploy_uprobes_threads_;
-  return std::thread([this, pids]() {
-    DeployUProbes(pids);
+  return std::thread([this, pids, pid_activity = std::move(pid_activity)]() {
+    DeployUProbes(pids, pid_activity);
     --num_deploy_uprobes_threads_;
   });
   return {};
@@ -540,11 +570,167 @@ int UProbeManager::DeployOpenSSLUProbes(const absl::flat_hash_set<md::UPID>& pid
   return uprobe_count;
 }
 
-int UProbeManager::DeployGoUProbes(const absl::flat_hash_set<md::UPID>& pids) {
+namespace {
+
+template <typename T>
+std::optional<T> OptionalIfOK(StatusOr<T> status_or) {
+  if (!status_or.ok()) {
+    return std::nullopt;
+  }
+  return status_or.ConsumeValueOrDie();
+}
+
+}  // namespace
+
+StatusOr<GoSymAddrs> UProbeManager::GetGoSymAddrs(const std::string& binary,
+                                                  ElfReader* elf_reader) {
+  // Binaries without a build ID are still handled, they just can't be cached.
+  StatusOr<std::string> build_id_status = elf_reader->BuildID();
+  if (build_id_status.ok()) {
+    const GoSymAddrs* cached = go_symaddrs_cache_->Lookup(build_id_status.ValueOrDie());
+    if (cached != nullptr) {
+      VLOG(1) << absl::Substitute("Using cached symaddrs for binary $0 [build_id=$1]", binary,
+                                  build_id_status.ValueOrDie());
+      return *cached;
+    }
+  }
+
+  PL_ASSIGN_OR_RETURN(std::unique_ptr<DwarfReader> dwarf_reader,
+                      DwarfReader::CreateIndexingOnDemand(binary));
+
+  GoSymAddrs symaddrs;
+  symaddrs.common = OptionalIfOK(GoCommonSymAddrs(elf_reader, dwarf_reader.get()));
+  symaddrs.tls = OptionalIfOK(GoTLSSymAddrs(elf_reader, dwarf_reader.get()));
+  symaddrs.http2 = OptionalIfOK(GoHTTP2SymAddrs(elf_reader, dwarf_reader.get()));
+
+  if (build_id_status.ok()) {
+    go_symaddrs_cache_->Insert(build_id_status.ValueOrDie(), symaddrs);
+  }
+  return symaddrs;
+}
+
+void UProbeManager::ObserveTimeToTraced(const std::vector<md::UPID>& upids) {
+  // UPID start times are in kernel ticks since boot.
+  const double ticks_per_sec = system::Config::GetInstance().KernelTicksPerSecond();
+  const double now_sec = BootTimeSeconds();
+  for (const auto& upid : upids) {
+    // Processes that were running before Stirling started would only measure Stirling's uptime.
+    if (upid.start_ts() < start_time_ticks_) {
+      continue;
+    }
+    time_to_traced_histogram_.Observe(now_sec - upid.start_ts() / ticks_per_sec);
+  }
+}
+
+int UProbeManager::DeployGoUProbesOnBinary(const std::string& binary,
+                                           const std::vector<md::UPID>& upids) {
   int uprobe_count = 0;
 
+  std::vector<int32_t> pid_vec;
+  for (const auto& upid : upids) {
+    pid_vec.push_back(upid.pid());
+  }
+
+  // Read binary's symbols.
+  StatusOr<std::unique_ptr<ElfReader>> elf_reader_status = ElfReader::Create(binary);
+  if (!elf_reader_status.ok()) {
+    LOG(WARNING) << absl::Substitute(
+        "Cannot analyze binary $0 for uprobe deployment. "
+        "If file is under /var/lib, container may have terminated. "
+        "Message = $1",
+        binary, elf_reader_status.msg());
+    return 0;
+  }
+  std::unique_ptr<ElfReader> elf_reader = elf_reader_status.ConsumeValueOrDie();
+
+  // Avoid going past this point if not a golang program.
+  // The DwarfReader is memory intensive, and the remaining probes are Golang specific.
+  if (!IsGoExecutable(elf_reader.get())) {
+    return 0;
+  }
+
+  StatusOr<GoSymAddrs> symaddrs_status = GetGoSymAddrs(binary, elf_reader.get());
+  if (!symaddrs_status.ok()) {
+    VLOG(1) << absl::Substitute(
+        "Failed to get binary $0 debug symbols. Cannot deploy uprobes. "
+        "Message = $1",
+        binary, symaddrs_status.msg());
+    return 0;
+  }
+  const GoSymAddrs symaddrs = symaddrs_status.ConsumeValueOrDie();
+
+  if (!symaddrs.common.has_value()) {
+    VLOG(1) << absl::Substitute(
+        "Golang binary $0 does not have the mandatory symbols (e.g. TCPConn).", binary);
+    return 0;
+  }
+
+  const std::lock_guard<std::mutex> lock(go_attach_mutex_);
+
+  UpdateGoCommonSymAddrs(symaddrs.common.value(), pid_vec);
+
+  // Setup thread to GOID mapping.
+  SetupGOIDMaps(binary, pid_vec);
+
+  // Go Runtime Probes.
+  {
+    StatusOr<int> attach_status =
+        AttachGoRuntimeUProbes(binary, elf_reader.get(), symaddrs, pid_vec);
+    if (!attach_status.ok()) {
+      LOG_FIRST_N(WARNING, 10) << absl::Substitute("Failed to attach Go Runtime Uprobes to $0: $1",
+                                                   binary, attach_status.ToString());
+    } else {
+      uprobe_count += attach_status.ValueOrDie();
+    }
+  }
+
+  // GoTLS Probes.
+  {
+    StatusOr<int> attach_status = AttachGoTLSUProbes(binary, elf_reader.get(), symaddrs, pid_vec);
+    if (!attach_status.ok()) {
+      LOG_FIRST_N(WARNING, 10) << absl::Substitute("Failed to attach GoTLS Uprobes to $0: $1",
+                                                   binary, attach_status.ToString());
+    } else {
+      uprobe_count += attach_status.ValueOrDie();
+    }
+  }
+
+  // Go HTTP2 Probes.
+  if (cfg_enable_http2_tracing_) {
+    StatusOr<int> attach_status =
+        AttachGoHTTP2Probes(binary, elf_reader.get(), symaddrs, pid_vec);
+    if (!attach_status.ok()) {
+      LOG_FIRST_N(WARNING, 10) << absl::Substitute("Failed to attach HTTP2 Uprobes to $0: $1",
+                                                   binary, attach_status.ToString());
+    } else {
+      uprobe_count += attach_status.ValueOrDie();
+    }
+  }
+
+  if (uprobe_count != 0) {
+    ObserveTimeToTraced(upids);
+  }
+
+  return uprobe_count;
+}
+
+int UProbeManager::DeployGoUProbes(const absl::flat_hash_set<md::UPID>& pids,
+                                   const absl::flat_hash_map<uint32_t, uint64_t>& pid_activity) {
   static int32_t kPID = getpid();
 
+  struct BinaryTask {
+    std::string binary;
+    std::vector<md::UPID> upids;
+    uint64_t activity = 0;
+    uint64_t size = 0;
+  };
+
+  absl::flat_hash_map<uint32_t, md::UPID> pid_to_upid;
+  for (const auto& upid : pids) {
+    pid_to_upid.emplace(upid.pid(), upid);
+  }
+
+  std::vector<BinaryTask> tasks;
   for (const auto& [binary, pid_vec] : ConvertPIDsListToMap(pids, &fp_resolver_)) {
     // Don't bother rescanning binaries that have been scanned before to avoid unnecessary work.
     if (!scanned_binaries_.insert(binary).second) {
@@ -559,81 +745,39 @@ int UProbeManager::DeployGoUProbes(const absl::flat_hash_set<md::UPID>& pids) {
       }
     }
 
-    // Read binary's symbols.
-    StatusOr<std::unique_ptr<ElfReader>> elf_reader_status = ElfReader::Create(binary);
-    if (!elf_reader_status.ok()) {
-      LOG(WARNING) << absl::Substitute(
-          "Cannot analyze binary $0 for uprobe deployment. "
-          "If file is under /var/lib, container may have terminated. "
-          "Message = $1",
-          binary, elf_reader_status.msg());
-      continue;
-    }
-    std::unique_ptr<ElfReader> elf_reader = elf_reader_status.ConsumeValueOrDie();
-
-    // Avoid going past this point if not a golang program.
-    // The DwarfReader is memory intensive, and the remaining probes are Golang specific.
-    if (!IsGoExecutable(elf_reader.get())) {
-      continue;
+    BinaryTask task{.binary = binary};
+    std::error_code ec;
+    task.size = std::filesystem::file_size(binary, ec);
+    if (ec) {
+      task.size = 0;
     }
-
-    StatusOr<std::unique_ptr<DwarfReader>> dwarf_reader_status =
-        DwarfReader::CreateIndexingAll(binary);
-    if (!dwarf_reader_status.ok()) {
-      VLOG(1) << absl::Substitute(
-          "Failed to get binary $0 debug symbols. Cannot deploy uprobes. "
-          "Message = $1",
-          binary, dwarf_reader_status.msg());
-      continue;
-    }
-    std::unique_ptr<DwarfReader> dwarf_reader = dwarf_reader_status.ConsumeValueOrDie();
-
-    Status s = UpdateGoCommonSymAddrs(elf_reader.get(), dwarf_reader.get(), pid_vec);
-    if (!s.ok()) {
-      VLOG(1) << absl::Substitute(
-          "Golang binary $0 does not have the mandatory symbols (e.g. TCPConn).", binary);
-      continue;
-    }
-
-    // Setup thread to GOID mapping.
-    SetupGOIDMaps(binary, pid_vec);
-
-    // Go Runtime Probes.
-    {
-      StatusOr<int> attach_status =
-          AttachGoRuntimeUProbes(binary, elf_reader.get(), dwarf_reader.get(), pid_vec);
-      if (!attach_status.ok()) {
-        LOG_FIRST_N(WARNING, 10) << absl::Substitute(
-            "Failed to attach Go Runtime Uprobes to $0: $1", binary, attach_status.ToString());
-      } else {
-        uprobe_count += attach_status.ValueOrDie();
+    for (int32_t pid : pid_vec) {
+      task.upids.push_back(pid_to_upid.at(pid));
+      auto iter = pid_activity.find(pid);
+      if (iter != pid_activity.end()) {
+        task.activity += iter->second;
       }
     }
+    tasks.push_back(std::move(task));
+  }
 
-    // GoTLS Probes.
-    {
-      StatusOr<int> attach_status =
-          AttachGoTLSUProbes(binary, elf_reader.get(), dwarf_reader.get(), pid_vec);
-      if (!attach_status.ok()) {
-        LOG_FIRST_N(WARNING, 10) << absl::Substitute("Failed to attach GoTLS Uprobes to $0: $1",
-                                                     binary, attach_status.ToString());
-      } else {
-        uprobe_count += attach_status.ValueOrDie();
-      }
-    }
+  // The busiest binaries are the ones whose traffic is being missed the most.
+  std::stable_sort(tasks.begin(), tasks.end(), [](const BinaryTask& a, const BinaryTask& b) {
+    return a.activity > b.activity;
+  });
 
-    // Go HTTP2 Probes.
-    if (cfg_enable_http2_tracing_) {
-      StatusOr<int> attach_status =
-          AttachGoHTTP2Probes(binary, elf_reader.get(), dwarf_reader.get(), pid_vec);
-      if (!attach_status.ok()) {
-        LOG_FIRST_N(WARNING, 10) << absl::Substitute("Failed to attach HTTP2 Uprobes to $0: $1",
-                                                     binary, attach_status.ToString());
-      } else {
-        uprobe_count += attach_status.ValueOrDie();
-      }
-    }
+  if (deploy_pool_ == nullptr) {
+    deploy_pool_ = std::make_unique<TaskPool>(FLAGS_stirling_uprobe_deploy_threads,
+                                              FLAGS_stirling_uprobe_deploy_max_bytes);
+  }
+
+  std::atomic<int> uprobe_count = 0;
+  for (const BinaryTask& task : tasks) {
+    deploy_pool_->Submit(task.size, [this, &task, &uprobe_count]() {
+      uprobe_count += DeployGoUProbesOnBinary(task.binary, task.upids);
+    });
   }
+  deploy_pool_->Wait();
 
   return uprobe_count;
 }
@@ -684,7 +828,8 @@ absl::flat_hash_set<md::UPID> UProbeManager::PIDsToRescanForUProbes() {
   return upids_to_rescan;
 }
 
-void UProbeManager::DeployUProbes(const absl::flat_hash_set<md::UPID>& pids) {
+void UProbeManager::DeployUProbes(const absl::flat_hash_set<md::UPID>& pids,
+                                  const absl::flat_hash_map<uint32_t, uint64_t>& pid_activity) {
   const std::lock_guard<std::mutex> lock(deploy_uprobes_mutex_);
 
   proc_tracker_.Update(pids);
@@ -701,7 +846,7 @@ void UProbeManager::DeployUProbes(const absl::flat_hash_set<md::UPID>& pids) {
   if (FLAGS_stirling_rescan_for_dlopen) {
     uprobe_count += DeployOpenSSLUProbes(PIDsToRescanForUProbes());
   }
-  uprobe_count += DeployGoUProbes(proc_tracker_.new_upids());
+  uprobe_count += DeployGoUProbes(proc_tracker_.new_upids(), pid_activity);
 
   if (uprobe_count != 0) {
     LOG(INFO) << absl::Substitute("Number of uprobes deployed = $0", uprobe_count);
@@ -18,13 +18,17 @@
 
 #pragma once
 
+#include <atomic>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
 #include <absl/synchronization/mutex.h>
+#include <prometheus/histogram.h>
 
 #include "src/stirling/bpf_tools/bcc_wrapper.h"
 #include "src/stirling/obj_tools/dwarf_reader.h"
@@ -32,13 +36,18 @@
 
 #include "src/stirling/source_connectors/socket_tracer/bcc_bpf_intf/socket_trace.hpp"
 #include "src/stirling/source_connectors/socket_tracer/bcc_bpf_intf/symaddrs.h"
+#include "src/stirling/source_connectors/socket_tracer/go_symaddrs_cache.h"
 
 #include "src/stirling/utils/detect_application.h"
 #include "src/stirling/utils/proc_path_tools.h"
 #include "src/stirling/utils/proc_tracker.h"
+#include "src/stirling/utils/task_pool.h"
 
 DECLARE_bool(stirling_rescan_for_dlopen);
 DECLARE_double(stirling_rescan_exp_backoff_factor);
+DECLARE_string(stirling_go_symaddrs_cache_dir);
+DECLARE_int32(stirling_uprobe_deploy_threads);
+DECLARE_uint64(stirling_uprobe_deploy_max_bytes);
 
 namespace px {
 namespace stirling {
@@ -125,9 +134,12 @@ class UProbeManager {
    * Runs the uprobe deployment code on the provided set of pids, as a thread.
    * @param pids New PIDs to analyze deploy uprobes on. Old PIDs can also be provided,
    *             if they need to be rescanned.
+   * @param pid_activity Amount of traffic observed per PID, used to deploy uprobes on the
+   *                     busiest processes first. PIDs without an entry are deployed last.
    * @return thread that handles the uprobe deployment work.
    */
-  std::thread RunDeployUProbesThread(const absl::flat_hash_set<md::UPID>& pids);
+  std::thread RunDeployUProbesThread(const absl::flat_hash_set<md::UPID>& pids,
+                                     absl::flat_hash_map<uint32_t, uint64_t> pid_activity = {});
 
   /**
    * Returns true if a previously dispatched thread (via RunDeployUProbesThread is still running).
@@ -368,7 +380,8 @@ class UProbeManager {
    * Deploys all available uprobe types (HTTP2, OpenSSL, etc.) on new processes.
    * @param pids The list of pids to analyze and instrument with uprobes, if appropriate.
    */
-  void DeployUProbes(const absl::flat_hash_set<md::UPID>& pids);
+  void DeployUProbes(const absl::flat_hash_set<md::UPID>& pids,
+                     const absl::flat_hash_map<uint32_t, uint64_t>& pid_activity);
 
   /**
    * Deploys all OpenSSL uprobes on new processes.
@@ -379,10 +392,27 @@ class UProbeManager {
 
   /**
    * Deploys all Go uprobes on new processes.
+   * Distinct binaries are processed concurrently by deploy_pool_, in decreasing order of the
+   * activity of their processes, while their total size is within
+   * FLAGS_stirling_uprobe_deploy_max_bytes.
    * @param pids The list of pids to analyze and instrument with Go uprobes, if appropriate.
+   * @param pid_activity See RunDeployUProbesThread().
    * @return Number of uprobes deployed.
    */
-  int DeployGoUProbes(const absl::flat_hash_set<md::UPID>& pids);
+  int DeployGoUProbes(const absl::flat_hash_set<md::UPID>& pids,
+                      const absl::flat_hash_map<uint32_t, uint64_t>& pid_activity);
+
+  /**
+   * Deploys all Go uprobes on a single binary. Safe to call concurrently for distinct binaries.
+   * @param binary The binary to analyze and instrument with Go uprobes, if appropriate.
+   * @param upids The processes that are instances of the binary.
+   * @return Number of uprobes deployed.
+   */
+  int DeployGoUProbesOnBinary(const std::string& binary, const std::vector<md::UPID>& upids);
+
+  // Records the time from the start of the processes until they are traced. Processes that
+  // started before the UProbeManager are skipped.
+  void ObserveTimeToTraced(const std::vector<md::UPID>& upids);
 
   /**
    * Sets up the BPF maps used for GOID tracking. Required for general Go tracing.
@@ -398,14 +428,14 @@ class UProbeManager {
    *
    * @param binary The path to the binary on which to deploy Go probes.
    * @param elf_reader ELF reader for the binary.
-   * @param dwarf_reader DWARF reader for the binary.
+   * @param symaddrs Symbol addresses resolved for the binary.
    * @param pids The list of PIDs that are new instances of the binary. Used to populate symbol
    *             addresses.
    * @return The number of uprobes deployed, or error. It is not an error if the binary
    *         is not a Go binary; instead the return value will be zero.
    */
   StatusOr<int> AttachGoRuntimeUProbes(const std::string& binary, obj_tools::ElfReader* elf_reader,
-                                       obj_tools::DwarfReader* dwarf_reader,
+                                       const GoSymAddrs& symaddrs,
                                        const std::vector<int32_t>& new_pids);
 
   /**
@@ -414,7 +444,7 @@ class UProbeManager {
    *
    * @param binary The path to the binary on which to deploy Go HTTP2 probes.
    * @param elf_reader ELF reader for the binary.
-   * @param dwarf_reader DWARF reader for the binary.
+   * @param symaddrs Symbol addresses resolved for the binary.
    * @param pids The list of PIDs that are new instances of the binary. Used to populate symbol
    *             addresses.
    * @return The number of uprobes deployed, or error. It is not considered an error if the binary
@@ -422,8 +452,7 @@ class UProbeManager {
    *         zero.
    */
   StatusOr<int> AttachGoHTTP2Probes(const std::string& binary, obj_tools::ElfReader* elf_reader,
-                                    obj_tools::DwarfReader* dwarf_reader,
-                                    const std::vector<int32_t>& pids);
+                                    const GoSymAddrs& symaddrs, const std::vector<int32_t>& pids);
 
   /**
    * Attaches the required probes for GoTLS tracing to the specified binary, if it is a compatible
@@ -431,14 +460,14 @@ class UProbeManager {
    *
    * @param binary The path to the binary on which to deploy Go HTTP2 probes.
    * @param elf_reader ELF reader for the binary.
-   * @param dwarf_reader DWARF reader for the binary.
+   * @param symaddrs Symbol addresses resolved for the binary.
    * @param pids The list of PIDs that are new instances of the binary. Used to populate symbol
    *             addresses.
    * @return The number of uprobes deployed, or error. It is not an error if the binary
    *         is not a Go binary or doesn't use Go TLS; instead the return value will be zero.
    */
   StatusOr<int> AttachGoTLSUProbes(const std::string& binary, obj_tools::ElfReader* elf_reader,
-                                   obj_tools::DwarfReader* dwarf_reader,
+                                   const GoSymAddrs& symaddrs,
                                    const std::vector<int32_t>& new_pids);
 
   /**
@@ -479,14 +508,21 @@ class UProbeManager {
   absl::flat_hash_set<md::UPID> PIDsToRescanForUProbes();
 
   Status UpdateOpenSSLSymAddrs(std::filesystem::path container_lib, uint32_t pid);
-  Status UpdateGoCommonSymAddrs(obj_tools::ElfReader* elf_reader,
-                                obj_tools::DwarfReader* dwarf_reader,
-                                const std::vector<int32_t>& pids);
-  Status UpdateGoHTTP2SymAddrs(obj_tools::ElfReader* elf_reader,
-                               obj_tools::DwarfReader* dwarf_reader,
-                               const std::vector<int32_t>& pids);
-  Status UpdateGoTLSSymAddrs(obj_tools::ElfReader* elf_reader, obj_tools::DwarfReader* dwarf_reader,
+  void UpdateGoCommonSymAddrs(const struct go_common_symaddrs_t& symaddrs,
+                              const std::vector<int32_t>& pids);
+  void UpdateGoHTTP2SymAddrs(const struct go_http2_symaddrs_t& symaddrs,
                              const std::vector<int32_t>& pids);
+  void UpdateGoTLSSymAddrs(const struct go_tls_symaddrs_t& symaddrs,
+                           const std::vector<int32_t>& pids);
+
+  /**
+   * Returns the symbol addresses needed for the Go uprobes of the binary.
+   * They are looked up in go_symaddrs_cache_ by build ID first, since resolving them requires
+   * indexing the DWARF info, which is expensive for large binaries.
+   *
+   * @return Error if the DWARF info could not be read.
+   */
+  StatusOr<GoSymAddrs> GetGoSymAddrs(const std::string& binary, obj_tools::ElfReader* elf_reader);
   Status UpdateNodeTLSWrapSymAddrs(int32_t pid, const std::filesystem::path& node_exe,
                                    const SemVer& ver);
 
@@ -507,8 +543,21 @@ class UProbeManager {
   std::mutex deploy_uprobes_mutex_;
   std::atomic<int> num_deploy_uprobes_threads_ = 0;
 
+  // Serializes the BCC and BPF map accesses of concurrent DeployGoUProbesOnBinary() calls.
+  // Only the analysis of the binaries, which dominates the deployment time, runs concurrently.
+  std::mutex go_attach_mutex_;
+
+  // The time at which the UProbeManager was created, in kernel ticks since boot.
+  const int64_t start_time_ticks_;
+
+  prometheus::Histogram& time_to_traced_histogram_;
+
   std::unique_ptr<system::ProcParser> proc_parser_;
   ProcTracker proc_tracker_;
+
+  // Symbol addresses of Go binaries, shared across all processes running the same binary.
+  std::unique_ptr<GoSymAddrsCache> go_symaddrs_cache_;
+
   LazyLoadedFPResolver fp_resolver_;
 
   absl::flat_hash_set<upid_t> upids_with_mmap_;
@@ -543,6 +592,10 @@ class UProbeManager {
       node_tlswrap_symaddrs_map_;
   std::unique_ptr<UserSpaceManagedBPFMap<uint32_t, int, ebpf::BPFMapInMapTable<uint32_t>>>
       go_goid_map_;
+
+  // Worker threads that analyze binaries for Go uprobe deployment, created on first use.
+  // Declared last so that the workers are joined before the state they use is destroyed.
+  std::unique_ptr<TaskPool> deploy_pool_;
 };
 
 }  // namespace stirling
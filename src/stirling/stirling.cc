@@ -23,12 +23,16 @@
 #include <chrono>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <utility>
 #include <vector>
 
 #include <absl/base/internal/spinlock.h>
+#include <absl/strings/ascii.h>
+#include <absl/strings/str_split.h>
 
 #include "src/common/base/base.h"
 #include "src/common/perf/elapsed_timer.h"
@@ -36,6 +40,7 @@
 
 #include "src/stirling/bpf_tools/probe_cleaner.h"
 #include "src/stirling/core/data_table.h"
+#include "src/stirling/core/proc_lifecycle_tracker.h"
 #include "src/stirling/core/pub_sub_manager.h"
 #include "src/stirling/core/source_connector.h"
 #include "src/stirling/core/source_registry.h"
@@ -55,6 +60,16 @@
 
 #include "src/stirling/source_connectors/dynamic_tracer/dynamic_tracing/dynamic_tracer.h"
 
+DEFINE_bool(stirling_proc_lifecycle_tracking, true,
+            "If true, and Stirling is not running with agent metadata, track processes with BPF "
+            "exec/exit events instead of scanning /proc on every iteration.");
+DEFINE_uint32(stirling_proc_rescan_period_secs, 30,
+              "Period at which process lifecycle tracking reconciles against /proc.");
+DEFINE_string(stirling_unsubscribed_columns, "",
+              "Comma-separated <table>.<column> names (e.g. 'http_events.req_body') whose values "
+              "are not collected. String columns are filled with empty strings instead, so the "
+              "table schemas do not change.");
+
 namespace px {
 namespace stirling {
 
@@ -170,6 +185,10 @@ class StirlingImpl final : public Stirling {
   }
   std::unique_ptr<ConnectorContext> GetContext();
 
+  // Returns the UPIDs for a standalone context from the ProcLifecycleTracker,
+  // or nullptr if process lifecycle tracking is disabled or could not be initialized.
+  std::shared_ptr<const absl::flat_hash_set<md::UPID>> StandaloneUPIDs();
+
   void Run() override;
   Status RunAsThread() override;
   bool IsRunning() const override;
@@ -234,6 +253,11 @@ class StirlingImpl final : public Stirling {
   AgentMetadataCallback agent_metadata_callback_ = nullptr;
   AgentMetadataType agent_metadata_;
 
+  // Tracks the live processes for the standalone context, when there is no agent metadata.
+  // Created on first use, since the agent metadata callback may be registered after Init().
+  std::once_flag proc_lifecycle_tracker_once_;
+  std::unique_ptr<ProcLifecycleTracker> proc_lifecycle_tracker_;
+
   absl::base_internal::SpinLock dynamic_trace_status_map_lock_;
   absl::flat_hash_map<sole::uuid, StatusOr<stirlingpb::Publish>> dynamic_trace_status_map_
       ABSL_GUARDED_BY(dynamic_trace_status_map_lock_);
@@ -365,9 +389,37 @@ std::unique_ptr<ConnectorContext> StirlingImpl::GetContext() {
   if (agent_metadata_callback_ != nullptr) {
     return std::unique_ptr<ConnectorContext>(new AgentContext(agent_metadata_callback_()));
   }
+  std::shared_ptr<const absl::flat_hash_set<md::UPID>> upids = StandaloneUPIDs();
+  if (upids != nullptr) {
+    return std::unique_ptr<ConnectorContext>(new StandaloneContext(std::move(upids)));
+  }
   return std::unique_ptr<ConnectorContext>(new StandaloneContext());
 }
 
+std::shared_ptr<const absl::flat_hash_set<md::UPID>> StirlingImpl::StandaloneUPIDs() {
+  if (!FLAGS_stirling_proc_lifecycle_tracking) {
+    return nullptr;
+  }
+
+  std::call_once(proc_lifecycle_tracker_once_, [this]() {
+    StatusOr<std::unique_ptr<ProcLifecycleTracker>> tracker_status =
+        ProcLifecycleTracker::Create(system::Config::GetInstance().proc_path(),
+                                     std::chrono::seconds(FLAGS_stirling_proc_rescan_period_secs));
+    if (!tracker_status.ok()) {
+      LOG(WARNING) << absl::Substitute(
+          "Could not start process lifecycle tracking, will scan /proc instead. Message=$0",
+          tracker_status.msg());
+      return;
+    }
+    proc_lifecycle_tracker_ = tracker_status.ConsumeValueOrDie();
+  });
+
+  if (proc_lifecycle_tracker_ == nullptr) {
+    return nullptr;
+  }
+  return proc_lifecycle_tracker_->Update();
+}
+
 namespace {
 
 std::vector<DataTable*> GetDataTables(const std::vector<InfoClassManager*>& info_class_mgrs) {
@@ -379,6 +431,24 @@ std::vector<DataTable*> GetDataTables(const std::vector<InfoClassManager*>& info
   return data_tables;
 }
 
+// Returns the columns of FLAGS_stirling_unsubscribed_columns, keyed by table name. Table names
+// may contain dots, so the column name is whatever follows the last dot.
+absl::flat_hash_map<std::string, std::vector<std::string>> UnsubscribedColumns() {
+  absl::flat_hash_map<std::string, std::vector<std::string>> columns;
+  for (std::string_view name :
+       absl::StrSplit(FLAGS_stirling_unsubscribed_columns, ',', absl::SkipWhitespace())) {
+    name = absl::StripAsciiWhitespace(name);
+    size_t pos = name.rfind('.');
+    if (pos == std::string_view::npos) {
+      LOG(WARNING) << absl::Substitute("Ignoring unsubscribed column '$0' without a table name.",
+                                       name);
+      continue;
+    }
+    columns[std::string(name.substr(0, pos))].emplace_back(name.substr(pos + 1));
+  }
+  return columns;
+}
+
 }  // namespace
 
 Status StirlingImpl::AddSource(std::unique_ptr<SourceConnector> source) {
@@ -390,10 +460,18 @@ Status StirlingImpl::AddSource(std::unique_ptr<SourceConnector> source) {
   std::vector<InfoClassManager*> mgrs;
   mgrs.reserve(source->table_schemas().size());
 
+  const auto unsubscribed_columns = UnsubscribedColumns();
   for (const DataTableSchema& schema : source->table_schemas()) {
     LOG(INFO) << absl::Substitute("Adding info class: [$0/$1]", source->name(), schema.name());
     auto mgr = std::make_unique<InfoClassManager>(schema);
     mgr->SetSourceConnector(source.get());
+    auto iter = unsubscribed_columns.find(schema.name());
+    if (iter != unsubscribed_columns.end()) {
+      for (const auto& col_name : iter->second) {
+        Status s = mgr->data_table()->UnsubscribeColumn(col_name);
+        LOG_IF(WARNING, !s.ok()) << s.msg();
+      }
+    }
     mgrs.push_back(mgr.get());
     info_class_mgrs_.push_back(std::move(mgr));
   }
@@ -700,25 +778,6 @@ void SleepForDuration(std::chrono::milliseconds sleep_duration) {
   }
 }
 
-// Returns true if any of the input tables are beyond the threshold.
-bool DataExceedsThreshold(const std::vector<DataTable*>& data_tables) {
-  // Data push threshold, based on percentage of buffer that is filled.
-  constexpr uint32_t kDefaultOccupancyPctThreshold = 100;
-
-  // Data push threshold, based number of records after which a push.
-  constexpr uint32_t kDefaultOccupancyThreshold = 1024;
-
-  for (const auto* data_table : data_tables) {
-    if (static_cast<uint32_t>(100 * data_table->OccupancyPct()) > kDefaultOccupancyPctThreshold) {
-      return true;
-    }
-    if (data_table->Occupancy() > kDefaultOccupancyThreshold) {
-      return true;
-    }
-  }
-  return false;
-}
-
 }  // namespace
 
 // Main Data Collector loop.
@@ -759,7 +818,7 @@ void StirlingImpl::RunCore() {
           source->TransferData(ctx.get(), output.data_tables);
         }
         // Phase 2: Push Data upstream.
-        if (source->push_freq_mgr().Expired() || DataExceedsThreshold(output.data_tables)) {
+        if (source->PushRequired(output.data_tables)) {
           source->PushData(data_push_callback_, output.data_tables);
         }
       }
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/stirling/utils/task_pool.h"
+
+#include <algorithm>
+
+namespace px {
+namespace stirling {
+
+TaskPool::TaskPool(int num_threads, uint64_t max_cost) : max_cost_(max_cost) {
+  num_threads = std::max(num_threads, 1);
+  threads_.reserve(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    threads_.emplace_back(&TaskPool::WorkerLoop, this);
+  }
+}
+
+TaskPool::~TaskPool() {
+  {
+    absl::MutexLock lock(&mu_);
+    mu_.Await(absl::Condition(
+        +[](TaskPool* pool) ABSL_NO_THREAD_SAFETY_ANALYSIS {
+          return pool->queue_.empty() && pool->num_running_ == 0;
+        },
+        this));
+    stopping_ = true;
+  }
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void TaskPool::Submit(uint64_t cost, std::function<void()> fn) {
+  absl::MutexLock lock(&mu_);
+  queue_.push_back({cost, std::move(fn)});
+}
+
+void TaskPool::Wait() {
+  absl::MutexLock lock(&mu_);
+  mu_.Await(absl::Condition(
+      +[](TaskPool* pool) ABSL_NO_THREAD_SAFETY_ANALYSIS {
+        return pool->queue_.empty() && pool->num_running_ == 0;
+      },
+      this));
+}
+
+bool TaskPool::CanStartTask() const {
+  if (queue_.empty()) {
+    return false;
+  }
+  if (num_running_ == 0) {
+    return true;
+  }
+  const uint64_t cost = queue_.front().cost;
+  return cost <= max_cost_ && running_cost_ <= max_cost_ - cost;
+}
+
+void TaskPool::WorkerLoop() {
+  while (true) {
+    Task task;
+    {
+      absl::MutexLock lock(&mu_);
+      mu_.Await(absl::Condition(
+          +[](TaskPool* pool) ABSL_NO_THREAD_SAFETY_ANALYSIS {
+            return pool->stopping_ || pool->CanStartTask();
+          },
+          this));
+      if (stopping_) {
+        return;
+      }
+      task = std::move(queue_.front());
+      queue_.pop_front();
+      running_cost_ += task.cost;
+      ++num_running_;
+    }
+
+    task.fn();
+
+    absl::MutexLock lock(&mu_);
+    running_cost_ -= task.cost;
+    --num_running_;
+  }
+}
+
+}  // namespace stirling
+}  // namespace px
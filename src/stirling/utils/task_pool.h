@@ -0,0 +1,84 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <absl/base/thread_annotations.h>
+#include <absl/synchronization/mutex.h>
+
+namespace px {
+namespace stirling {
+
+/**
+ * TaskPool runs tasks on a fixed set of worker threads, which are kept for the lifetime of the
+ * pool. Each task declares a cost (e.g. the memory it is expected to use), and a task is only
+ * started while the total cost of the running tasks stays within the pool's budget. A task that
+ * exceeds the budget on its own is run once no other task is running, so every task eventually
+ * runs.
+ *
+ * Tasks are started in the order in which they were submitted.
+ */
+class TaskPool {
+ public:
+  TaskPool(int num_threads, uint64_t max_cost);
+
+  // Waits for the submitted tasks to finish and joins the worker threads.
+  ~TaskPool();
+
+  /**
+   * Queues fn to be run by one of the worker threads.
+   */
+  void Submit(uint64_t cost, std::function<void()> fn);
+
+  /**
+   * Blocks until all the submitted tasks have finished.
+   */
+  void Wait();
+
+  int num_threads() const { return threads_.size(); }
+
+ private:
+  struct Task {
+    uint64_t cost = 0;
+    std::function<void()> fn;
+  };
+
+  void WorkerLoop();
+
+  // Whether the task at the front of the queue can start.
+  bool CanStartTask() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const uint64_t max_cost_;
+
+  absl::Mutex mu_;
+  std::deque<Task> queue_ ABSL_GUARDED_BY(mu_);
+  uint64_t running_cost_ ABSL_GUARDED_BY(mu_) = 0;
+  int num_running_ ABSL_GUARDED_BY(mu_) = 0;
+  bool stopping_ ABSL_GUARDED_BY(mu_) = false;
+
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace stirling
+}  // namespace px
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/stirling/utils/task_pool.h"
+
+#include <atomic>
+#include <thread>
+
+#include <absl/container/flat_hash_set.h>
+#include <absl/synchronization/notification.h>
+#include <gtest/gtest.h>
+
+namespace px {
+namespace stirling {
+
+TEST(TaskPoolTest, RunsAllTasks) {
+  TaskPool pool(/*num_threads*/ 4, /*max_cost*/ 100);
+  std::atomic<int> count = 0;
+  for (int i = 0; i < 100; ++i) {
+    pool.Submit(/*cost*/ 1, [&count]() { ++count; });
+  }
+  pool.Wait();
+  EXPECT_EQ(count, 100);
+}
+
+TEST(TaskPoolTest, RunsTasksConcurrently) {
+  TaskPool pool(/*num_threads*/ 2, /*max_cost*/ 100);
+  absl::Notification first_started;
+  absl::Notification second_started;
+  bool first_saw_second = false;
+  bool second_saw_first = false;
+  // Each task only finishes in time if the other one runs at the same time.
+  pool.Submit(/*cost*/ 1, [&]() {
+    first_started.Notify();
+    first_saw_second = second_started.WaitForNotificationWithTimeout(absl::Seconds(10));
+  });
+  pool.Submit(/*cost*/ 1, [&]() {
+    second_started.Notify();
+    second_saw_first = first_started.WaitForNotificationWithTimeout(absl::Seconds(10));
+  });
+  pool.Wait();
+  EXPECT_TRUE(first_saw_second);
+  EXPECT_TRUE(second_saw_first);
+}
+
+TEST(TaskPoolTest, KeepsRunningCostWithinBudget) {
+  TaskPool pool(/*num_threads*/ 4, /*max_cost*/ 10);
+  std::atomic<int> running_cost = 0;
+  std::atomic<int> max_running_cost = 0;
+  for (int i = 0; i < 20; ++i) {
+    pool.Submit(/*cost*/ 4, [&]() {
+      int cost = running_cost += 4;
+      int max = max_running_cost;
+      while (cost > max && !max_running_cost.compare_exchange_weak(max, cost)) {
+      }
+      absl::SleepFor(absl::Milliseconds(1));
+      running_cost -= 4;
+    });
+  }
+  pool.Wait();
+  EXPECT_LE(max_running_cost, 8);
+}
+
+TEST(TaskPoolTest, RunsTaskOverBudgetAlone) {
+  TaskPool pool(/*num_threads*/ 2, /*max_cost*/ 10);
+  std::atomic<int> num_running = 0;
+  bool ran_alone = false;
+  pool.Submit(/*cost*/ 1, [&]() {
+    ++num_running;
+    absl::SleepFor(absl::Milliseconds(10));
+    --num_running;
+  });
+  pool.Submit(/*cost*/ 100, [&]() { ran_alone = (++num_running == 1); });
+  pool.Wait();
+  EXPECT_TRUE(ran_alone);
+}
+
+TEST(TaskPoolTest, ReusesThreadsAcrossRounds) {
+  TaskPool pool(/*num_threads*/ 2, /*max_cost*/ 100);
+  absl::Mutex mu;
+  absl::flat_hash_set<std::thread::id> thread_ids;
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < 10; ++i) {
+      pool.Submit(/*cost*/ 1, [&]() {
+        absl::MutexLock lock(&mu);
+        thread_ids.insert(std::this_thread::get_id());
+      });
+    }
+    pool.Wait();
+  }
+  EXPECT_LE(thread_ids.size(), 2);
+  EXPECT_FALSE(thread_ids.contains(std::this_thread::get_id()));
+}
+
+}  // namespace stirling
+}  // namespace px
@@ -302,12 +302,14 @@ schema::Relation Table::GetRelation() const { return rel_; }
 TableStats Table::GetTableStats() const {
   TableStats info;
   auto num_batches = NumBatches();
+  auto num_rows = NumRows();
   absl::base_internal::SpinLockHolder lock(&stats_lock_);
 
   info.batches_added = batches_added_;
   info.batches_expired = batches_expired_;
   info.num_batches = num_batches;
   info.bytes = hot_bytes_ + cold_bytes_;
+  info.num_rows = num_rows;
   info.cold_bytes = cold_bytes_;
   info.compacted_batches = compacted_batches_;
   info.max_table_size = max_table_size_;
@@ -583,6 +585,27 @@ int64_t Table::NumBatches() const {
   return RingSizeUnlocked() + hot_batches_.size();
 }
 
+int64_t Table::NumRows() const {
+  // Row IDs are assigned consecutively and expire from the front, so the live rows are the ones
+  // from the first remaining row ID up to next_row_id_.
+  absl::MutexLock gen_lock(&generation_lock_);
+  int64_t first_row_id = -1;
+  {
+    absl::MutexLock cold_lock(&cold_lock_);
+    if (ring_back_idx_ != -1) {
+      first_row_id = cold_row_ids_.front().first;
+    }
+  }
+  absl::MutexLock hot_lock(&hot_lock_);
+  if (first_row_id == -1) {
+    if (hot_row_ids_.empty()) {
+      return 0;
+    }
+    first_row_id = hot_row_ids_.front().first;
+  }
+  return next_row_id_ - first_row_id;
+}
+
 BatchSlice Table::FirstBatch() const {
   absl::MutexLock gen_lock(&generation_lock_);
   {
@@ -51,6 +51,7 @@ using RecordBatchSPtr = std::shared_ptr<arrow::RecordBatch>;
 
 struct TableStats {
   int64_t bytes;
+  int64_t num_rows;
   int64_t cold_bytes;
   int64_t num_batches;
   int64_t batches_added;
@@ -374,6 +375,7 @@ class Table : public NotCopyable {
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(hot_lock_);
 
   int64_t NumBatches() const;
+  int64_t NumRows() const;
   int64_t ColdBatchLengthUnlocked(int64_t ring_index) const
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(cold_lock_);
   int64_t HotBatchLengthUnlocked(int64_t hot_index) const ABSL_EXCLUSIVE_LOCKS_REQUIRED(hot_lock_);
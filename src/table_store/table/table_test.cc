@@ -128,6 +128,7 @@ TEST(TableTest, bytes_test) {
 
   EXPECT_OK(table.WriteRowBatch(rb1));
   EXPECT_EQ(table.GetTableStats().bytes, rb1_size);
+  EXPECT_EQ(table.GetTableStats().num_rows, 3);
 
   schema::RowBatch rb2(rd, 2);
   std::vector<types::Int64Value> col1_rb2 = {4, 5};
@@ -161,6 +162,7 @@ TEST(TableTest, bytes_test) {
   EXPECT_OK(table.TransferRecordBatch(std::move(wrapper_batch_1)));
 
   EXPECT_EQ(table.GetTableStats().bytes, rb1_size + rb2_size + rb3_size);
+  EXPECT_EQ(table.GetTableStats().num_rows, 8);
 }
 
 TEST(TableTest, bytes_test_w_compaction) {
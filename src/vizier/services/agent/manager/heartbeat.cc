@@ -19,6 +19,7 @@
 #include "src/vizier/services/agent/manager/heartbeat.h"
 
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -31,15 +32,29 @@ namespace agent {
 using ::px::event::Dispatcher;
 using ::px::shared::k8s::metadatapb::ResourceUpdate;
 
+namespace {
+
+int64_t SizeClass(int64_t num_rows) {
+  int64_t size_class = 0;
+  for (; num_rows >= 10; num_rows /= 10) {
+    ++size_class;
+  }
+  return size_class;
+}
+
+}  // namespace
+
 HeartbeatMessageHandler::HeartbeatMessageHandler(Dispatcher* d,
                                                  px::md::AgentMetadataStateManager* mds_manager,
                                                  RelationInfoManager* relation_info_manager,
+                                                 table_store::TableStore* table_store,
                                                  Info* agent_info,
                                                  Manager::VizierNATSConnector* nats_conn)
     : MessageHandler(d, agent_info, nats_conn),
       time_source_(dispatcher()->GetTimeSource()),
       mds_manager_(mds_manager),
       relation_info_manager_(relation_info_manager),
+      table_store_(table_store),
       heartbeat_send_timer_(
           dispatcher()->CreateTimer(std::bind(&HeartbeatMessageHandler::SendHeartbeat, this))),
       heartbeat_watchdog_timer_(
@@ -97,10 +112,24 @@ Status HeartbeatMessageHandler::SendHeartbeatInternal() {
   auto* update_info = hb->mutable_update_info();
 
   ConsumeAgentPIDUpdates(update_info);
-  if (agent_info()->capabilities.collects_data() &&
-      (!sent_schema_ || relation_info_manager_->has_updates())) {
-    sent_schema_ = true;
-    relation_info_manager_->AddSchemaToUpdateInfo(update_info);
+  if (agent_info()->capabilities.collects_data()) {
+    auto table_num_rows = TableNumRows();
+    absl::flat_hash_map<std::string, int64_t> row_size_classes;
+    for (const auto& [name, num_rows] : table_num_rows) {
+      row_size_classes[name] = SizeClass(num_rows);
+    }
+    if (!sent_schema_ || relation_info_manager_->has_updates() ||
+        row_size_classes != sent_row_size_classes_) {
+      sent_schema_ = true;
+      sent_row_size_classes_ = std::move(row_size_classes);
+      relation_info_manager_->AddSchemaToUpdateInfo(update_info);
+      for (auto& schema : *update_info->mutable_schema()) {
+        auto it = table_num_rows.find(schema.name());
+        if (it != table_num_rows.end()) {
+          schema.set_num_rows(it->second);
+        }
+      }
+    }
   }
 
   // We skip sending the metadata update when there have been no changes.
@@ -117,6 +146,19 @@ Status HeartbeatMessageHandler::SendHeartbeatInternal() {
   return nats_conn()->Publish(req);
 }
 
+absl::flat_hash_map<std::string, int64_t> HeartbeatMessageHandler::TableNumRows() const {
+  absl::flat_hash_map<std::string, int64_t> table_num_rows;
+  for (uint64_t table_id : table_store_->GetTableIDs()) {
+    // Only the default tablet is counted, so tabletized tables are left out.
+    table_store::Table* table = table_store_->GetTable(table_id);
+    if (table == nullptr) {
+      continue;
+    }
+    table_num_rows[table_store_->GetTableName(table_id)] = table->GetTableStats().num_rows;
+  }
+  return table_num_rows;
+}
+
 void HeartbeatMessageHandler::HeartbeatWatchdog() {
   if (heartbeat_info_.last_ackd_seq_num < heartbeat_info_.last_sent_seq_num) {
     auto diff = time_source_.MonotonicTime() - heartbeat_info_.last_heartbeat_send_time_;
@@ -19,7 +19,11 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
+#include <absl/container/flat_hash_map.h>
+
+#include "src/table_store/table/table_store.h"
 #include "src/vizier/services/agent/manager/manager.h"
 
 namespace px {
@@ -31,7 +35,8 @@ class HeartbeatMessageHandler : public Manager::MessageHandler {
   HeartbeatMessageHandler() = delete;
   HeartbeatMessageHandler(px::event::Dispatcher* dispatcher,
                           px::md::AgentMetadataStateManager* mds_manager,
-                          RelationInfoManager* relation_info_manager, Info* agent_info,
+                          RelationInfoManager* relation_info_manager,
+                          table_store::TableStore* table_store, Info* agent_info,
                           Manager::VizierNATSConnector* nats_conn);
 
   ~HeartbeatMessageHandler() override = default;
@@ -50,6 +55,9 @@ class HeartbeatMessageHandler : public Manager::MessageHandler {
 
   void DoHeartbeats();
 
+  // Returns the number of rows held in each table of the table store, by table name.
+  absl::flat_hash_map<std::string, int64_t> TableNumRows() const;
+
   void SendHeartbeat();
   Status SendHeartbeatInternal();
   void HeartbeatWatchdog();
@@ -69,6 +77,11 @@ class HeartbeatMessageHandler : public Manager::MessageHandler {
   const px::event::TimeSource& time_source_;
   px::md::AgentMetadataStateManager* mds_manager_;
   RelationInfoManager* relation_info_manager_;
+  table_store::TableStore* table_store_;
+  // The order of magnitude of each table's row count in the last schema that was sent, by table
+  // name. The schema is sent again when one of them changes, so the row counts that the planner
+  // reads from the schema stay roughly current without sending the schema on every heartbeat.
+  absl::flat_hash_map<std::string, int64_t> sent_row_size_classes_;
   std::chrono::duration<double> heartbeat_latency_moving_average_{0};
 
   px::event::TimerUPtr heartbeat_send_timer_;
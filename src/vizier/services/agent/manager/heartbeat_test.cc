@@ -16,6 +16,7 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <arrow/memory_pool.h>
 #include <gtest/gtest.h>
 
 #include <string>
@@ -29,6 +30,8 @@
 #include "src/common/testing/event/simulated_time_system.h"
 #include "src/common/testing/testing.h"
 #include "src/shared/metadatapb/metadata.pb.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/table_store/table/table_store.h"
 #include "src/vizier/messages/messagespb/messages.pb.h"
 #include "src/vizier/services/agent/manager/heartbeat.h"
 #include "src/vizier/services/agent/manager/manager.h"
@@ -38,7 +41,10 @@ namespace px {
 namespace vizier {
 namespace agent {
 
+using ::px::table_store::Table;
 using ::px::table_store::schema::Relation;
+using ::px::table_store::schema::RowBatch;
+using ::px::table_store::schema::RowDescriptor;
 using ::px::testing::proto::EqualsProto;
 using ::px::testing::proto::Partially;
 using shared::metadatapb::MetadataType;
@@ -134,12 +140,39 @@ class HeartbeatMessageHandlerTest : public ::testing::Test {
       EXPECT_OK(relation_info_manager_->AddRelationInfo(relation_info));
     }
 
+    table_store_ = std::make_shared<table_store::TableStore>();
+    for (const auto& relation_info : relation_info_vec) {
+      table_store_->AddTable(Table::Create(relation_info.name, relation_info.relation),
+                             relation_info.name, relation_info.id);
+    }
+
     agent_info_ = agent::Info{};
     agent_info_.capabilities.set_collects_data(true);
 
     heartbeat_handler_ = std::make_unique<HeartbeatMessageHandler>(
-        dispatcher_.get(), mds_manager_.get(), relation_info_manager_.get(), &agent_info_,
-        nats_conn_.get());
+        dispatcher_.get(), mds_manager_.get(), relation_info_manager_.get(), table_store_.get(),
+        &agent_info_, nats_conn_.get());
+  }
+
+  // Writes num_rows rows to relation0.
+  void WriteRelation0Rows(int64_t num_rows) {
+    std::vector<types::Time64NSValue> times;
+    std::vector<types::Int64Value> counts;
+    for (int64_t i = 0; i < num_rows; ++i) {
+      times.push_back(next_time_++);
+      counts.push_back(i);
+    }
+    Table* table = table_store_->GetTable("relation0");
+    auto rb = RowBatch(RowDescriptor(table->GetRelation().col_types()), num_rows);
+    EXPECT_OK(rb.AddColumn(types::ToArrow(times, arrow::default_memory_pool())));
+    EXPECT_OK(rb.AddColumn(types::ToArrow(counts, arrow::default_memory_pool())));
+    EXPECT_OK(table->WriteRowBatch(rb));
+  }
+
+  void AckHeartbeat(int64_t sequence_number) {
+    auto hb_ack = std::make_unique<messages::VizierMessage>();
+    hb_ack->mutable_heartbeat_ack()->set_sequence_number(sequence_number);
+    EXPECT_OK(heartbeat_handler_->HandleMessage(std::move(hb_ack)));
   }
 
   void CheckFilterElements(const messages::AgentDataInfo& data_info,
@@ -161,6 +194,8 @@ class HeartbeatMessageHandlerTest : public ::testing::Test {
   std::unique_ptr<event::Dispatcher> dispatcher_;
   std::unique_ptr<FakeAgentMetadataStateManager> mds_manager_;
   std::unique_ptr<RelationInfoManager> relation_info_manager_;
+  std::shared_ptr<table_store::TableStore> table_store_;
+  int64_t next_time_ = 1;
   std::unique_ptr<HeartbeatMessageHandler> heartbeat_handler_;
   std::unique_ptr<FakeNATSConnector<px::vizier::messages::VizierMessage>> nats_conn_;
   agent::Info agent_info_;
@@ -310,6 +345,40 @@ TEST_F(HeartbeatMessageHandlerTest, HandleHeartbeatRelationUpdates) {
   EXPECT_EQ(3, hb.update_info().schema().size());
 }
 
+TEST_F(HeartbeatMessageHandlerTest, HandleHeartbeatTableNumRows) {
+  WriteRelation0Rows(5);
+  dispatcher_->Run(event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(1, nats_conn_->published_msgs().size());
+  auto hb = nats_conn_->published_msgs()[0].heartbeat();
+  ASSERT_EQ(2, hb.update_info().schema().size());
+  EXPECT_EQ("relation0", hb.update_info().schema(0).name());
+  EXPECT_EQ(5, hb.update_info().schema(0).num_rows());
+  EXPECT_EQ("relation1", hb.update_info().schema(1).name());
+  EXPECT_EQ(0, hb.update_info().schema(1).num_rows());
+  AckHeartbeat(0);
+
+  // The row count stays within the same order of magnitude, so the schema isn't resent.
+  WriteRelation0Rows(3);
+  time_system_->SetMonotonicTime(start_monotonic_time_ + std::chrono::milliseconds(5000 + 1));
+  dispatcher_->Run(event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(2, nats_conn_->published_msgs().size());
+  hb = nats_conn_->published_msgs()[1].heartbeat();
+  EXPECT_EQ(1, hb.sequence_number());
+  EXPECT_EQ(0, hb.update_info().schema().size());
+  AckHeartbeat(1);
+
+  // The row count grows by an order of magnitude, so the schema is resent with the new count.
+  WriteRelation0Rows(20);
+  time_system_->SetMonotonicTime(start_monotonic_time_ + std::chrono::milliseconds(2 * 5000 + 2));
+  dispatcher_->Run(event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(3, nats_conn_->published_msgs().size());
+  hb = nats_conn_->published_msgs()[2].heartbeat();
+  EXPECT_EQ(2, hb.sequence_number());
+  ASSERT_EQ(2, hb.update_info().schema().size());
+  EXPECT_EQ("relation0", hb.update_info().schema(0).name());
+  EXPECT_EQ(28, hb.update_info().schema(0).num_rows());
+}
+
 class HeartbeatNackMessageHandlerTest : public ::testing::Test {
  protected:
   void TearDown() override { dispatcher_->Exit(); }
@@ -365,6 +365,33 @@ func deleteTableFromComputed(computedSchemaPb *storepb.ComputedSchema, tableName
 	return nil
 }
 
+// padNumRows makes NumRows parallel to AgentID. Computed schemas written before agents reported
+// their row counts have no NumRows, so their agents are counted as holding no rows.
+func padNumRows(agents *storepb.ComputedSchema_AgentIDs) {
+	for len(agents.NumRows) < len(agents.AgentID) {
+		agents.NumRows = append(agents.NumRows, 0)
+	}
+	agents.NumRows = agents.NumRows[:len(agents.AgentID)]
+}
+
+// updateTableNumRows sets the row count of each table to the total over the agents that hold it.
+func updateTableNumRows(computedSchemaPb *storepb.ComputedSchema) {
+	for i, tableInfo := range computedSchemaPb.Tables {
+		agents, ok := computedSchemaPb.TableNameToAgentIDs[tableInfo.Name]
+		if !ok {
+			continue
+		}
+		var numRows int64
+		for _, n := range agents.NumRows {
+			numRows += n
+		}
+		// Copy the table info, it may be the one the agent sent.
+		table := *tableInfo
+		table.NumRows = numRows
+		computedSchemaPb.Tables[i] = &table
+	}
+}
+
 func deleteAgentFromComputed(computedSchemaPb *storepb.ComputedSchema, tableName string, agentIDPb *uuidpb.UUID) error {
 	agents := computedSchemaPb.TableNameToAgentIDs[tableName]
 	// If the number of agents is 1, delete the schema period.
@@ -389,10 +416,13 @@ func deleteAgentFromComputed(computedSchemaPb *storepb.ComputedSchema, tableName
 		return fmt.Errorf("Agent %v marked for deletion not found in list of agents for %s", agentIDPb, tableName)
 	}
 
+	padNumRows(agents)
 	// Set the ith element equal to last element.
 	agents.AgentID[idx] = agents.AgentID[len(agents.AgentID)-1]
+	agents.NumRows[idx] = agents.NumRows[len(agents.NumRows)-1]
 	// Truncate last element away.
 	agents.AgentID = agents.AgentID[:len(agents.AgentID)-1]
+	agents.NumRows = agents.NumRows[:len(agents.NumRows)-1]
 	computedSchemaPb.TableNameToAgentIDs[tableName] = agents
 	return nil
 }
@@ -433,11 +463,14 @@ func (a *Datastore) UpdateSchemas(agentID uuid.UUID, schemas []*storepb.TableInf
 		tableMap[existingTable.Name] = existingTable
 	}
 
-	// Add the list of tables that the agent currently belongs to.
+	// Add the list of tables that the agent currently belongs to, along with the agent's index in
+	// each table's list of agents.
+	previousAgentTableIdx := make(map[string]int)
 	for name, agents := range computedSchemaPb.TableNameToAgentIDs {
-		for _, agt := range agents.AgentID {
+		for i, agt := range agents.AgentID {
 			if agt.Equal(agentIDPb) {
 				previousAgentTableTracker[name] = false
+				previousAgentTableIdx[name] = i
 				break
 			}
 		}
@@ -451,8 +484,11 @@ func (a *Datastore) UpdateSchemas(agentID uuid.UUID, schemas []*storepb.TableInf
 
 		_, agentHasTable := previousAgentTableTracker[schemaPb.Name]
 		if agentHasTable {
-			// If it's in the new schema, we don't need to do anything, so we mark this true.
+			// If it's in the new schema, we only need to update the agent's row count, so we mark this true.
 			previousAgentTableTracker[schemaPb.Name] = true
+			agents := computedSchemaPb.TableNameToAgentIDs[schemaPb.Name]
+			padNumRows(agents)
+			agents.NumRows[previousAgentTableIdx[schemaPb.Name]] = schemaPb.NumRows
 			continue
 		}
 		// We haven't seen the agent w/ this schema. That means two cases
@@ -463,12 +499,15 @@ func (a *Datastore) UpdateSchemas(agentID uuid.UUID, schemas []*storepb.TableInf
 
 		// Case 1 tableExists, but agent needs to be associated.
 		if tableExists {
+			padNumRows(agents)
 			agents.AgentID = append(agents.AgentID, agentIDPb)
+			agents.NumRows = append(agents.NumRows, schemaPb.NumRows)
 			continue
 		}
 
 		computedSchemaPb.TableNameToAgentIDs[schemaPb.Name] = &storepb.ComputedSchema_AgentIDs{
 			AgentID: []*uuidpb.UUID{agentIDPb},
+			NumRows: []int64{schemaPb.NumRows},
 		}
 	}
 
@@ -491,6 +530,7 @@ func (a *Datastore) UpdateSchemas(agentID uuid.UUID, schemas []*storepb.TableInf
 			return err
 		}
 	}
+	updateTableNumRows(computedSchemaPb)
 
 	computedSchema, err := computedSchemaPb.Marshal()
 	if err != nil {
@@ -536,15 +576,19 @@ func (a *Datastore) PruneComputedSchema() error {
 
 	// Filter out any dead agents from the table -> agent mapping.
 	for tableName, agentIDs := range computedSchemaPb.TableNameToAgentIDs {
+		padNumRows(agentIDs)
 		prunedIDs := []*uuidpb.UUID{}
+		prunedNumRows := []int64{}
 		for i, agentID := range agentIDs.AgentID {
 			if existingAgents[utils.UUIDFromProtoOrNil(agentID)] {
 				prunedIDs = append(prunedIDs, agentIDs.AgentID[i])
+				prunedNumRows = append(prunedNumRows, agentIDs.NumRows[i])
 			}
 		}
 		if len(prunedIDs) > 0 {
 			tableToAgents[tableName] = &storepb.ComputedSchema_AgentIDs{
 				AgentID: prunedIDs,
+				NumRows: prunedNumRows,
 			}
 			existingTables[tableName] = true
 		}
@@ -562,6 +606,7 @@ func (a *Datastore) PruneComputedSchema() error {
 		Tables:              tableInfos,
 		TableNameToAgentIDs: tableToAgents,
 	}
+	updateTableNumRows(newComputedSchemaPb)
 	computedSchema, err := newComputedSchemaPb.Marshal()
 	if err != nil {
 		log.WithError(err).Error("Could not marshal computed schema update message.")
@@ -736,6 +736,47 @@ func TestAgent_GetAgentUpdate(t *testing.T) {
 	assert.NotNil(t, err)
 }
 
+func TestAgent_UpdateSchemasNumRows(t *testing.T) {
+	ads, _, _, cleanup := setupManager(t)
+	defer cleanup()
+
+	agUUID1, err := uuid.FromString(testutils.UnhealthyAgentUUID)
+	require.NoError(t, err)
+	agUUID2, err := uuid.FromString(testutils.ExistingAgentUUID)
+	require.NoError(t, err)
+
+	updateNumRows := func(agentID uuid.UUID, numRows int64) {
+		schema := new(storepb.TableInfo)
+		if err := proto.UnmarshalText(testutils.SchemaInfoPB, schema); err != nil {
+			t.Fatal("Cannot Unmarshal protobuf.")
+		}
+		schema.NumRows = numRows
+		err := ads.UpdateSchemas(agentID, []*storepb.TableInfo{schema})
+		require.NoError(t, err)
+	}
+	checkNumRows := func(numRows int64) {
+		schema, err := ads.GetComputedSchema()
+		require.NoError(t, err)
+		require.Len(t, schema.Tables, 1)
+		assert.Equal(t, numRows, schema.Tables[0].NumRows)
+		agents := schema.TableNameToAgentIDs["a_table"]
+		assert.Len(t, agents.NumRows, len(agents.AgentID))
+	}
+
+	// The computed row count of a table is the sum over the agents that hold it.
+	updateNumRows(agUUID2, 100)
+	checkNumRows(100)
+	updateNumRows(agUUID1, 20)
+	checkNumRows(120)
+	updateNumRows(agUUID2, 300)
+	checkNumRows(320)
+
+	// Agents that no longer hold the table don't count towards it.
+	err = ads.UpdateSchemas(agUUID2, []*storepb.TableInfo{})
+	require.NoError(t, err)
+	checkNumRows(20)
+}
+
 func TestAgent_UpdateConfig(t *testing.T) {
 	_, agtMgr, nc, cleanup := setupManager(t)
 	defer cleanup()
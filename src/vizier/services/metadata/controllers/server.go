@@ -126,6 +126,11 @@ func convertToSchemaInfo(computedSchema *storepb.ComputedSchema) ([]*distributed
 			Relation:  schemaPb,
 			AgentList: agentIDs.AgentID,
 		}
+		// A table without rows might also be one whose agents don't report row counts, so it's left
+		// without statistics.
+		if schema.NumRows > 0 {
+			schemaInfo[idx].Stats = &distributedpb.TableStats{NumRows: schema.NumRows}
+		}
 	}
 
 	return schemaInfo, nil
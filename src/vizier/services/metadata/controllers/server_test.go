@@ -822,12 +822,15 @@ func TestGetAgentUpdates(t *testing.T) {
 		TableNameToAgentIDs: map[string]*storepb.ComputedSchema_AgentIDs{
 			"table1": {
 				AgentID: []*uuidpb.UUID{u1pb, u2pb},
+				NumRows: []int64{1000, 200},
 			},
 			"table2": {
 				AgentID: []*uuidpb.UUID{u1pb},
+				NumRows: []int64{0},
 			},
 		},
 	}
+	computedSchema1.Tables[0].NumRows = 1200
 
 	cursorID := uuid.Must(uuid.NewV4())
 	mockAgtMgr.
@@ -1013,10 +1016,13 @@ func TestGetAgentUpdates(t *testing.T) {
 	assert.Equal(t, 2, len(r1.AgentSchemas[0].AgentList))
 	assert.Equal(t, u1pb, r1.AgentSchemas[0].AgentList[0])
 	assert.Equal(t, u2pb, r1.AgentSchemas[0].AgentList[1])
+	assert.Equal(t, &distributedpb.TableStats{NumRows: 1200}, r1.AgentSchemas[0].Stats)
 	assert.Equal(t, "table2", r1.AgentSchemas[1].Name)
 	assert.Equal(t, 2, len(r1.AgentSchemas[1].Relation.Columns))
 	assert.Equal(t, 1, len(r1.AgentSchemas[1].AgentList))
 	assert.Equal(t, u1pb, r1.AgentSchemas[1].AgentList[0])
+	// Tables without rows are sent without statistics.
+	assert.Nil(t, r1.AgentSchemas[1].Stats)
 
 	// Check empty message
 	r2 := resps[2]